@@ -0,0 +1,86 @@
+# This file is part of Mixxx, Digital DJ'ing software.
+# Copyright (C) 2001-2020 Mixxx Development Team
+# Distributed under the GNU General Public Licence (GPL) version 2 or any later
+# later version. See the LICENSE file for details.
+
+#[=======================================================================[.rst:
+Findlz4
+-------
+
+Finds the LZ4 compression library.
+
+Imported Targets
+^^^^^^^^^^^^^^^^
+
+This module provides the following imported targets, if found:
+
+``lz4::lz4``
+  The LZ4 library
+
+Result Variables
+^^^^^^^^^^^^^^^^
+
+This will define the following variables:
+
+``lz4_FOUND``
+  True if the system has the LZ4 library.
+``lz4_INCLUDE_DIRS``
+  Include directories needed to use LZ4.
+``lz4_LIBRARIES``
+  Libraries needed to link to LZ4.
+``lz4_DEFINITIONS``
+  Compile definitions needed to use LZ4.
+
+Cache Variables
+^^^^^^^^^^^^^^^
+
+The following cache variables may also be set:
+
+``lz4_INCLUDE_DIR``
+  The directory containing ``lz4.h``.
+``lz4_LIBRARY``
+  The path to the LZ4 library.
+
+#]=======================================================================]
+
+find_package(PkgConfig QUIET)
+if(PkgConfig_FOUND)
+  pkg_check_modules(PC_lz4 QUIET liblz4)
+endif()
+
+find_path(lz4_INCLUDE_DIR
+  NAMES lz4.h
+  PATHS ${PC_lz4_INCLUDE_DIRS}
+  DOC "LZ4 include directory")
+mark_as_advanced(lz4_INCLUDE_DIR)
+
+find_library(lz4_LIBRARY
+  NAMES lz4 liblz4
+  PATHS ${PC_lz4_LIBRARY_DIRS}
+  DOC "LZ4 library"
+)
+mark_as_advanced(lz4_LIBRARY)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(
+  lz4
+  DEFAULT_MSG
+  lz4_LIBRARY
+  lz4_INCLUDE_DIR
+)
+
+if(lz4_FOUND)
+  set(lz4_LIBRARIES "${lz4_LIBRARY}")
+  set(lz4_INCLUDE_DIRS "${lz4_INCLUDE_DIR}")
+  set(lz4_DEFINITIONS ${PC_lz4_CFLAGS_OTHER})
+
+  if(NOT TARGET lz4::lz4)
+    add_library(lz4::lz4 UNKNOWN IMPORTED)
+    set_target_properties(lz4::lz4
+      PROPERTIES
+        IMPORTED_LOCATION "${lz4_LIBRARY}"
+        INTERFACE_COMPILE_OPTIONS "${PC_lz4_CFLAGS_OTHER}"
+        INTERFACE_INCLUDE_DIRECTORIES "${lz4_INCLUDE_DIR}"
+    )
+  endif()
+endif()
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <QList>
+
 #include "audio/types.h"
 #include "util/assert.h"
+#include "util/indexrange.h"
 #include "util/types.h"
 
 /*
@@ -37,6 +40,21 @@ class Analyzer {
     // but not finalize()!
     virtual bool processSamples(const CSAMPLE* pIn, const int iLen) = 0;
 
+    // Returns the frame ranges relative to the start of the track that
+    // need to be processed, sorted and non-overlapping. An empty list
+    // requests the whole track. The frames in between are only skipped if
+    // none of the other analyzers needs them, see skipSamples().
+    virtual QList<mixxx::IndexRange> frameRangesToProcess() const {
+        return {};
+    }
+
+    // Notifies the analyzer that the next iLen samples are not decoded
+    // and will not be passed to processSamples(). Only invoked for
+    // analyzers that restrict their frameRangesToProcess().
+    virtual void skipSamples(const int iLen) {
+        Q_UNUSED(iLen);
+    }
+
     // Update the track object with the analysis results after
     // processing finished successfully, i.e. all available audio
     // samples have been processed.
@@ -85,6 +103,17 @@ class AnalyzerWithState final {
         }
     }
 
+    QList<mixxx::IndexRange> frameRangesToProcess() const {
+        DEBUG_ASSERT(m_active);
+        return m_analyzer->frameRangesToProcess();
+    }
+
+    void skipSamples(const int iLen) {
+        if (m_active) {
+            m_analyzer->skipSamples(iLen);
+        }
+    }
+
     void finish(TrackPointer tio) {
         if (m_active) {
             m_analyzer->storeResults(tio);
@@ -6,6 +6,7 @@
 #include <QtDebug>
 
 #include "analyzer/constants.h"
+#include "analyzer/fastanalysis.h"
 #include "analyzer/plugins/analyzerqueenmarybeats.h"
 #include "analyzer/plugins/analyzersoundtouchbeats.h"
 #include "library/rekordbox/rekordboxconstants.h"
@@ -13,6 +14,18 @@
 #include "track/beatutils.h"
 #include "track/track.h"
 
+namespace {
+
+// Segments in fast analysis mode agree on the tempo if their
+// BPM values differ by less than this fraction.
+constexpr double kSegmentBpmTolerance = 0.02;
+
+// Beat intervals within this fraction of the detected beat length
+// count as evidence for the tempo of a segment.
+constexpr double kBeatIntervalTolerance = 0.05;
+
+} // anonymous namespace
+
 // static
 QList<mixxx::AnalyzerPluginInfo> AnalyzerBeats::availablePlugins() {
     QList<mixxx::AnalyzerPluginInfo> plugins;
@@ -37,8 +50,8 @@ AnalyzerBeats::AnalyzerBeats(UserSettingsPointer pConfig, bool enforceBpmDetecti
           m_bPreferencesFixedTempo(true),
           m_bPreferencesFastAnalysis(false),
           m_totalSamples(0),
-          m_iMaxSamplesToProcess(0),
-          m_iCurrentSample(0) {
+          m_iCurrentSample(0),
+          m_currentSegment(0) {
 }
 
 bool AnalyzerBeats::initialize(TrackPointer pTrack,
@@ -87,31 +100,23 @@ bool AnalyzerBeats::initialize(TrackPointer pTrack,
 
     m_sampleRate = sampleRate;
     m_totalSamples = totalSamples;
-    // In fast analysis mode, skip processing after
-    // kFastAnalysisSecondsToAnalyze seconds are analyzed.
+    m_iCurrentSample = 0;
+    // In fast analysis mode only a few evenly spaced segments with a
+    // total length of kFastAnalysisSecondsToAnalyze seconds are analyzed.
+    m_fastAnalysisFrameRanges.clear();
     if (m_bPreferencesFastAnalysis) {
-        m_iMaxSamplesToProcess =
-                mixxx::kFastAnalysisSecondsToAnalyze * m_sampleRate * mixxx::kAnalysisChannels;
-    } else {
-        m_iMaxSamplesToProcess = m_totalSamples;
+        m_fastAnalysisFrameRanges = mixxx::fastAnalysisFrameRanges(
+                m_totalSamples / mixxx::kAnalysisChannels, m_sampleRate);
     }
-    m_iCurrentSample = 0;
+    m_currentSegment = 0;
+    m_segmentResults.clear();
 
     // if we can load a stored track don't reanalyze it
     bool bShouldAnalyze = shouldAnalyze(pTrack);
 
     DEBUG_ASSERT(!m_pPlugin);
     if (bShouldAnalyze) {
-        if (m_pluginId == mixxx::AnalyzerQueenMaryBeats::pluginInfo().id()) {
-            m_pPlugin = std::make_unique<mixxx::AnalyzerQueenMaryBeats>();
-        } else if (m_pluginId == mixxx::AnalyzerSoundTouchBeats::pluginInfo().id()) {
-            m_pPlugin = std::make_unique<mixxx::AnalyzerSoundTouchBeats>();
-        } else {
-            // This must not happen, because we have already verified above
-            // that the PlugInId is valid
-            DEBUG_ASSERT(false);
-        }
-
+        m_pPlugin = createPlugin();
         if (m_pPlugin) {
             if (m_pPlugin->initialize(sampleRate)) {
                 qDebug() << "Beat calculation started with plugin" << m_pluginId;
@@ -127,6 +132,18 @@ bool AnalyzerBeats::initialize(TrackPointer pTrack,
     return bShouldAnalyze;
 }
 
+std::unique_ptr<mixxx::AnalyzerBeatsPlugin> AnalyzerBeats::createPlugin() const {
+    if (m_pluginId == mixxx::AnalyzerQueenMaryBeats::pluginInfo().id()) {
+        return std::make_unique<mixxx::AnalyzerQueenMaryBeats>();
+    } else if (m_pluginId == mixxx::AnalyzerSoundTouchBeats::pluginInfo().id()) {
+        return std::make_unique<mixxx::AnalyzerSoundTouchBeats>();
+    }
+    // This must not happen, because we have already verified
+    // that the PlugInId is valid
+    DEBUG_ASSERT(false);
+    return nullptr;
+}
+
 bool AnalyzerBeats::shouldAnalyze(TrackPointer pTrack) const {
     bool bpmLock = pTrack->isBpmLocked();
     if (bpmLock) {
@@ -196,23 +213,198 @@ bool AnalyzerBeats::shouldAnalyze(TrackPointer pTrack) const {
 }
 
 bool AnalyzerBeats::processSamples(const CSAMPLE *pIn, const int iLen) {
+    if (!m_fastAnalysisFrameRanges.isEmpty()) {
+        return processSegmentSamples(pIn, iLen);
+    }
+
     VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
         return false;
     }
 
     m_iCurrentSample += iLen;
-    if (m_iCurrentSample > m_iMaxSamplesToProcess) {
-        return true; // silently ignore all remaining samples
+    return m_pPlugin->processSamples(pIn, iLen);
+}
+
+QList<mixxx::IndexRange> AnalyzerBeats::frameRangesToProcess() const {
+    return m_fastAnalysisFrameRanges;
+}
+
+void AnalyzerBeats::skipSamples(const int iLen) {
+    m_iCurrentSample += iLen;
+}
+
+bool AnalyzerBeats::processSegmentSamples(const CSAMPLE* pIn, const int iLen) {
+    const auto chunkFrameRange = mixxx::IndexRange::forward(
+            m_iCurrentSample / mixxx::kAnalysisChannels,
+            iLen / mixxx::kAnalysisChannels);
+    m_iCurrentSample += iLen;
+
+    while (m_currentSegment < m_fastAnalysisFrameRanges.size()) {
+        const auto segmentFrameRange = m_fastAnalysisFrameRanges.at(m_currentSegment);
+        if (segmentFrameRange.start() >= chunkFrameRange.end()) {
+            // The next segment starts after this chunk
+            break;
+        }
+        const auto overlap = intersect2(chunkFrameRange, segmentFrameRange);
+        if (overlap && !overlap->empty()) {
+            if (!m_pPlugin) {
+                m_pPlugin = createPlugin();
+                if (!m_pPlugin || !m_pPlugin->initialize(m_sampleRate)) {
+                    qWarning() << "Beat calculation failed to start for segment"
+                               << segmentFrameRange;
+                    return false;
+                }
+            }
+            if (!m_pPlugin->processSamples(
+                        pIn + (overlap->start() - chunkFrameRange.start()) * mixxx::kAnalysisChannels,
+                        overlap->length() * mixxx::kAnalysisChannels)) {
+                return false;
+            }
+        }
+        if (segmentFrameRange.end() > chunkFrameRange.end()) {
+            // The segment continues in the next chunk
+            break;
+        }
+        finishSegment(segmentFrameRange);
+        ++m_currentSegment;
+    }
+    return true;
+}
+
+void AnalyzerBeats::finishSegment(mixxx::IndexRange segmentFrameRange) {
+    if (!m_pPlugin) {
+        // Nothing has been processed
+        return;
+    }
+    const std::unique_ptr<mixxx::AnalyzerBeatsPlugin> pPlugin = std::move(m_pPlugin);
+    if (!pPlugin->finalize()) {
+        qWarning() << "Beat/BPM analysis failed for segment" << segmentFrameRange;
+        return;
     }
 
-    return m_pPlugin->processSamples(pIn, iLen);
+    SegmentResult result;
+    if (pPlugin->supportsBeatTracking()) {
+        const QVector<mixxx::audio::FramePos> beats = pPlugin->getBeats();
+        const QVector<BeatUtils::ConstRegion> constantRegions =
+                BeatUtils::retrieveConstRegions(beats, m_sampleRate);
+        if (constantRegions.isEmpty()) {
+            return;
+        }
+        mixxx::audio::FramePos firstBeat = mixxx::audio::kStartFramePos;
+        result.bpm = BeatUtils::makeConstBpm(constantRegions, m_sampleRate, &firstBeat);
+        if (!result.bpm.isValid() || !firstBeat.isValid()) {
+            return;
+        }
+        firstBeat = BeatUtils::adjustPhase(firstBeat, result.bpm, m_sampleRate, beats);
+        result.firstBeat = firstBeat + segmentFrameRange.start();
+
+        // The share of beat intervals that match the detected tempo
+        const double beatLength = 60.0 * m_sampleRate.value() / result.bpm.value();
+        int matchingIntervals = 0;
+        for (int i = 1; i < beats.size(); ++i) {
+            if (std::abs((beats[i] - beats[i - 1]) - beatLength) <=
+                    kBeatIntervalTolerance * beatLength) {
+                ++matchingIntervals;
+            }
+        }
+        result.confidence = beats.size() > 1
+                ? static_cast<double>(matchingIntervals) / (beats.size() - 1)
+                : 0.0;
+    } else {
+        // The phase is unknown
+        result.bpm = pPlugin->getBpm();
+        if (!result.bpm.isValid()) {
+            return;
+        }
+        result.firstBeat = mixxx::audio::FramePos(segmentFrameRange.start());
+        result.confidence = 1.0;
+    }
+    m_segmentResults.append(result);
+}
+
+mixxx::BeatsPointer AnalyzerBeats::reconcileSegmentResults() const {
+    if (m_segmentResults.isEmpty()) {
+        return nullptr;
+    }
+
+    // Each segment scores the sum of the confidences of all
+    // segments that agree with its tempo.
+    int bestSegment = 0;
+    double bestScore = 0.0;
+    double totalConfidence = 0.0;
+    for (int i = 0; i < m_segmentResults.size(); ++i) {
+        const SegmentResult& candidate = m_segmentResults.at(i);
+        totalConfidence += candidate.confidence;
+        double score = 0.0;
+        for (const auto& other : m_segmentResults) {
+            if (std::abs(other.bpm.value() - candidate.bpm.value()) <=
+                    kSegmentBpmTolerance * candidate.bpm.value()) {
+                score += other.confidence;
+            }
+        }
+        if (score > bestScore ||
+                (score == bestScore &&
+                        candidate.confidence >
+                                m_segmentResults.at(bestSegment).confidence)) {
+            bestSegment = i;
+            bestScore = score;
+        }
+    }
+
+    const SegmentResult& best = m_segmentResults.at(bestSegment);
+    qDebug() << "AnalyzerBeats fast analysis detected BPM:" << best.bpm
+             << "confidence:" << (totalConfidence > 0 ? bestScore / totalConfidence : 0.0)
+             << "segments:" << m_segmentResults.size();
+
+    // Extrapolate the grid of the most confident segment back to
+    // the start of the track
+    const double beatLength = 60.0 * m_sampleRate.value() / best.bpm.value();
+    const mixxx::audio::FramePos firstBeat = best.firstBeat -
+            std::floor(best.firstBeat.value() / beatLength) * beatLength;
+    const QString subVersion = BeatFactory::getPreferredSubVersion(
+            getExtraVersionInfo(m_pluginId, m_bPreferencesFastAnalysis));
+    if (m_bPreferencesFixedTempo) {
+        return mixxx::Beats::fromConstTempo(
+                m_sampleRate,
+                firstBeat.toNearestFrameBoundary(),
+                best.bpm,
+                subVersion);
+    }
+
+    // Tempo changes in between the segments are not detected, but the
+    // beats are stored as a beat map as requested by the preferences.
+    // Otherwise the version would not match in shouldAnalyze() and the
+    // track would be analyzed again each time.
+    const mixxx::audio::FramePos endPosition(
+            static_cast<double>(m_totalSamples / mixxx::kAnalysisChannels));
+    QVector<mixxx::audio::FramePos> beats;
+    for (auto beat = firstBeat; beat < endPosition; beat += beatLength) {
+        beats.append(beat.toNearestFrameBoundary());
+    }
+    return mixxx::Beats::fromBeatPositions(m_sampleRate, beats, subVersion);
 }
 
 void AnalyzerBeats::cleanup() {
     m_pPlugin.reset();
+    m_segmentResults.clear();
 }
 
 void AnalyzerBeats::storeResults(TrackPointer pTrack) {
+    if (!m_fastAnalysisFrameRanges.isEmpty()) {
+        // The last segment is still pending if the track turned out to be
+        // shorter than expected.
+        if (m_currentSegment < m_fastAnalysisFrameRanges.size()) {
+            finishSegment(m_fastAnalysisFrameRanges.at(m_currentSegment));
+        }
+        const auto pBeats = reconcileSegmentResults();
+        if (!pBeats) {
+            qWarning() << "Beat/BPM analysis failed";
+            return;
+        }
+        pTrack->trySetBeats(pBeats);
+        return;
+    }
+
     VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
         return;
     }
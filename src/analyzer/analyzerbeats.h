@@ -9,6 +9,7 @@
 
 #include <QHash>
 #include <QList>
+#include <QVector>
 
 #include "analyzer/analyzer.h"
 #include "analyzer/plugins/analyzerplugin.h"
@@ -30,11 +31,25 @@ class AnalyzerBeats : public Analyzer {
             mixxx::audio::SampleRate sampleRate,
             int totalSamples) override;
     bool processSamples(const CSAMPLE *pIn, const int iLen) override;
+    QList<mixxx::IndexRange> frameRangesToProcess() const override;
+    void skipSamples(const int iLen) override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
   private:
+    // The tempo and phase detected in one of the segments
+    // that are processed in fast analysis mode
+    struct SegmentResult {
+        mixxx::Bpm bpm;
+        mixxx::audio::FramePos firstBeat;
+        double confidence;
+    };
+
     bool shouldAnalyze(TrackPointer pTrack) const;
+    std::unique_ptr<mixxx::AnalyzerBeatsPlugin> createPlugin() const;
+    bool processSegmentSamples(const CSAMPLE* pIn, const int iLen);
+    void finishSegment(mixxx::IndexRange segmentFrameRange);
+    mixxx::BeatsPointer reconcileSegmentResults() const;
     static QHash<QString, QString> getExtraVersionInfo(
             const QString& pluginId, bool bPreferencesFastAnalysis);
 
@@ -49,6 +64,10 @@ class AnalyzerBeats : public Analyzer {
 
     mixxx::audio::SampleRate m_sampleRate;
     SINT m_totalSamples;
-    int m_iMaxSamplesToProcess;
     int m_iCurrentSample;
+
+    // Fast analysis runs a separate plugin instance on each segment
+    QList<mixxx::IndexRange> m_fastAnalysisFrameRanges;
+    int m_currentSegment;
+    QVector<SegmentResult> m_segmentResults;
 };
@@ -4,6 +4,7 @@
 #include <QtDebug>
 
 #include "analyzer/constants.h"
+#include "analyzer/fastanalysis.h"
 #if defined __KEYFINDER__
 #include "analyzer/plugins/analyzerkeyfinder.h"
 #endif
@@ -34,7 +35,6 @@ AnalyzerKey::AnalyzerKey(const KeyDetectionSettings& keySettings)
         : m_keySettings(keySettings),
           m_iSampleRate(0),
           m_iTotalSamples(0),
-          m_iMaxSamplesToProcess(0),
           m_iCurrentSample(0),
           m_bPreferencesKeyDetectionEnabled(true),
           m_bPreferencesFastAnalysisEnabled(false),
@@ -76,14 +76,14 @@ bool AnalyzerKey::initialize(TrackPointer tio,
 
     m_iSampleRate = sampleRate;
     m_iTotalSamples = totalSamples;
-    // In fast analysis mode, skip processing after
-    // kFastAnalysisSecondsToAnalyze seconds are analyzed.
+    m_iCurrentSample = 0;
+    // In fast analysis mode only a few evenly spaced segments with a
+    // total length of kFastAnalysisSecondsToAnalyze seconds are analyzed.
+    m_fastAnalysisFrameRanges.clear();
     if (m_bPreferencesFastAnalysisEnabled) {
-        m_iMaxSamplesToProcess = mixxx::kFastAnalysisSecondsToAnalyze * m_iSampleRate * mixxx::kAnalysisChannels;
-    } else {
-        m_iMaxSamplesToProcess = m_iTotalSamples;
+        m_fastAnalysisFrameRanges = mixxx::fastAnalysisFrameRanges(
+                m_iTotalSamples / mixxx::kAnalysisChannels, sampleRate);
     }
-    m_iCurrentSample = 0;
 
     // if we can't load a stored track reanalyze it
     bool bShouldAnalyze = shouldAnalyze(tio);
@@ -155,12 +155,38 @@ bool AnalyzerKey::processSamples(const CSAMPLE *pIn, const int iLen) {
         return false;
     }
 
+    const auto chunkFrameRange = mixxx::IndexRange::forward(
+            m_iCurrentSample / mixxx::kAnalysisChannels,
+            iLen / mixxx::kAnalysisChannels);
     m_iCurrentSample += iLen;
-    if (m_iCurrentSample > m_iMaxSamplesToProcess) {
-        return true; // silently ignore remaining samples
+    if (m_fastAnalysisFrameRanges.isEmpty()) {
+        return m_pPlugin->processSamples(pIn, iLen);
+    }
+
+    // The segments are fed into the plugin back to back
+    for (const auto& segmentFrameRange : qAsConst(m_fastAnalysisFrameRanges)) {
+        if (segmentFrameRange.start() >= chunkFrameRange.end()) {
+            break;
+        }
+        const auto overlap = intersect2(chunkFrameRange, segmentFrameRange);
+        if (!overlap || overlap->empty()) {
+            continue;
+        }
+        if (!m_pPlugin->processSamples(
+                    pIn + (overlap->start() - chunkFrameRange.start()) * mixxx::kAnalysisChannels,
+                    overlap->length() * mixxx::kAnalysisChannels)) {
+            return false;
+        }
     }
+    return true;
+}
 
-    return m_pPlugin->processSamples(pIn, iLen);
+QList<mixxx::IndexRange> AnalyzerKey::frameRangesToProcess() const {
+    return m_fastAnalysisFrameRanges;
+}
+
+void AnalyzerKey::skipSamples(const int iLen) {
+    m_iCurrentSample += iLen;
 }
 
 void AnalyzerKey::cleanup() {
@@ -178,6 +204,13 @@ void AnalyzerKey::storeResults(TrackPointer tio) {
     }
 
     KeyChangeList key_changes = m_pPlugin->getKeyChanges();
+    if (m_fastAnalysisFrameRanges.size() > 1) {
+        // The key changes at the boundaries of the concatenated segments
+        // are artifacts. Only the predominant key of each segment is kept
+        // and adjacent segments are merged.
+        key_changes = mixxx::fastAnalysisMergeKeyChanges(
+                m_fastAnalysisFrameRanges, key_changes);
+    }
     QHash<QString, QString> extraVersionInfo = getExtraVersionInfo(
             m_pluginId, m_bPreferencesFastAnalysisEnabled);
     Keys track_keys = KeyFactory::makePreferredKeys(
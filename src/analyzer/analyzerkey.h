@@ -23,6 +23,8 @@ class AnalyzerKey : public Analyzer {
             mixxx::audio::SampleRate sampleRate,
             int totalSamples) override;
     bool processSamples(const CSAMPLE *pIn, const int iLen) override;
+    QList<mixxx::IndexRange> frameRangesToProcess() const override;
+    void skipSamples(const int iLen) override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
@@ -37,9 +39,11 @@ class AnalyzerKey : public Analyzer {
     QString m_pluginId;
     int m_iSampleRate;
     int m_iTotalSamples;
-    int m_iMaxSamplesToProcess;
     int m_iCurrentSample;
 
+    // Fast analysis feeds only these ranges into the plugin
+    QList<mixxx::IndexRange> m_fastAnalysisFrameRanges;
+
     bool m_bPreferencesKeyDetectionEnabled;
     bool m_bPreferencesFastAnalysisEnabled;
     bool m_bPreferencesReanalyzeEnabled;
@@ -1,5 +1,6 @@
 #include "analyzer/analyzerthread.h"
 
+#include <algorithm>
 #include <mutex>
 
 #include "analyzer/analyzerbeats.h"
@@ -9,6 +10,7 @@
 #include "analyzer/analyzersilence.h"
 #include "analyzer/analyzerwaveform.h"
 #include "analyzer/constants.h"
+#include "engine/cachingreader/cachingreadertap.h"
 #include "engine/engine.h"
 #include "library/dao/analysisdao.h"
 #include "moc_analyzerthread.cpp"
@@ -152,7 +154,21 @@ void AnalyzerThread::doRun() {
         }
 
         if (processTrack) {
+            // Reuse the audio that is decoded for playback if the track
+            // is loaded into a deck while it is analyzed
+            if (m_modeFlags & AnalyzerModeFlags::WithPlaybackAudio) {
+                m_pPlaybackAudioTap = std::make_shared<CachingReaderTap>(
+                        m_currentTrack->getId());
+                if (!CachingReaderTap::attach(m_pPlaybackAudioTap)) {
+                    // Another analysis job is working on the same track
+                    m_pPlaybackAudioTap.reset();
+                }
+            }
             const auto analysisResult = analyzeAudioSource(audioSource);
+            if (m_pPlaybackAudioTap) {
+                CachingReaderTap::detach(m_pPlaybackAudioTap);
+                m_pPlaybackAudioTap.reset();
+            }
             DEBUG_ASSERT(analysisResult != AnalysisResult::Pending);
             if (analysisResult == AnalysisResult::Finished) {
                 // The analysis has been finished, and is either complete without
@@ -233,103 +249,187 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
     // Analysis starts now
     emitBusyProgress(kAnalyzerProgressNone);
 
-    mixxx::IndexRange remainingFrameRange = audioSource->frameIndexRange();
-    while (!remainingFrameRange.empty()) {
-        sleepWhileSuspended();
-        if (isStopping()) {
-            return AnalysisResult::Cancelled;
+    // Frames that are not needed by any analyzer are skipped
+    const QList<mixxx::IndexRange> frameRanges =
+            frameRangesToProcess(audioSource->frameIndexRange());
+    SINT framesToProcess = 0;
+    for (const auto& frameRange : frameRanges) {
+        framesToProcess += frameRange.length();
+    }
+    SINT processedFrames = 0;
+    SINT nextFrameIndex = audioSource->frameIndexRange().start();
+    for (const auto& frameRange : frameRanges) {
+        if (frameRange.start() > nextFrameIndex) {
+            const SINT skippedSamples =
+                    (frameRange.start() - nextFrameIndex) * mixxx::kAnalysisChannels;
+            for (auto&& analyzer : m_analyzers) {
+                analyzer.skipSamples(skippedSamples);
+            }
         }
+        nextFrameIndex = frameRange.end();
+        // Only the trailing range may be adjusted while reading
+        const bool isTrailingRange = frameRange.end() == audioSource->frameIndexRange().end();
+        mixxx::IndexRange remainingFrameRange = frameRange;
+        while (!remainingFrameRange.empty()) {
+            sleepWhileSuspended();
+            if (isStopping()) {
+                return AnalysisResult::Cancelled;
+            }
 
-        // 1st step: Decode next chunk of audio data
-
-        // Split the range for the next chunk from the remaining (= to-be-analyzed) frames
-        auto chunkFrameRange =
-                remainingFrameRange.splitAndShrinkFront(
-                        math_min(mixxx::kAnalysisFramesPerChunk, remainingFrameRange.length()));
-        DEBUG_ASSERT(!chunkFrameRange.empty());
-
-        // Request the next chunk of audio data
-        const auto readableSampleFrames =
-                audioSourceProxy.readSampleFrames(
-                        mixxx::WritableSampleFrames(
-                                chunkFrameRange,
-                                mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
-        // The returned range fits into the requested range
-        DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
-
-        // Sometimes the duration of the audio source is inaccurate and adjusted
-        // while reading. We need to adjust all frame ranges to reflect this new
-        // situation by restoring all invariants and consistency requirements!
-
-        // Shrink the original range of the current chunks to the actual available
-        // range.
-        chunkFrameRange = intersect(chunkFrameRange, audioSourceProxy.frameIndexRange());
-        // The audio data that has just been read should still fit into the adjusted
-        // chunk range.
-        DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
-
-        // We also need to adjust the remaining frame range for the next requests.
-        remainingFrameRange = intersect(remainingFrameRange, audioSourceProxy.frameIndexRange());
-        // Currently the range will never grow, but lets also account for this case
-        // that might become relevant in the future.
-        VERIFY_OR_DEBUG_ASSERT(remainingFrameRange.empty() ||
-                remainingFrameRange.end() == audioSourceProxy.frameIndexRange().end()) {
-            if (chunkFrameRange.length() < mixxx::kAnalysisFramesPerChunk) {
-                // If we have read an incomplete chunk while the range has grown
-                // we need to discard the read results and re-read the current
-                // chunk!
-
-                remainingFrameRange.growFront(chunkFrameRange.length());
-                continue;
+            // 1st step: Decode next chunk of audio data
+
+            // Split the range for the next chunk from the remaining (= to-be-analyzed) frames
+            auto chunkFrameRange =
+                    remainingFrameRange.splitAndShrinkFront(
+                            math_min(mixxx::kAnalysisFramesPerChunk, remainingFrameRange.length()));
+            DEBUG_ASSERT(!chunkFrameRange.empty());
+
+            // Request the next chunk of audio data, either from the chunks
+            // that have already been decoded for playback or from the
+            // audio source
+            mixxx::ReadableSampleFrames readableSampleFrames;
+            if (m_pPlaybackAudioTap &&
+                    m_pPlaybackAudioTap->consume(
+                            chunkFrameRange,
+                            m_sampleBuffer.data()) == chunkFrameRange) {
+                readableSampleFrames = mixxx::ReadableSampleFrames(
+                        chunkFrameRange,
+                        mixxx::SampleBuffer::ReadableSlice(
+                                m_sampleBuffer.data(),
+                                chunkFrameRange.length() * mixxx::kAnalysisChannels));
+            } else {
+                readableSampleFrames =
+                        audioSourceProxy.readSampleFrames(
+                                mixxx::WritableSampleFrames(
+                                        chunkFrameRange,
+                                        mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
+            }
+            // The returned range fits into the requested range
+            DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
+
+            // Sometimes the duration of the audio source is inaccurate and adjusted
+            // while reading. We need to adjust all frame ranges to reflect this new
+            // situation by restoring all invariants and consistency requirements!
+
+            // Shrink the original range of the current chunks to the actual available
+            // range.
+            chunkFrameRange = intersect(chunkFrameRange, audioSourceProxy.frameIndexRange());
+            // The audio data that has just been read should still fit into the adjusted
+            // chunk range.
+            DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
+
+            // We also need to adjust the remaining frame range for the next requests.
+            remainingFrameRange = intersect(remainingFrameRange, audioSourceProxy.frameIndexRange());
+            // Currently the range will never grow, but lets also account for this case
+            // that might become relevant in the future.
+            VERIFY_OR_DEBUG_ASSERT(!isTrailingRange || remainingFrameRange.empty() ||
+                    remainingFrameRange.end() == audioSourceProxy.frameIndexRange().end()) {
+                if (chunkFrameRange.length() < mixxx::kAnalysisFramesPerChunk) {
+                    // If we have read an incomplete chunk while the range has grown
+                    // we need to discard the read results and re-read the current
+                    // chunk!
+
+                    remainingFrameRange.growFront(chunkFrameRange.length());
+                    continue;
+                }
+                framesToProcess += audioSourceProxy.frameIndexRange().end() -
+                        remainingFrameRange.end();
+                DEBUG_ASSERT(remainingFrameRange.end() < audioSourceProxy.frameIndexRange().end());
+                kLogger.warning()
+                        << "Unexpected growth of the audio source while reading"
+                        << mixxx::IndexRange::forward(
+                                remainingFrameRange.end(), audioSourceProxy.frameIndexRange().end());
+                remainingFrameRange.growBack(
+                        audioSourceProxy.frameIndexRange().end() - remainingFrameRange.end());
             }
-            DEBUG_ASSERT(remainingFrameRange.end() < audioSourceProxy.frameIndexRange().end());
-            kLogger.warning()
-                    << "Unexpected growth of the audio source while reading"
-                    << mixxx::IndexRange::forward(
-                            remainingFrameRange.end(), audioSourceProxy.frameIndexRange().end());
-            remainingFrameRange.growBack(
-                    audioSourceProxy.frameIndexRange().end() - remainingFrameRange.end());
-        }
 
-        sleepWhileSuspended();
-        if (isStopping()) {
-            return AnalysisResult::Cancelled;
-        }
+            sleepWhileSuspended();
+            if (isStopping()) {
+                return AnalysisResult::Cancelled;
+            }
 
-        // 2nd: step: Analyze chunk of decoded audio data
-        if (!readableSampleFrames.frameIndexRange().empty()) {
-            for (auto&& analyzer : m_analyzers) {
-                analyzer.processSamples(
-                        readableSampleFrames.readableData(),
-                        readableSampleFrames.readableLength());
+            // 2nd: step: Analyze chunk of decoded audio data
+            if (!readableSampleFrames.frameIndexRange().empty()) {
+                for (auto&& analyzer : m_analyzers) {
+                    analyzer.processSamples(
+                            readableSampleFrames.readableData(),
+                            readableSampleFrames.readableLength());
+                }
             }
-        }
 
-        // Don't check again for paused/stopped again and simply finish
-        // the current iteration by emitting progress.
-
-        // 3rd step: Update & emit progress
-        if (audioSource->frameLength() > 0) {
-            const double frameProgress =
-                    double(audioSource->frameLength() - remainingFrameRange.length()) /
-                    double(audioSource->frameLength());
-            // math_min is required to compensate rounding errors
-            const AnalyzerProgress progress =
-                    math_min(kAnalyzerProgressFinalizing,
-                            frameProgress *
-                                    (kAnalyzerProgressFinalizing - kAnalyzerProgressNone));
-            DEBUG_ASSERT(progress > kAnalyzerProgressNone);
-            emitBusyProgress(progress);
-        } else {
-            // Unreadable audio source
-            DEBUG_ASSERT(remainingFrameRange.empty());
-            emitBusyProgress(kAnalyzerProgressUnknown);
+            // Don't check again for paused/stopped again and simply finish
+            // the current iteration by emitting progress.
+
+            // 3rd step: Update & emit progress
+            processedFrames += chunkFrameRange.length();
+            if (framesToProcess > 0) {
+                const double frameProgress =
+                        double(processedFrames) / double(framesToProcess);
+                // math_min is required to compensate rounding errors
+                const AnalyzerProgress progress =
+                        math_min(kAnalyzerProgressFinalizing,
+                                frameProgress *
+                                        (kAnalyzerProgressFinalizing - kAnalyzerProgressNone));
+                DEBUG_ASSERT(progress > kAnalyzerProgressNone);
+                emitBusyProgress(progress);
+            } else {
+                // Unreadable audio source
+                DEBUG_ASSERT(remainingFrameRange.empty());
+                emitBusyProgress(kAnalyzerProgressUnknown);
+            }
         }
     }
 
     return AnalysisResult::Finished;
 }
 
+QList<mixxx::IndexRange> AnalyzerThread::frameRangesToProcess(
+        mixxx::IndexRange trackFrameRange) const {
+    // Collect the frame ranges of all active analyzers in track coordinates
+    std::vector<mixxx::IndexRange> frameRanges;
+    for (const auto& analyzer : m_analyzers) {
+        if (!analyzer.isActive()) {
+            continue;
+        }
+        const auto analyzerFrameRanges = analyzer.frameRangesToProcess();
+        if (analyzerFrameRanges.isEmpty()) {
+            // This analyzer needs the whole track
+            return {trackFrameRange};
+        }
+        for (const auto& frameRange : analyzerFrameRanges) {
+            const auto trackRange = intersect2(
+                    mixxx::IndexRange::forward(
+                            trackFrameRange.start() + frameRange.start(),
+                            frameRange.length()),
+                    trackFrameRange);
+            if (trackRange && !trackRange->empty()) {
+                frameRanges.push_back(*trackRange);
+            }
+        }
+    }
+    if (frameRanges.empty()) {
+        return {trackFrameRange};
+    }
+    // Merge overlapping ranges
+    std::sort(frameRanges.begin(),
+            frameRanges.end(),
+            [](mixxx::IndexRange lhs, mixxx::IndexRange rhs) {
+                return lhs.start() < rhs.start();
+            });
+    QList<mixxx::IndexRange> mergedFrameRanges;
+    for (const auto& frameRange : frameRanges) {
+        if (!mergedFrameRanges.isEmpty() &&
+                frameRange.start() <= mergedFrameRanges.last().end()) {
+            mergedFrameRanges.last() = mixxx::IndexRange::between(
+                    mergedFrameRanges.last().start(),
+                    math_max(mergedFrameRanges.last().end(), frameRange.end()));
+        } else {
+            mergedFrameRanges.append(frameRange);
+        }
+    }
+    return mergedFrameRanges;
+}
+
 void AnalyzerThread::emitBusyProgress(AnalyzerProgress busyProgress) {
     DEBUG_ASSERT(m_currentTrack);
     if ((m_emittedState == AnalyzerThreadState::Busy) &&
@@ -15,11 +15,17 @@
 #include "util/samplebuffer.h"
 #include "util/workerthread.h"
 
+class CachingReaderTap;
+
 enum AnalyzerModeFlags {
     None = 0x00,
     WithBeats = 0x01,
     WithWaveform = 0x02,
     LowPriority = 0x04,
+    // Consume the audio that is decoded by the CachingReader while the
+    // track is playing instead of decoding it again. Each analysis job
+    // attaches its own CachingReaderTap for the current track.
+    WithPlaybackAudio = 0x08,
     All = WithBeats | WithWaveform,
 };
 
@@ -120,6 +126,9 @@ class AnalyzerThread : public WorkerThread {
 
     TrackPointer m_currentTrack;
 
+    // Only set while analyzing m_currentTrack with WithPlaybackAudio
+    std::shared_ptr<CachingReaderTap> m_pPlaybackAudioTap;
+
     AnalyzerThreadState m_emittedState;
 
     PerformanceTimer m_lastBusyProgressEmittedTimer;
@@ -132,6 +141,11 @@ class AnalyzerThread : public WorkerThread {
     AnalysisResult analyzeAudioSource(
             const mixxx::AudioSourcePointer& audioSource);
 
+    // The union of the frame ranges that are needed by the active
+    // analyzers, sorted and non-overlapping
+    QList<mixxx::IndexRange> frameRangesToProcess(
+            mixxx::IndexRange trackFrameRange) const;
+
     // Blocks the worker thread until a next track becomes available
     TrackPointer receiveNextTrack();
 
@@ -13,7 +13,13 @@ constexpr SINT kAnalysisFramesPerChunk = 4096;
 constexpr SINT kAnalysisSamplesPerChunk =
         kAnalysisFramesPerChunk * kAnalysisChannels;
 
-// Only analyze the first minute in fast-analysis mode.
+// Only analyze one minute in fast-analysis mode. The time is split into
+// evenly spaced segments to skip intros and outros that are often
+// ambient or beatless, see fastAnalysisFrameRanges().
 constexpr int kFastAnalysisSecondsToAnalyze = 60;
+constexpr int kFastAnalysisSegmentCount = 4;
+// The share of a segment that its predominant key must cover to be
+// trusted, see fastAnalysisMergeKeyChanges().
+constexpr double kFastAnalysisMinKeyConfidence = 0.5;
 
 }  // namespace mixxx
@@ -0,0 +1,126 @@
+#include "analyzer/fastanalysis.h"
+
+#include <QHash>
+#include <QVector>
+#include <algorithm>
+
+#include "analyzer/constants.h"
+
+namespace mixxx {
+
+namespace {
+
+struct KeySegment {
+    track::io::key::ChromaticKey key;
+    double confidence;
+};
+
+// The key that covers most of the given range of the concatenated
+// frame ranges and the share of the range it covers
+KeySegment predominantKey(
+        const KeyChangeList& concatenatedKeyChanges,
+        double start,
+        double end) {
+    QHash<int, double> keyLengths;
+    for (int i = 0; i < concatenatedKeyChanges.size(); ++i) {
+        const double changeStart = std::max(start, concatenatedKeyChanges.at(i).second);
+        const double changeEnd = i + 1 < concatenatedKeyChanges.size()
+                ? std::min(end, concatenatedKeyChanges.at(i + 1).second)
+                : end;
+        if (changeEnd > changeStart) {
+            keyLengths[concatenatedKeyChanges.at(i).first] += changeEnd - changeStart;
+        }
+    }
+    KeySegment segment{track::io::key::INVALID, 0.0};
+    double maxLength = 0;
+    for (auto it = keyLengths.constBegin(); it != keyLengths.constEnd(); ++it) {
+        if (it.key() != track::io::key::INVALID && it.value() > maxLength) {
+            segment.key = static_cast<track::io::key::ChromaticKey>(it.key());
+            maxLength = it.value();
+        }
+    }
+    if (end > start) {
+        segment.confidence = maxLength / (end - start);
+    }
+    return segment;
+}
+
+} // anonymous namespace
+
+QList<IndexRange> fastAnalysisFrameRanges(
+        SINT totalFrames,
+        audio::SampleRate sampleRate) {
+    DEBUG_ASSERT(totalFrames >= 0);
+    const SINT framesToAnalyze =
+            static_cast<SINT>(kFastAnalysisSecondsToAnalyze) * sampleRate.value();
+    if (totalFrames <= framesToAnalyze || !sampleRate.isValid()) {
+        return {IndexRange::forward(0, totalFrames)};
+    }
+    // The gaps before, between, and after the segments are of equal length
+    const SINT segmentFrames = framesToAnalyze / kFastAnalysisSegmentCount;
+    const SINT gapFrames = (totalFrames - segmentFrames * kFastAnalysisSegmentCount) /
+            (kFastAnalysisSegmentCount + 1);
+    QList<IndexRange> frameRanges;
+    for (int i = 0; i < kFastAnalysisSegmentCount; ++i) {
+        frameRanges.append(IndexRange::forward(
+                gapFrames * (i + 1) + segmentFrames * i,
+                segmentFrames));
+    }
+    return frameRanges;
+}
+
+KeyChangeList fastAnalysisMergeKeyChanges(
+        const QList<IndexRange>& frameRanges,
+        const KeyChangeList& concatenatedKeyChanges) {
+    QVector<KeySegment> segments;
+    segments.reserve(frameRanges.size());
+    double offset = 0;
+    for (const auto& frameRange : frameRanges) {
+        segments.append(predominantKey(
+                concatenatedKeyChanges, offset, offset + frameRange.length()));
+        offset += frameRange.length();
+    }
+
+    // Segments without a clear key are merged into the more confident
+    // adjacent segment. The decision is based on the detected keys only,
+    // so a merged segment does not propagate its new key any further.
+    QVector<track::io::key::ChromaticKey> keys;
+    keys.reserve(segments.size());
+    for (int i = 0; i < segments.size(); ++i) {
+        const KeySegment& segment = segments.at(i);
+        if (segment.confidence >= kFastAnalysisMinKeyConfidence) {
+            keys.append(segment.key);
+            continue;
+        }
+        const KeySegment* pNeighbor = nullptr;
+        if (i > 0) {
+            pNeighbor = &segments.at(i - 1);
+        }
+        if (i + 1 < segments.size() &&
+                (!pNeighbor || segments.at(i + 1).confidence > pNeighbor->confidence)) {
+            pNeighbor = &segments.at(i + 1);
+        }
+        if (pNeighbor && pNeighbor->confidence > segment.confidence) {
+            keys.append(pNeighbor->key);
+        } else {
+            keys.append(segment.key);
+        }
+    }
+
+    KeyChangeList keyChanges;
+    for (int i = 0; i < keys.size(); ++i) {
+        if (keys.at(i) == track::io::key::INVALID) {
+            continue;
+        }
+        if (!keyChanges.isEmpty() && keyChanges.last().first == keys.at(i)) {
+            continue;
+        }
+        const double position = keyChanges.isEmpty()
+                ? 0.0
+                : static_cast<double>(frameRanges.at(i).start());
+        keyChanges.append(qMakePair(keys.at(i), position));
+    }
+    return keyChanges;
+}
+
+} // namespace mixxx
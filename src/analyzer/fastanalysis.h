@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QList>
+
+#include "audio/types.h"
+#include "track/keys.h"
+#include "util/indexrange.h"
+
+namespace mixxx {
+
+/// Returns the frame ranges of a track with the given length that are
+/// processed in fast-analysis mode, sorted and non-overlapping. Frame
+/// indices are relative to the start of the track. Tracks that are not
+/// longer than kFastAnalysisSecondsToAnalyze are processed completely.
+QList<IndexRange> fastAnalysisFrameRanges(
+        SINT totalFrames,
+        audio::SampleRate sampleRate);
+
+/// Reduces the key changes detected within the concatenated frame ranges
+/// to one key per range and merges adjacent ranges. A range whose
+/// predominant key covers less than kFastAnalysisMinKeyConfidence of it
+/// takes the key of the more confident adjacent range. Each key lasts
+/// from the start of the range in which it was detected until the next
+/// change, the first one from the start of the track.
+KeyChangeList fastAnalysisMergeKeyChanges(
+        const QList<IndexRange>& frameRanges,
+        const KeyChangeList& concatenatedKeyChanges);
+
+} // namespace mixxx
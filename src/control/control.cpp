@@ -1,10 +1,288 @@
 #include "control/control.h"
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "control/controlobject.h"
+#include "control/controlupdatecoalescer.h"
 #include "moc_control.cpp"
 #include "util/stat.h"
 
 namespace {
+
+/// The registry of all ControlDoublePrivate instances and their aliases.
+///
+/// Controller scripts, skins and QML resolve thousands of keys, often from
+/// different threads at once, so lookups must never block. The registry is
+/// split into shards by the hash of the key, and each shard is a hash table
+/// with chained buckets. The key and the control of a node never change, a
+/// node is replaced or unlinked instead. Writers serialize on a mutex per
+/// shard and link a new node in front of its bucket, so an insert is O(1)
+/// amortized. Lookups only count themselves as active in their shard and
+/// walk the bucket without waiting for anything.
+///
+/// Unlinked nodes and replaced tables may still be read by lookups that
+/// started before. A writer frees them when it finds no lookup active in
+/// the shard.
+class ControlRegistry {
+  public:
+    ~ControlRegistry() {
+        for (Shard& shard : m_shards) {
+            retireTable(&shard, shard.pTable.load());
+            freeRetired(&shard);
+        }
+    }
+
+    /// Returns the control or a null pointer if the key is unknown or the
+    /// control has expired. Does not block.
+    QSharedPointer<ControlDoublePrivate> find(const ConfigKey& key) const {
+        const uint hash = qHash(key);
+        const Shard& shard = shardForHash(hash);
+        // Must be counted before any node is loaded, see reclaim()
+        shard.activeLookups.fetch_add(1);
+        QSharedPointer<ControlDoublePrivate> pControl;
+        const Node* pNode = findNode(*shard.pTable.load(), hash, key);
+        if (pNode) {
+            pControl = pNode->pControl.lock();
+        }
+        shard.activeLookups.fetch_sub(1);
+        return pControl;
+    }
+
+    /// Inserts the control unless a live control with the same key exists.
+    /// Returns the control that is registered for the key afterwards.
+    QSharedPointer<ControlDoublePrivate> insertIfAbsent(
+            const ConfigKey& key,
+            const QSharedPointer<ControlDoublePrivate>& pControl) {
+        const uint hash = qHash(key);
+        Shard& shard = shardForHash(hash);
+        const MMutexLocker locker(&shard.writeMutex);
+        const Node* pNode = findNode(*shard.pTable.load(), hash, key);
+        if (pNode) {
+            auto pExisting = pNode->pControl.lock();
+            if (pExisting) {
+                return pExisting;
+            }
+        }
+        insertNode(&shard, hash, key, pControl);
+        return pControl;
+    }
+
+    void insert(const ConfigKey& key,
+            const QSharedPointer<ControlDoublePrivate>& pControl) {
+        const uint hash = qHash(key);
+        Shard& shard = shardForHash(hash);
+        const MMutexLocker locker(&shard.writeMutex);
+        insertNode(&shard, hash, key, pControl);
+    }
+
+    /// Removes the key if its control has expired, i.e. it has not been
+    /// replaced by a new control in the meantime.
+    void removeExpired(const ConfigKey& key) {
+        const uint hash = qHash(key);
+        Shard& shard = shardForHash(hash);
+        const MMutexLocker locker(&shard.writeMutex);
+        Table* pTable = shard.pTable.load();
+        std::atomic<Node*>* pLink = &pTable->bucket(hash);
+        for (Node* pNode = pLink->load(); pNode; pNode = pLink->load()) {
+            if (pNode->key == key) {
+                if (pNode->pControl.isNull()) {
+                    unlinkNode(&shard, pLink, pNode);
+                    --pTable->size;
+                    reclaim(&shard);
+                }
+                return;
+            }
+            pLink = &pNode->pNext;
+        }
+    }
+
+    /// Returns all live controls. If clear is true the registry is emptied,
+    /// otherwise only expired entries are removed.
+    QList<QSharedPointer<ControlDoublePrivate>> collect(bool clear) {
+        QList<QSharedPointer<ControlDoublePrivate>> result;
+        for (Shard& shard : m_shards) {
+            const MMutexLocker locker(&shard.writeMutex);
+            Table* pTable = shard.pTable.load();
+            for (std::size_t i = 0; i <= pTable->mask; ++i) {
+                std::atomic<Node*>* pLink = &pTable->buckets[i];
+                for (Node* pNode = pLink->load(); pNode; pNode = pLink->load()) {
+                    auto pControl = pNode->pControl.lock();
+                    if (pControl) {
+                        result.append(std::move(pControl));
+                    } else if (!clear) {
+                        unlinkNode(&shard, pLink, pNode);
+                        --pTable->size;
+                        continue;
+                    }
+                    pLink = &pNode->pNext;
+                }
+            }
+            if (clear) {
+                shard.pTable.store(new Table(kInitialBucketCount));
+                retireTable(&shard, pTable);
+            }
+            reclaim(&shard);
+        }
+        return result;
+    }
+
+  private:
+    static constexpr std::size_t kShardCount = 32;
+    static constexpr std::size_t kInitialBucketCount = 64;
+    // The table of a shard grows when it has more keys than buckets
+    static constexpr std::size_t kMaxLoadFactor = 1;
+
+    struct Node {
+        Node(const ConfigKey& key,
+                const QWeakPointer<ControlDoublePrivate>& pControl,
+                Node* pNext)
+                : key(key),
+                  pControl(pControl),
+                  pNext(pNext) {
+        }
+
+        const ConfigKey key;
+        const QWeakPointer<ControlDoublePrivate> pControl;
+        std::atomic<Node*> pNext;
+    };
+
+    struct Table {
+        explicit Table(std::size_t bucketCount)
+                : buckets(new std::atomic<Node*>[bucketCount]()),
+                  mask(bucketCount - 1),
+                  size(0) {
+            DEBUG_ASSERT((bucketCount & mask) == 0);
+        }
+
+        std::atomic<Node*>& bucket(uint hash) const {
+            // The lower bits select the shard
+            return buckets[(hash / kShardCount) & mask];
+        }
+
+        const std::unique_ptr<std::atomic<Node*>[]> buckets;
+        const std::size_t mask;
+        // Only accessed while holding the writeMutex of the shard
+        std::size_t size;
+    };
+
+    // Lookups in different shards do not share a cache line
+    struct alignas(64) Shard {
+        Shard()
+                : pTable(new Table(kInitialBucketCount)),
+                  activeLookups(0) {
+        }
+
+        MMutex writeMutex;
+        std::atomic<Table*> pTable;
+        mutable std::atomic<int> activeLookups;
+        // Unlinked, but maybe still read by active lookups. Only accessed
+        // while holding writeMutex.
+        std::vector<Node*> retiredNodes;
+        std::vector<Table*> retiredTables;
+    };
+
+    static const Node* findNode(const Table& table, uint hash, const ConfigKey& key) {
+        for (const Node* pNode = table.bucket(hash).load(); pNode;
+                pNode = pNode->pNext.load()) {
+            if (pNode->key == key) {
+                return pNode;
+            }
+        }
+        return nullptr;
+    }
+
+    static void insertNode(Shard* pShard,
+            uint hash,
+            const ConfigKey& key,
+            const QWeakPointer<ControlDoublePrivate>& pControl) {
+        Table* pTable = pShard->pTable.load();
+        if (pTable->size >= (pTable->mask + 1) * kMaxLoadFactor) {
+            pTable = grow(pShard);
+        }
+        // Lookups find the new node first, so the previous node of the key
+        // can be unlinked afterwards.
+        std::atomic<Node*>& head = pTable->bucket(hash);
+        Node* pNewNode = new Node(key, pControl, head.load());
+        head.store(pNewNode);
+        std::atomic<Node*>* pLink = &pNewNode->pNext;
+        for (Node* pNode = pLink->load(); pNode; pNode = pLink->load()) {
+            if (pNode->key == key) {
+                unlinkNode(pShard, pLink, pNode);
+                reclaim(pShard);
+                return;
+            }
+            pLink = &pNode->pNext;
+        }
+        ++pTable->size;
+    }
+
+    /// Replaces the table of the shard with one with twice as many buckets.
+    /// The nodes are copied, because lookups may still walk the old ones.
+    static Table* grow(Shard* pShard) {
+        Table* pOldTable = pShard->pTable.load();
+        auto* pNewTable = new Table((pOldTable->mask + 1) * 2);
+        for (std::size_t i = 0; i <= pOldTable->mask; ++i) {
+            for (const Node* pNode = pOldTable->buckets[i].load(); pNode;
+                    pNode = pNode->pNext.load()) {
+                std::atomic<Node*>& head = pNewTable->bucket(qHash(pNode->key));
+                head.store(new Node(pNode->key, pNode->pControl, head.load()));
+                ++pNewTable->size;
+            }
+        }
+        pShard->pTable.store(pNewTable);
+        retireTable(pShard, pOldTable);
+        reclaim(pShard);
+        return pNewTable;
+    }
+
+    static void unlinkNode(Shard* pShard, std::atomic<Node*>* pLink, Node* pNode) {
+        pLink->store(pNode->pNext.load());
+        pShard->retiredNodes.push_back(pNode);
+    }
+
+    static void retireTable(Shard* pShard, Table* pTable) {
+        for (std::size_t i = 0; i <= pTable->mask; ++i) {
+            for (Node* pNode = pTable->buckets[i].load(); pNode;
+                    pNode = pNode->pNext.load()) {
+                pShard->retiredNodes.push_back(pNode);
+            }
+        }
+        pShard->retiredTables.push_back(pTable);
+    }
+
+    /// Frees the retired nodes and tables if no lookup is active. All atomic
+    /// operations are sequentially consistent: If no lookup is counted after
+    /// a node has been unlinked, a lookup that starts later can't reach it.
+    static void reclaim(Shard* pShard) {
+        if (pShard->activeLookups.load() == 0) {
+            freeRetired(pShard);
+        }
+    }
+
+    static void freeRetired(Shard* pShard) {
+        for (Node* pNode : pShard->retiredNodes) {
+            delete pNode;
+        }
+        pShard->retiredNodes.clear();
+        for (Table* pTable : pShard->retiredTables) {
+            delete pTable;
+        }
+        pShard->retiredTables.clear();
+    }
+
+    Shard& shardForHash(uint hash) {
+        return m_shards[hash % kShardCount];
+    }
+    const Shard& shardForHash(uint hash) const {
+        return m_shards[hash % kShardCount];
+    }
+
+    std::array<Shard, kShardCount> m_shards;
+};
+
 /// Hack to implement persistent controls. This is a pointer to the current
 /// user configuration object (if one exists). In general, we do not want the
 /// user configuration to be a singleton -- objects that need access to it
@@ -13,17 +291,16 @@ namespace {
 /// configuration object would be arduous.
 UserSettingsPointer s_pUserConfig;
 
-/// Mutex guarding access to s_qCOHash and s_qCOAliasHash.
-MMutex s_qCOHashMutex;
+/// All ControlDoublePrivate instantiations, including aliases.
+ControlRegistry s_registry;
 
-/// Hash of ControlDoublePrivate instantiations.
-QHash<ConfigKey, QWeakPointer<ControlDoublePrivate>> s_qCOHash
-        GUARDED_BY(s_qCOHashMutex);
+/// Mutex guarding access to s_qCOAliasHash and the creation of s_pDefaultCO.
+MMutex s_qCOAliasHashMutex;
 
 /// Hash of aliases between ConfigKeys. Solely used for looking up the first
 /// alias associated with a key.
 QHash<ConfigKey, ConfigKey> s_qCOAliasHash
-        GUARDED_BY(s_qCOHashMutex);
+        GUARDED_BY(s_qCOAliasHashMutex);
 
 /// is used instead of a nullptr, helps to omit null checks everywhere
 QWeakPointer<ControlDoublePrivate> s_pDefaultCO;
@@ -37,7 +314,8 @@ ControlDoublePrivate::ControlDoublePrivate()
           m_trackFlags(Stat::COUNT | Stat::SUM | Stat::AVERAGE |
                   Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX),
           // default CO is read only
-          m_confirmRequired(true) {
+          m_confirmRequired(true),
+          m_coalescerSlot(-1) {
 }
 
 ControlDoublePrivate::ControlDoublePrivate(
@@ -55,7 +333,8 @@ ControlDoublePrivate::ControlDoublePrivate(
           m_trackType(Stat::UNSPECIFIED),
           m_trackFlags(Stat::COUNT | Stat::SUM | Stat::AVERAGE |
                   Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX),
-          m_confirmRequired(false) {
+          m_confirmRequired(false),
+          m_coalescerSlot(-1) {
     initialize(defaultValue);
 }
 
@@ -84,10 +363,8 @@ void ControlDoublePrivate::initialize(double defaultValue) {
 }
 
 ControlDoublePrivate::~ControlDoublePrivate() {
-    s_qCOHashMutex.lock();
-    //qDebug() << "ControlDoublePrivate::s_qCOHash.remove(" << m_key.group << "," << m_key.item << ")";
-    s_qCOHash.remove(m_key);
-    s_qCOHashMutex.unlock();
+    //qDebug() << "ControlDoublePrivate::s_registry.removeExpired(" << m_key.group << "," << m_key.item << ")";
+    s_registry.removeExpired(m_key);
 
     if (m_bPersistInConfiguration) {
         UserSettingsPointer pConfig = s_pUserConfig;
@@ -106,22 +383,16 @@ void ControlDoublePrivate::setUserConfig(const UserSettingsPointer& pConfig) {
 
 // static
 void ControlDoublePrivate::insertAlias(const ConfigKey& alias, const ConfigKey& key) {
-    MMutexLocker locker(&s_qCOHashMutex);
-
-    auto it = s_qCOHash.constFind(key);
-    VERIFY_OR_DEBUG_ASSERT(it != s_qCOHash.constEnd()) {
-        qWarning() << "cannot create alias for null control" << key;
-        return;
-    }
+    MMutexLocker locker(&s_qCOAliasHashMutex);
 
-    QSharedPointer<ControlDoublePrivate> pControl = it.value();
+    QSharedPointer<ControlDoublePrivate> pControl = s_registry.find(key);
     VERIFY_OR_DEBUG_ASSERT(!pControl.isNull()) {
-        qWarning() << "cannot create alias for expired control" << key;
+        qWarning() << "cannot create alias for null or expired control" << key;
         return;
     }
 
     s_qCOAliasHash.insert(key, alias);
-    s_qCOHash.insert(alias, pControl);
+    s_registry.insert(alias, pControl);
 }
 
 // static
@@ -142,41 +413,34 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
         return nullptr;
     }
 
-    // Scope for MMutexLocker.
-    {
-        const MMutexLocker locker(&s_qCOHashMutex);
-        const auto it = s_qCOHash.find(key);
-        if (it != s_qCOHash.end()) {
-            auto pControl = it.value().lock();
-            if (pControl) {
-                // Control object already exists
-                if (pCreatorCO) {
-                    qWarning()
-                            << "ControlObject"
-                            << key.group << key.item
-                            << "already created";
-                    DEBUG_ASSERT(!"pCreatorCO != nullptr, ControlObject already created");
-                    return nullptr;
-                }
-                return pControl;
-            } else {
-                // The weak pointer has become invalid and can be cleaned up
-                s_qCOHash.erase(it);
-            }
-        }
-    }
-
-    if (pCreatorCO) {
-        auto pControl = QSharedPointer<ControlDoublePrivate>(
+    auto pControl = s_registry.find(key);
+    if (!pControl && pCreatorCO) {
+        pControl = QSharedPointer<ControlDoublePrivate>(
                 new ControlDoublePrivate(key,
                         pCreatorCO,
                         bIgnoreNops,
                         bTrack,
                         bPersist,
                         defaultValue));
-        const MMutexLocker locker(&s_qCOHashMutex);
-        //qDebug() << "ControlDoublePrivate::s_qCOHash.insert(" << key.group << "," << key.item << ")";
-        s_qCOHash.insert(key, pControl);
+        //qDebug() << "ControlDoublePrivate::s_registry.insertIfAbsent(" << key.group << "," << key.item << ")";
+        const auto pRegisteredControl = s_registry.insertIfAbsent(key, pControl);
+        if (pRegisteredControl == pControl) {
+            return pControl;
+        }
+        // Created concurrently by another thread
+        pControl->resetCreatorCO(pCreatorCO);
+        pControl = pRegisteredControl;
+    }
+    if (pControl) {
+        // Control object already exists
+        if (pCreatorCO) {
+            qWarning()
+                    << "ControlObject"
+                    << key.group << key.item
+                    << "already created";
+            DEBUG_ASSERT(!"pCreatorCO != nullptr, ControlObject already created");
+            return nullptr;
+        }
         return pControl;
     }
 
@@ -195,7 +459,7 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getDefaultControl() {
         // Try again with the mutex locked to protect against creating two
         // ControlDoublePrivateConst objects. Access to s_defaultCO itself is
         // thread save.
-        MMutexLocker locker(&s_qCOHashMutex);
+        MMutexLocker locker(&s_qCOAliasHashMutex);
         defaultCO = s_pDefaultCO.lock();
         if (!defaultCO) {
             defaultCO = QSharedPointer<ControlDoublePrivate>(new ControlDoublePrivateConst());
@@ -207,38 +471,18 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getDefaultControl() {
 
 // static
 QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::getAllInstances() {
-    QList<QSharedPointer<ControlDoublePrivate>> result;
-    MMutexLocker locker(&s_qCOHashMutex);
-    result.reserve(s_qCOHash.size());
-    for (auto it = s_qCOHash.begin(); it != s_qCOHash.end(); ++it) {
-        auto pControl = it.value().lock();
-        if (pControl) {
-            result.append(std::move(pControl));
-        } else {
-            // The weak pointer has become invalid and can be cleaned up
-            s_qCOHash.erase(it);
-        }
-    }
-    return result;
+    // Invalid weak pointers are cleaned up
+    return s_registry.collect(false);
 }
 
 // static
 QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::takeAllInstances() {
-    QList<QSharedPointer<ControlDoublePrivate>> result;
-    MMutexLocker locker(&s_qCOHashMutex);
-    result.reserve(s_qCOHash.size());
-    for (auto it = s_qCOHash.begin(); it != s_qCOHash.end(); ++it) {
-        auto pControl = it.value().lock();
-        if (pControl) {
-            result.append(std::move(pControl));
-        }
-    }
-    s_qCOHash.clear();
-    return result;
+    return s_registry.collect(true);
 }
 
 //static
 QHash<ConfigKey, ConfigKey> ControlDoublePrivate::getControlAliases() {
+    MMutexLocker locker(&s_qCOAliasHashMutex);
     // Implicitly shared classes can safely be copied across threads
     return s_qCOAliasHash;
 }
@@ -277,6 +521,10 @@ void ControlDoublePrivate::setInner(double value, QObject* pSender) {
         return;
     }
     m_value.setValue(value);
+    const int coalescerSlot = m_coalescerSlot.loadAcquire();
+    if (coalescerSlot >= 0) {
+        ControlUpdateCoalescer::valueChanged(coalescerSlot, value, pSender);
+    }
     emit valueChanged(value, pSender);
 
     if (m_bTrack) {
@@ -12,6 +12,7 @@
 #include "util/mutex.h"
 
 class ControlObject;
+class ControlUpdateCoalescer;
 
 enum class ControlFlag {
     None = 0,
@@ -204,6 +205,12 @@ class ControlDoublePrivate : public QObject {
     ControlValueAtomic<double> m_defaultValue;
 
     QSharedPointer<ControlNumericBehavior> m_pBehavior;
+
+    // The slot in ControlUpdateCoalescer or -1 if no ControlProxy has
+    // subscribed to coalesced updates
+    QAtomicInt m_coalescerSlot;
+
+    friend ControlUpdateCoalescer;
 };
 
 /// The constant ControlDoublePrivate version is used as dummy for default
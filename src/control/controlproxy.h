@@ -5,6 +5,7 @@
 #include <QString>
 
 #include "control/control.h"
+#include "control/controlupdatecoalescer.h"
 #include "preferences/usersettings.h"
 #include "util/platform.h"
 
@@ -100,6 +101,30 @@ class ControlProxy : public QObject {
         return true;
     }
 
+    /// Connects like connectValueChanged() with an auto connection, but
+    /// changes from other threads are delivered at most once per GUI tick
+    /// with the latest value, see ControlUpdateCoalescer. Must be called from
+    /// the GUI thread and not be combined with connectValueChanged().
+    template<typename Receiver, typename Slot>
+    bool connectValueChangedCoalesced(Receiver receiver, Slot func) {
+        if (!valid()) {
+            return false;
+        }
+        if (!m_pCoalescedUpdates) {
+            m_pCoalescedUpdates = ControlUpdateCoalescer::subscribe(m_pControl.data());
+            if (!m_pCoalescedUpdates) {
+                // No slot left, fall back to queued events
+                return connectValueChanged(receiver, func);
+            }
+            connect(m_pCoalescedUpdates,
+                    &ControlCoalescedUpdates::valueChanged,
+                    this,
+                    &ControlProxy::slotValueChangedDirect,
+                    Qt::DirectConnection);
+        }
+        return connect(this, &ControlProxy::valueChanged, receiver, func, Qt::AutoConnection);
+    }
+
     /// Called from update();
     virtual void emitValueChanged() {
         emit valueChanged(get());
@@ -186,4 +211,7 @@ class ControlProxy : public QObject {
   protected:
     /// Pointer to connected control.
     QSharedPointer<ControlDoublePrivate> m_pControl;
+
+  private:
+    ControlCoalescedUpdates* m_pCoalescedUpdates;
 };
@@ -0,0 +1,150 @@
+#include "control/controlupdatecoalescer.h"
+
+#include <QThread>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "control/control.h"
+#include "moc_controlupdatecoalescer.cpp"
+#include "util/assert.h"
+#include "util/counter.h"
+
+namespace {
+
+constexpr int kBitsPerWord = 64;
+
+/// One bit per slot, set from any thread when the control changes
+std::array<std::atomic<quint64>, ControlUpdateCoalescer::kMaxControls / kBitsPerWord>
+        s_dirtySlots;
+
+std::atomic<quint64> s_dispatchedCount{0};
+std::atomic<quint64> s_coalescedCount{0};
+
+/// The thread of the first subscriber, changes from it are not coalesced
+std::atomic<QThread*> s_pGuiThread{nullptr};
+
+struct Slot {
+    ControlDoublePrivate* pControl = nullptr;
+    std::unique_ptr<ControlCoalescedUpdates> pUpdates;
+    int subscriberCount = 0;
+};
+
+// Only accessed from the GUI thread
+std::vector<Slot> s_slots;
+std::vector<int> s_freeSlots;
+quint64 s_publishedCoalescedCount = 0;
+
+void emitValueChanged(int slot, double value, QObject* pSender) {
+    if (slot >= static_cast<int>(s_slots.size()) || !s_slots[slot].pUpdates) {
+        // Unsubscribed after the change
+        return;
+    }
+    emit s_slots[slot].pUpdates->valueChanged(value, pSender);
+}
+
+} // anonymous namespace
+
+// static
+ControlCoalescedUpdates* ControlUpdateCoalescer::subscribe(ControlDoublePrivate* pControl) {
+    QThread* pGuiThread = nullptr;
+    s_pGuiThread.compare_exchange_strong(pGuiThread, QThread::currentThread());
+    DEBUG_ASSERT(s_pGuiThread.load() == QThread::currentThread());
+
+    int slot = pControl->m_coalescerSlot.loadAcquire();
+    if (slot < 0) {
+        if (!s_freeSlots.empty()) {
+            slot = s_freeSlots.back();
+            s_freeSlots.pop_back();
+        } else if (s_slots.size() < static_cast<std::size_t>(kMaxControls)) {
+            slot = static_cast<int>(s_slots.size());
+            s_slots.emplace_back();
+        } else {
+            return nullptr;
+        }
+        s_slots[slot].pControl = pControl;
+        s_slots[slot].pUpdates = std::make_unique<ControlCoalescedUpdates>();
+        pControl->m_coalescerSlot.storeRelease(slot);
+    }
+    DEBUG_ASSERT(s_slots[slot].pControl == pControl);
+    ++s_slots[slot].subscriberCount;
+    return s_slots[slot].pUpdates.get();
+}
+
+// static
+void ControlUpdateCoalescer::unsubscribe(ControlDoublePrivate* pControl) {
+    DEBUG_ASSERT(s_pGuiThread.load() == QThread::currentThread());
+    const int slot = pControl->m_coalescerSlot.loadAcquire();
+    VERIFY_OR_DEBUG_ASSERT(slot >= 0 && s_slots[slot].pControl == pControl) {
+        return;
+    }
+    if (--s_slots[slot].subscriberCount > 0) {
+        return;
+    }
+    pControl->m_coalescerSlot.storeRelease(-1);
+    // The subscriber might be unsubscribing while the signal is emitted
+    s_slots[slot].pUpdates.release()->deleteLater();
+    s_slots[slot] = Slot();
+    // A pending bit is ignored or causes a redundant update of the next
+    // control that gets this slot.
+    s_freeSlots.push_back(slot);
+}
+
+// static
+void ControlUpdateCoalescer::valueChanged(int slot, double value, QObject* pSender) {
+    if (QThread::currentThread() == s_pGuiThread.load(std::memory_order_relaxed)) {
+        // Like a direct connection
+        emitValueChanged(slot, value, pSender);
+        return;
+    }
+    const quint64 bit = quint64(1) << (slot % kBitsPerWord);
+    const quint64 dirtyBits = s_dirtySlots[slot / kBitsPerWord].fetch_or(
+            bit, std::memory_order_release);
+    if (dirtyBits & bit) {
+        s_coalescedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// static
+void ControlUpdateCoalescer::process() {
+    DEBUG_ASSERT(!s_pGuiThread.load() || s_pGuiThread.load() == QThread::currentThread());
+    // Slots beyond the used ones are never marked
+    const int wordCount = static_cast<int>(
+            (s_slots.size() + kBitsPerWord - 1) / kBitsPerWord);
+    int dispatched = 0;
+    for (int word = 0; word < wordCount; ++word) {
+        quint64 dirtyBits = s_dirtySlots[word].exchange(0, std::memory_order_acquire);
+        while (dirtyBits) {
+            const int bitIndex = qCountTrailingZeroBits(dirtyBits);
+            dirtyBits &= dirtyBits - 1;
+            const int slot = word * kBitsPerWord + bitIndex;
+            if (!s_slots[slot].pControl) {
+                continue;
+            }
+            // Read the latest value, intermediate values are skipped.
+            // The setter is unknown, so no subscriber filters it.
+            emitValueChanged(slot, s_slots[slot].pControl->get(), nullptr);
+            ++dispatched;
+        }
+    }
+    if (dispatched > 0) {
+        s_dispatchedCount.fetch_add(dispatched, std::memory_order_relaxed);
+        Counter("ControlUpdateCoalescer dispatched").increment(dispatched);
+    }
+    const quint64 coalescedCount = s_coalescedCount.load(std::memory_order_relaxed);
+    if (coalescedCount > s_publishedCoalescedCount) {
+        Counter("ControlUpdateCoalescer coalesced")
+                .increment(static_cast<int>(coalescedCount - s_publishedCoalescedCount));
+    }
+    s_publishedCoalescedCount = coalescedCount;
+}
+
+// static
+ControlUpdateCoalescer::Counters ControlUpdateCoalescer::takeCounters() {
+    Counters counters;
+    counters.dispatched = s_dispatchedCount.exchange(0, std::memory_order_relaxed);
+    counters.coalesced = s_coalescedCount.exchange(0, std::memory_order_relaxed);
+    s_publishedCoalescedCount = 0;
+    return counters;
+}
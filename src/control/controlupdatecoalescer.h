@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QObject>
+#include <QtGlobal>
+
+class ControlDoublePrivate;
+
+/// Emits the coalesced value changes of a single control in the GUI thread.
+class ControlCoalescedUpdates : public QObject {
+    Q_OBJECT
+  signals:
+    void valueChanged(double value, QObject* pSender);
+};
+
+/// Delivers value changes of controls to the GUI thread at most once per GUI
+/// tick.
+///
+/// A queued connection posts one event per value change, which floods the
+/// event queue of the GUI thread with controls that the engine updates on
+/// every callback like playposition or the VU meters. Instead, a change from
+/// another thread only marks the control in a lock-free bitset. process(),
+/// called by GuiTick, then emits the latest value of every marked control
+/// once. Changes made in the GUI thread are still emitted immediately.
+class ControlUpdateCoalescer {
+  public:
+    struct Counters {
+        /// Values emitted by process()
+        quint64 dispatched = 0;
+        /// Changes that were superseded by a later change before the tick
+        quint64 coalesced = 0;
+    };
+
+    /// The maximum number of controls with coalesced updates. More controls
+    /// fall back to queued connections.
+    static constexpr int kMaxControls = 4096;
+
+    /// Returns the object that emits the coalesced changes of the control
+    /// or nullptr if no slot is left. Must be called from the GUI thread.
+    static ControlCoalescedUpdates* subscribe(ControlDoublePrivate* pControl);
+    /// Must be called from the GUI thread once per successful subscribe().
+    static void unsubscribe(ControlDoublePrivate* pControl);
+
+    /// Called by ControlDoublePrivate from any thread. Lock-free.
+    static void valueChanged(int slot, double value, QObject* pSender);
+
+    /// Emits the latest values of all controls that changed since the last
+    /// call. Must be called from the GUI thread.
+    static void process();
+
+    /// Returns the counters accumulated since the last call.
+    static Counters takeCounters();
+};
@@ -1,12 +1,51 @@
 #include "dialog/dlgdevelopertools.h"
 
 #include <QDateTime>
+#include <algorithm>
 
 #include "control/control.h"
 #include "moc_dlgdevelopertools.cpp"
 #include "util/cmdlineargs.h"
 #include "util/logging.h"
 #include "util/statsmanager.h"
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+#include "waveform/waveformwidgetfactory.h"
+
+namespace {
+
+enum FrameTimesColumn {
+    FRAME_TIMES_COLUMN_NAME = 0,
+    FRAME_TIMES_COLUMN_P50,
+    FRAME_TIMES_COLUMN_P95,
+    FRAME_TIMES_COLUMN_P99,
+    FRAME_TIMES_COLUMN_MAX,
+    NUM_FRAME_TIMES_COLUMNS
+};
+
+void setFrameTimesRow(QTableWidget* pTable,
+        int row,
+        const QString& name,
+        const FrameTimeRecorder::Percentiles& percentiles) {
+    const auto setItem = [pTable, row](int column, const QString& text) {
+        QTableWidgetItem* pItem = pTable->item(row, column);
+        if (!pItem) {
+            pItem = new QTableWidgetItem();
+            pTable->setItem(row, column, pItem);
+        }
+        pItem->setText(text);
+    };
+    const auto formatMillis = [](mixxx::Duration duration) {
+        return QString::number(duration.toDoubleMillis(), 'f', 2);
+    };
+    setItem(FRAME_TIMES_COLUMN_NAME, name);
+    setItem(FRAME_TIMES_COLUMN_P50, formatMillis(percentiles.p50));
+    setItem(FRAME_TIMES_COLUMN_P95, formatMillis(percentiles.p95));
+    setItem(FRAME_TIMES_COLUMN_P99, formatMillis(percentiles.p99));
+    setItem(FRAME_TIMES_COLUMN_MAX, formatMillis(percentiles.max));
+}
+
+} // anonymous namespace
+#endif
 
 DlgDeveloperTools::DlgDeveloperTools(QWidget* pParent,
                                      UserSettingsPointer pConfig)
@@ -82,6 +121,28 @@ DlgDeveloperTools::DlgDeveloperTools(QWidget* pParent,
 
     m_logCursor = logTextView->textCursor();
 
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    frameTimesTable->setColumnCount(NUM_FRAME_TIMES_COLUMNS);
+    frameTimesTable->setHorizontalHeaderLabels(QStringList{
+            tr("Name"),
+            tr("50% [ms]"),
+            tr("95% [ms]"),
+            tr("99% [ms]"),
+            tr("Max [ms]"),
+    });
+    connect(frameTimesReset,
+            &QPushButton::clicked,
+            this,
+            &DlgDeveloperTools::slotFrameTimesReset);
+    connect(frameTimesExport,
+            &QPushButton::clicked,
+            this,
+            &DlgDeveloperTools::slotFrameTimesExport);
+#else
+    // The frame times are recorded by the legacy waveform widgets
+    toolTabWidget->removeTab(toolTabWidget->indexOf(frameTimesTab));
+#endif
+
     // Update at 2FPS.
     startTimer(500);
 
@@ -124,7 +185,85 @@ void DlgDeveloperTools::timerEvent(QTimerEvent* pEvent) {
         if (pManager) {
             pManager->updateStats();
         }
+    } else if (toolTabWidget->currentWidget() == frameTimesTab) {
+        updateFrameTimes();
+    }
+}
+
+void DlgDeveloperTools::updateFrameTimes() {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    const WaveformWidgetFactory* pFactory = WaveformWidgetFactory::instance();
+    if (!pFactory) {
+        return;
+    }
+    const FrameTimeRecorder& recorder = pFactory->frameTimeRecorder();
+    const QStringList widgetNames = pFactory->frameTimeWidgetNames();
+    const int widgetCount = std::min(static_cast<int>(widgetNames.size()),
+            FrameTimeRecorder::kMaxWidgets);
+
+    frameTimesSummary->setText(
+            tr("%1 frames, %2 dropped frames, GUI thread busy %3% of the time")
+                    .arg(QString::number(recorder.frameCount()),
+                            QString::number(recorder.droppedFrames()),
+                            QString::number(recorder.guiThreadBusyRatio() * 100, 'f', 1)));
+
+    // Widgets that are rendered offscreen have a second row for the
+    // render thread
+    frameTimesTable->setRowCount(2 * widgetCount + 2);
+    int row = 0;
+    setFrameTimesRow(frameTimesTable, row++, tr("Render"), recorder.renderPercentiles());
+    for (int i = 0; i < widgetCount; ++i) {
+        setFrameTimesRow(frameTimesTable,
+                row++,
+                widgetNames[i],
+                recorder.widgetRenderPercentiles(i));
+        const FrameTimeRecorder::Percentiles offscreen =
+                recorder.offscreenRenderPercentiles(i);
+        if (offscreen.max != mixxx::Duration()) {
+            setFrameTimesRow(frameTimesTable,
+                    row++,
+                    tr("%1 (render thread)").arg(widgetNames[i]),
+                    offscreen);
+        }
+    }
+    setFrameTimesRow(frameTimesTable,
+            row++,
+            tr("Render to swap"),
+            recorder.renderToSwapPercentiles());
+    frameTimesTable->setRowCount(row);
+#endif
+}
+
+void DlgDeveloperTools::slotFrameTimesReset() {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    WaveformWidgetFactory* pFactory = WaveformWidgetFactory::instance();
+    if (!pFactory) {
+        return;
+    }
+    pFactory->clearFrameTimes();
+    updateFrameTimes();
+#endif
+}
+
+void DlgDeveloperTools::slotFrameTimesExport() {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    const WaveformWidgetFactory* pFactory = WaveformWidgetFactory::instance();
+    if (!pFactory) {
+        return;
+    }
+    QString timestamp = QDateTime::currentDateTime()
+            .toString("yyyy-MM-dd_hh'h'mm'm'ss's'");
+    QString traceFileName = m_pConfig->getSettingsPath() +
+            "/frame_times_" + timestamp + ".json";
+    QFile traceFile(traceFileName);
+    if (!traceFile.open(QIODevice::WriteOnly)) {
+        qWarning() << "open" << traceFileName << "failed";
+        return;
     }
+    traceFile.write(pFactory->frameTimeRecorder().toChromeTrace(
+            pFactory->frameTimeWidgetNames()));
+    qInfo() << "Frame times exported to" << traceFileName;
+#endif
 }
 
 void DlgDeveloperTools::slotControlSearch(const QString& search) {
@@ -23,8 +23,12 @@ class DlgDeveloperTools : public QDialog, public Ui::DlgDeveloperTools {
     void slotControlSearch(const QString& search);
     void slotLogSearch();
     void slotControlDump();
+    void slotFrameTimesReset();
+    void slotFrameTimesExport();
 
   private:
+    void updateFrameTimes();
+
     UserSettingsPointer m_pConfig;
     ControlModel m_controlModel;
     QSortFilterProxyModel m_controlProxyModel;
@@ -197,3 +197,8 @@ double AutoPanEffect::computeLawCoefficient(double position) {
     // center => 1 + 1 / sqrt(abs(0) + 1) = 2
     return 1 + 1 / sqrt(std::abs(position) + 1);
 }
+
+SINT AutoPanEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    // The pan delay line and the smoothing of the position
+    return filterTailFrames(engineParameters);
+}
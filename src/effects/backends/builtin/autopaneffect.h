@@ -96,6 +96,8 @@ class AutoPanEffect : public EffectProcessorImpl<AutoPanGroupState> {
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) override;
 
+    SINT tailFrames(const mixxx::EngineParameters& engineParameters) const override;
+
     double computeLawCoefficient(double position);
 
   private:
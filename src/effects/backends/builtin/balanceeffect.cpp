@@ -193,3 +193,7 @@ void BalanceEffect::processChannel(
     pGroupState->m_oldMidSide = midSide;
     pGroupState->m_freq = freq;
 }
+
+SINT BalanceEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    return filterTailFrames(engineParameters);
+}
@@ -45,6 +45,8 @@ class BalanceEffect : public EffectProcessorImpl<BalanceGroupState> {
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) override;
 
+    SINT tailFrames(const mixxx::EngineParameters& engineParameters) const override;
+
   private:
     QString debugString() const {
         return getId();
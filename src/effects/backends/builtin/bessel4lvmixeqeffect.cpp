@@ -90,3 +90,7 @@ void Bessel4LVMixEQEffect::processChannel(
                 m_pHiFreqCorner->get());
     }
 }
+
+SINT Bessel4LVMixEQEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    return filterTailFrames(engineParameters);
+}
@@ -38,6 +38,8 @@ class Bessel4LVMixEQEffect : public EffectProcessorImpl<Bessel4LVMixEQEffectGrou
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatureState) override;
 
+    SINT tailFrames(const mixxx::EngineParameters& engineParameters) const override;
+
   private:
     QString debugString() const {
         return getId();
@@ -90,3 +90,7 @@ void Bessel8LVMixEQEffect::processChannel(
                 m_pHiFreqCorner->get());
     }
 }
+
+SINT Bessel8LVMixEQEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    return filterTailFrames(engineParameters);
+}
@@ -40,6 +40,8 @@ class Bessel8LVMixEQEffect : public EffectProcessorImpl<Bessel8LVMixEQEffectGrou
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatureState) override;
 
+    SINT tailFrames(const mixxx::EngineParameters& engineParameters) const override;
+
   private:
     QString debugString() const {
         return getId();
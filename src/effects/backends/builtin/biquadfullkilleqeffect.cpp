@@ -411,3 +411,7 @@ void BiquadFullKillEQEffect::processChannel(
                 m_pHiFreqCorner->get());
     }
 }
+
+SINT BiquadFullKillEQEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    return filterTailFrames(engineParameters);
+}
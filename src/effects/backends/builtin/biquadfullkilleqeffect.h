@@ -74,6 +74,8 @@ class BiquadFullKillEQEffect : public EffectProcessorImpl<BiquadFullKillEQEffect
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatureState) override;
 
+    SINT tailFrames(const mixxx::EngineParameters& engineParameters) const override;
+
     void setFilters(mixxx::audio::SampleRate sampleRate,
             double lowFreqCorner,
             double highFreqCorner);
@@ -112,3 +112,9 @@ void BitCrusherEffect::processChannel(
         pOutput[i + 1] = pState->hold_r;
     }
 }
+
+SINT BitCrusherEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    // The held sample is replaced after a few frames
+    Q_UNUSED(engineParameters);
+    return 0;
+}
@@ -40,6 +40,8 @@ class BitCrusherEffect : public EffectProcessorImpl<BitCrusherGroupState> {
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatureState) override;
 
+    SINT tailFrames(const mixxx::EngineParameters& engineParameters) const override;
+
   private:
     QString debugString() const {
         return getId();
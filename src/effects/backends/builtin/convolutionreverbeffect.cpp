@@ -0,0 +1,179 @@
+#include "effects/backends/builtin/convolutionreverbeffect.h"
+
+#include <QMutex>
+#include <QtDebug>
+#include <cmath>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "util/math.h"
+
+namespace {
+
+// The time until the reverberation has decayed by 60 dB
+constexpr double kReverbSeconds = 2.0;
+// The impulse response is cut off below -75 dB
+constexpr double kImpulseSeconds = 2.5;
+constexpr double kFadeInSeconds = 0.005;
+// The high frequencies decay faster, like in a real hall
+constexpr double kStartLowPassHz = 8000;
+constexpr double kEndLowPassHz = 1500;
+// The energy of the impulse response of each channel. The reverberation of
+// a sustained signal is 6 dB quieter than the signal.
+constexpr double kImpulseEnergy = 0.25;
+
+SINT impulseFrames(mixxx::audio::SampleRate sampleRate) {
+    return static_cast<SINT>(kImpulseSeconds * sampleRate);
+}
+
+std::vector<CSAMPLE> generateImpulse(mixxx::audio::SampleRate sampleRate) {
+    const SINT frames = impulseFrames(sampleRate);
+    std::vector<CSAMPLE> impulse(frames * ConvolutionFilter::kChannelCount);
+    const double decay = std::pow(10.0, -3.0 / (kReverbSeconds * sampleRate));
+    const double lowPassDecay = std::pow(kEndLowPassHz / kStartLowPassHz, 1.0 / frames);
+    const double fadeInFrames = kFadeInSeconds * sampleRate;
+
+    // Uncorrelated noise for each channel makes the reverberation wide. The
+    // generator is seeded to generate the same impulse response every time.
+    std::minstd_rand generator(1);
+    std::uniform_real_distribution<double> noise(-1.0, 1.0);
+    double lowPassed[ConvolutionFilter::kChannelCount] = {};
+    double energy[ConvolutionFilter::kChannelCount] = {};
+    double gain = 1.0;
+    double lowPassHz = kStartLowPassHz;
+    for (SINT frame = 0; frame < frames; ++frame) {
+        const double lowPass = 1.0 - std::exp(-2 * M_PI * lowPassHz / sampleRate);
+        const double fadeIn = math_min(1.0, (frame + 1) / fadeInFrames);
+        for (int channel = 0; channel < ConvolutionFilter::kChannelCount; ++channel) {
+            lowPassed[channel] += (noise(generator) - lowPassed[channel]) * lowPass;
+            const double sample = lowPassed[channel] * gain * fadeIn;
+            impulse[frame * ConvolutionFilter::kChannelCount + channel] =
+                    static_cast<CSAMPLE>(sample);
+            energy[channel] += sample * sample;
+        }
+        gain *= decay;
+        lowPassHz *= lowPassDecay;
+    }
+
+    for (int channel = 0; channel < ConvolutionFilter::kChannelCount; ++channel) {
+        const auto normalize = static_cast<CSAMPLE>(std::sqrt(kImpulseEnergy / energy[channel]));
+        for (SINT frame = 0; frame < frames; ++frame) {
+            impulse[frame * ConvolutionFilter::kChannelCount + channel] *= normalize;
+        }
+    }
+    return impulse;
+}
+
+} // anonymous namespace
+
+// static
+ConvolutionFilterPointer ConvolutionReverbGroupState::filter(
+        mixxx::audio::SampleRate sampleRate,
+        ConvolutionPartitioning partitioning) {
+    // The spectra of the impulse response take a few MB, so all states
+    // share them as long as one of them uses them.
+    static QMutex s_mutex;
+    static std::map<std::pair<mixxx::audio::SampleRate::value_t, SINT>,
+            std::weak_ptr<const ConvolutionFilter>>
+            s_filters;
+    QMutexLocker locker(&s_mutex);
+    std::weak_ptr<const ConvolutionFilter>& pCachedFilter =
+            s_filters[std::make_pair(sampleRate.value(), partitioning.tailBlockFrames)];
+    ConvolutionFilterPointer pFilter = pCachedFilter.lock();
+    if (!pFilter) {
+        const std::vector<CSAMPLE> impulse = generateImpulse(sampleRate);
+        pFilter = std::make_shared<const ConvolutionFilter>(impulse.data(),
+                impulseFrames(sampleRate),
+                partitioning);
+        pCachedFilter = pFilter;
+    }
+    return pFilter;
+}
+
+// static
+QString ConvolutionReverbEffect::getId() {
+    return "org.mixxx.effects.convolutionreverb";
+}
+
+// static
+EffectManifestPointer ConvolutionReverbEffect::getManifest() {
+    EffectManifestPointer pManifest(new EffectManifest());
+    pManifest->setAddDryToWet(true);
+    pManifest->setEffectRampsFromDry(true);
+
+    pManifest->setId(getId());
+    pManifest->setName(QObject::tr("Convolution Reverb"));
+    pManifest->setShortName(QObject::tr("Conv Reverb"));
+    pManifest->setAuthor("The Mixxx Team");
+    pManifest->setVersion("1.0");
+    pManifest->setDescription(QObject::tr(
+            "Emulates the sound of a hall by convolving the signal with "
+            "its impulse response"));
+
+    EffectManifestParameterPointer send = pManifest->addParameter();
+    send->setId("send_amount");
+    send->setName(QObject::tr("Send"));
+    send->setShortName(QObject::tr("Send"));
+    send->setDescription(QObject::tr(
+            "How much of the signal to send in to the effect"));
+    send->setValueScaler(EffectManifestParameter::ValueScaler::Linear);
+    send->setUnitsHint(EffectManifestParameter::UnitsHint::Unknown);
+    send->setDefaultLinkType(EffectManifestParameter::LinkType::Linked);
+    send->setDefaultLinkInversion(EffectManifestParameter::LinkInversion::NotInverted);
+    send->setRange(0, 0, 1);
+
+    return pManifest;
+}
+
+void ConvolutionReverbEffect::loadEngineEffectParameters(
+        const QMap<QString, EngineEffectParameterPointer>& parameters) {
+    m_pSendParameter = parameters.value("send_amount");
+}
+
+ConvolutionReverbEffect::~ConvolutionReverbEffect() {
+    //qDebug() << debugString() << "destroyed";
+}
+
+void ConvolutionReverbEffect::processChannel(
+        ConvolutionReverbGroupState* pState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        const mixxx::EngineParameters& engineParameters,
+        const EffectEnableState enableState,
+        const GroupFeatureState& groupFeatures) {
+    Q_UNUSED(groupFeatures);
+
+    const auto sendCurrent = static_cast<CSAMPLE_GAIN>(m_pSendParameter->value());
+
+    // Discard the signal from the last time the effect was enabled
+    if (enableState == EffectEnableState::Enabling) {
+        pState->convolver.reset();
+    }
+
+    pState->convolver.process(pInput,
+            pOutput,
+            engineParameters,
+            pState->sendPrevious,
+            sendCurrent);
+
+    // Like ReverbEffect, the ramping of the send parameter handles ramping
+    // when enabling, and this effect ramps to dry when disabling itself.
+    if (enableState == EffectEnableState::Disabling) {
+        SampleUtil::applyRampingGain(pOutput, 1.0, 0.0, engineParameters.samplesPerBuffer());
+        pState->sendPrevious = 0;
+    } else {
+        pState->sendPrevious = sendCurrent;
+    }
+}
+
+SINT ConvolutionReverbEffect::tailFrames(
+        const mixxx::EngineParameters& engineParameters) const {
+    // The convolved signal lags behind by less than two tail blocks
+    const ConvolutionPartitioning partitioning =
+            ConvolutionPartitioning::forFramesPerBuffer(
+                    engineParameters.framesPerBuffer());
+    return impulseFrames(engineParameters.sampleRate()) +
+            2 * partitioning.tailBlockFrames;
+}
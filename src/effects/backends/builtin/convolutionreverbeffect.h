@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QMap>
+
+#include "effects/backends/effectprocessor.h"
+#include "engine/effects/engineeffect.h"
+#include "engine/effects/engineeffectparameter.h"
+#include "engine/filters/partitionedconvolver.h"
+#include "util/class.h"
+#include "util/defs.h"
+#include "util/sample.h"
+#include "util/types.h"
+
+class ConvolutionReverbGroupState : public EffectState {
+  public:
+    ConvolutionReverbGroupState(const mixxx::EngineParameters& engineParameters)
+            : EffectState(engineParameters),
+              sendPrevious(0),
+              convolver(&ConvolutionReverbGroupState::filter, engineParameters) {
+    }
+
+    /// The impulse response of the hall, shared by all states
+    static ConvolutionFilterPointer filter(mixxx::audio::SampleRate sampleRate,
+            ConvolutionPartitioning partitioning);
+
+    CSAMPLE_GAIN sendPrevious;
+    PartitionedConvolver convolver;
+};
+
+/// A reverb that convolves the signal with the impulse response of a hall.
+/// The impulse response is generated from decaying noise that gets darker
+/// over time.
+class ConvolutionReverbEffect : public EffectProcessorImpl<ConvolutionReverbGroupState> {
+  public:
+    ConvolutionReverbEffect() = default;
+    virtual ~ConvolutionReverbEffect();
+
+    static QString getId();
+    static EffectManifestPointer getManifest();
+
+    void loadEngineEffectParameters(
+            const QMap<QString, EngineEffectParameterPointer>& parameters) override;
+
+    void processChannel(
+            ConvolutionReverbGroupState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            const mixxx::EngineParameters& engineParameters,
+            const EffectEnableState enableState,
+            const GroupFeatureState& groupFeatures) override;
+
+    SINT tailFrames(const mixxx::EngineParameters& engineParameters) const override;
+
+  private:
+    QString debugString() const {
+        return getId();
+    }
+
+    EngineEffectParameterPointer m_pSendParameter;
+
+    DISALLOW_COPY_AND_ASSIGN(ConvolutionReverbEffect);
+};
@@ -3,7 +3,7 @@
 #include <QtDebug>
 
 #include "util/math.h"
-#include "util/rampingvalue.h"
+#include "util/parametersmoothing.h"
 #include "util/sample.h"
 
 constexpr int EchoGroupState::kMaxDelaySeconds;
@@ -165,76 +165,77 @@ void EchoEffect::processChannel(
     int read_position = pGroupState->write_position;
     decrementRing(&read_position, delay_samples, pGroupState->delay_buf.size());
 
-    RampingValue<CSAMPLE_GAIN> send(send_current,
-            pGroupState->prev_send,
-            engineParameters.framesPerBuffer());
-    // Feedback the delay buffer and then add the new input.
-
-    RampingValue<CSAMPLE_GAIN> feedback(feedback_current,
-            pGroupState->prev_feedback,
-            engineParameters.framesPerBuffer());
+    const CSAMPLE_GAIN prev_send = pGroupState->prev_send;
+    const CSAMPLE_GAIN prev_feedback = pGroupState->prev_feedback;
 
+    // Feedback the delay buffer and then add the new input. Send and
+    // feedback are ramped at control rate.
     //TODO: rewrite to remove assumption of stereo buffer
-    for (SINT i = 0;
-            i < engineParameters.samplesPerBuffer();
-            i += engineParameters.channelCount()) {
-        CSAMPLE_GAIN send_ramped = send.getNext();
-        CSAMPLE_GAIN feedback_ramped = feedback.getNext();
-
-        CSAMPLE bufferedSampleLeft = pGroupState->delay_buf[read_position];
-        CSAMPLE bufferedSampleRight = pGroupState->delay_buf[read_position + 1];
-        if (read_position != prev_read_position) {
-            const CSAMPLE_GAIN frac = static_cast<CSAMPLE_GAIN>(i) /
-                    engineParameters.samplesPerBuffer();
-            bufferedSampleLeft *= frac;
-            bufferedSampleRight *= frac;
-            bufferedSampleLeft += pGroupState->delay_buf[prev_read_position] * (1 - frac);
-            bufferedSampleRight += pGroupState->delay_buf[prev_read_position + 1] * (1 - frac);
-            incrementRing(&prev_read_position,
+    ParameterSmoothing::forEachBlock<CSAMPLE_GAIN>(
+            engineParameters.framesPerBuffer(),
+            [&](CSAMPLE_GAIN t, SINT offsetFrames, SINT blockFrames) {
+        const CSAMPLE_GAIN send_ramped = prev_send + (send_current - prev_send) * t;
+        const CSAMPLE_GAIN feedback_ramped =
+                prev_feedback + (feedback_current - prev_feedback) * t;
+        const SINT blockEnd = (offsetFrames + blockFrames) * engineParameters.channelCount();
+        for (SINT i = offsetFrames * engineParameters.channelCount();
+                i < blockEnd;
+                i += engineParameters.channelCount()) {
+            CSAMPLE bufferedSampleLeft = pGroupState->delay_buf[read_position];
+            CSAMPLE bufferedSampleRight = pGroupState->delay_buf[read_position + 1];
+            if (read_position != prev_read_position) {
+                const CSAMPLE_GAIN frac = static_cast<CSAMPLE_GAIN>(i) /
+                        engineParameters.samplesPerBuffer();
+                bufferedSampleLeft *= frac;
+                bufferedSampleRight *= frac;
+                bufferedSampleLeft += pGroupState->delay_buf[prev_read_position] * (1 - frac);
+                bufferedSampleRight += pGroupState->delay_buf[prev_read_position + 1] * (1 - frac);
+                incrementRing(&prev_read_position,
+                        engineParameters.channelCount(),
+                        pGroupState->delay_buf.size());
+            }
+            incrementRing(&read_position,
                     engineParameters.channelCount(),
                     pGroupState->delay_buf.size());
-        }
-        incrementRing(&read_position,
-                engineParameters.channelCount(),
-                pGroupState->delay_buf.size());
-
-        // Actual delays distort and saturate, so clamp the buffer here.
-        pGroupState->delay_buf[pGroupState->write_position] = SampleUtil::clampSample(
-                pInput[i] * send_ramped +
-                bufferedSampleLeft * feedback_ramped);
-        pGroupState->delay_buf[pGroupState->write_position + 1] = SampleUtil::clampSample(
-                pInput[i + 1] * send_ramped +
-                bufferedSampleRight * feedback_ramped);
-
-        // Pingpong the output.  If the pingpong value is zero, all of the
-        // math below should result in a simple copy of delay buf to pOutput.
-        if (pGroupState->ping_pong < delay_samples / 2) {
-            // Left sample plus a fraction of the right sample, normalized
-            // by 1 + fraction.
-            pOutput[i] =
-                    (bufferedSampleLeft + bufferedSampleRight * pingpong_frac) /
-                    (1 + pingpong_frac);
-            // Right sample reduced by (1 - fraction)
-            pOutput[i + 1] = bufferedSampleRight * (1 - pingpong_frac);
-        } else {
-            // Left sample reduced by (1 - fraction)
-            pOutput[i] = bufferedSampleLeft * (1 - pingpong_frac);
-            // Right sample plus fraction of left sample, normalized by
-            // 1 + fraction
-            pOutput[i + 1] =
-                    (bufferedSampleRight + bufferedSampleLeft * pingpong_frac) /
-                    (1 + pingpong_frac);
-        }
 
-        incrementRing(&pGroupState->write_position,
-                engineParameters.channelCount(),
-                pGroupState->delay_buf.size());
+            // Actual delays distort and saturate, so clamp the buffer here.
+            pGroupState->delay_buf[pGroupState->write_position] = SampleUtil::clampSample(
+                    pInput[i] * send_ramped +
+                    bufferedSampleLeft * feedback_ramped);
+            pGroupState->delay_buf[pGroupState->write_position + 1] = SampleUtil::clampSample(
+                    pInput[i + 1] * send_ramped +
+                    bufferedSampleRight * feedback_ramped);
+
+            // Pingpong the output.  If the pingpong value is zero, all of the
+            // math below should result in a simple copy of delay buf to pOutput.
+            if (pGroupState->ping_pong < delay_samples / 2) {
+                // Left sample plus a fraction of the right sample, normalized
+                // by 1 + fraction.
+                pOutput[i] =
+                        (bufferedSampleLeft + bufferedSampleRight * pingpong_frac) /
+                        (1 + pingpong_frac);
+                // Right sample reduced by (1 - fraction)
+                pOutput[i + 1] = bufferedSampleRight * (1 - pingpong_frac);
+            } else {
+                // Left sample reduced by (1 - fraction)
+                pOutput[i] = bufferedSampleLeft * (1 - pingpong_frac);
+                // Right sample plus fraction of left sample, normalized by
+                // 1 + fraction
+                pOutput[i + 1] =
+                        (bufferedSampleRight + bufferedSampleLeft * pingpong_frac) /
+                        (1 + pingpong_frac);
+            }
+
+            incrementRing(&pGroupState->write_position,
+                    engineParameters.channelCount(),
+                    pGroupState->delay_buf.size());
 
-        ++(pGroupState->ping_pong);
-        if (pGroupState->ping_pong >= delay_samples) {
-            pGroupState->ping_pong = 0;
+            ++(pGroupState->ping_pong);
+            if (pGroupState->ping_pong >= delay_samples) {
+                pGroupState->ping_pong = 0;
+            }
         }
-    }
+    });
 
     // The ramping of the send parameter handles ramping when enabling, so
     // this effect must handle ramping to dry when disabling itself (instead
@@ -250,3 +251,11 @@ void EchoEffect::processChannel(
     pGroupState->prev_feedback = feedback_current;
     pGroupState->prev_delay_samples = delay_samples;
 }
+
+SINT EchoEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    // The delay time may have been longer before it was changed, so assume
+    // the longest delay for the repeats.
+    return feedbackTailFrames(engineParameters,
+            EchoGroupState::kMaxDelaySeconds,
+            m_pFeedbackParameter->value());
+}
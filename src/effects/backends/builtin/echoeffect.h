@@ -64,6 +64,8 @@ class EchoEffect : public EffectProcessorImpl<EchoGroupState> {
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) override;
 
+    SINT tailFrames(const mixxx::EngineParameters& engineParameters) const override;
+
   private:
     QString debugString() const {
         return getId();
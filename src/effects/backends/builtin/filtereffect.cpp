@@ -177,3 +177,7 @@ void FilterEffect::processChannel(
     pState->m_q = q;
     pState->m_hiFreq = hpf;
 }
+
+SINT FilterEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    return filterTailFrames(engineParameters);
+}
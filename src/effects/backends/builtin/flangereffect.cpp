@@ -13,6 +13,10 @@ inline CSAMPLE tanh_approx(CSAMPLE input) {
     // return tanhf(input); // 142ns for process;
     return input / (1 + input * input / (3 + input * input / 5)); // 119ns for process
 }
+
+// The delays and gains of the vectorized kernel are calculated for chunks of
+// this many frames on the stack
+constexpr SINT kChunkFrames = 256;
 } // namespace
 
 // static
@@ -108,6 +112,11 @@ void FlangerEffect::loadEngineEffectParameters(
     m_pTripletParameter = parameters.value("triplet");
 }
 
+FlangerEffect::FlangerEffect()
+        : m_pDspKernel(std::make_unique<ControlProxy>(
+                  "[Master]", "dsp_kernel", nullptr, ControlFlag::NoWarnIfMissing)) {
+}
+
 FlangerEffect::~FlangerEffect() {
     //qDebug() << debugString() << "destroyed";
 }
@@ -147,15 +156,17 @@ void FlangerEffect::processChannel(
     // independently in the loop below, so do not multiply lfoPeriodSamples by
     // the number of channels.
 
-    const auto mix = static_cast<CSAMPLE_GAIN>(m_pMixParameter->value());
-    RampingValue<CSAMPLE_GAIN> mixRamped(
-            pState->prev_mix, mix, engineParameters.framesPerBuffer());
-    pState->prev_mix = mix;
+    FlangerParameters parameters;
+    parameters.sampleRate = engineParameters.sampleRate();
+    parameters.lfoPeriodFrames = lfoPeriodFrames;
 
-    const auto regen = static_cast<CSAMPLE_GAIN>(m_pRegenParameter->value());
-    RampingValue<CSAMPLE_GAIN> regenRamped(
-            pState->prev_regen, regen, engineParameters.framesPerBuffer());
-    pState->prev_regen = regen;
+    parameters.previousMix = pState->prev_mix;
+    parameters.mix = static_cast<CSAMPLE_GAIN>(m_pMixParameter->value());
+    pState->prev_mix = parameters.mix;
+
+    parameters.previousRegen = pState->prev_regen;
+    parameters.regen = static_cast<CSAMPLE_GAIN>(m_pRegenParameter->value());
+    pState->prev_regen = parameters.regen;
 
     // With and Manual is limited by amount of amplitude that remains from width
     // to kMaxDelayMs
@@ -165,20 +176,64 @@ void FlangerEffect::processChannel(
     double minManual = kCenterDelayMs - (kMaxLfoWidthMs - width) / 2;
     manual = math_clamp(manual, minManual, maxManual);
 
-    RampingValue<double> widthRamped(
-            pState->prev_width, width, engineParameters.framesPerBuffer());
+    parameters.previousWidth = pState->prev_width;
+    parameters.width = width;
     pState->prev_width = static_cast<CSAMPLE_GAIN>(width);
 
-    RampingValue<double> manualRamped(
-            pState->prev_manual, manual, engineParameters.framesPerBuffer());
+    parameters.previousManual = pState->prev_manual;
+    parameters.manual = manual;
     pState->prev_manual = static_cast<CSAMPLE_GAIN>(manual);
 
+    if (m_pDspKernel->toBool()) {
+        processReference(pState,
+                pInput,
+                pOutput,
+                engineParameters.framesPerBuffer(),
+                parameters);
+    } else {
+        processVectorized(pState,
+                pInput,
+                pOutput,
+                engineParameters.framesPerBuffer(),
+                parameters);
+    }
+
+    if (enableState == EffectEnableState::Disabling) {
+        SampleUtil::clear(pState->delayLeft, kBufferLenth);
+        SampleUtil::clear(pState->delayRight, kBufferLenth);
+        pState->previousPeriodFrames = -1;
+        pState->prev_regen = 0;
+        pState->prev_mix = 0;
+    }
+}
+
+SINT FlangerEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    return feedbackTailFrames(engineParameters,
+            kMaxDelayMs / 1000,
+            m_pRegenParameter->value());
+}
+
+// static
+void FlangerEffect::processReference(FlangerGroupState* pState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        SINT framesPerBuffer,
+        const FlangerParameters& parameters) {
+    RampingValue<CSAMPLE_GAIN> mixRamped(
+            parameters.previousMix, parameters.mix, framesPerBuffer);
+    RampingValue<CSAMPLE_GAIN> regenRamped(
+            parameters.previousRegen, parameters.regen, framesPerBuffer);
+    RampingValue<double> widthRamped(
+            parameters.previousWidth, parameters.width, framesPerBuffer);
+    RampingValue<double> manualRamped(
+            parameters.previousManual, parameters.manual, framesPerBuffer);
+    const double lfoPeriodFrames = parameters.lfoPeriodFrames;
+
     CSAMPLE* delayLeft = pState->delayLeft;
     CSAMPLE* delayRight = pState->delayRight;
 
-    for (SINT i = 0;
-            i < engineParameters.samplesPerBuffer();
-            i += engineParameters.channelCount()) {
+    for (SINT i = 0; i < framesPerBuffer * mixxx::kEngineChannelCount;
+            i += mixxx::kEngineChannelCount) {
         CSAMPLE_GAIN mix_ramped = mixRamped.getNext();
         CSAMPLE_GAIN regen_ramped = regenRamped.getNext();
         double width_ramped = widthRamped.getNext();
@@ -191,7 +246,7 @@ void FlangerEffect::processChannel(
 
         auto periodFraction = pState->lfoFrames / static_cast<float>(lfoPeriodFrames);
         double delayMs = manual_ramped + width_ramped / 2 * sin(M_PI * 2.0f * periodFraction);
-        double delayFrames = delayMs * engineParameters.sampleRate() / 1000;
+        double delayFrames = delayMs * parameters.sampleRate / 1000;
 
         SINT framePrev =
                 (pState->delayPos - static_cast<SINT>(floor(delayFrames)) +
@@ -207,8 +262,10 @@ void FlangerEffect::processChannel(
         CSAMPLE prevRight = delayRight[framePrev];
         CSAMPLE nextRight = delayRight[frameNext];
 
+        // Use the same rounding as for framePrev, a delay just below an
+        // integer must not be rounded up in float
         const CSAMPLE_GAIN frac = static_cast<CSAMPLE_GAIN>(
-                delayFrames - floorf(static_cast<float>(delayFrames)));
+                delayFrames - floor(delayFrames));
         CSAMPLE delayedSampleLeft = prevLeft + frac * (nextLeft - prevLeft);
         CSAMPLE delayedSampleRight = prevRight + frac * (nextRight - prevRight);
 
@@ -222,12 +279,96 @@ void FlangerEffect::processChannel(
         pOutput[i] = (pInput[i] + mix_ramped * delayedSampleLeft) / gain;
         pOutput[i + 1] = (pInput[i + 1] + mix_ramped * delayedSampleRight) / gain;
     }
+}
 
-    if (enableState == EffectEnableState::Disabling) {
-        SampleUtil::clear(delayLeft, kBufferLenth);
-        SampleUtil::clear(delayRight, kBufferLenth);
-        pState->previousPeriodFrames = -1;
-        pState->prev_regen = 0;
-        pState->prev_mix = 0;
+// static
+void FlangerEffect::processVectorized(FlangerGroupState* pState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        SINT framesPerBuffer,
+        const FlangerParameters& parameters) {
+    // The ramps reach the new values with the last frame like RampingValue
+    const float rampStep = framesPerBuffer > 0 ? 1.0f / framesPerBuffer : 0.0f;
+    const auto mixStart = static_cast<float>(parameters.previousMix);
+    const auto mixStep = static_cast<float>(parameters.mix - parameters.previousMix) * rampStep;
+    const auto regenStart = static_cast<float>(parameters.previousRegen);
+    const auto regenStep =
+            static_cast<float>(parameters.regen - parameters.previousRegen) * rampStep;
+    const auto msToFrames = static_cast<float>(parameters.sampleRate / 1000);
+    const auto manualStart = static_cast<float>(parameters.previousManual);
+    const auto manualStep = static_cast<float>(
+            parameters.manual - parameters.previousManual) * rampStep;
+    const auto widthStart = static_cast<float>(parameters.previousWidth / 2);
+    const auto widthStep = static_cast<float>(
+            (parameters.width - parameters.previousWidth) / 2) * rampStep;
+    const double lfoPeriodFrames = parameters.lfoPeriodFrames;
+    const float periodInv = 1.0f / static_cast<float>(lfoPeriodFrames);
+
+    CSAMPLE* delayLeft = pState->delayLeft;
+    CSAMPLE* delayRight = pState->delayRight;
+
+    float cycles[kChunkFrames];
+    float delayFrames[kChunkFrames];
+    CSAMPLE_GAIN regens[kChunkFrames];
+    CSAMPLE_GAIN dryGains[kChunkFrames];
+    CSAMPLE_GAIN wetGains[kChunkFrames];
+
+    for (SINT chunkStart = 0; chunkStart < framesPerBuffer; chunkStart += kChunkFrames) {
+        const SINT chunkFrames = math_min(kChunkFrames, framesPerBuffer - chunkStart);
+
+        unsigned int lfoFrames = pState->lfoFrames;
+        for (SINT i = 0; i < chunkFrames; ++i) {
+            lfoFrames++;
+            if (lfoFrames >= lfoPeriodFrames) {
+                lfoFrames = 0;
+            }
+            cycles[i] = static_cast<float>(lfoFrames);
+        }
+        pState->lfoFrames = lfoFrames;
+
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < chunkFrames; ++i) {
+            const auto step = static_cast<float>(chunkStart + i + 1);
+            const float manual = manualStart + manualStep * step;
+            const float halfWidth = widthStart + widthStep * step;
+            delayFrames[i] = (manual + halfWidth * fastSinCycles(cycles[i] * periodInv)) *
+                    msToFrames;
+            regens[i] = regenStart + regenStep * step;
+            const float mix = mixStart + mixStep * step;
+            const float gainInv = 1 / (1 - mix + kGainCorrection * mix);
+            dryGains[i] = gainInv;
+            wetGains[i] = mix * gainInv;
+        }
+
+        // The feedback through the delay lines needs the previous frame, so
+        // this loop remains sequential
+        SINT delayPos = pState->delayPos;
+        const CSAMPLE* pChunkInput = pInput + chunkStart * mixxx::kEngineChannelCount;
+        CSAMPLE* pChunkOutput = pOutput + chunkStart * mixxx::kEngineChannelCount;
+        for (SINT i = 0; i < chunkFrames; ++i) {
+            const auto delay = static_cast<SINT>(delayFrames[i]);
+            const CSAMPLE_GAIN frac = delayFrames[i] - delay;
+            SINT framePrev = delayPos - delay;
+            framePrev += framePrev < 0 ? kBufferLenth : 0;
+            SINT frameNext = framePrev - 1;
+            frameNext += frameNext < 0 ? kBufferLenth : 0;
+
+            const CSAMPLE prevLeft = delayLeft[framePrev];
+            const CSAMPLE prevRight = delayRight[framePrev];
+            const CSAMPLE delayedSampleLeft =
+                    prevLeft + frac * (delayLeft[frameNext] - prevLeft);
+            const CSAMPLE delayedSampleRight =
+                    prevRight + frac * (delayRight[frameNext] - prevRight);
+
+            const CSAMPLE inLeft = pChunkInput[i * 2];
+            const CSAMPLE inRight = pChunkInput[i * 2 + 1];
+            delayLeft[delayPos] = tanh_approx(inLeft + regens[i] * delayedSampleLeft);
+            delayRight[delayPos] = tanh_approx(inRight + regens[i] * delayedSampleRight);
+            delayPos = delayPos + 1 < kBufferLenth ? delayPos + 1 : 0;
+
+            pChunkOutput[i * 2] = inLeft * dryGains[i] + delayedSampleLeft * wetGains[i];
+            pChunkOutput[i * 2 + 1] = inRight * dryGains[i] + delayedSampleRight * wetGains[i];
+        }
+        pState->delayPos = static_cast<unsigned int>(delayPos);
     }
 }
@@ -1,12 +1,15 @@
 #pragma once
 
 #include <QMap>
+#include <memory>
 
+#include "control/controlproxy.h"
 #include "effects/backends/effectprocessor.h"
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectparameter.h"
 #include "util/class.h"
 #include "util/defs.h"
+#include "util/fastmath.h"
 #include "util/rampingvalue.h"
 #include "util/sample.h"
 #include "util/types.h"
@@ -46,9 +49,24 @@ struct FlangerGroupState : public EffectState {
     CSAMPLE_GAIN prev_manual;
 };
 
+/// The parameters of one buffer, which are ramped from the values of the
+/// previous buffer
+struct FlangerParameters {
+    double sampleRate;
+    double lfoPeriodFrames;
+    CSAMPLE_GAIN previousMix;
+    CSAMPLE_GAIN mix;
+    CSAMPLE_GAIN previousRegen;
+    CSAMPLE_GAIN regen;
+    double previousWidth;
+    double width;
+    double previousManual;
+    double manual;
+};
+
 class FlangerEffect : public EffectProcessorImpl<FlangerGroupState> {
   public:
-    FlangerEffect() = default;
+    FlangerEffect();
     virtual ~FlangerEffect();
 
     static QString getId();
@@ -65,11 +83,32 @@ class FlangerEffect : public EffectProcessorImpl<FlangerGroupState> {
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) override;
 
+    SINT tailFrames(const mixxx::EngineParameters& engineParameters) const override;
+
+    /// The original implementation, which calculates the LFO and the ramps
+    /// of the parameters for every frame in double precision
+    static void processReference(FlangerGroupState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            SINT framesPerBuffer,
+            const FlangerParameters& parameters);
+
+    /// Calculates the delays and gains of a chunk of frames in vectorized
+    /// loops with an approximated sine before running the feedback loop,
+    /// which remains sequential.
+    static void processVectorized(FlangerGroupState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            SINT framesPerBuffer,
+            const FlangerParameters& parameters);
+
   private:
     QString debugString() const {
         return getId();
     }
 
+    std::unique_ptr<ControlProxy> m_pDspKernel;
+
     EngineEffectParameterPointer m_pSpeedParameter;
     EngineEffectParameterPointer m_pWidthParameter;
     EngineEffectParameterPointer m_pManualParameter;
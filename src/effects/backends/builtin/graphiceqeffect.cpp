@@ -236,3 +236,7 @@ void GraphicEQEffect::processChannel(
         }
     }
 }
+
+SINT GraphicEQEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    return filterTailFrames(engineParameters);
+}
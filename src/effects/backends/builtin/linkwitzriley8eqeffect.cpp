@@ -184,3 +184,7 @@ void LinkwitzRiley8EQEffect::processChannel(
         pState->old_high = fHigh;
     }
 }
+
+SINT LinkwitzRiley8EQEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    return filterTailFrames(engineParameters);
+}
@@ -155,3 +155,7 @@ void LoudnessContourEffect::processChannel(
     pState->m_oldFilterGainDb = filterGainDb;
     pState->m_oldGain = gain;
 }
+
+SINT LoudnessContourEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    return filterTailFrames(engineParameters);
+}
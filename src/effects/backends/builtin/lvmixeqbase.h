@@ -2,6 +2,7 @@
 
 #include "effects/backends/effectprocessor.h"
 #include "engine/filters/enginefilterdelay.h"
+#include "engine/filters/enginefilteriirbatch.h"
 #include "util/defs.h"
 #include "util/math.h"
 #include "util/sample.h"
@@ -62,6 +63,8 @@ class LVMixEQEffectGroupState : public EffectState {
                 lowFreq / sampleRate, LVMixEQEffectGroupStateConstants::kMaxDelay);
         SINT delayLow2 = m_low2->setFrequencyCornersForIntDelay(
                 highFreq / sampleRate, LVMixEQEffectGroupStateConstants::kMaxDelay);
+        m_lowFilters.setCoefs(0, *m_low1);
+        m_lowFilters.setCoefs(1, *m_low2);
 
         m_delay2->setDelay((delayLow1 - delayLow2) * 2);
         m_delay3->setDelay(delayLow1 * 2);
@@ -103,13 +106,11 @@ class LVMixEQEffectGroupState : public EffectState {
             m_delay3->process(pInput, m_pHighBuf, numSamples);
         }
 
-        if (fMid != 0 || m_oldMid != 0) {
+        // Both low passes are processed in one batch, even if only one of
+        // the bands is used, which costs no more than a single filter.
+        if (fLow != 0 || m_oldLow != 0 || fMid != 0 || m_oldMid != 0) {
             m_delay2->process(pInput, m_pBandBuf, numSamples);
-            m_low2->process(m_pBandBuf, m_pBandBuf, numSamples);
-        }
-
-        if (fLow != 0 || m_oldLow != 0) {
-            m_low1->process(pInput, m_pLowBuf, numSamples);
+            m_lowFilters.process({pInput, m_pBandBuf}, {m_pLowBuf, m_pBandBuf}, numSamples);
         }
 
         // Test code for comparing streams as two stereo channels
@@ -196,13 +197,10 @@ class LVMixEQEffectGroupState : public EffectState {
         // We know the exact group delay here so we can just hold off the ramping.
         m_delay3->processAndPauseFilter(pInput, m_pHighBuf, numSamples);
 
-        if (m_oldMid != 0) {
+        if (m_oldLow != 0 || m_oldMid != 0) {
             m_delay2->processAndPauseFilter(pInput, m_pBandBuf, numSamples);
-            m_low2->processAndPauseFilter(m_pBandBuf, m_pBandBuf, numSamples);
-        }
-
-        if (m_oldLow != 0) {
-            m_low1->processAndPauseFilter(pInput, m_pLowBuf, numSamples);
+            m_lowFilters.processAndPauseFilter(
+                    {pInput, m_pBandBuf}, {m_pLowBuf, m_pBandBuf}, numSamples);
         }
 
         SampleUtil::copy3WithRampingGain(pOutput,
@@ -270,8 +268,11 @@ class LVMixEQEffectGroupState : public EffectState {
 */
 
   private:
+    // Only used for designing the coefficients of m_lowFilters
     LPF* m_low1;
     LPF* m_low2;
+    // The low pass for the low band and the low pass for the band
+    EngineFilterIIRBatch<LPF::kSize, LPF::kPass, 2> m_lowFilters;
     EngineFilterDelay<LVMixEQEffectGroupStateConstants::kMaxDelay>* m_delay2;
     EngineFilterDelay<LVMixEQEffectGroupStateConstants::kMaxDelay>* m_delay3;
 
@@ -129,3 +129,9 @@ void MetronomeEffect::processChannel(
         SampleUtil::addMonoToStereo(&pOutput[outputOffset * 2], click, copyFrames);
     }
 }
+
+SINT MetronomeEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    // The clicks are generated regardless of the input
+    Q_UNUSED(engineParameters);
+    return kUnboundedTailFrames;
+}
@@ -87,6 +87,11 @@ void MoogLadder4FilterEffect::loadEngineEffectParameters(
     m_pHPF = parameters.value("hpf");
 }
 
+MoogLadder4FilterEffect::MoogLadder4FilterEffect()
+        : m_pDspKernel(std::make_unique<ControlProxy>(
+                  "[Master]", "dsp_kernel", nullptr, ControlFlag::NoWarnIfMissing)) {
+}
+
 MoogLadder4FilterEffect::~MoogLadder4FilterEffect() {
     //qDebug() << debugString() << "destroyed";
 }
@@ -100,6 +105,12 @@ void MoogLadder4FilterEffect::processChannel(
         const GroupFeatureState& groupFeatures) {
     Q_UNUSED(groupFeatures);
 
+    const DspKernel kernel = m_pDspKernel->toBool()
+            ? DspKernel::Reference
+            : DspKernel::Vectorized;
+    pState->m_pLowFilter->setKernel(kernel);
+    pState->m_pHighFilter->setKernel(kernel);
+
     double resonance = m_pResonance->value();
     double hpf;
     double lpf;
@@ -170,3 +181,11 @@ void MoogLadder4FilterEffect::processChannel(
     pState->m_hiFreq = hpf;
     pState->m_samplerate = engineParameters.sampleRate();
 }
+
+SINT MoogLadder4FilterEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    // The resonance is a feedback loop around the four filter stages, which
+    // rings at the corner frequency and self-oscillates at the maximum of 4.
+    return feedbackTailFrames(engineParameters,
+            1.0 / (kMinCorner * engineParameters.sampleRate()),
+            m_pResonance->value() / 4);
+}
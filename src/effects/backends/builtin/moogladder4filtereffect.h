@@ -1,4 +1,7 @@
 #pragma once
+#include <memory>
+
+#include "control/controlproxy.h"
 #include "effects/backends/effectprocessor.h"
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectparameter.h"
@@ -26,7 +29,7 @@ class MoogLadder4FilterGroupState : public EffectState {
 
 class MoogLadder4FilterEffect : public EffectProcessorImpl<MoogLadder4FilterGroupState> {
   public:
-    MoogLadder4FilterEffect() = default;
+    MoogLadder4FilterEffect();
     virtual ~MoogLadder4FilterEffect();
 
     static QString getId();
@@ -43,6 +46,8 @@ class MoogLadder4FilterEffect : public EffectProcessorImpl<MoogLadder4FilterGrou
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) override;
 
+    SINT tailFrames(const mixxx::EngineParameters& engineParameters) const override;
+
   private:
     QString debugString() const {
         return getId();
@@ -52,5 +57,7 @@ class MoogLadder4FilterEffect : public EffectProcessorImpl<MoogLadder4FilterGrou
     EngineEffectParameterPointer m_pResonance;
     EngineEffectParameterPointer m_pHPF;
 
+    std::unique_ptr<ControlProxy> m_pDspKernel;
+
     DISALLOW_COPY_AND_ASSIGN(MoogLadder4FilterEffect);
 };
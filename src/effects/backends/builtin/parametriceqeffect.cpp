@@ -205,3 +205,7 @@ void ParametricEQEffect::processChannel(
         }
     }
 }
+
+SINT ParametricEQEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    return filterTailFrames(engineParameters);
+}
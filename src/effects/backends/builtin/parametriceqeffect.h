@@ -58,6 +58,8 @@ class ParametricEQEffect : public EffectProcessorImpl<ParametricEQEffectGroupSta
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatureState) override;
 
+    SINT tailFrames(const mixxx::EngineParameters& engineParameters) const override;
+
   private:
     QString debugString() const {
         return getId();
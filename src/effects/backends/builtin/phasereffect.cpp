@@ -113,6 +113,11 @@ void PhaserEffect::loadEngineEffectParameters(
     m_pStereoParameter = parameters.value("stereo");
 }
 
+PhaserEffect::PhaserEffect()
+        : m_pDspKernel(std::make_unique<ControlProxy>(
+                  "[Master]", "dsp_kernel", nullptr, ControlFlag::NoWarnIfMissing)) {
+}
+
 PhaserEffect::~PhaserEffect() {
     //qDebug() << debugString() << "destroyed";
 }
@@ -151,9 +156,42 @@ void PhaserEffect::processChannel(
     // so do not multiply periodSamples by the number of channels.
     const auto freqSkip = static_cast<CSAMPLE>(1.0f / periodSamples * kDoublePi);
 
-    const auto feedback = static_cast<CSAMPLE>(m_pFeedbackParameter->value());
-    const auto range = static_cast<CSAMPLE>(m_pRangeParameter->value());
-    const auto stages = static_cast<int>(2 * m_pStagesParameter->value());
+    PhaserParameters parameters;
+    parameters.freqSkip = freqSkip;
+    parameters.feedback = static_cast<CSAMPLE>(m_pFeedbackParameter->value());
+    parameters.range = static_cast<CSAMPLE>(m_pRangeParameter->value());
+    parameters.stages = static_cast<int>(2 * m_pStagesParameter->value());
+    parameters.stereo = m_pStereoParameter->toBool();
+    parameters.previousDepth = pState->oldDepth;
+    parameters.depth = depth;
+
+    if (m_pDspKernel->toBool()) {
+        processReference(pState,
+                pInput,
+                pOutput,
+                engineParameters.framesPerBuffer(),
+                parameters);
+    } else {
+        processVectorized(pState,
+                pInput,
+                pOutput,
+                engineParameters.framesPerBuffer(),
+                parameters);
+    }
+
+    pState->oldDepth = depth;
+}
+
+// static
+void PhaserEffect::processReference(PhaserGroupState* pState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        SINT framesPerBuffer,
+        const PhaserParameters& parameters) {
+    const CSAMPLE freqSkip = parameters.freqSkip;
+    const CSAMPLE feedback = parameters.feedback;
+    const CSAMPLE range = parameters.range;
+    const int stages = parameters.stages;
 
     CSAMPLE* oldInLeft = pState->oldInLeft;
     CSAMPLE* oldOutLeft = pState->oldOutLeft;
@@ -166,16 +204,14 @@ void PhaserEffect::processChannel(
 
     CSAMPLE left = 0, right = 0;
 
-    CSAMPLE_GAIN oldDepth = pState->oldDepth;
-    const CSAMPLE_GAIN depthDelta = (depth - oldDepth) / engineParameters.framesPerBuffer();
-    const CSAMPLE_GAIN depthStart = oldDepth + depthDelta;
+    const CSAMPLE_GAIN depthDelta =
+            (parameters.depth - parameters.previousDepth) / framesPerBuffer;
+    const CSAMPLE_GAIN depthStart = parameters.previousDepth + depthDelta;
 
-    const auto stereoCheck = static_cast<int>(m_pStereoParameter->value());
+    const int stereoCheck = parameters.stereo ? 1 : 0;
     int counter = 0;
 
-    for (SINT i = 0;
-            i < engineParameters.samplesPerBuffer();
-            i += engineParameters.channelCount()) {
+    for (SINT i = 0; i < framesPerBuffer * 2; i += 2) {
         left = pInput[i] + std::tanh(left * feedback);
         right = pInput[i + 1] + std::tanh(right * feedback);
 
@@ -206,12 +242,98 @@ void PhaserEffect::processChannel(
         left = processSample(left, oldInLeft, oldOutLeft, filterCoefLeft, stages);
         right = processSample(right, oldInRight, oldOutRight, filterCoefRight, stages);
 
-        const CSAMPLE_GAIN depth = depthStart + depthDelta * (i / engineParameters.channelCount());
+        const CSAMPLE_GAIN depth = depthStart + depthDelta * (i / 2);
 
         // Computing output combining the original and processed sample
         pOutput[i] = pInput[i] * (1.0f - 0.5f * depth) + left * depth * 0.5f;
         pOutput[i + 1] = pInput[i + 1] * (1.0f - 0.5f * depth) + right * depth * 0.5f;
     }
+}
 
-    pState->oldDepth = depth;
+// static
+void PhaserEffect::processVectorized(PhaserGroupState* pState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        SINT framesPerBuffer,
+        const PhaserParameters& parameters) {
+    const CSAMPLE feedback = parameters.feedback;
+    const CSAMPLE range = parameters.range;
+    const int stages = math_min(parameters.stages, MAXSTAGES);
+    const CSAMPLE freqSkip = parameters.freqSkip;
+    // For stereo enabled, the channels are out of phase
+    const CSAMPLE phaseOffset[2] = {
+            0, static_cast<float>(M_PI) * (parameters.stereo ? 1 : 0)};
+
+    // The channels are interleaved, so the lanes of a stage are adjacent
+    CSAMPLE oldIn[MAXSTAGES][2];
+    CSAMPLE oldOut[MAXSTAGES][2];
+    for (int j = 0; j < stages; ++j) {
+        oldIn[j][0] = pState->oldInLeft[j];
+        oldIn[j][1] = pState->oldInRight[j];
+        oldOut[j][0] = pState->oldOutLeft[j];
+        oldOut[j][1] = pState->oldOutRight[j];
+    }
+    CSAMPLE phase[2] = {pState->leftPhase, pState->rightPhase};
+    CSAMPLE filterCoef[2] = {0, 0};
+    CSAMPLE processed[2] = {0, 0};
+
+    const CSAMPLE_GAIN depthDelta =
+            (parameters.depth - parameters.previousDepth) / framesPerBuffer;
+    const CSAMPLE_GAIN depthStart = parameters.previousDepth + depthDelta;
+
+    for (SINT frame = 0; frame < framesPerBuffer; ++frame) {
+        CSAMPLE sample[2];
+        for (int c = 0; c < 2; ++c) {
+            sample[c] = pInput[frame * 2 + c] + fastTanh(processed[c] * feedback);
+            // The phase stays below 2 * pi, so the sum stays below 4 * pi
+            // and the subtraction is exact like fmodf. Adding the offset of 0
+            // to the left phase does not change it.
+            const CSAMPLE nextPhase = phase[c] + freqSkip + phaseOffset[c];
+            phase[c] = nextPhase >= kDoublePi ? nextPhase - kDoublePi : nextPhase;
+        }
+
+        // The coefficients are calculated like in the reference kernel. They
+        // are only updated every 'updateCoef' frames, and the allpass stages
+        // are too sensitive to them for an approximation.
+        if (frame % updateCoef == 0) {
+            for (int c = 0; c < 2; ++c) {
+                const auto delay = static_cast<CSAMPLE>(0.5 + 0.5 * sin(phase[c]));
+                const CSAMPLE tanw = std::tanh(range * delay / 2);
+                filterCoef[c] = (1.0f - tanw) / (1.0f + tanw);
+            }
+        }
+
+        for (int j = 0; j < stages; ++j) {
+            for (int c = 0; c < 2; ++c) {
+                oldOut[j][c] = (filterCoef[c] * sample[c]) +
+                        (filterCoef[c] * oldOut[j][c]) - oldIn[j][c];
+                oldIn[j][c] = sample[c];
+                sample[c] = oldOut[j][c];
+            }
+        }
+
+        const CSAMPLE_GAIN depth = depthStart + depthDelta * frame;
+        for (int c = 0; c < 2; ++c) {
+            processed[c] = sample[c];
+            pOutput[frame * 2 + c] = pInput[frame * 2 + c] * (1.0f - 0.5f * depth) +
+                    sample[c] * depth * 0.5f;
+        }
+    }
+
+    for (int j = 0; j < stages; ++j) {
+        pState->oldInLeft[j] = oldIn[j][0];
+        pState->oldInRight[j] = oldIn[j][1];
+        pState->oldOutLeft[j] = oldOut[j][0];
+        pState->oldOutRight[j] = oldOut[j][1];
+    }
+    pState->leftPhase = phase[0];
+    pState->rightPhase = phase[1];
+}
+
+SINT PhaserEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    // The feedback is applied once per frame after the allpass stages
+    return math_max(filterTailFrames(engineParameters),
+            feedbackTailFrames(engineParameters,
+                    1.0 / engineParameters.sampleRate(),
+                    m_pFeedbackParameter->value()));
 }
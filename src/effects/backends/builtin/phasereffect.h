@@ -1,10 +1,14 @@
 #pragma once
 
+#include <memory>
+
+#include "control/controlproxy.h"
 #include "effects/backends/effectprocessor.h"
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectparameter.h"
 #include "util/class.h"
 #include "util/defs.h"
+#include "util/fastmath.h"
 #include "util/sample.h"
 #include "util/types.h"
 
@@ -36,9 +40,23 @@ class PhaserGroupState final : public EffectState {
     CSAMPLE_GAIN oldDepth;
 };
 
+/// The parameters of one buffer
+struct PhaserParameters {
+    /// The step of the LFO phase per frame in radians
+    CSAMPLE freqSkip;
+    CSAMPLE feedback;
+    CSAMPLE range;
+    int stages;
+    /// Sets the LFOs of the channels out of phase
+    bool stereo;
+    /// The depth is ramped from the value of the previous buffer
+    CSAMPLE_GAIN previousDepth;
+    CSAMPLE_GAIN depth;
+};
+
 class PhaserEffect : public EffectProcessorImpl<PhaserGroupState> {
   public:
-    PhaserEffect() = default;
+    PhaserEffect();
     virtual ~PhaserEffect();
 
     static QString getId();
@@ -55,11 +73,33 @@ class PhaserEffect : public EffectProcessorImpl<PhaserGroupState> {
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) override;
 
+    SINT tailFrames(const mixxx::EngineParameters& engineParameters) const override;
+
+    /// The original implementation, which saturates the feedback with
+    /// std::tanh and calculates the LFO in double precision
+    static void processReference(PhaserGroupState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            SINT framesPerBuffer,
+            const PhaserParameters& parameters);
+
+    /// Processes both channels as lanes of the same operations and saturates
+    /// the feedback with an approximated tanh. The allpass stages and the
+    /// feedback are recursive per frame, so the kernel is vectorized across
+    /// the channels.
+    static void processVectorized(PhaserGroupState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            SINT framesPerBuffer,
+            const PhaserParameters& parameters);
+
   private:
     QString debugString() const {
         return getId();
     }
 
+    std::unique_ptr<ControlProxy> m_pDspKernel;
+
     EngineEffectParameterPointer m_pStagesParameter;
     EngineEffectParameterPointer m_pLFOPeriodParameter;
     EngineEffectParameterPointer m_pDepthParameter;
@@ -69,7 +109,7 @@ class PhaserEffect : public EffectProcessorImpl<PhaserGroupState> {
     EngineEffectParameterPointer m_pStereoParameter;
 
     //Passing the sample through a series of allpass filters
-    inline CSAMPLE processSample(CSAMPLE input,
+    static inline CSAMPLE processSample(CSAMPLE input,
             CSAMPLE* oldIn,
             CSAMPLE* oldOut,
             CSAMPLE mainCoef,
@@ -123,3 +123,14 @@ void ReverbEffect::processChannel(
         pState->sendPrevious = sendCurrent;
     }
 }
+
+SINT ReverbEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    // The signal circulates through the two halves of the plate tank, which
+    // take up to half a second each and attenuate it by the decay.
+    // MixxxPlateX2 scales the decay parameter by 0.89.
+    constexpr double kTankHalfSeconds = 0.5;
+    constexpr double kDecayScale = 0.89;
+    return feedbackTailFrames(engineParameters,
+            kTankHalfSeconds,
+            kDecayScale * m_pDecayParameter->value());
+}
@@ -367,3 +367,7 @@ void ThreeBandBiquadEQEffect::processChannel(
         pState->m_highCut->pauseFilter();
     }
 }
+
+SINT ThreeBandBiquadEQEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    return filterTailFrames(engineParameters);
+}
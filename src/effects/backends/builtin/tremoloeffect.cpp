@@ -216,3 +216,8 @@ void TremoloEffect::processChannel(
     pState->quantizeEnabled = m_pQuantizeParameter->toBool();
     pState->tripletEnabled = m_pTripletParameter->toBool();
 }
+
+SINT TremoloEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    Q_UNUSED(engineParameters);
+    return 0;
+}
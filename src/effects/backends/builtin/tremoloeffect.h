@@ -35,6 +35,8 @@ class TremoloEffect : public EffectProcessorImpl<TremoloState> {
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) override;
 
+    SINT tailFrames(const mixxx::EngineParameters& engineParameters) const override;
+
   private:
     QString debugString() const {
         return getId();
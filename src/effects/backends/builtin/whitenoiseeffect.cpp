@@ -1,6 +1,6 @@
 #include "effects/backends/builtin/whitenoiseeffect.h"
 
-#include "util/rampingvalue.h"
+#include "util/parametersmoothing.h"
 
 namespace {
 const QString dryWetParameterId = QStringLiteral("dry_wet");
@@ -51,19 +51,24 @@ void WhiteNoiseEffect::processChannel(
     WhiteNoiseGroupState& gs = *pState;
 
     CSAMPLE drywet = static_cast<CSAMPLE>(m_pDryWetParameter->value());
-    RampingValue<CSAMPLE_GAIN> drywet_ramping_value(
-            drywet, gs.previous_drywet, engineParameters.framesPerBuffer());
+    const CSAMPLE_GAIN previous_drywet = gs.previous_drywet;
 
     std::uniform_real_distribution<> r_distributor(0.0, 1.0);
 
-    for (unsigned int i = 0; i < engineParameters.samplesPerBuffer(); i++) {
-        CSAMPLE_GAIN drywet_ramped = drywet_ramping_value.getNext();
+    ParameterSmoothing::forEachBlock<CSAMPLE_GAIN>(
+            engineParameters.framesPerBuffer(),
+            [&](CSAMPLE_GAIN t, SINT offsetFrames, SINT blockFrames) {
+                const CSAMPLE_GAIN drywet_ramped =
+                        previous_drywet + (drywet - previous_drywet) * t;
+                const SINT start = offsetFrames * engineParameters.channelCount();
+                const SINT end = start + blockFrames * engineParameters.channelCount();
+                for (SINT i = start; i < end; ++i) {
+                    float noise = static_cast<float>(
+                            r_distributor(gs.gen));
 
-        float noise = static_cast<float>(
-                r_distributor(gs.gen));
-
-        pOutput[i] = pInput[i] * (1 - drywet_ramped) + noise * drywet_ramped;
-    }
+                    pOutput[i] = pInput[i] * (1 - drywet_ramped) + noise * drywet_ramped;
+                }
+            });
 
     if (enableState == EffectEnableState::Disabling) {
         gs.previous_drywet = 0;
@@ -71,3 +76,9 @@ void WhiteNoiseEffect::processChannel(
         gs.previous_drywet = drywet;
     }
 }
+
+SINT WhiteNoiseEffect::tailFrames(const mixxx::EngineParameters& engineParameters) const {
+    // The noise is generated regardless of the input
+    Q_UNUSED(engineParameters);
+    return kUnboundedTailFrames;
+}
@@ -4,12 +4,21 @@
 #include <QHash>
 #include <QPair>
 #include <QString>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <optional>
 
 #include "effects/defs.h"
 #include "engine/channelhandle.h"
 #include "engine/effects/groupfeaturestate.h"
 #include "engine/effects/message.h"
 #include "engine/engine.h"
+#include "util/assert.h"
+#include "util/fifo.h"
+#include "util/math.h"
+#include "util/sample.h"
 #include "util/types.h"
 
 /// Effects are implemented as two separate classes, an EffectState subclass and
@@ -41,14 +50,18 @@
 /// processed postfader for the main mix and prefader for the headphone output in
 /// parallel so there is no need for a prefader/postfader toggle switch.
 ///
-/// EffectStates allocated on the main thread are passed as pointers to the
-/// EffectProcessorImpl in the audio callback thread via the EffectsMessenger.
-/// EffectStates are allocated and deallocated when a routing switch for an
-/// EffectChain is toggled and when a new EngineEffect is loaded into an EffectSlot.
-/// This allows for scaling up to an arbitrary number of input signals
-/// without wasting a lot of memory. (EffectStates could be (de)allocated when toggling
-/// the enable switches for EffectSlots as well, but the memory savings would be
-/// relatively small compared to the additional code complexity.)
+/// EffectStates are assigned lazily by EffectProcessorImpl in the audio callback
+/// thread the first time an effect processes a combination of input and output
+/// signal. Because allocating memory in the audio callback thread is not allowed,
+/// the states are taken from a pool per input signal, which the main thread fills
+/// with a state for every output by prepareStatesForInputChannel() before the
+/// input is routed through the EffectChain or when an effect is loaded into a
+/// chain that the input is routed through. So the audio thread never runs out of
+/// states, and EffectStates only exist for the input signals that are actually
+/// routed through an effect. The EffectStates of an input signal are deleted on
+/// the main thread after the routing switch of the EffectChain for the input has
+/// been toggled off. They are not reused, because a reused EffectState would leak
+/// the audio of the previous input into the tail of delay based effects.
 class EffectState {
   public:
     EffectState(const mixxx::EngineParameters& engineParameters) {
@@ -63,23 +76,31 @@ class EffectState {
 /// for the template in EffectProcessorImpl.
 class EffectProcessor {
   public:
+    /// The tail of effects that generate a signal on their own or whose tail
+    /// is not known. These are never bypassed.
+    static constexpr SINT kUnboundedTailFrames = std::numeric_limits<SINT>::max();
+    /// Signals below -100 dBFS are considered silent
+    static constexpr CSAMPLE kSilenceThreshold = 0.00001f;
+
     virtual ~EffectProcessor() {
     }
 
     /// These methods are called from the main thread
     virtual void initialize(
-            const QSet<ChannelHandleAndGroup>& activeInputChannels,
+            const QSet<ChannelHandleAndGroup>& registeredInputChannels,
             const QSet<ChannelHandleAndGroup>& registeredOutputChannels,
             const mixxx::EngineParameters& engineParameters) = 0;
     virtual void loadEngineEffectParameters(
             const QMap<QString, EngineEffectParameterPointer>& parameters) = 0;
-    virtual EffectState* createState(const mixxx::EngineParameters& engineParameters) = 0;
+    /// Preallocates the EffectStates that the audio thread needs to process
+    /// every output of an input channel, before the input is routed to the
+    /// effect. See EffectProcessorImpl::process.
+    virtual void prepareStatesForInputChannel(const ChannelHandle* inputChannel) = 0;
+    /// The input channel is not routed to the effect anymore. Its states are
+    /// deleted by deleteStatesForInputChannel when the engine has released them.
+    virtual void releaseStatesForInputChannel(const ChannelHandle* inputChannel) = 0;
     virtual void deleteStatesForInputChannel(const ChannelHandle* inputChannel) = 0;
 
-    // Called from the audio thread
-    virtual bool loadStatesForInputChannel(const ChannelHandle* inputChannel,
-            const EffectStatesMap* pStatesMap) = 0;
-
     /// Called from the audio thread
     /// This method takes a buffer of audio samples as pInput, processes the buffer
     /// according to effect-specific logic, and outputs it to the buffer pOutput.
@@ -98,11 +119,58 @@ class EffectProcessor {
             const mixxx::EngineParameters& engineParameters,
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) = 0;
+
+    /// Called from the audio thread
+    /// The number of frames the effect keeps producing output with the current
+    /// parameters after its input has become silent, e.g. the decay of a
+    /// reverb or the repeats of an echo. EngineEffectChain stops processing an
+    /// input signal after it has been silent for longer than the tails of all
+    /// effects in the chain.
+    virtual SINT tailFrames(const mixxx::EngineParameters& engineParameters) const {
+        Q_UNUSED(engineParameters);
+        return kUnboundedTailFrames;
+    }
+
+    /// Called from the audio thread
+    /// The number of frames the output of the effect lags behind its input,
+    /// e.g. for effects that process the signal in blocks of a fixed size.
+    /// EngineEffectChain delays the dry signal by the latency of its effects
+    /// to keep it aligned with the wet signal.
+    virtual SINT latencyFrames() const {
+        return 0;
+    }
+
+  protected:
+    /// A conservative tail for the IIR filters and the short delay lines
+    /// that are used by EQs and filters, including low corner frequencies.
+    static SINT filterTailFrames(const mixxx::EngineParameters& engineParameters) {
+        return static_cast<SINT>(kFilterTailSeconds * engineParameters.sampleRate());
+    }
+
+    /// The tail of a feedback loop that takes loopSeconds for one round until
+    /// the signal in the loop has decayed below kSilenceThreshold.
+    static SINT feedbackTailFrames(const mixxx::EngineParameters& engineParameters,
+            double loopSeconds,
+            double feedbackGain) {
+        feedbackGain = std::abs(feedbackGain);
+        if (feedbackGain >= 1.0) {
+            return kUnboundedTailFrames;
+        }
+        double rounds = 1.0;
+        if (feedbackGain > 0.0) {
+            rounds += std::ceil(std::log(kSilenceThreshold) / std::log(feedbackGain));
+        }
+        return static_cast<SINT>(std::ceil(
+                rounds * loopSeconds * engineParameters.sampleRate()));
+    }
+
+  private:
+    static constexpr double kFilterTailSeconds = 0.5;
 };
 
 /// EffectProcessorImpl manages a separate EffectState for every combination of
-/// input channel to output channel. This allows for processing effects in
-/// parallel for PFL and post-fader for the master output.
+/// input channel to output channel that is processed. This allows for processing
+/// effects in parallel for PFL and post-fader for the master output.
 /// EffectSpecificState must be a subclass of EffectState.
 template<typename EffectSpecificState>
 class EffectProcessorImpl : public EffectProcessor {
@@ -119,7 +187,9 @@ class EffectProcessorImpl : public EffectProcessor {
         for (ChannelHandleMap<EffectSpecificState*>& outputsMap : m_channelStateMatrix) {
             int outputChannelHandleNumber = 0;
             for (EffectSpecificState* pState : outputsMap) {
-                VERIFY_OR_DEBUG_ASSERT(pState != nullptr) {
+                if (pState == nullptr) {
+                    // Not processed yet
+                    outputChannelHandleNumber++;
                     continue;
                 }
                 if (kEffectDebugOutput) {
@@ -134,6 +204,19 @@ class EffectProcessorImpl : public EffectProcessor {
             inputChannelHandleNumber++;
         }
         m_channelStateMatrix.clear();
+
+        // The audio thread has released this EffectProcessor, so it is safe
+        // to read the pools from this thread.
+        for (const auto& pPool : std::as_const(m_statePools)) {
+            if (!pPool) {
+                continue;
+            }
+            EffectSpecificState* pState;
+            while (pPool->states.read(&pState, 1) == 1) {
+                delete pState;
+            }
+        }
+        m_statePools.clear();
     };
 
     /// NOTE: Subclasses for Built-In effects must implement the following static methods for
@@ -142,6 +225,10 @@ class EffectProcessorImpl : public EffectProcessor {
     /// static EffectManifestPointer getManifest();
 
     /// This is the only non-static method that subclasses need to implement.
+    /// It is never called for two channels at the same time, because the
+    /// engine only processes channels in parallel that do not share an active
+    /// EngineEffectChain (see EngineEffectChain::isActiveForChannel()). So
+    /// members of the subclass may be written while processing a channel.
     virtual void processChannel(EffectSpecificState* channelState,
             const CSAMPLE* pInput,
             CSAMPLE* pOutput,
@@ -156,103 +243,60 @@ class EffectProcessorImpl : public EffectProcessor {
             const mixxx::EngineParameters& engineParameters,
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) final {
-        EffectSpecificState* pState = m_channelStateMatrix[inputHandle][outputHandle];
-        VERIFY_OR_DEBUG_ASSERT(pState != nullptr) {
-            if (kEffectDebugOutput) {
-                qWarning() << "EffectProcessorImpl::process could not retrieve"
-                              "EffectState for input"
-                           << inputHandle
-                           << "and output" << outputHandle
-                           << "EffectState should have been preallocated in the"
-                              "main thread.";
+        // NOTE: ChannelHandleMap is backed by a QVarLengthArray that is
+        // preallocated for the expected number of channels, so looking up a
+        // new combination of input and output does not allocate memory.
+        EffectSpecificState*& pState = m_channelStateMatrix[inputHandle][outputHandle];
+        if (pState == nullptr) {
+            StatePool* pPool = m_statePools[inputHandle].get();
+            if (!pPool || pPool->states.read(&pState, 1) != 1) {
+                // prepareStatesForInputChannel() fills the pool with a state
+                // for every output before the input is routed to the chain,
+                // so this only happens for an input that is processed without
+                // being prepared. Pass the signal through dry instead of
+                // allocating memory in the audio thread.
+                if (kEffectDebugOutput) {
+                    qWarning() << "EffectProcessorImpl::process no EffectState"
+                                  "available for input"
+                               << inputHandle
+                               << "and output" << outputHandle;
+                }
+                if (pInput != pOutput) {
+                    SampleUtil::copy(pOutput, pInput, engineParameters.samplesPerBuffer());
+                }
+                return;
             }
-            pState = createSpecificState(engineParameters);
-            m_channelStateMatrix[inputHandle][outputHandle] = pState;
+            pPool->statesInUse.fetch_add(1, std::memory_order_relaxed);
         }
         processChannel(pState, pInput, pOutput, engineParameters, enableState, groupFeatures);
     }
 
-    void initialize(const QSet<ChannelHandleAndGroup>& activeInputChannels,
+    void initialize(const QSet<ChannelHandleAndGroup>& registeredInputChannels,
             const QSet<ChannelHandleAndGroup>& registeredOutputChannels,
             const mixxx::EngineParameters& engineParameters) final {
         m_registeredOutputChannels = registeredOutputChannels;
-
-        for (const ChannelHandleAndGroup& inputChannel : activeInputChannels) {
-            if (kEffectDebugOutput) {
-                qDebug() << this << "EffectProcessorImpl::initialize allocating "
-                                    "EffectStates for input"
-                         << inputChannel;
-            }
-            ChannelHandleMap<EffectSpecificState*> outputChannelMap;
-            for (const ChannelHandleAndGroup& outputChannel :
-                    std::as_const(m_registeredOutputChannels)) {
-                outputChannelMap.insert(outputChannel.handle(),
-                        createSpecificState(engineParameters));
-                if (kEffectDebugOutput) {
-                    qDebug() << this << "EffectProcessorImpl::initialize "
-                                        "registering output"
-                             << outputChannel << outputChannelMap[outputChannel.handle()];
-                }
-            }
-            m_channelStateMatrix.insert(inputChannel.handle(), outputChannelMap);
+        m_engineParameters.emplace(engineParameters);
+        for (const ChannelHandleAndGroup& inputChannel : registeredInputChannels) {
+            m_statePools.insert(inputChannel.handle(),
+                    std::make_shared<StatePool>(math_max(1,
+                            static_cast<int>(registeredOutputChannels.size()))));
         }
     };
 
-    EffectState* createState(const mixxx::EngineParameters& engineParameters) final {
-        return createSpecificState(engineParameters);
-    };
-
-    bool loadStatesForInputChannel(const ChannelHandle* inputChannel,
-            const EffectStatesMap* pStatesMap) final {
-        if (kEffectDebugOutput) {
-            qDebug() << "EffectProcessorImpl::loadStatesForInputChannel" << this
-                     << "input" << *inputChannel;
-        }
-
-        // NOTE: ChannelHandleMap is like a map in that it associates an
-        // object with a ChannelHandle key, but it is actually backed by a
-        // QVarLengthArray, not a QMap. So it is okay that
-        // m_channelStateMatrix may be accessed concurrently in the main
-        // thread in deleteStatesForInputChannel.
-
-        // Can't directly cast a ChannelHandleMap from containing the base
-        // EffectState* type to EffectSpecificState* type, so iterate through
-        // pStatesMap to build a new ChannelHandleMap with
-        // dynamic_cast'ed states.
-        ChannelHandleMap<EffectSpecificState*>& effectSpecificStatesMap =
-                m_channelStateMatrix[*inputChannel];
-
-        // deleteStatesForInputChannel should have been called before a new
-        // map of EffectStates was sent to this function, or this is the first
-        // time states are being loaded for this input channel, so
-        // effectSpecificStatesMap should be empty and this loop should
-        // not go through any iterations.
-        for (EffectSpecificState* pState : effectSpecificStatesMap) {
-            VERIFY_OR_DEBUG_ASSERT(pState == nullptr) {
-                delete pState;
-            }
+    void prepareStatesForInputChannel(const ChannelHandle* inputChannel) final {
+        const auto& pPool = m_statePools[*inputChannel];
+        VERIFY_OR_DEBUG_ASSERT(pPool) {
+            return;
         }
+        pPool->prepared = true;
+        fillStatePool(pPool.get());
+    };
 
-        QSet<ChannelHandleAndGroup> receivedOutputChannels = m_registeredOutputChannels;
-        for (const ChannelHandleAndGroup& outputChannel :
-                std::as_const(m_registeredOutputChannels)) {
-            if (kEffectDebugOutput) {
-                qDebug() << "EffectProcessorImpl::loadStatesForInputChannel"
-                         << this << "output" << outputChannel;
-            }
-
-            auto pState = dynamic_cast<EffectSpecificState*>(
-                    pStatesMap->at(outputChannel.handle()));
-            VERIFY_OR_DEBUG_ASSERT(pState != nullptr) {
-                return false;
-            }
-            effectSpecificStatesMap.insert(outputChannel.handle(), pState);
-            receivedOutputChannels.insert(outputChannel);
+    void releaseStatesForInputChannel(const ChannelHandle* inputChannel) final {
+        const auto& pPool = m_statePools[*inputChannel];
+        if (pPool) {
+            pPool->prepared = false;
         }
-        // Output channels are hardcoded in EngineMaster and should not
-        // be registered after Mixxx initializes.
-        DEBUG_ASSERT(receivedOutputChannels == m_registeredOutputChannels);
-        return true;
     };
 
     /// Called from main thread for garbage collection after an input channel is disabled
@@ -264,14 +308,15 @@ class EffectProcessorImpl : public EffectProcessor {
 
         // NOTE: ChannelHandleMap is like a map in that it associates an
         // object with a ChannelHandle key, but it is actually backed by a
-        // QVarLengthArray, not a QMap. So it is okay that
-        // m_channelStateMatrix may be accessed concurrently in the audio
-        // engine thread in loadStatesForInputChannel.
+        // QVarLengthArray, not a QMap. The audio engine thread does not
+        // process the input channel anymore after it has been disabled, so
+        // it is okay that m_channelStateMatrix is modified here.
 
+        const auto& pPool = m_statePools[*inputChannel];
         ChannelHandleMap<EffectSpecificState*>& stateMap =
                 m_channelStateMatrix[*inputChannel];
         for (EffectSpecificState* pState : stateMap) {
-            VERIFY_OR_DEBUG_ASSERT(pState != nullptr) {
+            if (pState == nullptr) {
                 continue;
             }
             if (kEffectDebugOutput) {
@@ -279,8 +324,17 @@ class EffectProcessorImpl : public EffectProcessor {
                          << this << "deleting state" << pState;
             }
             delete pState;
+            if (pPool) {
+                pPool->statesInUse.fetch_sub(1, std::memory_order_relaxed);
+            }
         }
         stateMap.clear();
+
+        // The input has been routed to the chain again before its old
+        // states were deleted, so it needs a new state for every output.
+        if (pPool && pPool->prepared) {
+            fillStatePool(pPool.get());
+        }
     };
 
   protected:
@@ -296,6 +350,46 @@ class EffectProcessorImpl : public EffectProcessor {
     };
 
   private:
+    /// The EffectStates of one input channel that are not in use yet
+    struct StatePool {
+        explicit StatePool(int capacity)
+                : states(capacity),
+                  statesInUse(0),
+                  prepared(false) {
+        }
+
+        // Written in the main thread, read in the audio thread
+        FIFO<EffectSpecificState*> states;
+        // The states that the audio thread has taken from the pool and the
+        // main thread has not deleted yet
+        std::atomic<int> statesInUse;
+        // Only accessed in the main thread
+        bool prepared;
+    };
+
+    /// Called from main thread
+    void fillStatePool(StatePool* pPool) {
+        VERIFY_OR_DEBUG_ASSERT(m_engineParameters) {
+            return;
+        }
+        // Every output either already has a state or gets one from the
+        // pool. The audio thread only moves states from the pool to
+        // statesInUse, so the sum is at most underestimated while it does,
+        // which allocates a spare state that stays in the pool.
+        const auto requiredStates = static_cast<int>(m_registeredOutputChannels.size());
+        while (pPool->states.readAvailable() +
+                        pPool->statesInUse.load(std::memory_order_relaxed) <
+                requiredStates) {
+            EffectSpecificState* pState = createSpecificState(*m_engineParameters);
+            if (pPool->states.write(&pState, 1) != 1) {
+                delete pState;
+                return;
+            }
+        }
+    }
+
     QSet<ChannelHandleAndGroup> m_registeredOutputChannels;
     ChannelHandleMap<ChannelHandleMap<EffectSpecificState*>> m_channelStateMatrix;
+    ChannelHandleMap<std::shared_ptr<StatePool>> m_statePools;
+    std::optional<mixxx::EngineParameters> m_engineParameters;
 };
@@ -1,5 +1,7 @@
 #include "effects/backends/lv2/lv2backend.h"
 
+#include <lv2/buf-size/buf-size.h>
+
 #include "effects/backends/lv2/lv2effectprocessor.h"
 #include "effects/backends/lv2/lv2manifest.h"
 
@@ -39,6 +41,13 @@ void LV2Backend::initializeProperties() {
     m_properties["button_port"] = lilv_new_uri(m_pWorld, LV2_CORE__toggled);
     m_properties["integer_port"] = lilv_new_uri(m_pWorld, LV2_CORE__integer);
     m_properties["enumeration_port"] = lilv_new_uri(m_pWorld, LV2_CORE__enumeration);
+    m_properties["reports_latency"] = lilv_new_uri(m_pWorld, LV2_CORE__reportsLatency);
+    m_properties["fixed_block_length"] =
+            lilv_new_uri(m_pWorld, LV2_BUF_SIZE__fixedBlockLength);
+    m_properties["power_of_2_block_length"] =
+            lilv_new_uri(m_pWorld, LV2_BUF_SIZE__powerOf2BlockLength);
+    m_properties["coarse_block_length"] =
+            lilv_new_uri(m_pWorld, LV2_BUF_SIZE__coarseBlockLength);
 }
 
 const QList<QString> LV2Backend::getEffectIds() const {
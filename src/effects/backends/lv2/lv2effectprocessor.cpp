@@ -1,17 +1,183 @@
 #include "effects/backends/lv2/lv2effectprocessor.h"
 
+#include <QMutex>
+#include <lv2/buf-size/buf-size.h>
+
 #include "util/defs.h"
+#include "util/math.h"
 #include "util/sample.h"
 
+namespace {
+
+// The block size guarantees of the host, see LV2Manifest. The plugins are
+// never run with partial blocks, so the block length is coarse in any case.
+const LV2_Feature kFixedBlockLengthFeature = {LV2_BUF_SIZE__fixedBlockLength, nullptr};
+const LV2_Feature kPowerOf2BlockLengthFeature = {LV2_BUF_SIZE__powerOf2BlockLength, nullptr};
+const LV2_Feature kCoarseBlockLengthFeature = {LV2_BUF_SIZE__coarseBlockLength, nullptr};
+
+const LV2_Feature* const kFixedBlockFeatures[] = {
+        &kFixedBlockLengthFeature,
+        &kPowerOf2BlockLengthFeature,
+        &kCoarseBlockLengthFeature,
+        nullptr};
+const LV2_Feature* const kEngineBufferFeatures[] = {
+        &kCoarseBlockLengthFeature,
+        nullptr};
+
+static_assert((LV2EffectProcessor::kFixedBlockFrames &
+                      (LV2EffectProcessor::kFixedBlockFrames - 1)) == 0,
+        "The fixed block size must be a power of 2");
+
+// Lilv is not thread-safe. Plugins are instantiated in the main thread and in
+// the thread that prepares chain presets.
+QMutex s_lilvInstanceMutex;
+
+} // anonymous namespace
+
+LV2EffectGroupState::LV2EffectGroupState(
+        const mixxx::EngineParameters& engineParameters,
+        SINT blockFrames)
+        : EffectState(engineParameters),
+          m_pInstance(nullptr),
+          m_blockFrames(blockFrames),
+          m_inputL(blockFrames > 0 ? blockFrames : MAX_BUFFER_LEN / mixxx::kEngineChannelCount),
+          m_inputR(m_inputL.size()),
+          m_outputL(m_inputL.size()),
+          m_outputR(m_inputL.size()),
+          m_blockPosition(0),
+          m_reportsLatency(false),
+          m_pluginLatency(0) {
+}
+
+LV2EffectGroupState::~LV2EffectGroupState() {
+    if (m_pInstance) {
+        lilv_instance_deactivate(m_pInstance);
+        QMutexLocker locker(&s_lilvInstanceMutex);
+        lilv_instance_free(m_pInstance);
+    }
+}
+
+LilvInstance* LV2EffectGroupState::instantiate(const LilvPlugin* pPlugin,
+        const mixxx::EngineParameters& engineParameters,
+        const LV2_Feature* const* pFeatures,
+        const QList<int>& audioPortIndices,
+        int latencyPortIndex) {
+    DEBUG_ASSERT(!m_pInstance);
+    {
+        QMutexLocker locker(&s_lilvInstanceMutex);
+        m_pInstance = lilv_plugin_instantiate(
+                pPlugin, engineParameters.sampleRate(), pFeatures);
+    }
+    if (!m_pInstance) {
+        return nullptr;
+    }
+
+    // We assume the audio ports are in the following order:
+    // input_left, input_right, output_left, output_right
+    lilv_instance_connect_port(m_pInstance, audioPortIndices[0], m_inputL.data());
+    lilv_instance_connect_port(m_pInstance, audioPortIndices[1], m_inputR.data());
+    lilv_instance_connect_port(m_pInstance, audioPortIndices[2], m_outputL.data());
+    lilv_instance_connect_port(m_pInstance, audioPortIndices[3], m_outputR.data());
+
+    if (latencyPortIndex >= 0) {
+        lilv_instance_connect_port(m_pInstance, latencyPortIndex, &m_pluginLatency);
+        m_reportsLatency = true;
+    }
+    return m_pInstance;
+}
+
+void LV2EffectGroupState::activate() {
+    // Start with an empty FIFO, so the latency is exactly one block
+    m_blockPosition = 0;
+    m_outputL.clear();
+    m_outputR.clear();
+    lilv_instance_activate(m_pInstance);
+}
+
+void LV2EffectGroupState::deactivate() {
+    lilv_instance_deactivate(m_pInstance);
+}
+
+void LV2EffectGroupState::run(
+        const CSAMPLE* pInput, CSAMPLE* pOutput, SINT framesPerBuffer) {
+    if (m_blockFrames > 0) {
+        runBlocks(pInput, pOutput, framesPerBuffer);
+        return;
+    }
+
+    CSAMPLE* pInputL = m_inputL.data();
+    CSAMPLE* pInputR = m_inputR.data();
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < framesPerBuffer; ++i) {
+        pInputL[i] = pInput[i * 2];
+        pInputR[i] = pInput[i * 2 + 1];
+    }
+
+    lilv_instance_run(m_pInstance, framesPerBuffer);
+
+    const CSAMPLE* pOutputL = m_outputL.data();
+    const CSAMPLE* pOutputR = m_outputR.data();
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < framesPerBuffer; ++i) {
+        pOutput[i * 2] = pOutputL[i];
+        pOutput[i * 2 + 1] = pOutputR[i];
+    }
+}
+
+void LV2EffectGroupState::runBlocks(
+        const CSAMPLE* pInput, CSAMPLE* pOutput, SINT framesPerBuffer) {
+    SINT frame = 0;
+    while (frame < framesPerBuffer) {
+        const SINT frames = math_min(
+                m_blockFrames - m_blockPosition, framesPerBuffer - frame);
+        const CSAMPLE* pIn = pInput + frame * 2;
+        CSAMPLE* pOut = pOutput + frame * 2;
+
+        // The output at a position of the block is the output of the
+        // previous block for the input at the same position.
+        CSAMPLE* pInputL = m_inputL.data(m_blockPosition);
+        CSAMPLE* pInputR = m_inputR.data(m_blockPosition);
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < frames; ++i) {
+            pInputL[i] = pIn[i * 2];
+            pInputR[i] = pIn[i * 2 + 1];
+        }
+        const CSAMPLE* pOutputL = m_outputL.data(m_blockPosition);
+        const CSAMPLE* pOutputR = m_outputR.data(m_blockPosition);
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < frames; ++i) {
+            pOut[i * 2] = pOutputL[i];
+            pOut[i * 2 + 1] = pOutputR[i];
+        }
+
+        m_blockPosition += frames;
+        frame += frames;
+        if (m_blockPosition == m_blockFrames) {
+            lilv_instance_run(m_pInstance, m_blockFrames);
+            m_blockPosition = 0;
+        }
+    }
+}
+
+SINT LV2EffectGroupState::latencyFrames() const {
+    SINT latencyFrames = m_blockFrames;
+    // The value is only valid after the plugin has been run. It is
+    // 0 until then, which is the best guess anyway.
+    if (m_reportsLatency && m_pluginLatency > 0) {
+        latencyFrames += static_cast<SINT>(std::lround(m_pluginLatency));
+    }
+    return latencyFrames;
+}
+
 LV2EffectProcessor::LV2EffectProcessor(LV2EffectManifestPointer pManifest)
         : m_pManifest(pManifest),
+          m_LV2parameters(nullptr),
           m_pPlugin(pManifest->getPlugin()),
           m_audioPortIndices(pManifest->getAudioPortIndices()),
-          m_controlPortIndices(pManifest->getControlPortIndices()) {
-    m_inputL = new float[MAX_BUFFER_LEN];
-    m_inputR = new float[MAX_BUFFER_LEN];
-    m_outputL = new float[MAX_BUFFER_LEN];
-    m_outputR = new float[MAX_BUFFER_LEN];
+          m_controlPortIndices(pManifest->getControlPortIndices()),
+          m_latencyPortIndex(pManifest->getLatencyPortIndex()),
+          m_blockFrames(pManifest->hasFixedBlockLength() ? kFixedBlockFrames : 0),
+          m_latencyFrames(m_blockFrames) {
 }
 
 void LV2EffectProcessor::loadEngineEffectParameters(
@@ -31,10 +197,6 @@ void LV2EffectProcessor::loadEngineEffectParameters(
 }
 
 LV2EffectProcessor::~LV2EffectProcessor() {
-    delete[] m_inputL;
-    delete[] m_inputR;
-    delete[] m_outputL;
-    delete[] m_outputR;
     delete[] m_LV2parameters;
 }
 
@@ -47,40 +209,35 @@ void LV2EffectProcessor::processChannel(
         const GroupFeatureState& groupFeatures) {
     Q_UNUSED(groupFeatures);
 
-    for (int i = 0; i < m_engineEffectParameters.size(); i++) {
-        m_LV2parameters[i] = static_cast<float>(m_engineEffectParameters[i]->value());
+    if (!channelState->lilvInstance()) {
+        SampleUtil::copy(pOutput, pInput, engineParameters.samplesPerBuffer());
+        return;
     }
 
-    SINT framesPerBuffer = engineParameters.framesPerBuffer();
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < framesPerBuffer; ++i) {
-        m_inputL[i] = pInput[i * 2];
-        m_inputR[i] = pInput[i * 2 + 1];
+    for (int i = 0; i < m_engineEffectParameters.size(); i++) {
+        m_LV2parameters[i] = static_cast<float>(m_engineEffectParameters[i]->value());
     }
 
-    LilvInstance* instance = channelState->lilvInstance(m_pPlugin, engineParameters);
-
     if (enableState == EffectEnableState::Enabling) {
-        lilv_instance_activate(instance);
+        channelState->activate();
     }
 
-    lilv_instance_run(instance, framesPerBuffer);
-
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < framesPerBuffer; ++i) {
-        pOutput[i * 2] = m_outputL[i];
-        pOutput[i * 2 + 1] = m_outputR[i];
-    }
+    channelState->run(pInput, pOutput, engineParameters.framesPerBuffer());
+    m_latencyFrames = channelState->latencyFrames();
 
     if (enableState == EffectEnableState::Disabling) {
-        lilv_instance_deactivate(instance);
+        channelState->deactivate();
     }
 }
 
 LV2EffectGroupState* LV2EffectProcessor::createSpecificState(
         const mixxx::EngineParameters& engineParameters) {
-    LV2EffectGroupState* pState = new LV2EffectGroupState(engineParameters);
-    LilvInstance* pInstance = pState->lilvInstance(m_pPlugin, engineParameters);
+    LV2EffectGroupState* pState = new LV2EffectGroupState(engineParameters, m_blockFrames);
+    LilvInstance* pInstance = pState->instantiate(m_pPlugin,
+            engineParameters,
+            m_blockFrames > 0 ? kFixedBlockFeatures : kEngineBufferFeatures,
+            m_audioPortIndices,
+            m_latencyPortIndex);
     VERIFY_OR_DEBUG_ASSERT(pInstance) {
         return pState;
     }
@@ -89,20 +246,11 @@ LV2EffectGroupState* LV2EffectProcessor::createSpecificState(
         qDebug() << this << "LV2EffectProcessor creating LV2EffectGroupState" << pState;
     }
 
-    if (pInstance) {
-        for (int i = 0; i < m_engineEffectParameters.size(); i++) {
-            m_LV2parameters[i] = static_cast<float>(m_engineEffectParameters[i]->value());
-            lilv_instance_connect_port(pInstance,
-                    m_controlPortIndices[i],
-                    &m_LV2parameters[i]);
-        }
-
-        // We assume the audio ports are in the following order:
-        // input_left, input_right, output_left, output_right
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[0], m_inputL);
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[1], m_inputR);
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[2], m_outputL);
-        lilv_instance_connect_port(pInstance, m_audioPortIndices[3], m_outputR);
+    for (int i = 0; i < m_engineEffectParameters.size(); i++) {
+        m_LV2parameters[i] = static_cast<float>(m_engineEffectParameters[i]->value());
+        lilv_instance_connect_port(pInstance,
+                m_controlPortIndices[i],
+                &m_LV2parameters[i]);
     }
     return pState;
 };
@@ -7,36 +7,64 @@
 #include "effects/defs.h"
 #include "engine/effects/engineeffectparameter.h"
 #include "engine/engine.h"
+#include "util/samplebuffer.h"
 
 // Refer to EffectProcessor for documentation
 class LV2EffectGroupState final : public EffectState {
   public:
-    LV2EffectGroupState(const mixxx::EngineParameters& engineParameters)
-            : EffectState(engineParameters),
-              m_pInstance(nullptr) {
-    }
-    ~LV2EffectGroupState() {
-        if (m_pInstance) {
-            lilv_instance_deactivate(m_pInstance);
-            lilv_instance_free(m_pInstance);
-        }
-    }
+    /// The plugin is run with every engine buffer if blockFrames is 0,
+    /// otherwise always with blocks of blockFrames frames.
+    LV2EffectGroupState(const mixxx::EngineParameters& engineParameters,
+            SINT blockFrames);
+    ~LV2EffectGroupState();
+
+    /// Creates the plugin instance and connects its audio ports and its
+    /// latency port, if any, to the buffers of this state.
+    LilvInstance* instantiate(const LilvPlugin* pPlugin,
+            const mixxx::EngineParameters& engineParameters,
+            const LV2_Feature* const* pFeatures,
+            const QList<int>& audioPortIndices,
+            int latencyPortIndex);
 
-    LilvInstance* lilvInstance(const LilvPlugin* pPlugin,
-            const mixxx::EngineParameters& engineParameters) {
-        if (!m_pInstance) {
-            m_pInstance = lilv_plugin_instantiate(
-                    pPlugin, engineParameters.sampleRate(), nullptr);
-        }
+    LilvInstance* lilvInstance() const {
         return m_pInstance;
     }
 
+    void activate();
+    void deactivate();
+
+    /// Runs the plugin for the interleaved stereo samples of pInput
+    void run(const CSAMPLE* pInput, CSAMPLE* pOutput, SINT framesPerBuffer);
+
+    /// The latency reported by the plugin plus the block of the FIFO
+    SINT latencyFrames() const;
+
   private:
+    void runBlocks(const CSAMPLE* pInput, CSAMPLE* pOutput, SINT framesPerBuffer);
+
     LilvInstance* m_pInstance;
+    const SINT m_blockFrames;
+    // Planar buffers, which stay connected to the audio ports of the plugin.
+    // With a fixed block size, they hold the current block and the output of
+    // the previous block, which adds one block of latency.
+    mixxx::SampleBuffer m_inputL;
+    mixxx::SampleBuffer m_inputR;
+    mixxx::SampleBuffer m_outputL;
+    mixxx::SampleBuffer m_outputR;
+    // The number of frames of the current block that have been filled
+    SINT m_blockPosition;
+    bool m_reportsLatency;
+    // Written by the plugin
+    float m_pluginLatency;
 };
 
 class LV2EffectProcessor final : public EffectProcessorImpl<LV2EffectGroupState> {
   public:
+    /// The block size for plugins with a fixed block length.
+    /// Blocks of this size are processed efficiently by most plugins and
+    /// add only a small latency.
+    static constexpr SINT kFixedBlockFrames = 512;
+
     LV2EffectProcessor(LV2EffectManifestPointer pManifest);
     ~LV2EffectProcessor();
 
@@ -51,18 +79,25 @@ class LV2EffectProcessor final : public EffectProcessorImpl<LV2EffectGroupState>
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) override;
 
+    SINT latencyFrames() const override {
+        return m_latencyFrames;
+    }
+
   private:
     LV2EffectGroupState* createSpecificState(
             const mixxx::EngineParameters& engineParameters) override;
 
     LV2EffectManifestPointer m_pManifest;
     QList<EngineEffectParameterPointer> m_engineEffectParameters;
-    float* m_inputL;
-    float* m_inputR;
-    float* m_outputL;
-    float* m_outputR;
     float* m_LV2parameters;
     const LilvPlugin* m_pPlugin;
     const QList<int> m_audioPortIndices;
     const QList<int> m_controlPortIndices;
+    const int m_latencyPortIndex;
+    const SINT m_blockFrames;
+    // The latency of the last processed channel. It is the same for all
+    // channels unless the plugin changes it while processing. Like the
+    // control port values in m_LV2parameters it is written by
+    // processChannel(), which is never called for two channels at once.
+    SINT m_latencyFrames;
 };
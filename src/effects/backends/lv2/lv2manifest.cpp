@@ -9,6 +9,8 @@ LV2Manifest::LV2Manifest(const LilvPlugin* plug,
           m_minimum(lilv_plugin_get_num_ports(plug)),
           m_maximum(lilv_plugin_get_num_ports(plug)),
           m_default(lilv_plugin_get_num_ports(plug)),
+          m_latencyPortIndex(-1),
+          m_fixedBlockLength(false),
           m_status(AVAILABLE) {
     m_pLV2plugin = plug;
 
@@ -47,6 +49,15 @@ LV2Manifest::LV2Manifest(const LilvPlugin* plug,
             }
         }
 
+        // The latency is not a parameter, LV2EffectProcessor reports it to
+        // the effect chain instead.
+        if (lilv_port_is_a(m_pLV2plugin, port, properties["control_port"]) &&
+                lilv_port_is_a(m_pLV2plugin, port, properties["output_port"]) &&
+                lilv_port_has_property(m_pLV2plugin, port, properties["reports_latency"])) {
+            m_latencyPortIndex = i;
+            continue;
+        }
+
         if (lilv_port_is_a(m_pLV2plugin, port, properties["control_port"]) &&
                 !lilv_port_has_property(
                         m_pLV2plugin, port, properties["enumeration_port"]) &&
@@ -94,6 +105,9 @@ LV2Manifest::LV2Manifest(const LilvPlugin* plug,
     for (int i = 0; i < numPorts; i++) {
         const LilvPort* port = lilv_plugin_get_port_by_index(plug, i);
 
+        if (i == m_latencyPortIndex) {
+            continue;
+        }
         if (lilv_port_is_a(m_pLV2plugin, port, properties["control_port"]) &&
                 (lilv_port_has_property(m_pLV2plugin, port, properties["enumeration_port"]) ||
                         lilv_port_has_property(m_pLV2plugin, port, properties["button_port"]))) {
@@ -146,12 +160,22 @@ LV2Manifest::LV2Manifest(const LilvPlugin* plug,
         m_status = IO_NOT_STEREO;
     }
 
-    // We don't support any features
+    // The only features we support are the guarantees about the block size,
+    // see LV2EffectProcessor
     LilvNodes* features = lilv_plugin_get_required_features(m_pLV2plugin);
-    if (lilv_nodes_size(features) > 0) {
-        m_status = HAS_REQUIRED_FEATURES;
+    LILV_FOREACH(nodes, iterator, features) {
+        const LilvNode* feature = lilv_nodes_get(features, iterator);
+        if (!lilv_node_equals(feature, properties["fixed_block_length"]) &&
+                !lilv_node_equals(feature, properties["power_of_2_block_length"]) &&
+                !lilv_node_equals(feature, properties["coarse_block_length"])) {
+            m_status = HAS_REQUIRED_FEATURES;
+        }
     }
     lilv_nodes_free(features);
+
+    m_fixedBlockLength =
+            lilv_plugin_has_feature(m_pLV2plugin, properties["fixed_block_length"]) ||
+            lilv_plugin_has_feature(m_pLV2plugin, properties["power_of_2_block_length"]);
 }
 
 QList<int> LV2Manifest::getAudioPortIndices() {
@@ -162,6 +186,14 @@ QList<int> LV2Manifest::getControlPortIndices() {
     return controlPortIndices;
 }
 
+int LV2Manifest::getLatencyPortIndex() const {
+    return m_latencyPortIndex;
+}
+
+bool LV2Manifest::hasFixedBlockLength() const {
+    return m_fixedBlockLength;
+}
+
 const LilvPlugin* LV2Manifest::getPlugin() {
     return m_pLV2plugin;
 }
@@ -21,6 +21,12 @@ class LV2Manifest : public EffectManifest {
 
     QList<int> getAudioPortIndices();
     QList<int> getControlPortIndices();
+    /// The index of the control output port that reports the latency of
+    /// the plugin in frames, -1 if the plugin has no latency.
+    int getLatencyPortIndex() const;
+    /// True if the plugin wants to be run with blocks of a fixed size,
+    /// which usually means that it processes larger blocks more efficiently
+    bool hasFixedBlockLength() const;
     const LilvPlugin* getPlugin();
     bool isValid();
     Status getStatus();
@@ -38,6 +44,8 @@ class LV2Manifest : public EffectManifest {
     QList<int> audioPortIndices;
     // This list contains the control port indices
     QList<int> controlPortIndices;
+    int m_latencyPortIndex;
+    bool m_fixedBlockLength;
 
     // Arrays used for storing minimum, maximum and default parameter values
     std::vector<float> m_minimum;
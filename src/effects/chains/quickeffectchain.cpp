@@ -47,11 +47,8 @@ EffectChainPresetPointer QuickEffectChain::presetAtIndex(int index) const {
     return m_pChainPresetManager->quickEffectPresetAtIndex(index);
 }
 
-void QuickEffectChain::loadChainPreset(EffectChainPresetPointer pPreset) {
-    EffectChain::loadChainPreset(pPreset);
-    if (pPreset) {
-        setSuperParameter(pPreset->superKnob(), true);
-    }
+void QuickEffectChain::chainPresetLoaded(EffectChainPresetPointer pPreset) {
+    setSuperParameter(pPreset->superKnob(), true);
 }
 
 int QuickEffectChain::numPresets() const {
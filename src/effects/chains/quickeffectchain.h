@@ -20,6 +20,8 @@ class QuickEffectChain : public PerGroupEffectChain {
     int presetIndex() const override;
     EffectChainPresetPointer presetAtIndex(int index) const override;
 
-    void loadChainPreset(EffectChainPresetPointer pPreset) override;
     int numPresets() const override;
+
+  protected:
+    void chainPresetLoaded(EffectChainPresetPointer pPreset) override;
 };
@@ -63,10 +63,6 @@ typedef QSharedPointer<EffectPresetManager> EffectPresetManagerPointer;
 class EffectChainPresetManager;
 typedef QSharedPointer<EffectChainPresetManager> EffectChainPresetManagerPointer;
 
-class EffectState;
-// For sending EffectStates along the MessagePipe
-typedef ChannelHandleMap<EffectState*> EffectStatesMap;
-typedef std::array<EffectStatesMap, kNumEffectsPerUnit> EffectStatesMapArray;
 
 class EngineEffectParameter;
 typedef QSharedPointer<EngineEffectParameter> EngineEffectParameterPointer;
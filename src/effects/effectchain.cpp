@@ -1,5 +1,8 @@
 #include "effects/effectchain.h"
 
+#include <QtConcurrentRun>
+#include <utility>
+
 #include "control/controlencoder.h"
 #include "control/controlpotmeter.h"
 #include "control/controlpushbutton.h"
@@ -7,6 +10,7 @@
 #include "effects/effectsmanager.h"
 #include "effects/effectsmessenger.h"
 #include "effects/presets/effectchainpresetmanager.h"
+#include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectchain.h"
 #include "engine/engine.h"
 #include "mixer/playermanager.h"
@@ -16,6 +20,32 @@
 #include "util/sample.h"
 #include "util/xml.h"
 
+struct EffectChain::PreparedPreset {
+    struct Effect {
+        EffectManifestPointer pManifest;
+        EffectPresetPointer pPreset;
+        // Owned until it is loaded into an EffectSlot
+        EngineEffect* pEngineEffect;
+    };
+
+    explicit PreparedPreset(EffectChainPresetPointer pChainPreset)
+            : pChainPreset(pChainPreset) {
+    }
+
+    ~PreparedPreset() {
+        // The EngineEffects of a discarded preset have never been added to
+        // the engine.
+        for (const auto& effect : std::as_const(effects)) {
+            delete effect.pEngineEffect;
+        }
+    }
+
+    EffectChainPresetPointer pChainPreset;
+    QList<Effect> effects;
+
+    DISALLOW_COPY_AND_ASSIGN(PreparedPreset);
+};
+
 EffectChain::EffectChain(const QString& group,
         EffectsManager* pEffectsManager,
         EffectsMessengerPointer pEffectsMessenger,
@@ -156,6 +186,10 @@ EffectChain::EffectChain(const QString& group,
 }
 
 EffectChain::~EffectChain() {
+    // The preparation thread uses the pending EngineEffects
+    for (auto* pWatcher : std::as_const(m_presetPreparations)) {
+        pWatcher->waitForFinished();
+    }
     m_effectSlots.clear();
     removeFromEngine();
 }
@@ -201,17 +235,132 @@ const QString& EffectChain::presetName() const {
 }
 
 void EffectChain::loadChainPreset(EffectChainPresetPointer pPreset) {
-    slotControlClear(1);
     VERIFY_OR_DEBUG_ASSERT(pPreset) {
+        slotControlClear(1);
         return;
     }
 
-    int effectSlotIndex = 0;
+    // Allocating the EffectStates, which includes the instantiation of LV2
+    // plugins, would stall the GUI, so this is done in a worker thread. The
+    // processors are created here, because some of them create QObjects.
+    PreparedPresetPointer pPrepared = createEngineEffects(pPreset);
+    m_pPendingPreset = pPrepared;
+
+    auto* pWatcher = new QFutureWatcher<void>(this);
+    m_presetPreparations.append(pWatcher);
+    // The EngineEffects are owned by the PreparedPreset in the main thread, so
+    // they are never deleted in the worker thread.
+    connect(pWatcher,
+            &QFutureWatcher<void>::finished,
+            this,
+            [this, pWatcher, pPrepared] {
+                m_presetPreparations.removeOne(pWatcher);
+                pWatcher->deleteLater();
+                // A preset that has been loaded later discards this one
+                if (m_pPendingPreset != pPrepared) {
+                    return;
+                }
+                m_pPendingPreset.reset();
+                loadPreparedPreset(pPrepared);
+            });
+    pWatcher->setFuture(QtConcurrent::run(
+            m_pEffectsManager->getPresetPreparationThread(),
+            [pPrepared = pPrepared.get(), activeChannels = m_enabledInputChannels] {
+                preparePreset(pPrepared, activeChannels);
+            }));
+}
+
+EffectChain::PreparedPresetPointer EffectChain::createEngineEffects(
+        EffectChainPresetPointer pPreset) const {
+    const EffectsBackendManagerPointer pBackendManager =
+            m_pEffectsManager->getBackendManager();
+    auto pPrepared = std::make_shared<PreparedPreset>(pPreset);
     for (const auto& pEffectPreset : pPreset->effectPresets()) {
-        EffectSlotPointer pEffectSlot = m_effectSlots.at(effectSlotIndex);
-        pEffectSlot->loadEffectFromPreset(pEffectPreset);
-        effectSlotIndex++;
+        PreparedPreset::Effect effect{EffectManifestPointer(), EffectPresetPointer(), nullptr};
+        if (pEffectPreset && !pEffectPreset->isEmpty()) {
+            effect.pManifest = pBackendManager->getManifest(
+                    pEffectPreset->id(), pEffectPreset->backendType());
+        }
+        if (effect.pManifest) {
+            effect.pPreset = pEffectPreset;
+            effect.pEngineEffect = new EngineEffect(effect.pManifest,
+                    pBackendManager,
+                    m_pEffectsManager->registeredInputChannels(),
+                    m_pEffectsManager->registeredOutputChannels());
+        }
+        pPrepared->effects.append(effect);
     }
+    return pPrepared;
+}
+
+// static
+void EffectChain::preparePreset(PreparedPreset* pPrepared,
+        const QSet<ChannelHandleAndGroup>& activeChannels) {
+    for (const auto& effect : std::as_const(pPrepared->effects)) {
+        if (!effect.pEngineEffect) {
+            continue;
+        }
+        // EffectSlot prepares the states for the channels that have been
+        // routed to the chain in the meantime when the effect is loaded.
+        for (const auto& inputChannel : activeChannels) {
+            effect.pEngineEffect->prepareStatesForInputChannel(&inputChannel.handle());
+        }
+        // The EffectParameters set the same values again when the effect
+        // is loaded, but the engine must never see the default values.
+        for (const auto& pManifestParameter : effect.pManifest->parameters()) {
+            for (const auto& parameterPreset : effect.pPreset->getParameterPresets()) {
+                if (parameterPreset.isNull() ||
+                        parameterPreset.id() != pManifestParameter->id()) {
+                    continue;
+                }
+                effect.pEngineEffect->setParameter(pManifestParameter->index(),
+                        math_clamp(parameterPreset.value(),
+                                pManifestParameter->getMinimum(),
+                                pManifestParameter->getMaximum()));
+                break;
+            }
+        }
+    }
+}
+
+void EffectChain::loadPreparedPreset(const PreparedPresetPointer& pPrepared) {
+    const EffectChainPresetPointer pPreset = pPrepared->pChainPreset;
+
+    // Load the EngineEffects into the slots without sending any request and
+    // replace all effects of the EngineEffectChain at once afterwards. The
+    // engine swaps the array with the current effects, which are deleted
+    // in the main thread with the request.
+    const int numEffects = m_effectSlots.size();
+    VERIFY_OR_DEBUG_ASSERT(pPrepared->effects.size() <= numEffects) {
+        qWarning() << debugString() << "chain preset" << pPreset->name()
+                   << "has more effects than effect slots";
+    }
+    EngineEffect** pEffects = new EngineEffect*[numEffects];
+    for (int i = 0; i < numEffects; ++i) {
+        PreparedPreset::Effect effect{EffectManifestPointer(), EffectPresetPointer(), nullptr};
+        if (i < pPrepared->effects.size()) {
+            std::swap(effect, pPrepared->effects[i]);
+        }
+        EngineEffect* pReplacedEffect = m_effectSlots.at(i)->loadPreparedEffect(
+                effect.pManifest, effect.pPreset, effect.pEngineEffect);
+        VERIFY_OR_DEBUG_ASSERT(!pReplacedEffect || pReplacedEffect->isAddedToEngine()) {
+            delete pReplacedEffect;
+        }
+        pEffects[i] = effect.pEngineEffect;
+    }
+    // Requests for the new effects must not be sent before they are added
+    for (int i = 0; i < numEffects; ++i) {
+        if (pEffects[i]) {
+            pEffects[i]->setAddedToEngine();
+        }
+    }
+
+    EffectsRequest* pRequest = new EffectsRequest();
+    pRequest->type = EffectsRequest::REPLACE_EFFECTS_IN_CHAIN;
+    pRequest->pTargetChain = m_pEngineEffectChain;
+    pRequest->ReplaceEffectsInChain.pEffects = pEffects;
+    pRequest->ReplaceEffectsInChain.iNumEffects = numEffects;
+    m_pMessenger->writeRequest(pRequest);
 
     setMixMode(pPreset->mixMode());
     m_pControlChainSuperParameter->setDefaultValue(pPreset->superKnob());
@@ -220,6 +369,8 @@ void EffectChain::loadChainPreset(EffectChainPresetPointer pPreset) {
     emit chainPresetChanged(m_presetName);
 
     setControlLoadedPresetIndex(presetIndex());
+
+    chainPresetLoaded(pPreset);
 }
 
 void EffectChain::sendParameterUpdate() {
@@ -396,24 +547,13 @@ void EffectChain::enableForInputChannel(const ChannelHandleAndGroup& handleGroup
     request->pTargetChain = m_pEngineEffectChain;
     request->EnableInputChannelForChain.pChannelHandle = &handleGroup.handle();
 
-    // Allocate EffectStates here in the main thread to avoid allocating
-    // memory in the realtime audio callback thread. Pointers to the
-    // EffectStates are passed to the EffectRequest and the EffectProcessorImpls
-    // store the pointers. The containers of EffectState* pointers get deleted
-    // by ~EffectsRequest, but the EffectStates are managed by EffectProcessorImpl.
-
-    // The EffectStates for one EngineEffectChain must be sent all together in
-    // the same message using an EffectStatesMapArray. If they were separated
-    // into a message for each effect, there would be a chance that the
-    // EngineEffectChain could get activated in one cycle of the audio callback
-    // thread but the EffectStates for an EngineEffect would not be received by
-    // EngineEffectsManager until the next audio callback cycle.
-
-    auto* pEffectStatesMapArray = new EffectStatesMapArray;
-    for (int i = 0; i < m_effectSlots.size(); ++i) {
-        m_effectSlots[i]->fillEffectStatesMap(&(*pEffectStatesMapArray)[i]);
+    // The EffectProcessorImpls take the EffectStates for the channel from a
+    // pool when they start processing it. Fill the pools here in the main
+    // thread before the request is sent to avoid allocating memory in the
+    // realtime audio callback thread.
+    for (const auto& pEffectSlot : std::as_const(m_effectSlots)) {
+        pEffectSlot->prepareStatesForInputChannel(&handleGroup.handle());
     }
-    request->EnableInputChannelForChain.pEffectStatesMapArray = pEffectStatesMapArray;
 
     m_pMessenger->writeRequest(request);
 
@@ -425,6 +565,10 @@ void EffectChain::disableForInputChannel(const ChannelHandleAndGroup& handleGrou
         return;
     }
 
+    for (const auto& pEffectSlot : std::as_const(m_effectSlots)) {
+        pEffectSlot->releaseStatesForInputChannel(&handleGroup.handle());
+    }
+
     EffectsRequest* request = new EffectsRequest();
     request->type = EffectsRequest::DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
     request->pTargetChain = m_pEngineEffectChain;
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <QDomDocument>
+#include <QFutureWatcher>
 #include <QList>
 #include <QMap>
 #include <QObject>
 #include <QSignalMapper>
+#include <memory>
 
 #include "control/controlobject.h"
 #include "effects/defs.h"
@@ -19,6 +21,7 @@ class ControlEncoder;
 class EffectChain;
 class EffectsManager;
 class EffectProcessor;
+class EngineEffect;
 class EngineEffectChain;
 
 /// EffectChain is the main thread representation of an effect chain.
@@ -76,7 +79,10 @@ class EffectChain : public QObject {
         return m_effectSlots;
     }
 
-    virtual void loadChainPreset(EffectChainPresetPointer pPreset);
+    /// Creates the EngineEffects of the preset, prepares them in a worker
+    /// thread and loads them afterwards. Loading another preset before
+    /// discards the result.
+    void loadChainPreset(EffectChainPresetPointer pPreset);
 
   public slots:
     void slotControlClear(double value);
@@ -93,6 +99,11 @@ class EffectChain : public QObject {
 
     virtual int numPresets() const;
 
+    /// Called after a chain preset has been loaded into the effect slots
+    virtual void chainPresetLoaded(EffectChainPresetPointer pPreset) {
+        Q_UNUSED(pPreset);
+    }
+
     // Activates EffectChain processing for the provided channel.
     void enableForInputChannel(const ChannelHandleAndGroup& handleGroup);
     void disableForInputChannel(const ChannelHandleAndGroup& handleGroup);
@@ -127,6 +138,18 @@ class EffectChain : public QObject {
         return QString("EffectChain(%1)").arg(m_group);
     }
 
+    /// The EngineEffects for the effects of a chain preset. They are created
+    /// in the main thread, because processors may create QObjects, and
+    /// configured in a worker thread.
+    struct PreparedPreset;
+    typedef std::shared_ptr<PreparedPreset> PreparedPresetPointer;
+
+    PreparedPresetPointer createEngineEffects(EffectChainPresetPointer pPreset) const;
+    /// Called in the preset preparation thread
+    static void preparePreset(PreparedPreset* pPrepared,
+            const QSet<ChannelHandleAndGroup>& activeChannels);
+    void loadPreparedPreset(const PreparedPresetPointer& pPrepared);
+
     void addToEngine();
     void removeFromEngine();
 
@@ -158,6 +181,9 @@ class EffectChain : public QObject {
     QHash<ChannelHandleAndGroup, std::shared_ptr<ControlPushButton>> m_channelEnableButtons;
     QSet<ChannelHandleAndGroup> m_enabledInputChannels;
     EngineEffectChain* m_pEngineEffectChain;
+    // The most recently requested chain preset until it has been prepared
+    PreparedPresetPointer m_pPendingPreset;
+    QList<QFutureWatcher<void>*> m_presetPreparations;
 
     DISALLOW_COPY_AND_ASSIGN(EffectChain);
 };
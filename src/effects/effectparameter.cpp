@@ -2,15 +2,13 @@
 
 #include <QtDebug>
 
-#include "effects/effectsmessenger.h"
+#include "engine/effects/engineeffect.h"
 #include "util/assert.h"
 
 EffectParameter::EffectParameter(EngineEffect* pEngineEffect,
-        EffectsMessengerPointer pEffectsMessenger,
         EffectManifestParameterPointer pParameterManifest,
         const EffectParameterPreset& preset)
         : m_pEngineEffect(pEngineEffect),
-          m_pMessenger(pEffectsMessenger),
           m_pParameterManifest(pParameterManifest) {
     if (preset.isNull()) {
         setValue(pParameterManifest->getDefault());
@@ -68,10 +66,6 @@ void EffectParameter::updateEngineState() {
     if (!m_pEngineEffect) {
         return;
     }
-    EffectsRequest* pRequest = new EffectsRequest();
-    pRequest->type = EffectsRequest::SET_PARAMETER_PARAMETERS;
-    pRequest->pTargetEffect = m_pEngineEffect;
-    pRequest->SetParameterParameters.iParameter = m_pParameterManifest->index();
-    pRequest->value = m_value;
-    m_pMessenger->writeRequest(pRequest);
+    // The engine picks up the value at the start of the next callback
+    m_pEngineEffect->setParameter(m_pParameterManifest->index(), m_value);
 }
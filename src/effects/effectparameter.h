@@ -26,7 +26,6 @@ class EffectParameterPreset;
 class EffectParameter {
   public:
     EffectParameter(EngineEffect* pEngineEffect,
-            EffectsMessengerPointer pEffectsMessenger,
             EffectManifestParameterPointer pParameterManifest,
             const EffectParameterPreset& preset);
     virtual ~EffectParameter();
@@ -62,7 +61,6 @@ class EffectParameter {
     bool clampValue();
 
     EngineEffect* m_pEngineEffect;
-    EffectsMessengerPointer m_pMessenger;
     EffectManifestParameterPointer m_pParameterManifest;
     double m_value;
     // Hidden parameters cannot be linked to the metaknob, but EffectParameter
@@ -136,42 +136,36 @@ EffectSlot::~EffectSlot() {
 }
 
 void EffectSlot::addToEngine() {
-    VERIFY_OR_DEBUG_ASSERT(!isLoaded()) {
+    VERIFY_OR_DEBUG_ASSERT(m_pEngineEffect && !m_pEngineEffect->isAddedToEngine()) {
         return;
     }
 
-    VERIFY_OR_DEBUG_ASSERT(!m_pEngineEffect) {
-        return;
-    }
-
-    m_pEngineEffect = new EngineEffect(
-            m_pManifest,
-            m_pBackendManager,
-            m_pChain->getActiveChannels(),
-            m_pEffectsManager->registeredInputChannels(),
-            m_pEffectsManager->registeredOutputChannels());
-
     EffectsRequest* request = new EffectsRequest();
     request->type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
     request->pTargetChain = m_pEngineEffectChain;
     request->AddEffectToChain.pEffect = m_pEngineEffect;
     request->AddEffectToChain.iIndex = m_iEffectNumber;
     m_pMessenger->writeRequest(request);
+
+    m_pEngineEffect->setAddedToEngine();
 }
 
-void EffectSlot::removeFromEngine() {
-    VERIFY_OR_DEBUG_ASSERT(isLoaded()) {
+void EffectSlot::removeFromEngine(EngineEffect* pEngineEffect) {
+    VERIFY_OR_DEBUG_ASSERT(pEngineEffect) {
+        return;
+    }
+
+    if (!pEngineEffect->isAddedToEngine()) {
+        delete pEngineEffect;
         return;
     }
 
     EffectsRequest* request = new EffectsRequest();
     request->type = EffectsRequest::REMOVE_EFFECT_FROM_CHAIN;
     request->pTargetChain = m_pEngineEffectChain;
-    request->RemoveEffectFromChain.pEffect = m_pEngineEffect;
+    request->RemoveEffectFromChain.pEffect = pEngineEffect;
     request->RemoveEffectFromChain.iIndex = m_iEffectNumber;
     m_pMessenger->writeRequest(request);
-
-    m_pEngineEffect = nullptr;
 }
 
 void EffectSlot::updateEngineState() {
@@ -179,11 +173,15 @@ void EffectSlot::updateEngineState() {
         return;
     }
 
-    EffectsRequest* pRequest = new EffectsRequest();
-    pRequest->type = EffectsRequest::SET_EFFECT_PARAMETERS;
-    pRequest->pTargetEffect = m_pEngineEffect;
-    pRequest->SetEffectParameters.enabled = m_pControlEnabled->toBool();
-    m_pMessenger->writeRequest(pRequest);
+    if (m_pEngineEffect->isAddedToEngine()) {
+        EffectsRequest* pRequest = new EffectsRequest();
+        pRequest->type = EffectsRequest::SET_EFFECT_PARAMETERS;
+        pRequest->pTargetEffect = m_pEngineEffect;
+        pRequest->SetEffectParameters.enabled = m_pControlEnabled->toBool();
+        m_pMessenger->writeRequest(pRequest);
+    } else {
+        m_pEngineEffect->setEnabled(m_pControlEnabled->toBool());
+    }
 
     for (const auto& parameterList : std::as_const(m_allParameters)) {
         for (auto const& pParameter : parameterList) {
@@ -192,27 +190,19 @@ void EffectSlot::updateEngineState() {
     }
 }
 
-void EffectSlot::fillEffectStatesMap(EffectStatesMap* pStatesMap) const {
-    //TODO: get actual configuration of engine
-    const mixxx::EngineParameters engineParameters(
-            mixxx::audio::SampleRate(96000),
-            MAX_BUFFER_LEN / mixxx::kEngineChannelCount);
+void EffectSlot::prepareStatesForInputChannel(const ChannelHandle* inputChannel) {
+    if (!m_pEngineEffect) {
+        return;
+    }
+    m_pEngineEffect->prepareStatesForInputChannel(inputChannel);
+}
 
-    if (isLoaded()) {
-        for (const auto& outputChannel :
-                m_pEffectsManager->registeredOutputChannels()) {
-            pStatesMap->insert(outputChannel.handle(),
-                    m_pEngineEffect->createState(engineParameters));
-        }
-    } else {
-        for (EffectState* pState : *pStatesMap) {
-            if (pState) {
-                delete pState;
-            }
-        }
-        pStatesMap->clear();
+void EffectSlot::releaseStatesForInputChannel(const ChannelHandle* inputChannel) {
+    if (!m_pEngineEffect) {
+        return;
     }
-};
+    m_pEngineEffect->releaseStatesForInputChannel(inputChannel);
+}
 
 EffectManifestPointer EffectSlot::getManifest() const {
     return m_pManifest;
@@ -272,9 +262,43 @@ void EffectSlot::loadEffectWithDefaults(const EffectManifestPointer pManifest) {
     loadEffectInner(pManifest, pPreset, false);
 }
 
+EngineEffect* EffectSlot::loadPreparedEffect(const EffectManifestPointer pManifest,
+        const EffectPresetPointer pPreset,
+        EngineEffect* pEngineEffect) {
+    VERIFY_OR_DEBUG_ASSERT(!pEngineEffect || !pEngineEffect->isAddedToEngine()) {
+        return nullptr;
+    }
+    return loadEngineEffect(pManifest, pPreset, pEngineEffect, true);
+}
+
 void EffectSlot::loadEffectInner(const EffectManifestPointer pManifest,
         EffectPresetPointer pEffectPreset,
         bool adoptMetaknobFromPreset) {
+    EngineEffect* pEngineEffect = nullptr;
+    if (pManifest && pEffectPreset) {
+        pEngineEffect = new EngineEffect(
+                pManifest,
+                m_pBackendManager,
+                m_pEffectsManager->registeredInputChannels(),
+                m_pEffectsManager->registeredOutputChannels());
+    }
+
+    EngineEffect* pReplacedEffect = loadEngineEffect(
+            pManifest, pEffectPreset, pEngineEffect, adoptMetaknobFromPreset);
+    if (pReplacedEffect) {
+        removeFromEngine(pReplacedEffect);
+    }
+    // The EngineEffect is added after its parameters have been set, so the
+    // engine never processes it with its default parameters.
+    if (isLoaded()) {
+        addToEngine();
+    }
+}
+
+EngineEffect* EffectSlot::loadEngineEffect(const EffectManifestPointer pManifest,
+        EffectPresetPointer pEffectPreset,
+        EngineEffect* pEngineEffect,
+        bool adoptMetaknobFromPreset) {
     if (kEffectDebugOutput) {
         if (pManifest) {
             qDebug() << this << m_group << "loading effect" << pManifest->id();
@@ -282,19 +306,26 @@ void EffectSlot::loadEffectInner(const EffectManifestPointer pManifest,
             qDebug() << this << m_group << "unloading effect";
         }
     }
-    unloadEffect();
+    EngineEffect* pReplacedEffect = clearEffect();
     DEBUG_ASSERT(!m_pManifest);
 
     // The function shall be called only with both pointers set or both null.
     DEBUG_ASSERT(pManifest.isNull() == pEffectPreset.isNull())
-    if (!pManifest || !pEffectPreset) {
+    DEBUG_ASSERT(pManifest.isNull() == (pEngineEffect == nullptr));
+    if (!pManifest || !pEffectPreset || !pEngineEffect) {
         // No new effect to load; just unload the old effect and return.
+        delete pEngineEffect;
         emit effectChanged();
-        return;
+        return pReplacedEffect;
     }
 
     m_pManifest = pManifest;
-    addToEngine();
+    m_pEngineEffect = pEngineEffect;
+    // The new effect processes the inputs that are routed to the chain as
+    // soon as it is added to the engine.
+    for (const auto& inputChannel : m_pChain->getActiveChannels()) {
+        m_pEngineEffect->prepareStatesForInputChannel(&inputChannel.handle());
+    }
 
     // Create EffectParameters. Every parameter listed in the manifest must have
     // an EffectParameter created, regardless of whether it is loaded in a slot.
@@ -311,7 +342,6 @@ void EffectSlot::loadEffectInner(const EffectManifestPointer pManifest,
         }
         EffectParameterPointer pParameter(new EffectParameter(
                 m_pEngineEffect,
-                m_pMessenger,
                 pManifestParameter,
                 parameterPreset));
         m_allParameters[pManifestParameter->parameterType()].append(pParameter);
@@ -367,11 +397,19 @@ void EffectSlot::loadEffectInner(const EffectManifestPointer pManifest,
 
     emit effectChanged();
     updateEngineState();
+    return pReplacedEffect;
 }
 
 void EffectSlot::unloadEffect() {
+    EngineEffect* pEngineEffect = clearEffect();
+    if (pEngineEffect) {
+        removeFromEngine(pEngineEffect);
+    }
+}
+
+EngineEffect* EffectSlot::clearEffect() {
     if (!isLoaded()) {
-        return;
+        return nullptr;
     }
 
     m_pControlLoaded->forceSet(0.0);
@@ -400,7 +438,9 @@ void EffectSlot::unloadEffect() {
 
     m_pManifest.clear();
 
-    removeFromEngine();
+    EngineEffect* pEngineEffect = m_pEngineEffect;
+    m_pEngineEffect = nullptr;
+    return pEngineEffect;
 }
 
 void EffectSlot::loadParameters() {
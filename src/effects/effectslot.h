@@ -104,6 +104,15 @@ class EffectSlot : public QObject {
     /// Call with nullptr for pManifest to unload an effect
     void loadEffectWithDefaults(
             const EffectManifestPointer pManifest);
+    /// Loads an effect with an EngineEffect that has been prepared in a worker
+    /// thread, see EffectChain::loadChainPreset. The new EngineEffect is not
+    /// sent to the engine and the previous one is not removed from it.
+    /// Instead the previous EngineEffect is returned, so that all effects of
+    /// the chain can be replaced with a single request. Call with nullptr for
+    /// all arguments to unload an effect.
+    EngineEffect* loadPreparedEffect(const EffectManifestPointer pManifest,
+            const EffectPresetPointer pPreset,
+            EngineEffect* pEngineEffect);
 
     void hideParameter(EffectParameterPointer pParameter);
     void showParameter(EffectParameterPointer pParameter);
@@ -123,7 +132,11 @@ class EffectSlot : public QObject {
         return m_group;
     }
 
-    void fillEffectStatesMap(EffectStatesMap* pStatesMap) const;
+    /// Preallocates the EffectStates for an input channel that is about to
+    /// be routed through the loaded effect.
+    void prepareStatesForInputChannel(const ChannelHandle* inputChannel);
+    /// The input channel is not routed through the loaded effect anymore.
+    void releaseStatesForInputChannel(const ChannelHandle* inputChannel);
 
     EffectManifestPointer getManifest() const;
 
@@ -155,15 +168,25 @@ class EffectSlot : public QObject {
     }
 
     void addToEngine();
-    void removeFromEngine();
+    void removeFromEngine(EngineEffect* pEngineEffect);
 
     /// Call with nullptr for pManifest and pPreset to unload an effect
     void loadEffectInner(const EffectManifestPointer pManifest,
             EffectPresetPointer pPreset,
             bool adoptMetaknobFromPreset = false);
+    /// Loads the effect with an EngineEffect that has not been added to the
+    /// engine yet and returns the previous EngineEffect, which the caller has
+    /// to remove from the engine.
+    EngineEffect* loadEngineEffect(const EffectManifestPointer pManifest,
+            EffectPresetPointer pPreset,
+            EngineEffect* pEngineEffect,
+            bool adoptMetaknobFromPreset);
 
     void loadParameters();
     void unloadEffect();
+    /// Unloads the effect without removing the EngineEffect from the engine,
+    /// which is returned.
+    EngineEffect* clearEffect();
 
     const unsigned int m_iEffectNumber;
     QHash<EffectParameterType, unsigned int> m_iNumParameterSlots;
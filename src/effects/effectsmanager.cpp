@@ -30,6 +30,8 @@ EffectsManager::EffectsManager(
           m_hiEqFreq(ConfigKey("[Mixer Profile]", "HiEQFrequency"), 0., 22040) {
     qRegisterMetaType<EffectChainMixMode>("EffectChainMixMode");
 
+    m_presetPreparationThread.setMaxThreadCount(1);
+
     m_pBackendManager = EffectsBackendManagerPointer(new EffectsBackendManager());
 
     QPair<EffectsRequestPipe*, EffectsResponsePipe*> requestPipes =
@@ -3,6 +3,7 @@
 #include <QHash>
 #include <QList>
 #include <QSet>
+#include <QThreadPool>
 
 #include "control/controlpotmeter.h"
 #include "effects/backends/effectsbackendmanager.h"
@@ -71,6 +72,12 @@ class EffectsManager {
 
     bool isAdoptMetaknobSettingEnabled() const;
 
+    /// A single thread that prepares the chain presets of all EffectChains
+    /// one after another
+    QThreadPool* getPresetPreparationThread() {
+        return &m_presetPreparationThread;
+    }
+
   private:
     void addStandardEffectChains();
     void addOutputEffectChain();
@@ -105,5 +112,7 @@ class EffectsManager {
     ControlPotmeter m_loEqFreq;
     ControlPotmeter m_hiEqFreq;
 
+    QThreadPool m_presetPreparationThread;
+
     DISALLOW_COPY_AND_ASSIGN(EffectsManager);
 };
@@ -85,6 +85,16 @@ void EffectsMessenger::collectGarbage(const EffectsRequest* pRequest) {
             qDebug() << debugString() << "delete" << pRequest->RemoveEffectFromChain.pEffect;
         }
         delete pRequest->RemoveEffectFromChain.pEffect;
+    } else if (pRequest->type == EffectsRequest::REPLACE_EFFECTS_IN_CHAIN) {
+        // The engine has swapped the new effects with the replaced ones
+        for (int i = 0; i < pRequest->ReplaceEffectsInChain.iNumEffects; ++i) {
+            if (kEffectDebugOutput && pRequest->ReplaceEffectsInChain.pEffects[i]) {
+                qDebug() << debugString() << "delete"
+                         << pRequest->ReplaceEffectsInChain.pEffects[i];
+            }
+            delete pRequest->ReplaceEffectsInChain.pEffects[i];
+        }
+        delete[] pRequest->ReplaceEffectsInChain.pEffects;
     } else if (pRequest->type == EffectsRequest::REMOVE_EFFECT_CHAIN) {
         if (kEffectDebugOutput) {
             qDebug() << debugString() << "delete" << pRequest->RemoveEffectChain.pChain;
@@ -0,0 +1,166 @@
+#include "engine/cachingreader/cachingreadertap.h"
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "engine/engine.h"
+#include "util/compatibility/qmutex.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+// 64 chunks of 8192 stereo frames are about 11 seconds of audio at 48 kHz
+// and occupy 4 MB per analysis job.
+constexpr int kSlotCount = 64;
+
+constexpr SINT kChannels = mixxx::kEngineChannelCount;
+
+} // anonymous namespace
+
+// static
+std::atomic<int> CachingReaderTap::s_generation{0};
+// static
+QMutex CachingReaderTap::s_mutex;
+// static
+std::map<TrackId, std::shared_ptr<CachingReaderTap>> CachingReaderTap::s_attachedTaps;
+
+CachingReaderTap::CachingReaderTap(TrackId trackId)
+        : m_trackId(trackId),
+          m_claimed(false),
+          m_slots(kSlotCount),
+          m_freeSlots(kSlotCount),
+          m_publishedSlots(kSlotCount) {
+    for (int i = 0; i < kSlotCount; ++i) {
+        m_slots[i].samples.resize(CachingReaderChunk::kFrames * kChannels);
+        m_freeSlots.push(i);
+    }
+}
+
+// static
+bool CachingReaderTap::attach(const std::shared_ptr<CachingReaderTap>& pTap) {
+    VERIFY_OR_DEBUG_ASSERT(pTap && pTap->trackId().isValid()) {
+        return false;
+    }
+    const auto locker = lockMutex(&s_mutex);
+    if (!s_attachedTaps.emplace(pTap->trackId(), pTap).second) {
+        return false;
+    }
+    s_generation.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+// static
+void CachingReaderTap::detach(const std::shared_ptr<CachingReaderTap>& pTap) {
+    const auto locker = lockMutex(&s_mutex);
+    const auto it = s_attachedTaps.find(pTap->trackId());
+    if (it == s_attachedTaps.end() || it->second != pTap) {
+        return;
+    }
+    s_attachedTaps.erase(it);
+    s_generation.fetch_add(1, std::memory_order_release);
+}
+
+// static
+void CachingReaderTap::update(
+        TrackId trackId,
+        std::shared_ptr<CachingReaderTap>* ppTap,
+        int* pGeneration) {
+    const auto locker = lockMutex(&s_mutex);
+    if (*ppTap) {
+        const auto it = s_attachedTaps.find((*ppTap)->trackId());
+        if (it == s_attachedTaps.end() || it->second != *ppTap) {
+            // Detached
+            ppTap->reset();
+        } else if ((*ppTap)->trackId() != trackId) {
+            (*ppTap)->m_claimed = false;
+            ppTap->reset();
+            s_generation.fetch_add(1, std::memory_order_release);
+        }
+    }
+    if (!*ppTap && trackId.isValid()) {
+        const auto it = s_attachedTaps.find(trackId);
+        if (it != s_attachedTaps.end() && !it->second->m_claimed) {
+            it->second->m_claimed = true;
+            *ppTap = it->second;
+        }
+    }
+    // All modifications happen while the mutex is locked
+    *pGeneration = s_generation.load(std::memory_order_relaxed);
+}
+
+// static
+void CachingReaderTap::release(std::shared_ptr<CachingReaderTap>* ppTap) {
+    if (!*ppTap) {
+        return;
+    }
+    const auto locker = lockMutex(&s_mutex);
+    (*ppTap)->m_claimed = false;
+    ppTap->reset();
+    // Another worker that has loaded the same track may claim it now
+    s_generation.fetch_add(1, std::memory_order_release);
+}
+
+void CachingReaderTap::publish(
+        mixxx::IndexRange frameIndexRange,
+        const CSAMPLE* pSamples) {
+    if (frameIndexRange.empty() ||
+            frameIndexRange.start() > frameIndexRange.end()) {
+        return;
+    }
+    VERIFY_OR_DEBUG_ASSERT(frameIndexRange.length() <= CachingReaderChunk::kFrames) {
+        return;
+    }
+    const int* pSlotIndex = m_freeSlots.front();
+    if (!pSlotIndex) {
+        // All slots are in use, drop the chunk
+        return;
+    }
+    const int slotIndex = *pSlotIndex;
+    m_freeSlots.pop();
+    Slot& slot = m_slots[slotIndex];
+    slot.frameIndexRange = frameIndexRange;
+    SampleUtil::copy(slot.samples.data(), pSamples, frameIndexRange.length() * kChannels);
+    // Both queues have the capacity for all slots
+    m_publishedSlots.push(slotIndex);
+}
+
+mixxx::IndexRange CachingReaderTap::consume(
+        mixxx::IndexRange frameIndexRange,
+        CSAMPLE* pDest) {
+    while (const int* pSlotIndex = m_publishedSlots.front()) {
+        const int slotIndex = *pSlotIndex;
+        m_publishedSlots.pop();
+        const auto inserted = m_pendingSlots.emplace(
+                m_slots[slotIndex].frameIndexRange.start(), slotIndex);
+        if (!inserted.second) {
+            // The chunk has been read again, e.g. after seeking back
+            m_freeSlots.push(slotIndex);
+        }
+    }
+    // The analyzer only moves forward, so chunks that end before the
+    // requested range will never be needed again.
+    while (!m_pendingSlots.empty() &&
+            m_slots[m_pendingSlots.begin()->second].frameIndexRange.end() <=
+                    frameIndexRange.start()) {
+        m_freeSlots.push(m_pendingSlots.begin()->second);
+        m_pendingSlots.erase(m_pendingSlots.begin());
+    }
+    SINT frameIndex = frameIndexRange.start();
+    for (const auto& entry : m_pendingSlots) {
+        const Slot& slot = m_slots[entry.second];
+        if (frameIndex >= frameIndexRange.end() ||
+                slot.frameIndexRange.start() > frameIndex) {
+            // Done or found a gap
+            break;
+        }
+        const SINT copyEnd = math_min(slot.frameIndexRange.end(), frameIndexRange.end());
+        if (copyEnd <= frameIndex) {
+            continue;
+        }
+        SampleUtil::copy(
+                pDest + (frameIndex - frameIndexRange.start()) * kChannels,
+                slot.samples.data() + (frameIndex - slot.frameIndexRange.start()) * kChannels,
+                (copyEnd - frameIndex) * kChannels);
+        frameIndex = copyEnd;
+    }
+    return mixxx::IndexRange::between(frameIndexRange.start(), frameIndex);
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <QMutex>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "rigtorp/SPSCQueue.h"
+#include "track/trackid.h"
+#include "util/class.h"
+#include "util/indexrange.h"
+#include "util/types.h"
+
+/// Shares the audio that a CachingReaderWorker decodes for playback with a
+/// single analysis job, so that a track that is played while it is analyzed
+/// does not need to be decoded twice.
+///
+/// An analysis job opts in by creating a tap for its track and attaching it
+/// before it starts decoding. The first CachingReaderWorker that has loaded
+/// the same track claims the tap and publishes a copy of every stereo chunk
+/// it reads. The analyzer consumes the chunks while it advances linearly
+/// through the track and decodes all regions that have not been played on
+/// its own.
+///
+/// Chunks are passed through a fixed number of preallocated slots and two
+/// lock-free FIFOs, chunks that are published while all slots are in use
+/// are dropped. The mutex only guards attaching and detaching taps. The
+/// workers look up their tap after an attachment has changed and otherwise
+/// only load an atomic counter while reading.
+///
+/// Only the decoding is shared. The analyzers still report their results
+/// as before: the waveform incrementally, the beats and the key when the
+/// analysis has finished.
+class CachingReaderTap {
+  public:
+    explicit CachingReaderTap(TrackId trackId);
+
+    TrackId trackId() const {
+        return m_trackId;
+    }
+
+    /// Makes the tap available to the CachingReaderWorkers and detaches
+    /// it again. Only a single tap can be attached per track, attaching
+    /// fails if another analysis job has already attached one.
+    static bool attach(const std::shared_ptr<CachingReaderTap>& pTap);
+    static void detach(const std::shared_ptr<CachingReaderTap>& pTap);
+
+    /// Changes each time a tap is attached, detached, or released by
+    /// a worker. Workers only need to call update() after it has changed.
+    static int generation() {
+        return s_generation.load(std::memory_order_acquire);
+    }
+
+    /// Called by the workers after the generation has changed. Drops the
+    /// claimed tap in *ppTap if it has been detached or does not belong to
+    /// the given track, claims the tap that is attached for the given track
+    /// if no other worker has claimed it, and stores the current generation
+    /// in *pGeneration.
+    static void update(
+            TrackId trackId,
+            std::shared_ptr<CachingReaderTap>* ppTap,
+            int* pGeneration);
+    /// Called by the workers when they stop reading the track of the
+    /// claimed tap in *ppTap.
+    static void release(std::shared_ptr<CachingReaderTap>* ppTap);
+
+    /// Called by the worker that has claimed the tap with the interleaved
+    /// stereo samples of each chunk that has been read.
+    void publish(
+            mixxx::IndexRange frameIndexRange,
+            const CSAMPLE* pSamples);
+
+    /// Called by the analysis job. Copies the interleaved stereo samples of
+    /// the leading part of frameIndexRange that has been published into pDest
+    /// and returns the copied range. The returned range starts at
+    /// frameIndexRange.start() or is empty. Chunks that end before
+    /// frameIndexRange are discarded.
+    mixxx::IndexRange consume(
+            mixxx::IndexRange frameIndexRange,
+            CSAMPLE* pDest);
+
+  private:
+    struct Slot {
+        mixxx::IndexRange frameIndexRange;
+        std::vector<CSAMPLE> samples;
+    };
+
+    static std::atomic<int> s_generation;
+    static QMutex s_mutex;
+    static std::map<TrackId, std::shared_ptr<CachingReaderTap>> s_attachedTaps;
+
+    const TrackId m_trackId;
+
+    // Guarded by s_mutex
+    bool m_claimed;
+
+    std::vector<Slot> m_slots;
+    // Indices of the slots that are owned by the producer or the
+    // consumer, respectively
+    rigtorp::SPSCQueue<int> m_freeSlots;
+    rigtorp::SPSCQueue<int> m_publishedSlots;
+
+    // Consumer only: Published slots indexed by their first frame
+    std::map<SINT, int> m_pendingSlots;
+
+    DISALLOW_COPY_AND_ASSIGN(CachingReaderTap);
+};
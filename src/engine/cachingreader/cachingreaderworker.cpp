@@ -4,6 +4,7 @@
 #include <QtDebug>
 
 #include "control/controlobject.h"
+#include "engine/cachingreader/cachingreadertap.h"
 #include "moc_cachingreaderworker.cpp"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
@@ -24,7 +25,8 @@ CachingReaderWorker::CachingReaderWorker(
         : m_group(group),
           m_tag(QString("CachingReaderWorker %1").arg(m_group)),
           m_pChunkReadRequestFIFO(pChunkReadRequestFIFO),
-          m_pReaderStatusFIFO(pReaderStatusFIFO) {
+          m_pReaderStatusFIFO(pReaderStatusFIFO),
+          m_tapGeneration(-1) {
 }
 
 ReaderStatusUpdate CachingReaderWorker::processReadRequest(
@@ -67,6 +69,18 @@ ReaderStatusUpdate CachingReaderWorker::processReadRequest(
         }
     }
 
+    // Share the decoded samples with an analysis job that has opted in
+    // for the same track. The lookup only happens after a tap has been
+    // attached or detached anywhere.
+    if (CachingReaderTap::generation() != m_tapGeneration) {
+        CachingReaderTap::update(m_trackId, &m_pTap, &m_tapGeneration);
+    }
+    if (m_pTap && !bufferedFrameIndexRange.empty()) {
+        m_pTap->publish(
+                bufferedFrameIndexRange,
+                pChunk->bufferedSampleFrames().readableData());
+    }
+
     ReaderStatusUpdate result;
     result.init(status, pChunk, m_pAudioSource ? m_pAudioSource->frameIndexRange() : mixxx::IndexRange());
     return result;
@@ -129,6 +143,8 @@ void CachingReaderWorker::closeAudioSource() {
     discardAllPendingRequests();
     // Closes open file handles of the old track.
     m_pAudioSource.reset();
+    m_trackId = TrackId();
+    CachingReaderTap::release(&m_pTap);
 
     // This function has to be called with the engine stopped only
     // to avoid collecting new requests for the old track
@@ -195,6 +211,10 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
         return;
     }
 
+    m_trackId = pTrack->getId();
+    // An analysis job might already have attached a tap for this track
+    m_tapGeneration = -1;
+
     // Adjust the internal buffer
     const SINT tempReadBufferSize =
             m_pAudioSource->getSignalInfo().frames2samples(
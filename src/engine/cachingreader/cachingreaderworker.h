@@ -5,13 +5,17 @@
 #include <QString>
 #include <QThread>
 #include <QtDebug>
+#include <memory>
 
 #include "engine/cachingreader/cachingreaderchunk.h"
 #include "engine/engineworker.h"
 #include "sources/audiosource.h"
 #include "track/track_decl.h"
+#include "track/trackid.h"
 #include "util/fifo.h"
 
+class CachingReaderTap;
+
 // POD with trivial ctor/dtor/copy for passing through FIFO
 typedef struct CachingReaderChunkReadRequest {
     CachingReaderChunk* chunk;
@@ -150,6 +154,12 @@ class CachingReaderWorker : public EngineWorker {
     // The current audio source of the track loaded
     mixxx::AudioSourcePointer m_pAudioSource;
 
+    // The id of the track loaded, used for sharing the decoded
+    // chunks with the analyzer through the CachingReaderTap
+    TrackId m_trackId;
+    std::shared_ptr<CachingReaderTap> m_pTap;
+    int m_tapGeneration;
+
     // Temporary buffer for reading samples from all channels
     // before conversion to a stereo signal.
     mixxx::SampleBuffer m_tempReadBuffer;
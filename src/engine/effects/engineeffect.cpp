@@ -1,23 +1,42 @@
 #include "engine/effects/engineeffect.h"
 
+#include <utility>
+
 #include "engine/engine.h"
 #include "util/defs.h"
 #include "util/sample.h"
 
+static_assert(std::atomic<double>::is_always_lock_free,
+        "The parameter table must not lock in the audio thread");
+
 EngineEffect::EngineEffect(EffectManifestPointer pManifest,
         EffectsBackendManagerPointer pBackendManager,
-        const QSet<ChannelHandleAndGroup>& activeInputChannels,
+        const QSet<ChannelHandleAndGroup>& registeredInputChannels,
+        const QSet<ChannelHandleAndGroup>& registeredOutputChannels)
+        : EngineEffect(pManifest,
+                  pBackendManager->createProcessor(pManifest),
+                  registeredInputChannels,
+                  registeredOutputChannels) {
+}
+
+EngineEffect::EngineEffect(EffectManifestPointer pManifest,
+        std::unique_ptr<EffectProcessor> pProcessor,
         const QSet<ChannelHandleAndGroup>& registeredInputChannels,
         const QSet<ChannelHandleAndGroup>& registeredOutputChannels)
         : m_pManifest(pManifest),
-          m_pProcessor(pBackendManager->createProcessor(pManifest)),
-          m_parameters(pManifest->parameters().size()) {
+          m_pProcessor(std::move(pProcessor)),
+          m_bAddedToEngine(false),
+          m_parameters(pManifest->parameters().size()),
+          m_parameterValues(std::make_unique<std::atomic<double>[]>(
+                  pManifest->parameters().size())),
+          m_parametersChanged(false) {
     const QList<EffectManifestParameterPointer>& parameters = m_pManifest->parameters();
     for (int i = 0; i < parameters.size(); ++i) {
         EffectManifestParameterPointer param = parameters.at(i);
         EngineEffectParameterPointer pParameter(new EngineEffectParameter(param));
         m_parameters[i] = pParameter;
         m_parametersById[param->id()] = pParameter;
+        m_parameterValues[i].store(pParameter->value(), std::memory_order_relaxed);
     }
 
     for (const ChannelHandleAndGroup& inputChannel : registeredInputChannels) {
@@ -34,7 +53,7 @@ EngineEffect::EngineEffect(EffectManifestPointer pManifest,
     const mixxx::EngineParameters engineParameters(
             mixxx::audio::SampleRate(96000),
             MAX_BUFFER_LEN / mixxx::kEngineChannelCount);
-    m_pProcessor->initialize(activeInputChannels, registeredOutputChannels, engineParameters);
+    m_pProcessor->initialize(registeredInputChannels, registeredOutputChannels, engineParameters);
     m_effectRampsFromDry = pManifest->effectRampsFromDry();
 }
 
@@ -46,29 +65,65 @@ EngineEffect::~EngineEffect() {
     m_parameters.clear();
 }
 
-EffectState* EngineEffect::createState(const mixxx::EngineParameters& engineParameters) {
+void EngineEffect::prepareStatesForInputChannel(const ChannelHandle* inputChannel) {
     VERIFY_OR_DEBUG_ASSERT(m_pProcessor) {
-        return new EffectState(engineParameters);
+        return;
     }
-    return m_pProcessor->createState(engineParameters);
+    m_pProcessor->prepareStatesForInputChannel(inputChannel);
 }
 
-void EngineEffect::loadStatesForInputChannel(const ChannelHandle* inputChannel,
-        EffectStatesMap* pStatesMap) {
-    if (kEffectDebugOutput) {
-        qDebug() << "EngineEffect::loadStatesForInputChannel" << this
-                 << "loading states for input" << *inputChannel;
+void EngineEffect::releaseStatesForInputChannel(const ChannelHandle* inputChannel) {
+    VERIFY_OR_DEBUG_ASSERT(m_pProcessor) {
+        return;
     }
-    m_pProcessor->loadStatesForInputChannel(inputChannel, pStatesMap);
+    m_pProcessor->releaseStatesForInputChannel(inputChannel);
 }
 
 void EngineEffect::deleteStatesForInputChannel(const ChannelHandle* inputChannel) {
     m_pProcessor->deleteStatesForInputChannel(inputChannel);
 }
 
+void EngineEffect::setEnabled(bool enabled) {
+    for (auto& outputMap : m_effectEnableStateForChannelMatrix) {
+        for (auto& enableState : outputMap) {
+            if (enableState != EffectEnableState::Disabled && !enabled) {
+                enableState = EffectEnableState::Disabling;
+                // If an input is not routed to the chain, and the effect gets
+                // a message to disable, then the effect gets the message to enable,
+                // process() will not have executed, so the enableState will still be
+                // DISABLING instead of DISABLED.
+            } else if ((enableState == EffectEnableState::Disabled ||
+                               enableState == EffectEnableState::Disabling) &&
+                    enabled) {
+                enableState = EffectEnableState::Enabling;
+            }
+        }
+    }
+}
+
+bool EngineEffect::setParameter(int index, double value) {
+    VERIFY_OR_DEBUG_ASSERT(index >= 0 && index < m_parameters.size()) {
+        return false;
+    }
+    m_parameterValues[index].store(value, std::memory_order_relaxed);
+    // Publishes the value to the audio thread
+    m_parametersChanged.store(true, std::memory_order_release);
+    return true;
+}
+
+void EngineEffect::updateParameters() {
+    if (!m_parametersChanged.exchange(false, std::memory_order_acquire)) {
+        return;
+    }
+    // Copying all values is cheaper than tracking which ones have changed,
+    // there are only a few parameters per effect.
+    for (int i = 0; i < m_parameters.size(); ++i) {
+        m_parameters[i]->setValue(m_parameterValues[i].load(std::memory_order_relaxed));
+    }
+}
+
 bool EngineEffect::processEffectsRequest(EffectsRequest& message,
                                          EffectsResponsePipe* pResponsePipe) {
-    EngineEffectParameterPointer pParameter;
     EffectsResponse response(message);
 
     switch (message.type) {
@@ -78,51 +133,37 @@ bool EngineEffect::processEffectsRequest(EffectsRequest& message,
                      << "enabled" << message.SetEffectParameters.enabled;
         }
 
-        for (auto& outputMap : m_effectEnableStateForChannelMatrix) {
-            for (auto& enableState : outputMap) {
-                if (enableState != EffectEnableState::Disabled &&
-                        !message.SetEffectParameters.enabled) {
-                    enableState = EffectEnableState::Disabling;
-                    // If an input is not routed to the chain, and the effect gets
-                    // a message to disable, then the effect gets the message to enable,
-                    // process() will not have executed, so the enableState will still be
-                    // DISABLING instead of DISABLED.
-                } else if ((enableState == EffectEnableState::Disabled ||
-                                   enableState ==
-                                           EffectEnableState::Disabling) &&
-                        message.SetEffectParameters.enabled) {
-                    enableState = EffectEnableState::Enabling;
-                }
-            }
-        }
+        setEnabled(message.SetEffectParameters.enabled);
 
         response.success = true;
         pResponsePipe->writeMessage(response);
         return true;
         break;
-    case EffectsRequest::SET_PARAMETER_PARAMETERS:
-        if (kEffectDebugOutput) {
-            qDebug() << debugString() << "SET_PARAMETER_PARAMETERS"
-                     << "parameter" << message.SetParameterParameters.iParameter
-                     << "value" << message.value;
-        }
-        pParameter = m_parameters.value(
-                message.SetParameterParameters.iParameter, EngineEffectParameterPointer());
-        if (pParameter) {
-            pParameter->setValue(message.value);
-            response.success = true;
-        } else {
-            response.success = false;
-            response.status = EffectsResponse::NO_SUCH_PARAMETER;
-        }
-        pResponsePipe->writeMessage(response);
-        return true;
     default:
         break;
     }
     return false;
 }
 
+SINT EngineEffect::tailFrames(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        const mixxx::EngineParameters& engineParameters) {
+    if (m_effectEnableStateForChannelMatrix[inputHandle][outputHandle] ==
+            EffectEnableState::Disabled) {
+        return 0;
+    }
+    return m_pProcessor->tailFrames(engineParameters);
+}
+
+SINT EngineEffect::latencyFrames(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) {
+    if (m_effectEnableStateForChannelMatrix[inputHandle][outputHandle] ==
+            EffectEnableState::Disabled) {
+        return 0;
+    }
+    return m_pProcessor->latencyFrames();
+}
+
 bool EngineEffect::process(const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
         const CSAMPLE* pInput,
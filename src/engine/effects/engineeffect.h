@@ -6,6 +6,8 @@
 #include <QString>
 #include <QVector>
 #include <QtDebug>
+#include <atomic>
+#include <memory>
 
 #include "effects/backends/effectmanifest.h"
 #include "effects/backends/effectprocessor.h"
@@ -25,21 +27,52 @@ class EngineEffect final : public EffectsRequestHandler {
     /// Called in main thread by EffectSlot
     EngineEffect(EffectManifestPointer pManifest,
             EffectsBackendManagerPointer pBackendManager,
-            const QSet<ChannelHandleAndGroup>& activeInputChannels,
+            const QSet<ChannelHandleAndGroup>& registeredInputChannels,
+            const QSet<ChannelHandleAndGroup>& registeredOutputChannels);
+    /// Called in main thread with an EffectProcessor that has not been
+    /// created by an EffectsBackend, e.g. in tests
+    EngineEffect(EffectManifestPointer pManifest,
+            std::unique_ptr<EffectProcessor> pProcessor,
             const QSet<ChannelHandleAndGroup>& registeredInputChannels,
             const QSet<ChannelHandleAndGroup>& registeredOutputChannels);
     /// Called in main thread by EffectSlot
     ~EngineEffect();
 
-    /// Called in main thread to allocate an EffectState
-    EffectState* createState(const mixxx::EngineParameters& engineParameters);
+    /// Called in main thread to preallocate the EffectStates which are
+    /// needed when the effect starts processing an input channel
+    void prepareStatesForInputChannel(const ChannelHandle* inputChannel);
+    /// Called in main thread when the input channel is not routed to the
+    /// effect anymore
+    void releaseStatesForInputChannel(const ChannelHandle* inputChannel);
 
-    /// Called in audio thread to load EffectStates received from the main thread
-    void loadStatesForInputChannel(const ChannelHandle* inputChannel,
-            EffectStatesMap* pStatesMap);
     /// Called from the main thread for garbage collection after an input channel is disabled
     void deleteStatesForInputChannel(const ChannelHandle* inputChannel);
 
+    /// Called in main thread
+    /// Until the effect is sent to the engine it is owned by the main thread,
+    /// which sets the enable state directly instead of sending requests.
+    bool isAddedToEngine() const {
+        return m_bAddedToEngine;
+    }
+    void setAddedToEngine() {
+        m_bAddedToEngine = true;
+    }
+
+    /// Called in main thread before the effect is added to the engine or in
+    /// audio thread
+    void setEnabled(bool enabled);
+
+    /// Called in main thread or by the thread that prepares a chain preset.
+    /// The value is stored in the parameter table and becomes visible to the
+    /// EffectProcessor with the next call of updateParameters(), no
+    /// EffectsRequest is needed.
+    bool setParameter(int index, double value);
+
+    /// Called in audio thread at the start of a callback
+    /// Copies the parameter table to the EngineEffectParameters if any value
+    /// has changed since the last call.
+    void updateParameters();
+
     /// Called in audio thread
     bool processEffectsRequest(
             EffectsRequest& message,
@@ -55,6 +88,17 @@ class EngineEffect final : public EffectsRequestHandler {
             const EffectEnableState chainEnableState,
             const GroupFeatureState& groupFeatures);
 
+    /// Called in audio thread
+    /// The tail of the effect for the channel, 0 if it is disabled for the channel
+    SINT tailFrames(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            const mixxx::EngineParameters& engineParameters);
+
+    /// Called in audio thread
+    /// The latency of the effect for the channel, 0 if it is disabled for the channel
+    SINT latencyFrames(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle);
+
     const EffectManifestPointer getManifest() const {
         return m_pManifest;
     }
@@ -72,9 +116,14 @@ class EngineEffect final : public EffectsRequestHandler {
     std::unique_ptr<EffectProcessor> m_pProcessor;
     ChannelHandleMap<ChannelHandleMap<EffectEnableState>> m_effectEnableStateForChannelMatrix;
     bool m_effectRampsFromDry;
+    bool m_bAddedToEngine;
     // Must not be modified after construction.
     QVector<EngineEffectParameterPointer> m_parameters;
     QMap<QString, EngineEffectParameterPointer> m_parametersById;
+    // The latest parameter values, written by the main thread and read by
+    // the audio thread. Preallocated with one slot per parameter.
+    std::unique_ptr<std::atomic<double>[]> m_parameterValues;
+    std::atomic<bool> m_parametersChanged;
 
     DISALLOW_COPY_AND_ASSIGN(EngineEffect);
 };
@@ -1,7 +1,11 @@
 #include "engine/effects/engineeffectchain.h"
 
+#include <utility>
+
+#include "effects/backends/effectprocessor.h"
 #include "engine/effects/engineeffect.h"
 #include "util/defs.h"
+#include "util/math.h"
 #include "util/sample.h"
 
 EngineEffectChain::EngineEffectChain(const QString& group,
@@ -12,10 +16,18 @@ EngineEffectChain::EngineEffectChain(const QString& group,
           m_mixMode(EffectChainMixMode::DrySlashWet),
           m_dMix(0),
           m_buffer1(MAX_BUFFER_LEN),
-          m_buffer2(MAX_BUFFER_LEN) {
+          m_buffer2(MAX_BUFFER_LEN),
+          m_dryBuffer(MAX_BUFFER_LEN) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
 
+    m_dryDelays.reserve(kLatencyCompensatedChannels);
+    m_freeDryDelays.reserve(kLatencyCompensatedChannels);
+    for (int i = 0; i < kLatencyCompensatedChannels; ++i) {
+        m_dryDelays.push_back(std::make_unique<DryDelay>());
+        m_freeDryDelays.push_back(m_dryDelays.back().get());
+    }
+
     for (const ChannelHandleAndGroup& inputChannel : registeredInputChannels) {
         ChannelHandleMap<ChannelStatus> outputChannelMap;
         for (const ChannelHandleAndGroup& outputChannel : registeredOutputChannels) {
@@ -73,6 +85,27 @@ bool EngineEffectChain::removeEffect(EngineEffect* pEffect, int iIndex) {
     return true;
 }
 
+bool EngineEffectChain::replaceEffects(EngineEffect** pEffects, int numEffects) {
+    if (numEffects < 0) {
+        if (kEffectDebugOutput) {
+            qDebug() << debugString()
+                     << "WARNING: REPLACE_EFFECTS_IN_CHAIN message with invalid size:"
+                     << numEffects;
+        }
+        return false;
+    }
+
+    // The new effects have been configured completely in the main thread, so
+    // they only need to be swapped in.
+    while (numEffects > m_effects.size()) {
+        m_effects.append(nullptr);
+    }
+    for (int i = 0; i < numEffects; ++i) {
+        std::swap(m_effects[i], pEffects[i]);
+    }
+    return true;
+}
+
 // this is called from the engine thread onCallbackStart()
 bool EngineEffectChain::updateParameters(const EffectsRequest& message) {
     // TODO(rryan): Parameter interpolation.
@@ -109,6 +142,14 @@ bool EngineEffectChain::processEffectsRequest(EffectsRequest& message,
         response.success = removeEffect(message.RemoveEffectFromChain.pEffect,
                 message.RemoveEffectFromChain.iIndex);
         break;
+    case EffectsRequest::REPLACE_EFFECTS_IN_CHAIN:
+        if (kEffectDebugOutput) {
+            qDebug() << debugString() << this << "REPLACE_EFFECTS_IN_CHAIN"
+                     << message.ReplaceEffectsInChain.iNumEffects;
+        }
+        response.success = replaceEffects(message.ReplaceEffectsInChain.pEffects,
+                message.ReplaceEffectsInChain.iNumEffects);
+        break;
     case EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS:
         if (kEffectDebugOutput) {
             qDebug() << debugString() << this << "SET_EFFECT_CHAIN_PARAMETERS"
@@ -126,8 +167,7 @@ bool EngineEffectChain::processEffectsRequest(EffectsRequest& message,
                      << *message.EnableInputChannelForChain.pChannelHandle;
         }
         response.success = enableForInputChannel(
-                message.EnableInputChannelForChain.pChannelHandle,
-                message.EnableInputChannelForChain.pEffectStatesMapArray);
+                message.EnableInputChannelForChain.pChannelHandle);
         break;
     case EffectsRequest::DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL:
         if (kEffectDebugOutput) {
@@ -146,8 +186,7 @@ bool EngineEffectChain::processEffectsRequest(EffectsRequest& message,
     return true;
 }
 
-bool EngineEffectChain::enableForInputChannel(const ChannelHandle* inputHandle,
-        EffectStatesMapArray* statesForEffectsInChain) {
+bool EngineEffectChain::enableForInputChannel(const ChannelHandle* inputHandle) {
     if (kEffectDebugOutput) {
         qDebug() << "EngineEffectChain::enableForInputChannel" << this << inputHandle;
     }
@@ -155,28 +194,10 @@ bool EngineEffectChain::enableForInputChannel(const ChannelHandle* inputHandle,
     for (auto&& outputChannelStatus : outputMap) {
         VERIFY_OR_DEBUG_ASSERT(outputChannelStatus.enableState !=
                 EffectEnableState::Enabled) {
-            for (auto&& pStatesMap : *statesForEffectsInChain) {
-                for (auto&& pState : pStatesMap) {
-                    delete pState;
-                }
-            }
             return false;
         }
         outputChannelStatus.enableState = EffectEnableState::Enabling;
     }
-    for (int i = 0; i < m_effects.size(); ++i) {
-        if (m_effects[i] != nullptr) {
-            if (kEffectDebugOutput) {
-                qDebug() << "EngineEffectChain::enableForInputChannel" << this
-                         << "loading states for effect" << i;
-            }
-            EffectStatesMap* pStatesMap = &(*statesForEffectsInChain)[i];
-            VERIFY_OR_DEBUG_ASSERT(pStatesMap) {
-                return false;
-            }
-            m_effects[i]->loadStatesForInputChannel(inputHandle, pStatesMap);
-        }
-    }
     return true;
 }
 
@@ -220,6 +241,80 @@ void EngineEffectChain::deleteStatesForInputChannel(const ChannelHandle* inputCh
     }
 }
 
+bool EngineEffectChain::isTailExpired(ChannelStatus* pChannelStatus,
+        const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        const CSAMPLE* pIn,
+        const mixxx::EngineParameters& engineParameters) {
+    if (!SampleUtil::isSilent(pIn,
+                engineParameters.samplesPerBuffer(),
+                EffectProcessor::kSilenceThreshold)) {
+        pChannelStatus->silentFrames = 0;
+        return false;
+    }
+    const SINT silentFramesBefore = pChannelStatus->silentFrames;
+    if (silentFramesBefore <
+            EffectProcessor::kUnboundedTailFrames - engineParameters.framesPerBuffer()) {
+        pChannelStatus->silentFrames += engineParameters.framesPerBuffer();
+    }
+
+    // The effects are processed in series, so the tail of the chain is the
+    // sum of their tails.
+    SINT tailFrames = 0;
+    for (EngineEffect* pEffect : qAsConst(m_effects)) {
+        if (pEffect == nullptr) {
+            continue;
+        }
+        const SINT effectTailFrames = pEffect->tailFrames(
+                inputHandle, outputHandle, engineParameters);
+        if (effectTailFrames >= EffectProcessor::kUnboundedTailFrames - tailFrames) {
+            return false;
+        }
+        tailFrames += effectTailFrames;
+    }
+    // The output of this buffer would be silent if the tails had already
+    // decayed when it started.
+    return silentFramesBefore >= tailFrames;
+}
+
+const CSAMPLE* EngineEffectChain::compensateLatency(ChannelStatus* pChannelStatus,
+        const CSAMPLE* pIn,
+        SINT latencyFrames,
+        const unsigned int numSamples) {
+    DryDelay* pDryDelay = pChannelStatus->pDryDelay;
+    if (!pDryDelay) {
+        if (latencyFrames == 0 || m_freeDryDelays.empty()) {
+            return pIn;
+        }
+        pDryDelay = m_freeDryDelays.back();
+        m_freeDryDelays.pop_back();
+        pChannelStatus->pDryDelay = pDryDelay;
+        pChannelStatus->dryDelaySamples = 0;
+        pChannelStatus->dryDelayFilledSamples = 0;
+    }
+    // The delay crossfades from the old to the new delay in the second half
+    // of the buffer. A longer delay is only applied when the delay line
+    // already holds the input it reads from there. Otherwise the dry signal
+    // would fade into the silence of the empty delay line, so it stays ahead
+    // of the wet signal for a few buffers after the latency has appeared.
+    // A delay that is still used after the latency is gone fades back to
+    // the undelayed signal.
+    const SINT latencySamples =
+            math_min(latencyFrames, kMaxLatencyCompensationFrames) *
+            mixxx::kEngineChannelCount;
+    if (latencySamples <= pChannelStatus->dryDelaySamples ||
+            latencySamples <= pChannelStatus->dryDelayFilledSamples +
+                            static_cast<SINT>(numSamples) / 2) {
+        pChannelStatus->dryDelaySamples = latencySamples;
+    }
+    pChannelStatus->dryDelayFilledSamples = math_min(
+            pChannelStatus->dryDelayFilledSamples + static_cast<SINT>(numSamples),
+            (kMaxLatencyCompensationFrames + 1) * mixxx::kEngineChannelCount);
+    pDryDelay->setDelay(static_cast<unsigned int>(pChannelStatus->dryDelaySamples));
+    pDryDelay->process(pIn, m_dryBuffer.data(), numSamples);
+    return m_dryBuffer.data();
+}
+
 EngineEffectChain::ChannelStatus& EngineEffectChain::getChannelStatus(
         const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle) {
@@ -227,6 +322,20 @@ EngineEffectChain::ChannelStatus& EngineEffectChain::getChannelStatus(
     return status;
 }
 
+bool EngineEffectChain::isActiveForChannel(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) {
+    if (m_enableState == EffectEnableState::Enabling ||
+            m_enableState == EffectEnableState::Disabling) {
+        return true;
+    }
+    const ChannelStatus& channelStatus =
+            m_chainStatusForChannelMatrix[inputHandle][outputHandle];
+    // A channel that holds a dry delay returns it to m_freeDryDelays after
+    // the effects have stopped, see process().
+    return channelStatus.enableState != EffectEnableState::Disabled ||
+            channelStatus.pDryDelay;
+}
+
 bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
         CSAMPLE* pIn,
@@ -257,8 +366,25 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
     CSAMPLE currentMixKnob = m_dMix;
     CSAMPLE lastCallbackMixKnob = channelStatus.oldMixKnob;
 
+    //TODO: refactor rest of audio engine to use mixxx::AudioParameters
+    const mixxx::EngineParameters engineParameters(
+            mixxx::audio::SampleRate(sampleRate),
+            numSamples / mixxx::kEngineChannelCount);
+
+    // Skip processing while the input is silent and the tails of all effects
+    // have decayed, e.g. for a reverb on a stopped deck. The output would be
+    // as silent as the input. The intermediate enabling/disabling states are
+    // always processed to let the effects reset their state.
+    bool tailExpired = false;
+    if (effectiveChainEnableState == EffectEnableState::Enabled) {
+        tailExpired = isTailExpired(
+                &channelStatus, inputHandle, outputHandle, pIn, engineParameters);
+    } else {
+        channelStatus.silentFrames = 0;
+    }
+
     bool processingOccured = false;
-    if (effectiveChainEnableState != EffectEnableState::Disabled) {
+    if (effectiveChainEnableState != EffectEnableState::Disabled && !tailExpired) {
         // Ramping code inside the effects need to access the original samples
         // after writing to the output buffer. This requires not to use the same buffer
         // for in and output: Also, ChannelMixer::applyEffectsAndMixChannels
@@ -266,6 +392,7 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         CSAMPLE* pIntermediateInput = pIn;
         CSAMPLE* pIntermediateOutput;
         bool firstAddDryToWetEffectProcessed = false;
+        SINT latencyFrames = 0;
 
         for (EngineEffect* pEffect : qAsConst(m_effects)) {
             if (pEffect != nullptr) {
@@ -307,6 +434,7 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
                         firstAddDryToWetEffectProcessed = true;
                     }
 
+                    latencyFrames += pEffect->latencyFrames(inputHandle, outputHandle);
                     processingOccured = true;
                     // Output of this effect becomes the input of the next effect
                     pIntermediateInput = pIntermediateOutput;
@@ -315,13 +443,15 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         }
 
         if (processingOccured) {
+            const CSAMPLE* pDry = compensateLatency(
+                    &channelStatus, pIn, latencyFrames, numSamples);
             // pIntermediateInput is the output of the last processed effect. It would be the
             // intermediate input of the next effect if there was one.
             if (m_mixMode == EffectChainMixMode::DrySlashWet) {
                 // Dry/Wet mode: output = (input * (1-mix knob)) + (wet * mix knob)
                 SampleUtil::copy2WithRampingGain(
                         pOut,
-                        pIn,
+                        pDry,
                         1.0f - lastCallbackMixKnob,
                         1.0f - currentMixKnob,
                         pIntermediateInput,
@@ -332,7 +462,7 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
                 // Dry+Wet mode: output = input + (wet * mix knob)
                 SampleUtil::copy2WithRampingGain(
                         pOut,
-                        pIn,
+                        pDry,
                         1.0f,
                         1.0f,
                         pIntermediateInput,
@@ -343,6 +473,21 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         }
     }
 
+    // Return the delay of the dry signal after the effects have stopped,
+    // so the next channel with latency starts with an empty delay. The
+    // delayed dry signal is faded back to the input first, instead of
+    // jumping ahead by the latency.
+    if (!processingOccured && channelStatus.pDryDelay) {
+        if (channelStatus.dryDelaySamples > 0) {
+            const CSAMPLE* pDry = compensateLatency(&channelStatus, pIn, 0, numSamples);
+            SampleUtil::copy(pOut, pDry, numSamples);
+            processingOccured = true;
+        }
+        channelStatus.pDryDelay->pauseFilter();
+        m_freeDryDelays.push_back(channelStatus.pDryDelay);
+        channelStatus.pDryDelay = nullptr;
+    }
+
     channelStatus.oldMixKnob = currentMixKnob;
 
     // If the EffectProcessors have been sent a signal for the intermediate
@@ -2,10 +2,13 @@
 
 #include <QList>
 #include <QString>
+#include <vector>
 
 #include "engine/channelhandle.h"
 #include "engine/effects/groupfeaturestate.h"
 #include "engine/effects/message.h"
+#include "engine/engine.h"
+#include "engine/filters/enginefilterdelay.h"
 #include "util/class.h"
 #include "util/memory.h"
 #include "util/samplebuffer.h"
@@ -20,7 +23,8 @@ class EngineEffect;
 ///
 /// EngineEffectChain processes a list of EngineEffects in series.
 /// EngineEffectChain manages the input channel routing switches,
-/// the mix knob, and the chain enable switch.
+/// the mix knob, and the chain enable switch. It delays the dry signal by
+/// the latency of the effects before mixing it with the wet signal.
 class EngineEffectChain final : public EffectsRequestHandler {
   public:
     /// called from main thread
@@ -44,17 +48,50 @@ class EngineEffectChain final : public EffectsRequestHandler {
             const unsigned int sampleRate,
             const GroupFeatureState& groupFeatures);
 
+    /// Returns true if process() for the channel changes state of the chain
+    /// that is shared by all channels, i.e. if the chain is enabled for the
+    /// channel, its enable switch has just been toggled or the channel still
+    /// holds one of the shared dry delays. The effects of the chain, their
+    /// EffectProcessors and the buffers of the chain are only used for such
+    /// channels. For all other channels process() only updates the
+    /// ChannelStatus of the channel, so the chain may process them in
+    /// parallel with each other and with one active channel.
+    /// called from audio thread
+    bool isActiveForChannel(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle);
+
     /// called from main thread
     void deleteStatesForInputChannel(const ChannelHandle* channel);
 
   private:
+    // The latency of the effects that is compensated in the dry signal
+    static constexpr SINT kMaxLatencyCompensationFrames = 2048;
+    // The number of channels that can be compensated at the same time.
+    // The latency of other channels is not compensated.
+    static constexpr int kLatencyCompensatedChannels = 4;
+    typedef EngineFilterDelay<(kMaxLatencyCompensationFrames + 1) *
+            mixxx::kEngineChannelCount>
+            DryDelay;
+
     struct ChannelStatus {
         ChannelStatus()
                 : oldMixKnob(0),
-                  enableState(EffectEnableState::Disabled) {
+                  enableState(EffectEnableState::Disabled),
+                  silentFrames(0),
+                  pDryDelay(nullptr),
+                  dryDelaySamples(0),
+                  dryDelayFilledSamples(0) {
         }
         CSAMPLE oldMixKnob;
         EffectEnableState enableState;
+        // The number of frames since the input became silent
+        SINT silentFrames;
+        // Taken from m_freeDryDelays while the effects have a latency
+        DryDelay* pDryDelay;
+        // The delay that is currently applied to the dry signal
+        SINT dryDelaySamples;
+        // The number of input samples in pDryDelay, up to its size
+        SINT dryDelayFilledSamples;
     };
 
     QString debugString() const {
@@ -64,10 +101,25 @@ class EngineEffectChain final : public EffectsRequestHandler {
     bool updateParameters(const EffectsRequest& message);
     bool addEffect(EngineEffect* pEffect, int iIndex);
     bool removeEffect(EngineEffect* pEffect, int iIndex);
-    bool enableForInputChannel(const ChannelHandle* inputHandle,
-            EffectStatesMapArray* statesForEffectsInChain);
+    bool replaceEffects(EngineEffect** pEffects, int numEffects);
+    bool enableForInputChannel(const ChannelHandle* inputHandle);
     bool disableForInputChannel(const ChannelHandle* inputHandle);
 
+    // Returns true if the input has been silent for longer than the tails
+    // of the effects, updating the silence counter of the channel.
+    bool isTailExpired(ChannelStatus* pChannelStatus,
+            const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            const CSAMPLE* pIn,
+            const mixxx::EngineParameters& engineParameters);
+
+    // Returns the dry signal delayed by the latency of the effects. Changes
+    // of the delay are crossfaded.
+    const CSAMPLE* compensateLatency(ChannelStatus* pChannelStatus,
+            const CSAMPLE* pIn,
+            SINT latencyFrames,
+            const unsigned int numSamples);
+
     // Gets or creates a ChannelStatus entry in m_channelStatus for the provided
     // handle.
     ChannelStatus& getChannelStatus(const ChannelHandle& inputHandle,
@@ -80,6 +132,9 @@ class EngineEffectChain final : public EffectsRequestHandler {
     QList<EngineEffect*> m_effects;
     mixxx::SampleBuffer m_buffer1;
     mixxx::SampleBuffer m_buffer2;
+    mixxx::SampleBuffer m_dryBuffer;
+    std::vector<std::unique_ptr<DryDelay>> m_dryDelays;
+    std::vector<DryDelay*> m_freeDryDelays;
     ChannelHandleMap<ChannelHandleMap<ChannelStatus>> m_chainStatusForChannelMatrix;
 
     DISALLOW_COPY_AND_ASSIGN(EngineEffectChain);
@@ -1,16 +1,38 @@
 #include "engine/effects/engineeffectsmanager.h"
 
+#include <QThread>
+
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectchain.h"
 #include "util/defs.h"
+#include "util/math.h"
 #include "util/sample.h"
 
+namespace {
+
+// More threads do not pay off with the usual number of decks
+constexpr int kMaxWorkerThreads = 3;
+
+// The channels that can be processed in parallel are found with a bit per
+// EngineEffectChain. Larger setups are processed serially.
+typedef quint64 ChainMask;
+constexpr int kMaxParallelChains = 64;
+constexpr int kMaxParallelChannels = 32;
+
+} // anonymous namespace
+
 EngineEffectsManager::EngineEffectsManager(EffectsResponsePipe* pResponsePipe)
         : m_pResponsePipe(pResponsePipe),
           m_buffer1(MAX_BUFFER_LEN),
           m_buffer2(MAX_BUFFER_LEN) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
+
+    // The engine thread processes channels too
+    const int workerCount = math_min(QThread::idealThreadCount() - 1, kMaxWorkerThreads);
+    if (workerCount > 0) {
+        m_pWorkerPool = std::make_unique<EngineEffectsWorkerPool>(workerCount);
+    }
 }
 
 EngineEffectsManager::~EngineEffectsManager() {
@@ -30,6 +52,7 @@ void EngineEffectsManager::onCallbackStart() {
             break;
         case EffectsRequest::ADD_EFFECT_TO_CHAIN:
         case EffectsRequest::REMOVE_EFFECT_FROM_CHAIN:
+        case EffectsRequest::REPLACE_EFFECTS_IN_CHAIN:
         case EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS:
         case EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL:
         case EffectsRequest::DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL: {
@@ -46,6 +69,16 @@ void EngineEffectsManager::onCallbackStart() {
                 break;
             }
         }
+            if (request->type == EffectsRequest::REPLACE_EFFECTS_IN_CHAIN) {
+                // The array holds the replaced effects after the request has
+                // been processed, so add the new ones to our master list first.
+                for (int i = 0; i < request->ReplaceEffectsInChain.iNumEffects; ++i) {
+                    EngineEffect* pEffect = request->ReplaceEffectsInChain.pEffects[i];
+                    if (pEffect) {
+                        m_effects.append(pEffect);
+                    }
+                }
+            }
             processed = request->pTargetChain->processEffectsRequest(
                     *request, m_pResponsePipe.data());
             if (processed) {
@@ -56,6 +89,13 @@ void EngineEffectsManager::onCallbackStart() {
                     m_effects.append(request->AddEffectToChain.pEffect);
                 } else if (request->type == EffectsRequest::REMOVE_EFFECT_FROM_CHAIN) {
                     m_effects.removeAll(request->RemoveEffectFromChain.pEffect);
+                } else if (request->type == EffectsRequest::REPLACE_EFFECTS_IN_CHAIN) {
+                    for (int i = 0; i < request->ReplaceEffectsInChain.iNumEffects; ++i) {
+                        EngineEffect* pEffect = request->ReplaceEffectsInChain.pEffects[i];
+                        if (pEffect) {
+                            m_effects.removeAll(pEffect);
+                        }
+                    }
                 }
             } else {
                 // If we got here, the message was not handled for
@@ -65,7 +105,6 @@ void EngineEffectsManager::onCallbackStart() {
             }
             break;
         case EffectsRequest::SET_EFFECT_PARAMETERS:
-        case EffectsRequest::SET_PARAMETER_PARAMETERS:
             VERIFY_OR_DEBUG_ASSERT(m_effects.contains(request->pTargetEffect)) {
                 response.success = false;
                 response.status = EffectsResponse::NO_SUCH_EFFECT;
@@ -92,6 +131,12 @@ void EngineEffectsManager::onCallbackStart() {
             m_pResponsePipe->writeMessage(response);
         }
     }
+
+    // Apply the parameter changes after the effects have been added, so all
+    // chains of this callback process the same parameter values.
+    for (EngineEffect* pEffect : std::as_const(m_effects)) {
+        pEffect->updateParameters();
+    }
 }
 
 void EngineEffectsManager::processPreFaderInPlace(const ChannelHandle& inputHandle,
@@ -133,6 +178,82 @@ void EngineEffectsManager::processPostFaderInPlace(
             newGain);
 }
 
+void EngineEffectsManager::processPostFaderInPlace(
+        const ChannelHandle& outputHandle,
+        const InPlaceChannel* pChannels,
+        int channelCount,
+        const unsigned int numSamples,
+        const unsigned int sampleRate) {
+    const auto processChannel = [&](const InPlaceChannel& channel) {
+        processInner(SignalProcessingStage::Postfader,
+                *channel.pInputHandle,
+                outputHandle,
+                channel.pInOut,
+                channel.pInOut,
+                numSamples,
+                sampleRate,
+                *channel.pGroupFeatures,
+                channel.oldGain,
+                channel.newGain);
+    };
+
+    const QList<EngineEffectChain*>& chains =
+            m_chainsByStage.value(SignalProcessingStage::Postfader);
+    if (!m_pWorkerPool ||
+            channelCount < 2 ||
+            channelCount > kMaxParallelChannels ||
+            chains.size() > kMaxParallelChains) {
+        for (int i = 0; i < channelCount; ++i) {
+            processChannel(pChannels[i]);
+        }
+        return;
+    }
+
+    // Assign the channels to consecutive rounds. A channel is processed in
+    // a later round than all preceding channels that share an active chain
+    // with it, so the channels of a round can be processed in parallel and
+    // every chain processes its channels in the original order.
+    ChainMask masks[kMaxParallelChannels];
+    int rounds[kMaxParallelChannels];
+    int roundCount = 0;
+    for (int i = 0; i < channelCount; ++i) {
+        ChainMask mask = 0;
+        for (int chain = 0; chain < chains.size(); ++chain) {
+            EngineEffectChain* pChain = chains[chain];
+            if (pChain &&
+                    pChain->isActiveForChannel(*pChannels[i].pInputHandle, outputHandle)) {
+                mask |= ChainMask(1) << chain;
+            }
+        }
+        int round = 0;
+        for (int j = 0; j < i; ++j) {
+            if (masks[j] & mask) {
+                round = math_max(round, rounds[j] + 1);
+            }
+        }
+        masks[i] = mask;
+        rounds[i] = round;
+        roundCount = math_max(roundCount, round + 1);
+    }
+
+    for (int round = 0; round < roundCount; ++round) {
+        int roundChannels[kMaxParallelChannels];
+        int roundChannelCount = 0;
+        for (int i = 0; i < channelCount; ++i) {
+            if (rounds[i] == round) {
+                roundChannels[roundChannelCount++] = i;
+            }
+        }
+        if (roundChannelCount == 1) {
+            processChannel(pChannels[roundChannels[0]]);
+        } else {
+            m_pWorkerPool->run(roundChannelCount, [&](int index) {
+                processChannel(pChannels[roundChannels[index]]);
+            });
+        }
+    }
+}
+
 void EngineEffectsManager::processPostFaderAndMix(
         const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <QScopedPointer>
+#include <memory>
 
 #include "engine/channelhandle.h"
+#include "engine/effects/engineeffectsworkerpool.h"
 #include "engine/effects/groupfeaturestate.h"
 #include "engine/effects/message.h"
 #include "util/fifo.h"
@@ -22,6 +24,15 @@ class EngineEffect;
 ///                                      PFL switch --> QuickEffectChains & StandardEffectChains --> mix channels into headphone mix --> headphone effect processing
 class EngineEffectsManager final : public EffectsRequestHandler {
   public:
+    /// A channel for processPostFaderInPlace() with several channels
+    struct InPlaceChannel {
+        const ChannelHandle* pInputHandle;
+        CSAMPLE* pInOut;
+        const GroupFeatureState* pGroupFeatures;
+        CSAMPLE_GAIN oldGain;
+        CSAMPLE_GAIN newGain;
+    };
+
     EngineEffectsManager(EffectsResponsePipe* pResponsePipe);
     ~EngineEffectsManager();
 
@@ -48,6 +59,25 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             const CSAMPLE_GAIN oldGain = CSAMPLE_GAIN_ONE,
             const CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE);
 
+    /// Process the postfader EngineEffectChains on the buffers of several
+    /// channels in place, like calling the function above for each channel.
+    /// Channels that are not processed by a common EngineEffectChain are
+    /// processed in parallel on the worker threads. Channels that share a
+    /// chain are processed in the given order, so the output does not depend
+    /// on the scheduling of the threads.
+    ///
+    /// A chain shares its buffers, its dry delays and its EngineEffects with
+    /// the EffectProcessors between all channels. These are only touched for
+    /// channels for which EngineEffectChain::isActiveForChannel() is true, so
+    /// at most one of the channels that are processed at the same time uses
+    /// them.
+    void processPostFaderInPlace(
+            const ChannelHandle& outputHandle,
+            const InPlaceChannel* pChannels,
+            int channelCount,
+            const unsigned int numSamples,
+            const unsigned int sampleRate);
+
     /// Process the postfader EngineEffectChains, leaving the pIn buffer unmodified
     /// and mixing the output into the pOut buffer. Using EngineEffectsManager's
     /// temporary buffers for this avoids the need for ChannelMixer to allocate a
@@ -100,4 +130,7 @@ class EngineEffectsManager final : public EffectsRequestHandler {
 
     mixxx::SampleBuffer m_buffer1;
     mixxx::SampleBuffer m_buffer2;
+
+    // Null if there is only a single CPU core
+    std::unique_ptr<EngineEffectsWorkerPool> m_pWorkerPool;
 };
@@ -0,0 +1,138 @@
+#include "engine/effects/engineeffectsworkerpool.h"
+
+#include <QThread>
+#include <QtDebug>
+#include <thread>
+
+#include "util/assert.h"
+#include "util/denormalsarezero.h"
+#include "util/math.h"
+#include "util/wakesemaphore.h"
+
+namespace {
+
+constexpr std::uint64_t kTaskIndexMask = 0xFFFF;
+constexpr int kTaskCountShift = 16;
+constexpr int kGenerationShift = 32;
+
+int nextTaskIndex(std::uint64_t taskState) {
+    return static_cast<int>(taskState & kTaskIndexMask);
+}
+
+int taskCount(std::uint64_t taskState) {
+    return static_cast<int>((taskState >> kTaskCountShift) & kTaskIndexMask);
+}
+
+} // anonymous namespace
+
+class EngineEffectsWorkerPool::Worker : public QThread {
+  public:
+    Worker(EngineEffectsWorkerPool* pPool, int index)
+            : m_pPool(pPool),
+              m_stop(false) {
+        setObjectName(QStringLiteral("EngineEffectsWorker %1").arg(index));
+    }
+
+    void wake() {
+        m_wake.release();
+    }
+
+    void stop() {
+        m_stop.store(true);
+        m_wake.release();
+        wait();
+    }
+
+  protected:
+    void run() override {
+        // The results must not depend on the thread that processes a task
+        VERIFY_OR_DEBUG_ASSERT(mixxx::enableDenormalsAreZero()) {
+            qWarning() << objectName() << "Denormals are not flushed to zero";
+        }
+        int appliedSchedulingGeneration = 0;
+        while (true) {
+            m_wake.acquire();
+            if (m_stop.load()) {
+                return;
+            }
+            m_pPool->m_engineThreadScheduling.applyToCurrentThread(
+                    &appliedSchedulingGeneration);
+            m_pPool->processTasks();
+        }
+    }
+
+  private:
+    EngineEffectsWorkerPool* const m_pPool;
+    WakeSemaphore m_wake;
+    std::atomic<bool> m_stop;
+};
+
+EngineEffectsWorkerPool::EngineEffectsWorkerPool(int workerCount)
+        : m_taskFunction(nullptr),
+          m_pTask(nullptr),
+          m_taskState(0),
+          m_completedTasks(0) {
+    DEBUG_ASSERT(workerCount > 0);
+    m_workers.reserve(workerCount);
+    for (int i = 0; i < workerCount; ++i) {
+        m_workers.push_back(std::make_unique<Worker>(this, i));
+        // On Linux the workers additionally adopt the real-time scheduling
+        // of the engine thread, see EngineThreadScheduling
+        m_workers.back()->start(QThread::TimeCriticalPriority);
+    }
+}
+
+EngineEffectsWorkerPool::~EngineEffectsWorkerPool() {
+    for (const auto& pWorker : m_workers) {
+        pWorker->stop();
+    }
+}
+
+void EngineEffectsWorkerPool::runTasks(
+        int taskCount, TaskFunction function, void* pTask) {
+    VERIFY_OR_DEBUG_ASSERT(taskCount >= 0 &&
+            static_cast<std::uint64_t>(taskCount) <= kTaskIndexMask) {
+        return;
+    }
+    m_engineThreadScheduling.captureFromCurrentThread();
+
+    // All tasks of the previous run have been completed, so no worker
+    // accesses these until the new tasks are published below.
+    m_taskFunction = function;
+    m_pTask = pTask;
+    m_completedTasks.store(0, std::memory_order_relaxed);
+    const std::uint64_t generation =
+            (m_taskState.load(std::memory_order_relaxed) >> kGenerationShift) + 1;
+    m_taskState.store((generation << kGenerationShift) |
+                    (static_cast<std::uint64_t>(taskCount) << kTaskCountShift),
+            std::memory_order_release);
+
+    const int wokenWorkers = math_min(taskCount - 1, workerCount());
+    for (int i = 0; i < wokenWorkers; ++i) {
+        m_workers[i]->wake();
+    }
+
+    processTasks();
+    // Only wait for tasks that are still being processed by a worker.
+    // Workers that wake up after all tasks were taken find none and go back
+    // to sleep.
+    while (m_completedTasks.load(std::memory_order_acquire) < taskCount) {
+        std::this_thread::yield();
+    }
+}
+
+void EngineEffectsWorkerPool::processTasks() {
+    std::uint64_t taskState = m_taskState.load(std::memory_order_acquire);
+    while (nextTaskIndex(taskState) < taskCount(taskState)) {
+        // Fails if another thread has taken the task or if a new run has been
+        // started in the meantime. Retry with the updated state in both cases.
+        if (m_taskState.compare_exchange_weak(taskState,
+                    taskState + 1,
+                    std::memory_order_acq_rel,
+                    std::memory_order_acquire)) {
+            m_taskFunction(m_pTask, nextTaskIndex(taskState));
+            m_completedTasks.fetch_add(1, std::memory_order_release);
+            taskState = m_taskState.load(std::memory_order_acquire);
+        }
+    }
+}
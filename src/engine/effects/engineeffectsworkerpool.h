@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "engine/enginethreadscheduling.h"
+
+/// A pool of real-time threads that help the engine thread to process
+/// independent tasks in parallel within a single engine callback.
+///
+/// The threads sleep between the callbacks and are only woken for tasks that
+/// can be processed in parallel. run() does not allocate, does not lock and
+/// returns as soon as all tasks have been processed. The calling thread
+/// processes tasks too, so a task is never waiting for a worker to wake up
+/// while the calling thread is idle. Workers that wake up after all tasks have
+/// been taken go back to sleep without being waited for.
+///
+/// The workers flush denormals to zero like the engine thread and adopt its
+/// real-time scheduling, so the results do not depend on the thread that
+/// processes a task.
+class EngineEffectsWorkerPool {
+  public:
+    /// The pool is only useful with at least one worker.
+    explicit EngineEffectsWorkerPool(int workerCount);
+    ~EngineEffectsWorkerPool();
+
+    int workerCount() const {
+        return static_cast<int>(m_workers.size());
+    }
+
+    /// Calls task(index) for every index in [0, taskCount). Must only be
+    /// called from the engine thread.
+    template<typename Task>
+    void run(int taskCount, Task&& task) {
+        runTasks(taskCount,
+                [](void* pTask, int index) {
+                    (*static_cast<std::remove_reference_t<Task>*>(pTask))(index);
+                },
+                &task);
+    }
+
+  private:
+    class Worker;
+    using TaskFunction = void (*)(void* pTask, int index);
+
+    void runTasks(int taskCount, TaskFunction function, void* pTask);
+    /// Takes and processes tasks until all are taken.
+    void processTasks();
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    // Written by the engine thread before the tasks are published through
+    // m_taskState
+    TaskFunction m_taskFunction;
+    void* m_pTask;
+
+    // The generation of the run in the upper 32 bits, the number of tasks and
+    // the index of the next task to be taken in the lower 16 bits each. A
+    // task is taken with a compare and swap, so a worker that wakes up late
+    // cannot take a task of a later run by accident.
+    std::atomic<std::uint64_t> m_taskState;
+    std::atomic<int> m_completedTasks;
+
+    EngineThreadScheduling m_engineThreadScheduling;
+};
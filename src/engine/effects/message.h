@@ -21,14 +21,16 @@ struct EffectsRequest {
         SET_EFFECT_CHAIN_PARAMETERS,
         ADD_EFFECT_TO_CHAIN,
         REMOVE_EFFECT_FROM_CHAIN,
+        REPLACE_EFFECTS_IN_CHAIN,
         // Effects cannot currently be toggled for output channels;
         // the outputs that effects are applied to are hardwired in EngineMaster
         ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL,
         DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL,
 
         // Messages for EngineEffect
+        // Parameter values are not sent as messages, see
+        // EngineEffect::setParameter
         SET_EFFECT_PARAMETERS,
-        SET_PARAMETER_PARAMETERS,
 
         // Must come last.
         NUM_REQUEST_TYPES
@@ -36,8 +38,7 @@ struct EffectsRequest {
 
     EffectsRequest()
             : type(NUM_REQUEST_TYPES),
-              request_id(-1),
-              value(0.0) {
+              request_id(-1) {
         pTargetChain = nullptr;
         pTargetEffect = nullptr;
 #define CLEAR_STRUCT(x) memset(&x, 0, sizeof(x));
@@ -47,26 +48,12 @@ struct EffectsRequest {
         CLEAR_STRUCT(DisableInputChannelForChain);
         CLEAR_STRUCT(AddEffectToChain);
         CLEAR_STRUCT(RemoveEffectFromChain);
+        CLEAR_STRUCT(ReplaceEffectsInChain);
         CLEAR_STRUCT(SetEffectChainParameters);
         CLEAR_STRUCT(SetEffectParameters);
-        CLEAR_STRUCT(SetParameterParameters);
 #undef CLEAR_STRUCT
     }
 
-    // This is called from the main thread by EffectsManager after receiving a
-    // response from EngineEffectsManager in the audio engine thread.
-    ~EffectsRequest() {
-        if (type == ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL) {
-            VERIFY_OR_DEBUG_ASSERT(EnableInputChannelForChain.pEffectStatesMapArray != nullptr) {
-                return;
-            }
-            // This only deletes the container used to passed the EffectStates
-            // to EffectProcessorImpl. The EffectStates are managed by
-            // EffectProcessorImpl.
-            delete EnableInputChannelForChain.pEffectStatesMapArray;
-        }
-    }
-
     MessageType type;
     qint64 request_id;
 
@@ -75,6 +62,7 @@ struct EffectsRequest {
         // Used by:
         // - ADD_EFFECT_TO_CHAIN
         // - REMOVE_EFFECT_FROM_CHAIN
+        // - REPLACE_EFFECTS_IN_CHAIN
         // - SET_EFFECT_CHAIN_PARAMETERS
         // - ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL
         // - DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL
@@ -96,7 +84,6 @@ struct EffectsRequest {
             SignalProcessingStage signalProcessingStage;
         } RemoveEffectChain;
         struct {
-            EffectStatesMapArray* pEffectStatesMapArray;
             const ChannelHandle* pChannelHandle;
         } EnableInputChannelForChain;
         struct {
@@ -110,6 +97,13 @@ struct EffectsRequest {
             EngineEffect* pEffect;
             int iIndex;
         } RemoveEffectFromChain;
+        struct {
+            // The new effect for each effect slot or nullptr. The engine swaps
+            // them with the effects of the chain, so the array holds the
+            // replaced effects for garbage collection afterwards.
+            EngineEffect** pEffects;
+            int iNumEffects;
+        } ReplaceEffectsInChain;
         struct {
             bool enabled;
             EffectChainMixMode::Type mix_mode;
@@ -118,13 +112,7 @@ struct EffectsRequest {
         struct {
             bool enabled;
         } SetEffectParameters;
-        struct {
-            int iParameter;
-        } SetParameterParameters;
     };
-
-    // Used by SET_EFFECT_PARAMETER.
-    double value;
 };
 
 struct EffectsResponse {
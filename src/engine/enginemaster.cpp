@@ -177,6 +177,11 @@ EngineMaster::EngineMaster(
     m_pKeylockEngine->set(pConfig->getValueString(
             ConfigKey(group, "keylock_engine")).toDouble());
 
+    // 1 selects the reference kernels of the effects that have a vectorized
+    // kernel, see DspKernel
+    m_pDspKernel = new ControlObject(ConfigKey(group, "dsp_kernel"),
+            true, false, true);  // persist = true
+
     // TODO: Make this read only and make EngineMaster decide whether
     // processing the master mix is necessary.
     m_pMasterEnabled = new ControlObject(ConfigKey(group, "enabled"),
@@ -196,6 +201,7 @@ EngineMaster::EngineMaster(
 EngineMaster::~EngineMaster() {
     //qDebug() << "in ~EngineMaster()";
     delete m_pKeylockEngine;
+    delete m_pDspKernel;
     delete m_pCrossfader;
     delete m_pBalance;
     delete m_pHeadMix;
@@ -326,6 +326,7 @@ class EngineMaster : public QObject, public AudioSource {
     ControlPushButton* m_pXFaderReverse;
     ControlPushButton* m_pHeadSplitEnabled;
     ControlObject* m_pKeylockEngine;
+    ControlObject* m_pDspKernel;
 
     PflGainCalculator m_headphoneGain;
     TalkoverGainCalculator m_talkoverGain;
@@ -0,0 +1,58 @@
+#include "engine/enginethreadscheduling.h"
+
+#include <QThread>
+#include <QtDebug>
+
+#ifdef __LINUX__
+#include <pthread.h>
+#endif
+
+EngineThreadScheduling::EngineThreadScheduling()
+        : m_generation(0),
+          m_policy(0),
+          m_priority(0),
+          m_engineThreadId(0) {
+}
+
+void EngineThreadScheduling::captureFromCurrentThread() {
+#ifdef __LINUX__
+    const auto engineThreadId =
+            reinterpret_cast<std::uintptr_t>(QThread::currentThreadId());
+    if (engineThreadId == m_engineThreadId) {
+        return;
+    }
+    m_engineThreadId = engineThreadId;
+
+    int policy;
+    struct sched_param spm = {0};
+    if (pthread_getschedparam(pthread_self(), &policy, &spm) != 0 ||
+            (policy != SCHED_FIFO && policy != SCHED_RR)) {
+        // Not a real-time thread, the helpers keep their priority
+        return;
+    }
+    m_policy.store(policy, std::memory_order_relaxed);
+    m_priority.store(spm.sched_priority, std::memory_order_relaxed);
+    m_generation.fetch_add(1, std::memory_order_release);
+#endif
+}
+
+void EngineThreadScheduling::applyToCurrentThread(int* pAppliedGeneration) {
+#ifdef __LINUX__
+    const int generation = m_generation.load(std::memory_order_acquire);
+    if (generation == *pAppliedGeneration) {
+        return;
+    }
+    *pAppliedGeneration = generation;
+
+    struct sched_param spm = {0};
+    spm.sched_priority = m_priority.load(std::memory_order_relaxed);
+    if (pthread_setschedparam(pthread_self(),
+                m_policy.load(std::memory_order_relaxed),
+                &spm)) {
+        qWarning() << QThread::currentThread()->objectName()
+                   << "Failed bumping priority";
+    }
+#else
+    Q_UNUSED(pAppliedGeneration);
+#endif
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/// Lets the threads that help the engine thread adopt its real-time
+/// scheduling, so they are not preempted by ordinary threads while the engine
+/// thread waits for their results. Only implemented on Linux, where the
+/// engine thread is a SCHED_FIFO thread if the sound API provides one. On
+/// other platforms the helpers only run at QThread::TimeCriticalPriority.
+class EngineThreadScheduling {
+  public:
+    EngineThreadScheduling();
+
+    /// Called from the engine thread before it wakes a helper. The engine
+    /// thread is replaced when the sound devices are restarted, so its
+    /// scheduling is looked at again whenever it has changed.
+    void captureFromCurrentThread();
+
+    /// Called from a helper thread after it has been woken. Applies the
+    /// scheduling of the engine thread if it has changed since
+    /// *pAppliedGeneration, which starts at 0.
+    void applyToCurrentThread(int* pAppliedGeneration);
+
+  private:
+    std::atomic<int> m_generation;
+    std::atomic<int> m_policy;
+    std::atomic<int> m_priority;
+    // Only accessed by the engine thread
+    std::uintptr_t m_engineThreadId;
+};
@@ -7,6 +7,7 @@
 EngineFilterBiquad1LowShelving::EngineFilterBiquad1LowShelving(int sampleRate,
                                                                double centerFreq,
                                                                double Q) {
+    setCoefInterpolation(true);
     m_startFromDry = true;
     setFrequencyCorners(sampleRate, centerFreq, Q, 0);
 }
@@ -21,6 +22,7 @@ void EngineFilterBiquad1LowShelving::setFrequencyCorners(int sampleRate,
 
 EngineFilterBiquad1Peaking::EngineFilterBiquad1Peaking(int sampleRate,
                                                        double centerFreq, double Q) {
+    setCoefInterpolation(true);
     m_startFromDry = true;
     setFrequencyCorners(sampleRate, centerFreq, Q, 0);
 }
@@ -36,6 +38,7 @@ void EngineFilterBiquad1Peaking::setFrequencyCorners(int sampleRate,
 EngineFilterBiquad1HighShelving::EngineFilterBiquad1HighShelving(int sampleRate,
                                                                  double centerFreq,
                                                                  double Q) {
+    setCoefInterpolation(true);
     m_startFromDry = true;
     setFrequencyCorners(sampleRate, centerFreq, Q, 0);
 }
@@ -52,6 +55,7 @@ EngineFilterBiquad1Low::EngineFilterBiquad1Low(int sampleRate,
                                                double centerFreq,
                                                double Q,
                                                bool startFromDry) {
+    setCoefInterpolation(true);
     m_startFromDry = startFromDry;
     setFrequencyCorners(sampleRate, centerFreq, Q);
 }
@@ -66,6 +70,7 @@ void EngineFilterBiquad1Low::setFrequencyCorners(int sampleRate,
 EngineFilterBiquad1Band::EngineFilterBiquad1Band(int sampleRate,
                                                  double centerFreq,
                                                  double Q) {
+    setCoefInterpolation(true);
     setFrequencyCorners(sampleRate, centerFreq, Q);
 }
 
@@ -80,6 +85,7 @@ EngineFilterBiquad1High::EngineFilterBiquad1High(int sampleRate,
                                                  double centerFreq,
                                                  double Q,
                                                  bool startFromDry) {
+    setCoefInterpolation(true);
     m_startFromDry = startFromDry;
     setFrequencyCorners(sampleRate, centerFreq, Q);
 }
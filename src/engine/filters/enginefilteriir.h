@@ -7,6 +7,7 @@
 #include <fidlib.h>
 
 #include "engine/engineobject.h"
+#include "util/parametersmoothing.h"
 #include "util/sample.h"
 
 // set to 1 to print some analysis data using qDebug()
@@ -38,10 +39,15 @@ class EngineFilterIIRBase : public EngineObjectConstIn {
 template<unsigned int SIZE, enum IIRPass PASS>
 class EngineFilterIIR : public EngineFilterIIRBase {
   public:
+    static constexpr unsigned int kSize = SIZE;
+    static constexpr IIRPass kPass = PASS;
+
     EngineFilterIIR()
             : m_doRamping(false),
               m_doStart(false),
-              m_startFromDry(false) {
+              m_startFromDry(false),
+              m_interpolateCoefs(false),
+              m_doInterpolation(false) {
         memset(m_coef, 0, sizeof(m_coef));
         pauseFilter();
     }
@@ -60,6 +66,14 @@ class EngineFilterIIR : public EngineFilterIIRBase {
         m_startFromDry = val;
     }
 
+    // If enabled, new coefficients of a running filter are reached by
+    // interpolating the coefficients at control rate, keeping the state of
+    // the filter, instead of crossfading to a restarted filter.
+    // This is only stable for filters made of second order sections
+    void setCoefInterpolation(bool val) {
+        m_interpolateCoefs = val;
+    }
+
     // this is can be used instead off a final process() call before pause
     // It fades to dry or 0 according to the m_startFromDry parameter
     // it is an alternative for using pauseFillter() calls
@@ -81,6 +95,24 @@ class EngineFilterIIR : public EngineFilterIIRBase {
         pauseFilterInner();
     }
 
+    // Called before designing new coefficients
+    void backupCoefs() {
+        // A pending interpolation still starts from the coefficients that
+        // have been used for the last buffer
+        if (!m_doInterpolation) {
+            memcpy(m_oldCoef, m_coef, sizeof(m_coef));
+        }
+    }
+
+    // Called after designing new coefficients
+    void coefsChanged() {
+        if (m_interpolateCoefs && !m_doRamping) {
+            m_doInterpolation = true;
+        } else {
+            initBuffers();
+        }
+    }
+
     void initBuffers() {
         // Copy the current buffers into the old buffers
         memcpy(m_oldBuf1, m_buf1, sizeof(m_buf1));
@@ -104,12 +136,11 @@ class EngineFilterIIR : public EngineFilterIIRBase {
         // Copy to dynamic-ish memory to prevent fidlib API breakage.
         std::strncpy(spec_d, spec, bufsize);
 
-        // Copy the old coefficients into m_oldCoef
-        memcpy(m_oldCoef, m_coef, sizeof(m_coef));
+        backupCoefs();
 
         m_coef[0] = fid_design_coef(m_coef + 1, SIZE, spec_d, sampleRate, freq0, freq1, adj);
 
-        initBuffers();
+        coefsChanged();
 
 #if(IIR_ANALYSIS)
         char* desc;
@@ -164,8 +195,7 @@ class EngineFilterIIR : public EngineFilterIIRBase {
         spec1_d[FIDSPEC_LENGTH - 1] = '\0';
         spec2_d[FIDSPEC_LENGTH - 1] = '\0';
 
-        // Copy the old coefficients into m_oldCoef
-        memcpy(m_oldCoef, m_coef, sizeof(m_coef));
+        backupCoefs();
         m_coef[0] = fid_design_coef(m_coef + 1,
                             n_coef1,
                             spec1,
@@ -181,7 +211,7 @@ class EngineFilterIIR : public EngineFilterIIRBase {
                         freq12,
                         adj2);
 
-        initBuffers();
+        coefsChanged();
 
 #if(IIR_ANALYSIS)
         char* desc1;
@@ -226,11 +256,32 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     virtual void assumeSettled() {
         m_doRamping = false;
         m_doStart = false;
+        m_doInterpolation = false;
+    }
+
+    // The gain followed by the SIZE coefficients of the designed filter
+    const double* coefs() const {
+        return m_coef;
     }
 
     virtual void process(const CSAMPLE* pIn, CSAMPLE* pOutput,
                          const int iBufferSize) {
-        if (!m_doRamping) {
+        if (m_doInterpolation) {
+            double coef[SIZE + 1];
+            ParameterSmoothing::forEachBlock<double>(iBufferSize / 2,
+                    [&](double t, SINT offsetFrames, SINT blockFrames) {
+                        ParameterSmoothing::interpolate(
+                                coef, m_oldCoef, m_coef, SIZE + 1, t);
+                        const int end = static_cast<int>(offsetFrames + blockFrames) * 2;
+                        for (int i = static_cast<int>(offsetFrames) * 2; i < end; i += 2) {
+                            pOutput[i] = static_cast<CSAMPLE>(
+                                    processSample(coef, m_buf1, pIn[i]));
+                            pOutput[i + 1] = static_cast<CSAMPLE>(
+                                    processSample(coef, m_buf2, pIn[i + 1]));
+                        }
+                    });
+            m_doInterpolation = false;
+        } else if (!m_doRamping) {
             for (int i = 0; i < iBufferSize; i += 2) {
                 pOutput[i] = static_cast<CSAMPLE>(processSample(m_coef, m_buf1, pIn[i]));
                 pOutput[i + 1] = static_cast<CSAMPLE>(processSample(m_coef, m_buf2, pIn[i + 1]));
@@ -291,6 +342,7 @@ class EngineFilterIIR : public EngineFilterIIRBase {
         memset(m_buf2, 0, sizeof(m_buf2));
         m_doRamping = true;
         m_doStart = true;
+        m_doInterpolation = false;
     }
 
     double m_coef[SIZE + 1];
@@ -313,6 +365,10 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     bool m_doStart;
     // Flag set to true if this is a chained filter
     bool m_startFromDry;
+    // Flag set to true if new coefficients are interpolated
+    bool m_interpolateCoefs;
+    // Flag set to true if the next buffer interpolates from m_oldCoef to m_coef
+    bool m_doInterpolation;
 };
 
 template<>
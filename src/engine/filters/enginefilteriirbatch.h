@@ -0,0 +1,202 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+
+#include "engine/filters/enginefilteriir.h"
+#include "util/sample.h"
+
+// Processes several stereo IIR filters of the same topology in lockstep.
+//
+// The filter states are stored as structure of arrays, with one lane per
+// audio channel of each filter, so the inner loops over the lanes can be
+// vectorized by the compiler. Every filter has its own coefficients, they are
+// designed by a EngineFilterIIR of the same SIZE and PASS and copied with
+// setCoefs(). The results are identical to processing each filter on its own.
+//
+// Only the low and high pass filters made of cascaded second order sections
+// are supported.
+template<unsigned int SIZE, enum IIRPass PASS, int FILTERS>
+class EngineFilterIIRBatch {
+    static_assert(PASS == IIR_LP || PASS == IIR_HP,
+            "Only low and high pass filters can be batched");
+    static_assert(SIZE % 2 == 0,
+            "The filter must consist of second order sections");
+
+  public:
+    EngineFilterIIRBatch() {
+        memset(m_coef, 0, sizeof(m_coef));
+        memset(m_oldCoef, 0, sizeof(m_oldCoef));
+        memset(m_oldBuf, 0, sizeof(m_oldBuf));
+        for (int filter = 0; filter < FILTERS; ++filter) {
+            pauseFilter(filter);
+        }
+    }
+
+    // Copies the coefficients of the given filter to the filter with the
+    // given index and cross fades to them during the next process() call
+    void setCoefs(int filter, const EngineFilterIIR<SIZE, PASS>& design) {
+        const double* pCoef = design.coefs();
+        for (int lane = 2 * filter; lane < 2 * filter + 2; ++lane) {
+            for (unsigned int i = 0; i < SIZE + 1; ++i) {
+                m_oldCoef[i][lane] = m_coef[i][lane];
+                m_coef[i][lane] = pCoef[i];
+            }
+            for (unsigned int i = 0; i < SIZE; ++i) {
+                m_oldBuf[i][lane] = m_buf[i][lane];
+                m_buf[i][lane] = 0;
+            }
+        }
+        m_doRamping[filter] = true;
+    }
+
+    void pauseFilter(int filter) {
+        if (m_doStart[filter]) {
+            return;
+        }
+        for (int lane = 2 * filter; lane < 2 * filter + 2; ++lane) {
+            for (unsigned int i = 0; i < SIZE; ++i) {
+                m_buf[i][lane] = 0;
+            }
+        }
+        m_doRamping[filter] = true;
+        m_doStart[filter] = true;
+    }
+
+    // Processes the stereo buffer pIn[i] with the filter i into pOut[i].
+    // The buffers may be processed in place.
+    void process(const std::array<const CSAMPLE*, FILTERS>& pIn,
+            const std::array<CSAMPLE*, FILTERS>& pOut,
+            const int iBufferSize) {
+        bool doRamping = false;
+        for (int filter = 0; filter < FILTERS; ++filter) {
+            doRamping = doRamping || m_doRamping[filter];
+        }
+        if (!doRamping) {
+            for (int i = 0; i < iBufferSize; i += 2) {
+                double val[kLanes];
+                load(pIn, i, val);
+                processSample(m_coef, m_buf, val);
+                store(val, pOut, i);
+            }
+            return;
+        }
+
+        // The same cross fade as in EngineFilterIIR::process(), for the
+        // filters that have changed only
+        double cross_mix = 0.0;
+        const double cross_inc = 4.0 / static_cast<double>(iBufferSize);
+        for (int i = 0; i < iBufferSize; i += 2) {
+            double val[kLanes];
+            load(pIn, i, val);
+            double old[kLanes];
+            memcpy(old, val, sizeof(old));
+            processSample(m_oldCoef, m_oldBuf, old);
+            processSample(m_coef, m_buf, val);
+            for (int lane = 0; lane < kLanes; ++lane) {
+                const int filter = lane / 2;
+                if (!m_doRamping[filter]) {
+                    continue;
+                }
+                if (m_doStart[filter]) {
+                    old[lane] = 0;
+                }
+                // Round both to the output precision like EngineFilterIIR
+                const double oldOut = static_cast<CSAMPLE>(old[lane]);
+                const double newOut = static_cast<CSAMPLE>(val[lane]);
+                if (i < iBufferSize / 2) {
+                    val[lane] = oldOut;
+                } else {
+                    val[lane] = newOut * cross_mix + oldOut * (1.0 - cross_mix);
+                }
+            }
+            if (i >= iBufferSize / 2) {
+                cross_mix += cross_inc;
+            }
+            store(val, pOut, i);
+        }
+        for (int filter = 0; filter < FILTERS; ++filter) {
+            m_doRamping[filter] = false;
+            m_doStart[filter] = false;
+        }
+    }
+
+    // Like EngineFilterIIR::processAndPauseFilter(), it fades the filtered
+    // output to 0 and pauses all filters
+    void processAndPauseFilter(const std::array<const CSAMPLE*, FILTERS>& pIn,
+            const std::array<CSAMPLE*, FILTERS>& pOut,
+            const int iBufferSize) {
+        process(pIn, pOut, iBufferSize);
+        for (int filter = 0; filter < FILTERS; ++filter) {
+            SampleUtil::applyRampingGain(pOut[filter], 1.0, 0, iBufferSize);
+            pauseFilter(filter);
+        }
+    }
+
+  private:
+    static constexpr int kLanes = 2 * FILTERS;
+    static constexpr unsigned int kSections = SIZE / 2;
+    // The zeros of the sections are at z = -1 for low pass and at z = 1 for
+    // high pass filters
+    static constexpr double kFirSign = PASS == IIR_LP ? 1.0 : -1.0;
+
+    static void load(const std::array<const CSAMPLE*, FILTERS>& pIn,
+            int i,
+            double (&val)[kLanes]) {
+        for (int filter = 0; filter < FILTERS; ++filter) {
+            val[2 * filter] = pIn[filter][i];
+            val[2 * filter + 1] = pIn[filter][i + 1];
+        }
+    }
+
+    static void store(const double (&val)[kLanes],
+            const std::array<CSAMPLE*, FILTERS>& pOut,
+            int i) {
+        for (int filter = 0; filter < FILTERS; ++filter) {
+            pOut[filter][i] = static_cast<CSAMPLE>(val[2 * filter]);
+            pOut[filter][i + 1] = static_cast<CSAMPLE>(val[2 * filter + 1]);
+        }
+    }
+
+    // The operations are performed in the same order as in
+    // EngineFilterIIR::processSample() to get identical results.
+    static inline void processSample(const double (&coef)[SIZE + 1][kLanes],
+            double (&buf)[SIZE][kLanes],
+            double (&val)[kLanes]) {
+        // note: LOOP VECTORIZED.
+        for (int lane = 0; lane < kLanes; ++lane) {
+            val[lane] *= coef[0][lane];
+        }
+        for (unsigned int section = 0; section < kSections; ++section) {
+            double* z2 = buf[2 * section];
+            double* z1 = buf[2 * section + 1];
+            const double* a2 = coef[2 * section + 1];
+            const double* a1 = coef[2 * section + 2];
+            // note: LOOP VECTORIZED.
+            for (int lane = 0; lane < kLanes; ++lane) {
+                double iir = val[lane];
+                iir -= a2[lane] * z2[lane];
+                iir -= a1[lane] * z1[lane];
+                double fir = z2[lane];
+                fir += kFirSign * z1[lane] + kFirSign * z1[lane];
+                fir += iir;
+                z2[lane] = z1[lane];
+                z1[lane] = iir;
+                val[lane] = fir;
+            }
+        }
+    }
+
+    double m_coef[SIZE + 1][kLanes];
+    // Old coefficients needed for ramping
+    double m_oldCoef[SIZE + 1][kLanes];
+
+    double m_buf[SIZE][kLanes];
+    // Old buffers needed for ramping
+    double m_oldBuf[SIZE][kLanes];
+
+    // Flag set to true if ramping needs to be done
+    bool m_doRamping[FILTERS] = {};
+    // Flag set to true if old filter is invalid
+    bool m_doStart[FILTERS] = {};
+};
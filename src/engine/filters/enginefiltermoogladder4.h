@@ -16,7 +16,9 @@
 #include <QDebug>
 
 #include "engine/engineobject.h"
+#include "util/fastmath.h"
 #include "util/math.h"
+#include "util/parametersmoothing.h"
 #include "util/sample.h"
 #include "util/timer.h"
 
@@ -53,7 +55,8 @@ class EngineFilterMoogLadderBase : public EngineObjectConstIn {
 
   public:
     EngineFilterMoogLadderBase(
-            unsigned int sampleRate, float cutoff, float resonance) {
+            unsigned int sampleRate, float cutoff, float resonance)
+            : m_kernel(DspKernel::Vectorized) {
         initBuffers();
         setParameter(sampleRate, cutoff, resonance);
         m_postGain = m_postGainNew;
@@ -64,6 +67,10 @@ class EngineFilterMoogLadderBase : public EngineObjectConstIn {
     virtual ~EngineFilterMoogLadderBase() {
     }
 
+    void setKernel(DspKernel kernel) {
+        m_kernel = kernel;
+    }
+
     void initBuffers() {
         memset(&m_buf, 0, sizeof(m_buf));
         m_buffersClear = true;
@@ -122,27 +129,23 @@ class EngineFilterMoogLadderBase : public EngineObjectConstIn {
     virtual void process(const CSAMPLE* pIn, CSAMPLE* pOutput,
                          const int iBufferSize) {
         if (!m_doRamping) {
-            for (int i = 0; i < iBufferSize; i += 2) {
-                pOutput[i] = processSample(pIn[i], &m_buf[0]);
-                pOutput[i+1] = processSample(pIn[i+1], &m_buf[1]);
-            }
+            processFrames(pIn, pOutput, 0, iBufferSize);
         } else if (!m_buffersClear) {
-            float startPostGain = m_postGain;
-            float startKacr = m_kacr;
-            float startK2vg = m_k2vg;
-            double cross_mix = 0.0;
-            double cross_inc = 2.0 / static_cast<double>(iBufferSize);
-
-            for (int i = 0; i < iBufferSize; i += 2) {
-                cross_mix += cross_inc;
-                m_postGain = static_cast<float>(m_postGainNew * cross_mix +
-                        startPostGain * (1.0 - cross_mix));
-                m_kacr = static_cast<float>(m_kacrNew * cross_mix + startKacr * (1.0 - cross_mix));
-                m_k2vg = static_cast<float>(m_k2vgNew * cross_mix + startK2vg * (1.0 - cross_mix));
-                pOutput[i] = processSample(pIn[i], &m_buf[0]);
-                pOutput[i+1] = processSample(pIn[i+1], &m_buf[1]);
-            }
-
+            // Move the coefficients to the new values at control rate
+            const float start[] = {m_postGain, m_kacr, m_k2vg};
+            const float target[] = {m_postGainNew, m_kacrNew, m_k2vgNew};
+            ParameterSmoothing::forEachBlock<float>(iBufferSize / 2,
+                    [&](float t, SINT offsetFrames, SINT blockFrames) {
+                        float coefs[3];
+                        ParameterSmoothing::interpolate(coefs, start, target, 3, t);
+                        m_postGain = coefs[0];
+                        m_kacr = coefs[1];
+                        m_k2vg = coefs[2];
+                        processFrames(pIn,
+                                pOutput,
+                                static_cast<int>(offsetFrames) * 2,
+                                static_cast<int>(offsetFrames + blockFrames) * 2);
+                    });
         } else {
             m_postGain = m_postGainNew;
             m_kacr = m_kacrNew;
@@ -181,6 +184,108 @@ class EngineFilterMoogLadderBase : public EngineObjectConstIn {
         m_buffersClear = false;
     }
 
+    // Processes the samples in [begin, end) with the current coefficients
+    void processFrames(const CSAMPLE* pIn, CSAMPLE* pOutput, int begin, int end) {
+        if (m_kernel == DspKernel::Reference) {
+            for (int i = begin; i < end; i += 2) {
+                pOutput[i] = processSample(pIn[i], &m_buf[0]);
+                pOutput[i + 1] = processSample(pIn[i + 1], &m_buf[1]);
+            }
+        } else {
+            processFramesVectorized(pIn, pOutput, begin, end);
+        }
+    }
+
+    // processSample() for both channels at once. The channels are lanes of
+    // the same operations, which the compiler packs into SIMD registers.
+    // The divisions by v2 are replaced by multiplications and the
+    // approximation of tanh is rearranged to a single division.
+    void processFramesVectorized(const CSAMPLE* pIn,
+            CSAMPLE* pOutput,
+            int begin,
+            int end) {
+        constexpr float kInvV2 = 1 / (2 + kVt);
+        const float kacr = m_kacr;
+        const float k2vg = m_k2vg;
+        const float postGain = m_postGain;
+        float azt1[2] = {m_buf[0].m_azt1, m_buf[1].m_azt1};
+        float azt2[2] = {m_buf[0].m_azt2, m_buf[1].m_azt2};
+        float azt3[2] = {m_buf[0].m_azt3, m_buf[1].m_azt3};
+        float azt4[2] = {m_buf[0].m_azt4, m_buf[1].m_azt4};
+        float az5[2] = {m_buf[0].m_az5, m_buf[1].m_az5};
+        float amf[2] = {m_buf[0].m_amf, m_buf[1].m_amf};
+
+        for (int i = begin; i < end; i += 2) {
+            float out[2];
+            for (int c = 0; c < 2; ++c) {
+                const float input = pIn[i + c];
+                const float x1 = input - amf[c] * kacr;
+                const float az1 = azt1[c] + k2vg * tanhApproxLane(x1 * kInvV2);
+                const float at1 = k2vg * tanhApproxLane(az1 * kInvV2);
+                azt1[c] = az1 - at1;
+                const float az2 = azt2[c] + at1;
+                const float at2 = k2vg * tanhApproxLane(az2 * kInvV2);
+                azt2[c] = az2 - at2;
+                const float az3 = azt3[c] + at2;
+                const float at3 = k2vg * tanhApproxLane(az3 * kInvV2);
+                azt3[c] = az3 - at3;
+                const float az4 = azt4[c] + at3;
+                const float at4 = k2vg * tanhApproxLane(az4 * kInvV2);
+                azt4[c] = az4 - at4;
+
+                if (MODE == MoogMode::LowPassOversampling ||
+                        MODE == MoogMode::HighPassOversampling) {
+                    amf[c] = (az4 + az5[c]) / 2;
+                    az5[c] = az4;
+
+                    // The high pass output uses the values of the first pass
+                    const float x1b = input - amf[c] * kacr;
+                    const float az1b = azt1[c] + k2vg * tanhApproxLane(x1b * kInvV2);
+                    const float at1b = k2vg * tanhApproxLane(az1b * kInvV2);
+                    azt1[c] = az1b - at1b;
+                    const float az2b = azt2[c] + at1b;
+                    const float at2b = k2vg * tanhApproxLane(az2b * kInvV2);
+                    azt2[c] = az2b - at2b;
+                    const float az3b = azt3[c] + at2b;
+                    const float at3b = k2vg * tanhApproxLane(az3b * kInvV2);
+                    azt3[c] = az3b - at3b;
+                    const float az4b = azt4[c] + at3b;
+                    const float at4b = k2vg * tanhApproxLane(az4b * kInvV2);
+                    azt4[c] = az4b - at4b;
+
+                    amf[c] = (az4b + az5[c]) / 2;
+                    az5[c] = az4b;
+                } else {
+                    amf[c] = az4;
+                }
+
+                if (MODE == MoogMode::HighPassOversampling || MODE == MoogMode::HighPass) {
+                    out[c] = (x1 - 3 * az3 + 2 * az4) * postGain;
+                } else {
+                    out[c] = amf[c] * postGain;
+                }
+            }
+            pOutput[i] = out[0];
+            pOutput[i + 1] = out[1];
+        }
+
+        for (int c = 0; c < 2; ++c) {
+            m_buf[c].m_azt1 = azt1[c];
+            m_buf[c].m_azt2 = azt2[c];
+            m_buf[c].m_azt3 = azt3[c];
+            m_buf[c].m_azt4 = azt4[c];
+            m_buf[c].m_az5 = az5[c];
+            m_buf[c].m_amf = amf[c];
+        }
+    }
+
+    // tanh_approx() with a single division:
+    // x / (1 + x^2 / (3 + x^2 / 5)) = x * (15 + x^2) / (15 + 6 * x^2)
+    static inline float tanhApproxLane(float input) {
+        const float input2 = input * input;
+        return input * (15 + input2) / (15 + 6 * input2);
+    }
+
     inline CSAMPLE processSample(float input, struct Buffer* pB) {
         constexpr float v2 = 2 + kVt; // twice the 'thermal voltage of a transistor'
 
@@ -254,6 +359,8 @@ class EngineFilterMoogLadderBase : public EngineObjectConstIn {
     bool m_doRamping;
 
     bool m_buffersClear;
+
+    DspKernel m_kernel;
 };
 
 class EngineFilterMoogLadder4Low : public EngineFilterMoogLadderBase<MoogMode::LowPassOversampling> {
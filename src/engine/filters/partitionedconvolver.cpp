@@ -0,0 +1,459 @@
+#include "engine/filters/partitionedconvolver.h"
+
+#include <dsp/transforms/FFT.h>
+
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QtDebug>
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include "effects/defs.h"
+#include "engine/enginethreadscheduling.h"
+#include "util/assert.h"
+#include "util/denormalsarezero.h"
+#include "util/math.h"
+#include "util/platform.h"
+#include "util/sample.h"
+#include "util/wakesemaphore.h"
+
+namespace {
+
+// 23 ms at 44.1 kHz. Smaller tail blocks would need more partitions.
+constexpr SINT kMinTailBlockFrames = 1024;
+constexpr SINT kHeadBlocksPerTailBlock = 8;
+
+int partitionCount(SINT frames, SINT blockFrames) {
+    return static_cast<int>((math_max<SINT>(frames, 0) + blockFrames - 1) / blockFrames);
+}
+
+/// pSum += pA * pB for complex bins
+void multiplyAccumulate(float* M_RESTRICT pSumReal,
+        float* M_RESTRICT pSumImag,
+        const float* M_RESTRICT pAReal,
+        const float* M_RESTRICT pAImag,
+        const float* M_RESTRICT pBReal,
+        const float* M_RESTRICT pBImag,
+        SINT bins) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < bins; ++i) {
+        pSumReal[i] += pAReal[i] * pBReal[i] - pAImag[i] * pBImag[i];
+        pSumImag[i] += pAReal[i] * pBImag[i] + pAImag[i] * pBReal[i];
+    }
+}
+
+} // anonymous namespace
+
+// static
+ConvolutionPartitioning ConvolutionPartitioning::forFramesPerBuffer(SINT framesPerBuffer) {
+    const SINT tailBlockFrames = math_max<SINT>(kMinTailBlockFrames,
+            roundUpToPowerOf2(static_cast<int>(framesPerBuffer)));
+    return ConvolutionPartitioning{
+            tailBlockFrames / kHeadBlocksPerTailBlock, tailBlockFrames};
+}
+
+ConvolutionFilter::Partitions::Partitions(SINT blockFrames, int count)
+        : bins(blockFrames + 1),
+          count(count),
+          m_real(bins * count),
+          m_imag(bins * count) {
+}
+
+ConvolutionFilter::ConvolutionFilter(const CSAMPLE* pImpulse,
+        SINT frames,
+        ConvolutionPartitioning partitioning)
+        : m_frames(frames),
+          m_partitioning(partitioning) {
+    const SINT headFrames = math_min(frames, partitioning.headFrames());
+    const int headPartitions = partitionCount(headFrames, partitioning.headBlockFrames);
+    const int tailPartitions = partitionCount(
+            frames - partitioning.headFrames(), partitioning.tailBlockFrames);
+    m_head.reserve(kChannelCount);
+    m_tail.reserve(kChannelCount);
+    for (int channel = 0; channel < kChannelCount; ++channel) {
+        m_head.emplace_back(partitioning.headBlockFrames, headPartitions);
+        m_tail.emplace_back(partitioning.tailBlockFrames, tailPartitions);
+    }
+
+    // Transforms the partitions of a stage, each padded with zeros
+    const auto transform = [pImpulse, frames](std::vector<Partitions>* pPartitions,
+                                   SINT blockFrames,
+                                   SINT startFrame) {
+        FFTReal fft(static_cast<int>(2 * blockFrames));
+        std::vector<double> input(2 * blockFrames);
+        std::vector<double> real(2 * blockFrames);
+        std::vector<double> imag(2 * blockFrames);
+        for (int channel = 0; channel < kChannelCount; ++channel) {
+            Partitions& partitions = (*pPartitions)[channel];
+            for (int partition = 0; partition < partitions.count; ++partition) {
+                std::fill(input.begin(), input.end(), 0.0);
+                const SINT offset = startFrame + partition * blockFrames;
+                const SINT partitionFrames = math_min(blockFrames, frames - offset);
+                for (SINT i = 0; i < partitionFrames; ++i) {
+                    input[i] = pImpulse[(offset + i) * kChannelCount + channel];
+                }
+                fft.forward(input.data(), real.data(), imag.data());
+                std::copy(real.begin(),
+                        real.begin() + partitions.bins,
+                        partitions.real(partition));
+                std::copy(imag.begin(),
+                        imag.begin() + partitions.bins,
+                        partitions.imag(partition));
+            }
+        }
+    };
+    transform(&m_head, partitioning.headBlockFrames, 0);
+    transform(&m_tail, partitioning.tailBlockFrames, partitioning.headFrames());
+}
+
+/// The background thread that convolves the tails of all convolvers. It runs
+/// as long as a convolver exists. The tails are due within one engine buffer,
+/// so it is set up like the workers of EngineEffectsWorkerPool: it adopts the
+/// real-time scheduling of the engine thread and flushes denormals to zero,
+/// which the decaying tails would otherwise produce.
+class PartitionedConvolver::Worker : public QThread {
+  public:
+    Worker()
+            : m_stop(false) {
+        setObjectName(QStringLiteral("PartitionedConvolver"));
+    }
+
+    ~Worker() override {
+        m_stop.store(true);
+        m_wake.release();
+        wait();
+    }
+
+    static std::shared_ptr<Worker> instance() {
+        static QMutex s_mutex;
+        static std::weak_ptr<Worker> s_pWorker;
+        QMutexLocker locker(&s_mutex);
+        std::shared_ptr<Worker> pWorker = s_pWorker.lock();
+        if (!pWorker) {
+            pWorker = std::make_shared<Worker>();
+            // On Linux the worker additionally adopts the real-time
+            // scheduling of the engine thread, see EngineThreadScheduling
+            pWorker->start(QThread::TimeCriticalPriority);
+            s_pWorker = pWorker;
+        }
+        return pWorker;
+    }
+
+    void addConvolver(PartitionedConvolver* pConvolver) {
+        QMutexLocker locker(&m_mutex);
+        m_convolvers.append(pConvolver);
+    }
+
+    /// Waits until the pending job of the convolver has been finished
+    void removeConvolver(PartitionedConvolver* pConvolver) {
+        QMutexLocker locker(&m_mutex);
+        m_convolvers.removeOne(pConvolver);
+    }
+
+    /// Called from the engine thread
+    void wake() {
+        m_engineThreadScheduling.captureFromCurrentThread();
+        m_wake.release();
+    }
+
+  protected:
+    void run() override {
+        VERIFY_OR_DEBUG_ASSERT(mixxx::enableDenormalsAreZero()) {
+            qWarning() << objectName() << "Denormals are not flushed to zero";
+        }
+        int appliedSchedulingGeneration = 0;
+        while (true) {
+            m_wake.acquire();
+            if (m_stop.load()) {
+                return;
+            }
+            m_engineThreadScheduling.applyToCurrentThread(&appliedSchedulingGeneration);
+            QMutexLocker locker(&m_mutex);
+            for (PartitionedConvolver* pConvolver : std::as_const(m_convolvers)) {
+                pConvolver->processJob();
+            }
+        }
+    }
+
+  private:
+    WakeSemaphore m_wake;
+    EngineThreadScheduling m_engineThreadScheduling;
+    std::atomic<bool> m_stop;
+    // Only locked by the main thread and this thread
+    QMutex m_mutex;
+    QList<PartitionedConvolver*> m_convolvers;
+};
+
+PartitionedConvolver::Stage::Stage(SINT blockFrames, int partitions)
+        : m_blockFrames(blockFrames),
+          m_fftSize(2 * blockFrames),
+          m_pFft(std::make_unique<FFTReal>(static_cast<int>(m_fftSize))),
+          m_delayLinePos(0),
+          m_fftReal(m_fftSize),
+          m_fftImag(m_fftSize),
+          m_sumReal(blockFrames + 1),
+          m_sumImag(blockFrames + 1),
+          m_fftOutput(m_fftSize) {
+    m_delayLines.reserve(ConvolutionFilter::kChannelCount);
+    for (int channel = 0; channel < ConvolutionFilter::kChannelCount; ++channel) {
+        m_windows[channel].resize(m_fftSize);
+        m_delayLines.emplace_back(blockFrames, partitions);
+    }
+}
+
+// The destructor of FFTReal is only known here
+PartitionedConvolver::Stage::~Stage() = default;
+
+void PartitionedConvolver::Stage::process(const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        const std::vector<ConvolutionFilter::Partitions>& partitions) {
+    const int count = m_delayLines[0].count;
+    if (count == 0) {
+        SampleUtil::clear(pOutput, m_blockFrames * ConvolutionFilter::kChannelCount);
+        return;
+    }
+    m_delayLinePos = (m_delayLinePos + 1) % count;
+    const SINT bins = m_blockFrames + 1;
+    for (int channel = 0; channel < ConvolutionFilter::kChannelCount; ++channel) {
+        std::vector<double>& window = m_windows[channel];
+        std::copy(window.begin() + m_blockFrames, window.end(), window.begin());
+        for (SINT i = 0; i < m_blockFrames; ++i) {
+            window[m_blockFrames + i] = pInput[i * ConvolutionFilter::kChannelCount + channel];
+        }
+        m_pFft->forward(window.data(), m_fftReal.data(), m_fftImag.data());
+
+        ConvolutionFilter::Partitions& delayLine = m_delayLines[channel];
+        std::copy(m_fftReal.begin(),
+                m_fftReal.begin() + bins,
+                delayLine.real(m_delayLinePos));
+        std::copy(m_fftImag.begin(),
+                m_fftImag.begin() + bins,
+                delayLine.imag(m_delayLinePos));
+
+        // Partition i is applied to the input window of i blocks ago
+        std::fill(m_sumReal.begin(), m_sumReal.end(), 0.0f);
+        std::fill(m_sumImag.begin(), m_sumImag.end(), 0.0f);
+        const ConvolutionFilter::Partitions& filter = partitions[channel];
+        for (int partition = 0; partition < count; ++partition) {
+            const int delayed = (m_delayLinePos - partition + count) % count;
+            multiplyAccumulate(m_sumReal.data(),
+                    m_sumImag.data(),
+                    delayLine.real(delayed),
+                    delayLine.imag(delayed),
+                    filter.real(partition),
+                    filter.imag(partition),
+                    bins);
+        }
+
+        std::copy(m_sumReal.begin(), m_sumReal.end(), m_fftReal.begin());
+        std::copy(m_sumImag.begin(), m_sumImag.end(), m_fftImag.begin());
+        m_pFft->inverse(m_fftReal.data(), m_fftImag.data(), m_fftOutput.data());
+        // The first half is aliased by the circular convolution
+        for (SINT i = 0; i < m_blockFrames; ++i) {
+            pOutput[i * ConvolutionFilter::kChannelCount + channel] =
+                    static_cast<CSAMPLE>(m_fftOutput[m_blockFrames + i]);
+        }
+    }
+}
+
+void PartitionedConvolver::Stage::reset() {
+    for (int channel = 0; channel < ConvolutionFilter::kChannelCount; ++channel) {
+        std::fill(m_windows[channel].begin(), m_windows[channel].end(), 0.0);
+        ConvolutionFilter::Partitions& delayLine = m_delayLines[channel];
+        for (int partition = 0; partition < delayLine.count; ++partition) {
+            std::fill(delayLine.real(partition),
+                    delayLine.real(partition) + delayLine.bins,
+                    0.0f);
+            std::fill(delayLine.imag(partition),
+                    delayLine.imag(partition) + delayLine.bins,
+                    0.0f);
+        }
+    }
+}
+
+PartitionedConvolver::PartitionedConvolver(FilterFactory filterFactory,
+        const mixxx::EngineParameters& engineParameters)
+        : m_filterFactory(std::move(filterFactory)),
+          m_pWorker(Worker::instance()),
+          m_headFrames(0),
+          m_tailFrames(0),
+          m_tailInputIndex(0),
+          m_tailOutputIndex(0),
+          m_tailHandedOver(false),
+          m_tailReset(false),
+          m_jobInputIndex(0),
+          m_jobOutputIndex(0),
+          m_jobReset(false),
+          m_job(Job::None) {
+    allocate(engineParameters.sampleRate(),
+            ConvolutionPartitioning::forFramesPerBuffer(
+                    engineParameters.framesPerBuffer()));
+    m_pWorker->addConvolver(this);
+}
+
+PartitionedConvolver::~PartitionedConvolver() {
+    m_pWorker->removeConvolver(this);
+}
+
+void PartitionedConvolver::allocate(mixxx::audio::SampleRate sampleRate,
+        ConvolutionPartitioning partitioning) {
+    m_pFilter = m_filterFactory(sampleRate, partitioning);
+    DEBUG_ASSERT(m_pFilter && m_pFilter->partitioning() == partitioning);
+    m_sampleRate = sampleRate;
+    m_partitioning = partitioning;
+
+    const SINT headSamples = partitioning.headBlockFrames * ConvolutionFilter::kChannelCount;
+    const SINT tailSamples = partitioning.tailBlockFrames * ConvolutionFilter::kChannelCount;
+    m_pHead = std::make_unique<Stage>(
+            partitioning.headBlockFrames, m_pFilter->head()[0].count);
+    m_pTail = std::make_unique<Stage>(
+            partitioning.tailBlockFrames, m_pFilter->tail()[0].count);
+    m_headInput.assign(headSamples, 0);
+    m_headOutput.assign(headSamples, 0);
+    m_headFrames = 0;
+    for (int i = 0; i < 2; ++i) {
+        m_tailInput[i].assign(tailSamples, 0);
+        m_tailOutput[i].assign(tailSamples, 0);
+    }
+    m_tailFrames = 0;
+    m_tailHandedOver = false;
+    m_tailReset = false;
+}
+
+void PartitionedConvolver::process(const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        const mixxx::EngineParameters& engineParameters,
+        CSAMPLE_GAIN inputGainStart,
+        CSAMPLE_GAIN inputGainEnd) {
+    const SINT frames = engineParameters.framesPerBuffer();
+    const Job job = m_job.load(std::memory_order_acquire);
+    if (job == Job::Rebuild) {
+        SampleUtil::clear(pOutput, engineParameters.samplesPerBuffer());
+        return;
+    }
+    const ConvolutionPartitioning partitioning =
+            ConvolutionPartitioning::forFramesPerBuffer(frames);
+    if (engineParameters.sampleRate() != m_sampleRate || partitioning != m_partitioning) {
+        // Wait for a pending tail before the buffers are replaced
+        if (job == Job::None) {
+            m_jobSampleRate = engineParameters.sampleRate();
+            m_jobPartitioning = partitioning;
+            m_job.store(Job::Rebuild, std::memory_order_release);
+            m_pWorker->wake();
+        }
+        SampleUtil::clear(pOutput, engineParameters.samplesPerBuffer());
+        return;
+    }
+
+    const SINT headBlockFrames = m_partitioning.headBlockFrames;
+    const CSAMPLE_GAIN gainDelta = (inputGainEnd - inputGainStart) / frames;
+    SINT frame = 0;
+    while (frame < frames) {
+        const SINT chunkFrames = math_min(headBlockFrames - m_headFrames, frames - frame);
+        const CSAMPLE* pChunkInput = &pInput[frame * ConvolutionFilter::kChannelCount];
+        CSAMPLE* pHeadInput = &m_headInput[m_headFrames * ConvolutionFilter::kChannelCount];
+        CSAMPLE* pTailInput = &m_tailInput[m_tailInputIndex][(m_tailFrames + m_headFrames) *
+                ConvolutionFilter::kChannelCount];
+        for (SINT i = 0; i < chunkFrames; ++i) {
+            const CSAMPLE_GAIN gain = inputGainStart + gainDelta * (frame + i + 1);
+            for (int channel = 0; channel < ConvolutionFilter::kChannelCount; ++channel) {
+                const SINT sample = i * ConvolutionFilter::kChannelCount + channel;
+                pHeadInput[sample] = pChunkInput[sample] * gain;
+                pTailInput[sample] = pHeadInput[sample];
+            }
+        }
+        // Play the previous block, after the input has been read
+        SampleUtil::copy(&pOutput[frame * ConvolutionFilter::kChannelCount],
+                &m_headOutput[m_headFrames * ConvolutionFilter::kChannelCount],
+                chunkFrames * ConvolutionFilter::kChannelCount);
+        m_headFrames += chunkFrames;
+        frame += chunkFrames;
+        if (m_headFrames < headBlockFrames) {
+            continue;
+        }
+
+        m_headFrames = 0;
+        m_tailFrames += headBlockFrames;
+        if (m_tailFrames == m_partitioning.tailBlockFrames) {
+            m_tailFrames = 0;
+            tailBlockFinished();
+        }
+        m_pHead->process(m_headInput.data(), m_headOutput.data(), m_pFilter->head());
+        SampleUtil::add(m_headOutput.data(),
+                &m_tailOutput[m_tailOutputIndex][m_tailFrames *
+                        ConvolutionFilter::kChannelCount],
+                headBlockFrames * ConvolutionFilter::kChannelCount);
+    }
+}
+
+void PartitionedConvolver::tailBlockFinished() {
+    const SINT tailSamples = m_partitioning.tailBlockFrames * ConvolutionFilter::kChannelCount;
+    const bool idle = m_job.load(std::memory_order_acquire) == Job::None;
+    if (idle && m_tailHandedOver) {
+        // Play the tail of the block that was handed over one tail block ago
+        m_tailOutputIndex = 1 - m_tailOutputIndex;
+    } else {
+        if (!idle && kEffectDebugOutput) {
+            qWarning() << "PartitionedConvolver: The tail was not finished in time";
+        }
+        SampleUtil::clear(m_tailOutput[m_tailOutputIndex].data(), tailSamples);
+    }
+
+    if (!idle) {
+        // The input block is overwritten, so the tail restarts after it
+        m_tailHandedOver = false;
+        m_tailReset = true;
+        return;
+    }
+    m_jobInputIndex = m_tailInputIndex;
+    m_jobOutputIndex = 1 - m_tailOutputIndex;
+    m_jobReset = m_tailReset;
+    m_tailInputIndex = 1 - m_tailInputIndex;
+    m_tailHandedOver = true;
+    m_tailReset = false;
+    m_job.store(Job::Tail, std::memory_order_release);
+    m_pWorker->wake();
+}
+
+void PartitionedConvolver::reset() {
+    if (m_job.load(std::memory_order_acquire) == Job::Rebuild) {
+        // The buffers are cleared by the rebuild
+        return;
+    }
+    m_pHead->reset();
+    std::fill(m_headInput.begin(), m_headInput.end(), 0.0f);
+    std::fill(m_headOutput.begin(), m_headOutput.end(), 0.0f);
+    m_headFrames = 0;
+    SampleUtil::clear(m_tailOutput[m_tailOutputIndex].data(),
+            m_partitioning.tailBlockFrames * ConvolutionFilter::kChannelCount);
+    m_tailFrames = 0;
+    m_tailHandedOver = false;
+    m_tailReset = true;
+}
+
+void PartitionedConvolver::processJob() {
+    switch (m_job.load(std::memory_order_acquire)) {
+    case Job::None:
+        return;
+    case Job::Tail:
+        if (m_jobReset) {
+            m_pTail->reset();
+        }
+        m_pTail->process(m_tailInput[m_jobInputIndex].data(),
+                m_tailOutput[m_jobOutputIndex].data(),
+                m_pFilter->tail());
+        break;
+    case Job::Rebuild:
+        allocate(m_jobSampleRate, m_jobPartitioning);
+        break;
+    }
+    m_job.store(Job::None, std::memory_order_release);
+}
+
+void PartitionedConvolver::waitForBackgroundThread() const {
+    while (m_job.load(std::memory_order_acquire) != Job::None) {
+        std::this_thread::yield();
+    }
+}
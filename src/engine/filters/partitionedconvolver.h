@@ -0,0 +1,231 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "audio/types.h"
+#include "engine/engine.h"
+#include "util/class.h"
+#include "util/types.h"
+
+class FFTReal;
+
+/// The block sizes in which a PartitionedConvolver convolves the head and the
+/// tail of an impulse response. The head is convolved in the engine thread in
+/// small blocks, the tail in the background in large blocks that are at least
+/// as large as an engine buffer.
+struct ConvolutionPartitioning {
+    /// The head block is also the latency of the convolved signal
+    SINT headBlockFrames;
+    SINT tailBlockFrames;
+
+    static ConvolutionPartitioning forFramesPerBuffer(SINT framesPerBuffer);
+
+    /// The tail starts two tail blocks minus the latency into the impulse
+    /// response. The block of the tail that is convolved in the background
+    /// is then needed one tail block later.
+    SINT headFrames() const {
+        return 2 * tailBlockFrames - headBlockFrames;
+    }
+
+    bool operator==(const ConvolutionPartitioning& other) const {
+        return headBlockFrames == other.headBlockFrames &&
+                tailBlockFrames == other.tailBlockFrames;
+    }
+    bool operator!=(const ConvolutionPartitioning& other) const {
+        return !(*this == other);
+    }
+};
+
+/// The spectra of the partitions of a stereo impulse response. The filter is
+/// immutable, so it is shared by all convolvers with the same impulse
+/// response, sample rate and partitioning.
+class ConvolutionFilter {
+  public:
+    static constexpr int kChannelCount = 2;
+
+    /// pImpulse contains frames of interleaved stereo samples.
+    ConvolutionFilter(const CSAMPLE* pImpulse,
+            SINT frames,
+            ConvolutionPartitioning partitioning);
+
+    SINT frames() const {
+        return m_frames;
+    }
+    const ConvolutionPartitioning& partitioning() const {
+        return m_partitioning;
+    }
+
+    /// The spectra of the partitions of one channel, padded with as many
+    /// zeros as the partition is long. The real and imaginary parts of the
+    /// bins are stored in separate arrays to vectorize the complex products.
+    struct Partitions {
+        Partitions(SINT blockFrames, int count);
+
+        float* real(int partition) {
+            return &m_real[partition * bins];
+        }
+        const float* real(int partition) const {
+            return &m_real[partition * bins];
+        }
+        float* imag(int partition) {
+            return &m_imag[partition * bins];
+        }
+        const float* imag(int partition) const {
+            return &m_imag[partition * bins];
+        }
+
+        const SINT bins;
+        const int count;
+
+      private:
+        std::vector<float> m_real;
+        std::vector<float> m_imag;
+    };
+
+    /// The partitions of the head and the tail of each channel
+    const std::vector<Partitions>& head() const {
+        return m_head;
+    }
+    const std::vector<Partitions>& tail() const {
+        return m_tail;
+    }
+
+  private:
+    const SINT m_frames;
+    const ConvolutionPartitioning m_partitioning;
+    std::vector<Partitions> m_head;
+    std::vector<Partitions> m_tail;
+};
+
+typedef std::shared_ptr<const ConvolutionFilter> ConvolutionFilterPointer;
+
+/// Convolves a stereo signal with a long impulse response, e.g. of a room,
+/// with a non-uniformly partitioned convolution in the frequency domain.
+///
+/// The head of the impulse response is convolved in the engine thread in
+/// blocks of ConvolutionPartitioning::headBlockFrames, which delays the output
+/// by one head block. The large partitions of the tail are convolved by a
+/// background thread that is shared by all convolvers. A block of the tail is
+/// handed over when the input of a tail block is complete and its result is
+/// needed one tail block later, so the background thread has at least the
+/// time of one engine buffer to finish it. process() never waits for the
+/// background thread. If it is late, the tail of this block is dropped.
+///
+/// When the sample rate or the buffer size changes, the filter is replaced
+/// and the buffers are reallocated in the background thread. The output is
+/// silent until that has finished.
+class PartitionedConvolver {
+  public:
+    /// Returns the filter for a sample rate and partitioning. It is called
+    /// from the thread that constructs the convolver and from the
+    /// background thread.
+    typedef std::function<ConvolutionFilterPointer(
+            mixxx::audio::SampleRate, ConvolutionPartitioning)>
+            FilterFactory;
+
+    PartitionedConvolver(FilterFactory filterFactory,
+            const mixxx::EngineParameters& engineParameters);
+    ~PartitionedConvolver();
+
+    /// Convolves the interleaved stereo pInput into pOutput, which may be
+    /// the same buffer. The input is faded from inputGainStart to
+    /// inputGainEnd. Called from the engine thread.
+    void process(const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            const mixxx::EngineParameters& engineParameters,
+            CSAMPLE_GAIN inputGainStart,
+            CSAMPLE_GAIN inputGainEnd);
+
+    /// Discards the signal in the convolver. Called from the engine thread.
+    void reset();
+
+    /// Blocks until the background thread has finished the pending work of
+    /// this convolver. Only for tests, the engine thread must never wait.
+    void waitForBackgroundThread() const;
+
+  private:
+    class Worker;
+
+    /// Convolves one channel pair with the uniformly partitioned overlap-save
+    /// method.
+    class Stage {
+      public:
+        Stage(SINT blockFrames, int partitions);
+        ~Stage();
+
+        /// Convolves blockFrames of interleaved stereo pInput with the
+        /// partitions and writes them to pOutput.
+        void process(const CSAMPLE* pInput,
+                CSAMPLE* pOutput,
+                const std::vector<ConvolutionFilter::Partitions>& partitions);
+        void reset();
+
+      private:
+        const SINT m_blockFrames;
+        const SINT m_fftSize;
+        const std::unique_ptr<FFTReal> m_pFft;
+        // The last two blocks of input per channel
+        std::vector<double> m_windows[ConvolutionFilter::kChannelCount];
+        // The spectra of the recent input windows per channel, the
+        // frequency-domain delay line
+        std::vector<ConvolutionFilter::Partitions> m_delayLines;
+        int m_delayLinePos;
+        std::vector<double> m_fftReal;
+        std::vector<double> m_fftImag;
+        std::vector<float> m_sumReal;
+        std::vector<float> m_sumImag;
+        std::vector<double> m_fftOutput;
+
+        DISALLOW_COPY_AND_ASSIGN(Stage);
+    };
+
+    enum class Job {
+        None,
+        Tail,
+        Rebuild,
+    };
+
+    /// Called from the background thread
+    void processJob();
+    void allocate(mixxx::audio::SampleRate sampleRate,
+            ConvolutionPartitioning partitioning);
+
+    void tailBlockFinished();
+
+    const FilterFactory m_filterFactory;
+    const std::shared_ptr<Worker> m_pWorker;
+
+    // Replaced by the background thread while a rebuild is pending,
+    // otherwise owned by the engine thread
+    ConvolutionFilterPointer m_pFilter;
+    mixxx::audio::SampleRate m_sampleRate;
+    ConvolutionPartitioning m_partitioning;
+    std::unique_ptr<Stage> m_pHead;
+    std::unique_ptr<Stage> m_pTail;
+    std::vector<CSAMPLE> m_headInput;
+    std::vector<CSAMPLE> m_headOutput;
+    SINT m_headFrames;
+    std::vector<CSAMPLE> m_tailInput[2];
+    std::vector<CSAMPLE> m_tailOutput[2];
+    // The frames since the last tail block was handed over
+    SINT m_tailFrames;
+    // The input buffer that is written and the output buffer that is played
+    int m_tailInputIndex;
+    int m_tailOutputIndex;
+    bool m_tailHandedOver;
+    bool m_tailReset;
+
+    // The arguments of the pending job, written by the engine thread before
+    // it is handed over through m_job
+    int m_jobInputIndex;
+    int m_jobOutputIndex;
+    bool m_jobReset;
+    mixxx::audio::SampleRate m_jobSampleRate;
+    ConvolutionPartitioning m_jobPartitioning;
+    std::atomic<Job> m_job;
+
+    DISALLOW_COPY_AND_ASSIGN(PartitionedConvolver);
+};
@@ -2,20 +2,40 @@
 #include <QSqlResult>
 #include <QSqlError>
 #include <QtDebug>
+#include <limits>
 
 #include "library/dao/analysisdao.h"
+#include "library/dao/analysisdataformat.h"
 #include "library/queryutil.h"
 #include "preferences/waveformsettings.h"
 #include "util/performancetimer.h"
 #include "waveform/waveform.h"
+#include "waveform/waveformfactory.h"
 
 const QString AnalysisDao::s_analysisTableName = "track_analysis";
 
-// For a track that takes 1.2MB to store the big waveform, the default
-// compression level (-1) takes the size down to about 600KB. The difference
-// between the default and 9 (the max) was only about 1-2KB for a lot of extra
-// CPU time so I think we should stick with the default. rryan 4/3/2012
-constexpr int kCompressionLevel = -1;
+namespace {
+
+// The waveform bands are stored as bytes interleaved by channel, so deltas
+// between the samples of the same channel are small.
+constexpr int kDeltaStride = 2;
+
+int checksumOf(const char* pData, int size) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return qChecksum(QByteArrayView(pData, size));
+#else
+    return qChecksum(pData, static_cast<uint>(size));
+#endif
+}
+
+// The last versions that were stored with qCompress and int32 values
+QString legacyVersion(AnalysisDao::AnalysisType type) {
+    return type == AnalysisDao::TYPE_WAVEFORM
+            ? QStringLiteral(WAVEFORM_5_VERSION)
+            : QStringLiteral(WAVEFORMSUMMARY_5_VERSION);
+}
+
+} // anonymous namespace
 
 AnalysisDao::AnalysisDao(UserSettingsPointer pConfig)
         : m_pConfig(pConfig) {
@@ -84,21 +104,9 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(TrackId trac
         int checksum = query->value(dataChecksumColumn).toInt();
         QString dataPath = analysisPath.absoluteFilePath(
             QString::number(info.analysisId));
-        const QByteArray compressedData = loadDataFromFile(dataPath);
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-        const int file_checksum = qChecksum(
-                compressedData);
-#else
-        const int file_checksum = qChecksum(
-                compressedData.constData(),
-                compressedData.length());
-#endif
-        if (checksum != file_checksum) {
-            qDebug() << "WARNING: Corrupt analysis loaded from" << dataPath
-                     << "length" << compressedData.length();
+        if (!loadDataFromFile(dataPath, checksum, &info.data)) {
             continue;
         }
-        info.data = qUncompress(compressedData);
         bytes += info.data.length();
         analyses.append(info);
     }
@@ -120,15 +128,8 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
     PerformanceTimer time;
     time.start();
 
-    const QByteArray compressedData = qCompress(info->data, kCompressionLevel);
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    const int checksum = qChecksum(
-            compressedData);
-#else
-    const int checksum = qChecksum(
-            compressedData.constData(),
-            compressedData.length());
-#endif
+    const QByteArray compressedData = AnalysisDataFormat::encode(info->data, kDeltaStride);
+    const int checksum = checksumOf(compressedData.constData(), compressedData.length());
     QSqlQuery query(m_database);
     if (info->analysisId == -1) {
         query.prepare(QString(
@@ -262,15 +263,46 @@ QDir AnalysisDao::getAnalysisStoragePath() const {
     return dir.absolutePath().append("/");
 }
 
-QByteArray AnalysisDao::loadDataFromFile(const QString& filename) const {
-    QFile file(filename);
-    if (!file.exists()) {
-        return QByteArray();
-    }
+bool AnalysisDao::loadDataFromFile(
+        const QString& fileName, int checksum, QByteArray* pData) const {
+    QFile file(fileName);
     if (!file.open(QIODevice::ReadOnly)) {
-        return QByteArray();
+        return false;
+    }
+    const qint64 fileSize = file.size();
+    if (fileSize > std::numeric_limits<int>::max()) {
+        qDebug() << "WARNING: Analysis file is too large" << fileName;
+        return false;
+    }
+    const int size = static_cast<int>(fileSize);
+
+    // Map the file instead of reading it, the blocks are decoded directly
+    // from the mapped memory. Fall back to reading the file if mapping is not
+    // supported.
+    uchar* pMapped = size > 0 ? file.map(0, size) : nullptr;
+    QByteArray fileData;
+    const char* pFileData;
+    if (pMapped) {
+        pFileData = reinterpret_cast<const char*>(pMapped);
+    } else {
+        fileData = file.readAll();
+        pFileData = fileData.constData();
     }
-    return file.readAll();
+
+    bool success = checksumOf(pFileData, size) == checksum;
+    if (success) {
+        *pData = AnalysisDataFormat::decode(pFileData, size);
+        success = !pData->isNull();
+    }
+    if (!success) {
+        qDebug() << "WARNING: Corrupt analysis loaded from" << fileName
+                 << "length" << size;
+    }
+
+    if (pMapped) {
+        file.unmap(pMapped);
+    }
+    return success;
 }
 
 bool AnalysisDao::deleteFile(const QString& fileName) const {
@@ -366,6 +398,109 @@ void AnalysisDao::saveTrackAnalyses(
              << "analysisId" << analysis.analysisId;
 }
 
+int AnalysisDao::convertAnalysesToCurrentFormat(
+        const QSqlDatabase& database,
+        AnalysisType type,
+        const ConversionProgress& progress) const {
+    QDir analysisPath(getAnalysisStoragePath());
+
+    // Older analyses are only kept for older versions of Mixxx
+    const QString fromVersion = legacyVersion(type);
+    const bool waveform = type == TYPE_WAVEFORM;
+    const QString toVersion = waveform
+            ? WaveformFactory::currentWaveformVersion()
+            : WaveformFactory::currentWaveformSummaryVersion();
+    const QString toDescription = waveform
+            ? WaveformFactory::currentWaveformDescription()
+            : WaveformFactory::currentWaveformSummaryDescription();
+
+    QSqlQuery countQuery(database);
+    countQuery.prepare(QString("SELECT COUNT(*) FROM %1 WHERE type=:type AND version=:version")
+                               .arg(s_analysisTableName));
+    countQuery.bindValue(":type", type);
+    countQuery.bindValue(":version", fromVersion);
+    if (!countQuery.exec() || !countQuery.next()) {
+        LOG_FAILED_QUERY(countQuery) << "couldn't count analyses of type" << type;
+        return 0;
+    }
+    const int total = countQuery.value(0).toInt();
+
+    QSqlQuery query(database);
+    query.prepare(QString("SELECT id, data_checksum FROM %1 "
+                          "WHERE type=:type AND version=:version")
+                          .arg(s_analysisTableName));
+    query.bindValue(":type", type);
+    query.bindValue(":version", fromVersion);
+
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't get analyses of type" << type;
+        return 0;
+    }
+
+    PerformanceTimer time;
+    time.start();
+
+    QSqlQuery updateQuery(database);
+    // Older versions of Mixxx can't read the converted analyses and
+    // regenerate them, because they don't know the current version.
+    updateQuery.prepare(QString("UPDATE %1 SET data_checksum=:data_checksum,"
+                                "version=:version,"
+                                "description=:description "
+                                "WHERE id=:id")
+                                .arg(s_analysisTableName));
+    updateQuery.bindValue(":version", toVersion);
+    updateQuery.bindValue(":description", toDescription);
+
+    const int idColumn = query.record().indexOf("id");
+    const int dataChecksumColumn = query.record().indexOf("data_checksum");
+    int processed = 0;
+    int converted = 0;
+    while (query.next()) {
+        if (progress && !progress(processed, total)) {
+            break;
+        }
+        ++processed;
+        const int analysisId = query.value(idColumn).toInt();
+        const QString dataPath = analysisPath.absoluteFilePath(QString::number(analysisId));
+
+        QFile file(dataPath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        const QByteArray fileHeader = file.read(AnalysisDataFormat::kHeaderSize);
+        file.close();
+        int checksum = query.value(dataChecksumColumn).toInt();
+        // Analyses that have been stored in the blocked layout with the legacy
+        // version only need a new version
+        if (!AnalysisDataFormat::hasBlockedLayout(fileHeader.constData(), fileHeader.size())) {
+            QByteArray data;
+            if (!loadDataFromFile(dataPath, checksum, &data)) {
+                continue;
+            }
+            const QByteArray compressedData = AnalysisDataFormat::encode(data, kDeltaStride);
+            if (!saveDataToFile(dataPath, compressedData)) {
+                qDebug() << "WARNING: Couldn't save analysis data to file" << dataPath;
+                continue;
+            }
+            checksum = checksumOf(compressedData.constData(), compressedData.length());
+        }
+        updateQuery.bindValue(":id", analysisId);
+        updateQuery.bindValue(":data_checksum", checksum);
+        if (!updateQuery.exec()) {
+            LOG_FAILED_QUERY(updateQuery) << "couldn't update analysis" << analysisId;
+            continue;
+        }
+        ++converted;
+    }
+    if (progress) {
+        progress(processed, total);
+    }
+    qDebug() << "AnalysisDAO converted" << converted
+             << "analyses of type" << type
+             << "in" << time.elapsed().debugMillisWithUnit();
+    return converted;
+}
+
 size_t AnalysisDao::getDiskUsageInBytes(
         const QSqlDatabase& database,
         AnalysisType type) const {
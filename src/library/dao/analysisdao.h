@@ -3,6 +3,7 @@
 #include <QObject>
 #include <QDir>
 #include <QSqlDatabase>
+#include <functional>
 
 #include "preferences/usersettings.h"
 #include "library/dao/dao.h"
@@ -44,6 +45,18 @@ class AnalysisDao : public DAO {
     size_t getDiskUsageInBytes(
             const QSqlDatabase& database,
             AnalysisType type) const;
+    /// Called with the number of analyses that have been processed so far and
+    /// the total number of analyses. Returning false stops the conversion.
+    using ConversionProgress = std::function<bool(int processed, int total)>;
+    /// Rewrites all analyses of the given type that have been stored by older
+    /// versions of Mixxx with the legacy version in the current on-disk format
+    /// (see AnalysisDataFormat) and updates their version, see
+    /// WaveformFactory. Returns the number of converted analyses.
+    /// This may take a while and should not be called from the GUI thread.
+    int convertAnalysesToCurrentFormat(
+            const QSqlDatabase& database,
+            AnalysisType type,
+            const ConversionProgress& progress = nullptr) const;
 
     QList<AnalysisInfo> getAnalysesForTrackByType(TrackId trackId, AnalysisType type);
     QList<AnalysisInfo> getAnalysesForTrack(TrackId trackId);
@@ -59,7 +72,9 @@ class AnalysisDao : public DAO {
 
   private:
     QDir getAnalysisStoragePath() const;
-    QByteArray loadDataFromFile(const QString& fileName) const;
+    /// Loads and decodes the data of an analysis file, verifying the checksum
+    /// that has been stored in the database.
+    bool loadDataFromFile(const QString& fileName, int checksum, QByteArray* pData) const;
     bool saveDataToFile(const QString& fileName, const QByteArray& data) const;
     bool deleteFile(const QString& filename) const;
     QList<AnalysisInfo> loadAnalysesFromQuery(TrackId trackId, QSqlQuery* query);
@@ -0,0 +1,309 @@
+#include "library/dao/analysisdataformat.h"
+
+#include <QtDebug>
+#include <QtEndian>
+#include <cstring>
+#include <limits>
+
+#ifdef __LZ4__
+#include <lz4.h>
+#endif
+
+#include "util/assert.h"
+#include "util/math.h"
+
+namespace {
+
+// Header layout, all integers are little endian:
+//  0: magic "MXAN"
+//  4: format version (8 bit)
+//  5: codec (8 bit)
+//  6: delta stride (8 bit)
+//  7: reserved
+//  8: uncompressed size (32 bit)
+// 12: uncompressed block size (32 bit)
+// 16: block count (32 bit)
+// 20: (block count + 1) file offsets of the blocks (32 bit each), the last
+//     one points to the end of the data.
+// A block with a stored size equal to its uncompressed size is not
+// compressed.
+constexpr char kMagic[4] = {'M', 'X', 'A', 'N'};
+constexpr quint8 kFormatVersion = 1;
+constexpr int kHeaderSize = AnalysisDataFormat::kHeaderSize;
+constexpr int kOffsetSize = sizeof(quint32);
+
+// Large enough to compress well and small enough to stay in the CPU cache
+// while a block is delta-coded and compressed.
+constexpr int kBlockSize = 64 * 1024;
+
+constexpr int kMaxDeltaStride = 255;
+
+// For a track that takes 1.2MB to store the big waveform, the default
+// compression level (-1) takes the size down to about 600KB. The difference
+// between the default and 9 (the max) was only about 1-2KB for a lot of extra
+// CPU time so I think we should stick with the default. rryan 4/3/2012
+constexpr int kZlibCompressionLevel = -1;
+
+struct Header {
+    AnalysisDataFormat::Codec codec;
+    int deltaStride;
+    int uncompressedSize;
+    int blockSize;
+    int blockCount;
+};
+
+inline quint32 readUInt32(const char* pData) {
+    return qFromLittleEndian<quint32>(pData);
+}
+
+inline void writeUInt32(char* pData, quint32 value) {
+    qToLittleEndian<quint32>(value, pData);
+}
+
+void appendUInt32(QByteArray* pData, quint32 value) {
+    char bytes[kOffsetSize];
+    writeUInt32(bytes, value);
+    pData->append(bytes, kOffsetSize);
+}
+
+bool readHeader(const char* pData, int size, Header* pHeader) {
+    if (!AnalysisDataFormat::hasBlockedLayout(pData, size)) {
+        return false;
+    }
+    if (static_cast<quint8>(pData[4]) != kFormatVersion) {
+        qWarning() << "AnalysisDataFormat: Unsupported format version"
+                   << static_cast<quint8>(pData[4]);
+        return false;
+    }
+    pHeader->codec = static_cast<AnalysisDataFormat::Codec>(
+            static_cast<quint8>(pData[5]));
+    pHeader->deltaStride = static_cast<quint8>(pData[6]);
+    const quint32 uncompressedSize = readUInt32(pData + 8);
+    const quint32 blockSize = readUInt32(pData + 12);
+    const quint32 blockCount = readUInt32(pData + 16);
+    if (blockSize == 0 ||
+            uncompressedSize > static_cast<quint32>(std::numeric_limits<int>::max()) ||
+            blockCount != (uncompressedSize + blockSize - 1) / blockSize ||
+            kHeaderSize + (static_cast<qint64>(blockCount) + 1) * kOffsetSize > size) {
+        qWarning() << "AnalysisDataFormat: Corrupt header";
+        return false;
+    }
+    pHeader->uncompressedSize = static_cast<int>(uncompressedSize);
+    pHeader->blockSize = static_cast<int>(blockSize);
+    pHeader->blockCount = static_cast<int>(blockCount);
+    if (!AnalysisDataFormat::isCodecSupported(pHeader->codec)) {
+        qWarning() << "AnalysisDataFormat: Codec"
+                   << static_cast<int>(pHeader->codec)
+                   << "is not supported by this build";
+        return false;
+    }
+    return true;
+}
+
+void deltaEncode(char* pData, int length, int stride) {
+    for (int i = length - 1; i >= stride; --i) {
+        pData[i] = static_cast<char>(
+                static_cast<quint8>(pData[i]) - static_cast<quint8>(pData[i - stride]));
+    }
+}
+
+void deltaDecode(char* pData, int length, int stride) {
+    for (int i = stride; i < length; ++i) {
+        pData[i] = static_cast<char>(
+                static_cast<quint8>(pData[i]) + static_cast<quint8>(pData[i - stride]));
+    }
+}
+
+// Returns an empty QByteArray if the block should be stored uncompressed.
+QByteArray compressBlock(AnalysisDataFormat::Codec codec, const char* pData, int length) {
+    switch (codec) {
+    case AnalysisDataFormat::Codec::Lz4: {
+#ifdef __LZ4__
+        const int bound = LZ4_compressBound(length);
+        QByteArray compressed(bound, Qt::Uninitialized);
+        const int compressedLength = LZ4_compress_default(
+                pData, compressed.data(), length, bound);
+        if (compressedLength <= 0) {
+            return QByteArray();
+        }
+        compressed.truncate(compressedLength);
+        return compressed;
+#else
+        DEBUG_ASSERT(!"LZ4 is not available");
+        return QByteArray();
+#endif
+    }
+    case AnalysisDataFormat::Codec::Zlib:
+        return qCompress(reinterpret_cast<const uchar*>(pData),
+                length,
+                kZlibCompressionLevel);
+    case AnalysisDataFormat::Codec::None:
+        break;
+    }
+    return QByteArray();
+}
+
+bool decompressBlock(AnalysisDataFormat::Codec codec,
+        const char* pSource,
+        int sourceLength,
+        char* pDest,
+        int destLength) {
+    if (sourceLength == destLength) {
+        std::memcpy(pDest, pSource, destLength);
+        return true;
+    }
+    switch (codec) {
+    case AnalysisDataFormat::Codec::Lz4:
+#ifdef __LZ4__
+        return LZ4_decompress_safe(pSource, pDest, sourceLength, destLength) == destLength;
+#else
+        return false;
+#endif
+    case AnalysisDataFormat::Codec::Zlib: {
+        const QByteArray uncompressed = qUncompress(
+                reinterpret_cast<const uchar*>(pSource), sourceLength);
+        if (uncompressed.size() != destLength) {
+            return false;
+        }
+        std::memcpy(pDest, uncompressed.constData(), destLength);
+        return true;
+    }
+    case AnalysisDataFormat::Codec::None:
+        break;
+    }
+    return false;
+}
+
+bool decodeBlock(const Header& header,
+        const char* pData,
+        int size,
+        int block,
+        char* pDest,
+        int destLength) {
+    const char* pOffsets = pData + kHeaderSize;
+    const quint32 begin = readUInt32(pOffsets + block * kOffsetSize);
+    const quint32 end = readUInt32(pOffsets + (block + 1) * kOffsetSize);
+    if (begin > end || end > static_cast<quint32>(size)) {
+        return false;
+    }
+    if (!decompressBlock(header.codec,
+                pData + begin,
+                static_cast<int>(end - begin),
+                pDest,
+                destLength)) {
+        return false;
+    }
+    if (header.deltaStride > 0) {
+        deltaDecode(pDest, destLength, header.deltaStride);
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+// static
+AnalysisDataFormat::Codec AnalysisDataFormat::defaultCodec() {
+#ifdef __LZ4__
+    return Codec::Lz4;
+#else
+    return Codec::Zlib;
+#endif
+}
+
+// static
+bool AnalysisDataFormat::isCodecSupported(Codec codec) {
+    switch (codec) {
+    case Codec::None:
+    case Codec::Zlib:
+        return true;
+    case Codec::Lz4:
+#ifdef __LZ4__
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+// static
+QByteArray AnalysisDataFormat::encode(
+        const QByteArray& data,
+        int deltaStride,
+        Codec codec) {
+    VERIFY_OR_DEBUG_ASSERT(deltaStride >= 0 && deltaStride <= kMaxDeltaStride) {
+        deltaStride = 0;
+    }
+    VERIFY_OR_DEBUG_ASSERT(isCodecSupported(codec)) {
+        codec = defaultCodec();
+    }
+
+    const int blockCount = (data.size() + kBlockSize - 1) / kBlockSize;
+    const int offsetTableSize = (blockCount + 1) * kOffsetSize;
+
+    QByteArray encoded;
+    encoded.reserve(kHeaderSize + offsetTableSize + data.size() / 2);
+    encoded.append(kMagic, sizeof(kMagic));
+    encoded.append(static_cast<char>(kFormatVersion));
+    encoded.append(static_cast<char>(codec));
+    encoded.append(static_cast<char>(deltaStride));
+    encoded.append('\0');
+    appendUInt32(&encoded, data.size());
+    appendUInt32(&encoded, kBlockSize);
+    appendUInt32(&encoded, blockCount);
+    // The offsets are filled in while the blocks are appended.
+    encoded.append(offsetTableSize, '\0');
+
+    QByteArray blockBuffer;
+    for (int block = 0; block < blockCount; ++block) {
+        writeUInt32(encoded.data() + kHeaderSize + block * kOffsetSize, encoded.size());
+
+        const int blockStart = block * kBlockSize;
+        const int blockLength = math_min(kBlockSize, data.size() - blockStart);
+        const char* pBlock = data.constData() + blockStart;
+        if (deltaStride > 0) {
+            blockBuffer = QByteArray(pBlock, blockLength);
+            deltaEncode(blockBuffer.data(), blockLength, deltaStride);
+            pBlock = blockBuffer.constData();
+        }
+
+        const QByteArray compressed = compressBlock(codec, pBlock, blockLength);
+        if (compressed.isEmpty() || compressed.size() >= blockLength) {
+            encoded.append(pBlock, blockLength);
+        } else {
+            encoded.append(compressed);
+        }
+    }
+    writeUInt32(encoded.data() + kHeaderSize + blockCount * kOffsetSize, encoded.size());
+    return encoded;
+}
+
+// static
+bool AnalysisDataFormat::hasBlockedLayout(const char* pData, int size) {
+    // A legacy qCompress() blob starts with the big endian uncompressed size,
+    // which would need to be more than 1 GB to match the magic.
+    return size >= kHeaderSize && std::memcmp(pData, kMagic, sizeof(kMagic)) == 0;
+}
+
+// static
+QByteArray AnalysisDataFormat::decode(const char* pData, int size) {
+    if (!hasBlockedLayout(pData, size)) {
+        return qUncompress(reinterpret_cast<const uchar*>(pData), size);
+    }
+    Header header;
+    if (!readHeader(pData, size, &header)) {
+        return QByteArray();
+    }
+    QByteArray decoded(header.uncompressedSize, Qt::Uninitialized);
+    for (int block = 0; block < header.blockCount; ++block) {
+        const int blockStart = block * header.blockSize;
+        const int blockLength = math_min(
+                header.blockSize, header.uncompressedSize - blockStart);
+        if (!decodeBlock(header, pData, size, block,
+                    decoded.data() + blockStart, blockLength)) {
+            qWarning() << "AnalysisDataFormat: Failed to decode block" << block;
+            return QByteArray();
+        }
+    }
+    return decoded;
+}
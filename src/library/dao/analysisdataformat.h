@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QByteArray>
+
+/// The on-disk layout of the analysis data files managed by AnalysisDao.
+///
+/// The data is split into blocks of a fixed uncompressed size that are
+/// compressed independently. A table with the offsets of all blocks follows
+/// the header, so every block is decoded directly into its place in the
+/// output without an intermediate copy. Optionally the bytes of
+/// each block are delta-coded with a given stride before compression, which
+/// makes slowly changing byte signals like the waveform bands compress much
+/// better.
+///
+/// Blocks are compressed with LZ4 if Mixxx was built with it and with zlib
+/// otherwise. Files written by older versions of Mixxx, which are plain
+/// qCompress() blobs, are still decoded.
+class AnalysisDataFormat {
+  public:
+    enum class Codec {
+        None = 0,
+        Zlib = 1,
+        Lz4 = 2,
+    };
+
+    /// The number of leading bytes that hasBlockedLayout() needs to inspect.
+    static constexpr int kHeaderSize = 20;
+
+    /// The best codec that is available in this build.
+    static Codec defaultCodec();
+    static bool isCodecSupported(Codec codec);
+
+    /// Encodes the data into the blocked layout. A deltaStride of 0 disables
+    /// the delta coding.
+    static QByteArray encode(
+            const QByteArray& data,
+            int deltaStride = 0,
+            Codec codec = defaultCodec());
+
+    /// Returns true if the data was written by encode() and false for legacy
+    /// qCompress() blobs.
+    static bool hasBlockedLayout(const char* pData, int size);
+
+    /// Decodes the data of either layout. Returns a null QByteArray if the data
+    /// is corrupt or uses a codec that is not supported by this build.
+    static QByteArray decode(const char* pData, int size);
+    static QByteArray decode(const QByteArray& data) {
+        return decode(data.constData(), data.size());
+    }
+};
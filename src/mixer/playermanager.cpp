@@ -154,7 +154,10 @@ void PlayerManager::bindToLibrary(Library* pLibrary) {
     DEBUG_ASSERT(!m_pTrackAnalysisScheduler);
     m_pTrackAnalysisScheduler = pLibrary->createTrackAnalysisScheduler(
             kNumberOfAnalyzerThreads,
-            AnalyzerModeFlags::WithWaveform);
+            // Tracks are analyzed here because they have been loaded into
+            // a deck, so the audio decoded for playback can be reused.
+            static_cast<AnalyzerModeFlags>(AnalyzerModeFlags::WithWaveform |
+                    AnalyzerModeFlags::WithPlaybackAudio));
 
     connect(m_pTrackAnalysisScheduler.get(), &TrackAnalysisScheduler::trackProgress,
             this, &PlayerManager::onTrackAnalysisProgress);
@@ -1,11 +1,17 @@
 #include "preferences/dialog/dlgprefwaveform.h"
 
+#include <QProgressDialog>
+#include <QtConcurrentRun>
+
 #include "library/dao/analysisdao.h"
 #include "library/library.h"
 #include "mixxxmainwindow.h"
 #include "moc_dlgprefwaveform.cpp"
 #include "preferences/waveformsettings.h"
+#include "util/assert.h"
 #include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/parented_ptr.h"
 #include "waveform/renderers/waveformwidgetrenderer.h"
 #include "waveform/waveformwidgetfactory.h"
 
@@ -15,7 +21,8 @@ DlgPrefWaveform::DlgPrefWaveform(
         std::shared_ptr<Library> pLibrary)
         : DlgPreferencePage(pParent),
           m_pConfig(pConfig),
-          m_pLibrary(pLibrary) {
+          m_pLibrary(pLibrary),
+          m_convertCanceled(false) {
     setupUi(this);
 
     // Waveform overview init
@@ -128,6 +135,14 @@ DlgPrefWaveform::DlgPrefWaveform(
             &QAbstractButton::clicked,
             this,
             &DlgPrefWaveform::slotClearCachedWaveforms);
+    connect(convertCachedWaveforms,
+            &QAbstractButton::clicked,
+            this,
+            &DlgPrefWaveform::slotConvertCachedWaveforms);
+    connect(&m_convertedWaveformsWatcher,
+            &QFutureWatcher<int>::finished,
+            this,
+            &DlgPrefWaveform::slotCachedWaveformsConverted);
     connect(playMarkerPositionSlider,
             &QSlider::valueChanged,
             this,
@@ -135,6 +150,8 @@ DlgPrefWaveform::DlgPrefWaveform(
 }
 
 DlgPrefWaveform::~DlgPrefWaveform() {
+    m_convertCanceled.store(true);
+    m_convertedWaveformsWatcher.waitForFinished();
 }
 
 void DlgPrefWaveform::slotUpdate() {
@@ -300,6 +317,80 @@ void DlgPrefWaveform::slotClearCachedWaveforms() {
     calculateCachedWaveformDiskUsage();
 }
 
+void DlgPrefWaveform::slotConvertCachedWaveforms() {
+    VERIFY_OR_DEBUG_ASSERT(!m_convertedWaveformsWatcher.isRunning()) {
+        return;
+    }
+    // Clearing the cache while it is converted would only produce warnings
+    clearCachedWaveforms->setEnabled(false);
+    convertCachedWaveforms->setEnabled(false);
+    m_convertCanceled.store(false);
+
+    auto pProgressDlg = make_parented<QProgressDialog>(this);
+    pProgressDlg->setLabelText(tr("Converting cached waveforms..."));
+    pProgressDlg->setMinimumDuration(0);
+    // The dialog is closed when both analysis types have been converted
+    pProgressDlg->setAutoClose(false);
+    pProgressDlg->setAutoReset(false);
+    connect(pProgressDlg,
+            &QProgressDialog::canceled,
+            this,
+            [this] {
+                m_convertCanceled.store(true);
+            });
+    connect(&m_convertedWaveformsWatcher,
+            &QFutureWatcher<int>::finished,
+            pProgressDlg,
+            &QObject::deleteLater);
+
+    // The worker thread only posts the progress to the dialog, which drops
+    // updates that arrive after it has been deleted.
+    QProgressDialog* pProgressDlgPtr = pProgressDlg.get();
+    std::atomic<bool>* pCanceled = &m_convertCanceled;
+    m_convertedWaveformsWatcher.setFuture(QtConcurrent::run(
+            [pConfig = m_pConfig,
+                    pDbConnectionPool = m_pLibrary->dbConnectionPool(),
+                    pProgressDlgPtr,
+                    pCanceled] {
+                // The pooler limits the lifetime of the thread-local
+                // connection to this function.
+                const mixxx::DbConnectionPooler dbConnectionPooler(pDbConnectionPool);
+                QSqlDatabase dbConnection = mixxx::DbConnectionPooled(pDbConnectionPool);
+                AnalysisDao analysisDao(pConfig);
+                int converted = 0;
+                for (const auto type :
+                        {AnalysisDao::TYPE_WAVEFORM, AnalysisDao::TYPE_WAVESUMMARY}) {
+                    const QString labelText = type == AnalysisDao::TYPE_WAVEFORM
+                            ? tr("Converting cached waveforms...")
+                            : tr("Converting cached waveform overviews...");
+                    converted += analysisDao.convertAnalysesToCurrentFormat(
+                            dbConnection,
+                            type,
+                            [pProgressDlgPtr, pCanceled, labelText](
+                                    int processed, int total) {
+                                QMetaObject::invokeMethod(
+                                        pProgressDlgPtr,
+                                        [pProgressDlgPtr, labelText, processed, total] {
+                                            pProgressDlgPtr->setLabelText(labelText);
+                                            pProgressDlgPtr->setMaximum(total);
+                                            pProgressDlgPtr->setValue(processed);
+                                        },
+                                        Qt::QueuedConnection);
+                                return !pCanceled->load();
+                            });
+                }
+                return converted;
+            }));
+}
+
+void DlgPrefWaveform::slotCachedWaveformsConverted() {
+    qDebug() << "Converted" << m_convertedWaveformsWatcher.result()
+             << "cached waveforms";
+    clearCachedWaveforms->setEnabled(true);
+    convertCachedWaveforms->setEnabled(true);
+    calculateCachedWaveformDiskUsage();
+}
+
 void DlgPrefWaveform::slotSetBeatGridAlpha(int alpha) {
     m_pConfig->setValue(ConfigKey("[Waveform]", "beatGridAlpha"), alpha);
     WaveformWidgetFactory::instance()->setDisplayBeatGridAlpha(alpha);
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <QFutureWatcher>
 #include <QWidget>
+#include <atomic>
 #include <memory>
 
 #include "preferences/dialog/dlgpreferencepage.h"
@@ -37,6 +39,8 @@ class DlgPrefWaveform : public DlgPreferencePage, public Ui::DlgPrefWaveformDlg
     void slotSetNormalizeOverview(bool normalize);
     void slotWaveformMeasured(float frameRate, int droppedFrames);
     void slotClearCachedWaveforms();
+    void slotConvertCachedWaveforms();
+    void slotCachedWaveformsConverted();
     void slotSetBeatGridAlpha(int alpha);
     void slotSetPlayMarkerPosition(int position);
 
@@ -50,4 +54,8 @@ class DlgPrefWaveform : public DlgPreferencePage, public Ui::DlgPrefWaveformDlg
 
     UserSettingsPointer m_pConfig;
     std::shared_ptr<Library> m_pLibrary;
+
+    // The conversion of cached waveforms runs in a worker thread
+    QFutureWatcher<int> m_convertedWaveformsWatcher;
+    std::atomic<bool> m_convertCanceled;
 };
@@ -1,5 +1,7 @@
 #include "skin/legacy/colorschemeparser.h"
 
+#include <QTextStream>
+
 #include "widget/wpixmapstore.h"
 #include "widget/wimagestore.h"
 #include "widget/wskincolor.h"
@@ -45,9 +47,14 @@ void ColorSchemeParser::setupLegacyColorSchemes(const QDomElement& docElem,
         }
 
         if (bSelectedColorSchemeFound) {
+            const QDomNode filtersNode = schemeNode.namedItem("Filters");
             QSharedPointer<ImgSource> imsrc =
-                    QSharedPointer<ImgSource>(parseFilters(schemeNode.namedItem("Filters")));
-            WPixmapStore::setLoader(imsrc);
+                    QSharedPointer<ImgSource>(parseFilters(filtersNode));
+            // The filters define how the images are processed
+            QString filters;
+            QTextStream filtersStream(&filters);
+            filtersNode.save(filtersStream, 0);
+            WPixmapStore::setLoader(imsrc, filters);
             WImageStore::setLoader(imsrc);
             WSkinColor::setLoader(imsrc);
 
@@ -24,7 +24,9 @@
 #include "skin/legacy/colorschemeparser.h"
 #include "skin/legacy/launchimage.h"
 #include "skin/legacy/skincontext.h"
+#include "skin/legacy/skinimagecache.h"
 #include "util/cmdlineargs.h"
+#include "util/performancetimer.h"
 #include "util/timer.h"
 #include "util/valuetransformer.h"
 #include "util/xml.h"
@@ -93,6 +95,13 @@ QSet<QString> LegacySkinParser::s_sharedGroupStrings;
 
 static bool sDebug = false;
 
+namespace {
+
+const QString kSkinImageCacheDirectory = QStringLiteral("/cache/skin");
+constexpr int kSkinImageCacheMaxAgeDays = 90;
+
+} // anonymous namespace
+
 ControlObject* LegacySkinParser::controlFromConfigKey(
         const ConfigKey& key, bool bPersist, bool* pCreated) {
     if (!key.isValid()) {
@@ -320,6 +329,9 @@ Qt::MouseButton LegacySkinParser::parseButtonState(const QDomNode& node,
 QWidget* LegacySkinParser::parseSkin(const QString& skinPath, QWidget* pParent) {
     ScopedTimer timer("SkinLoader::parseSkin");
     qDebug() << "LegacySkinParser loading skin:" << skinPath;
+    PerformanceTimer loadTimer;
+    loadTimer.start();
+    SkinImageCache::setDirectory(m_pConfig->getSettingsPath() + kSkinImageCacheDirectory);
 
     m_pContext = std::make_unique<SkinContext>(m_pConfig, skinPath + "/skin.xml");
     m_pContext->setSkinBasePath(skinPath);
@@ -398,7 +410,20 @@ QWidget* LegacySkinParser::parseSkin(const QString& skinPath, QWidget* pParent)
     // created parent so MixxxMainWindow can use it for various purposes
     // (fullscreen mostly) --bkgood
     m_pParent = pParent;
+    // The SVGs are rasterized in parallel while the widgets are created
+    WPixmapStore::beginDeferredRasterization();
     QList<QWidget*> widgets = parseNode(skinDocument);
+    const int rasterizedCount = WPixmapStore::finishDeferredRasterization();
+
+    int cacheHits;
+    int cacheMisses;
+    SkinImageCache::takeStats(&cacheHits, &cacheMisses);
+    qInfo() << "LegacySkinParser loaded skin in"
+            << loadTimer.elapsed().formatMillisWithUnit() << "with"
+            << cacheHits << "of" << cacheHits + cacheMisses
+            << "rasterized images from the cache and"
+            << rasterizedCount << "rasterized in parallel";
+    SkinImageCache::prune(kSkinImageCacheMaxAgeDays);
 
     if (widgets.empty()) {
         SKIN_WARNING(skinDocument, *m_pContext) << "Skin produced no widgets!";
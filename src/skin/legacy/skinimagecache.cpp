@@ -0,0 +1,175 @@
+#include "skin/legacy/skinimagecache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QtDebug>
+#include <cstring>
+
+namespace {
+
+// File layout, written with QDataStream in big endian:
+//  magic (32 bit), format version (8 bit), width, height, QImage::Format,
+//  bytes per line (32 bit each), followed by the raw scanlines.
+constexpr quint32 kMagic = 0x4d585349; // "MXSI"
+constexpr quint8 kFormatVersion = 1;
+constexpr int kHeaderSize = 4 + 1 + 4 * 4;
+
+const QString kFileSuffix = QStringLiteral(".img");
+
+// Increment when the rasterization of the SVGs in Paintable changes, so
+// images rendered by an older version are not used.
+constexpr char kRendererVersion[] = "1";
+
+// The modification time of a file is its last use. Loading a file only
+// updates it if it is older, so loading a skin does not write every file.
+constexpr int kTouchIntervalDays = 1;
+
+// The cache is only accessed while loading skins in the GUI thread
+QString s_directory;
+int s_hits = 0;
+int s_misses = 0;
+
+QString filePath(const QByteArray& key) {
+    return s_directory + QLatin1Char('/') + QString::fromLatin1(key) + kFileSuffix;
+}
+
+/// Marks the file as used, see prune()
+void touch(const QString& fileName) {
+    QFile file(fileName);
+    // Append does not truncate the file. Setting the time needs write access
+    // on Windows.
+    if (!file.open(QIODevice::Append) ||
+            !file.setFileTime(QDateTime::currentDateTime(),
+                    QFileDevice::FileModificationTime)) {
+        qWarning() << "SkinImageCache: Failed to update the time of" << fileName;
+    }
+}
+
+} // anonymous namespace
+
+// static
+void SkinImageCache::setDirectory(const QString& path) {
+    if (path.isEmpty()) {
+        s_directory.clear();
+        return;
+    }
+    if (!QDir().mkpath(path)) {
+        qWarning() << "SkinImageCache: Failed to create directory" << path;
+        s_directory.clear();
+        return;
+    }
+    s_directory = path;
+}
+
+// static
+bool SkinImageCache::isEnabled() {
+    return !s_directory.isEmpty();
+}
+
+// static
+QByteArray SkinImageCache::key(const QByteArray& svgData,
+        double scaleFactor,
+        const QString& colorSchemeId) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(kRendererVersion);
+    // The output of QSvgRenderer may change with the Qt version
+    hash.addData(qVersion());
+    hash.addData(svgData);
+    hash.addData(QByteArray::number(scaleFactor, 'g', 17));
+    hash.addData(colorSchemeId.toUtf8());
+    return hash.result().toHex();
+}
+
+// static
+QImage SkinImageCache::load(const QByteArray& key) {
+    if (!isEnabled()) {
+        return QImage();
+    }
+    QFile file(filePath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        ++s_misses;
+        return QImage();
+    }
+    const QByteArray data = file.readAll();
+    QDataStream stream(data);
+    quint32 magic;
+    quint8 version;
+    qint32 width;
+    qint32 height;
+    qint32 format;
+    qint32 bytesPerLine;
+    stream >> magic >> version >> width >> height >> format >> bytesPerLine;
+    if (stream.status() != QDataStream::Ok ||
+            magic != kMagic ||
+            version != kFormatVersion ||
+            width <= 0 || height <= 0 ||
+            format <= QImage::Format_Invalid || format >= QImage::NImageFormats ||
+            data.size() - kHeaderSize != static_cast<qint64>(bytesPerLine) * height) {
+        qWarning() << "SkinImageCache: Ignoring corrupt file" << file.fileName();
+        ++s_misses;
+        return QImage();
+    }
+    QImage image(width, height, static_cast<QImage::Format>(format));
+    if (image.isNull() || image.bytesPerLine() != bytesPerLine) {
+        ++s_misses;
+        return QImage();
+    }
+    std::memcpy(image.bits(), data.constData() + kHeaderSize, data.size() - kHeaderSize);
+    if (file.fileTime(QFileDevice::FileModificationTime) <
+            QDateTime::currentDateTime().addDays(-kTouchIntervalDays)) {
+        touch(file.fileName());
+    }
+    ++s_hits;
+    return image;
+}
+
+// static
+void SkinImageCache::store(const QByteArray& key, const QImage& image) {
+    if (!isEnabled() || image.isNull()) {
+        return;
+    }
+    QSaveFile file(filePath(key));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "SkinImageCache: Failed to write" << file.fileName();
+        return;
+    }
+    QDataStream stream(&file);
+    stream << kMagic << kFormatVersion
+           << static_cast<qint32>(image.width())
+           << static_cast<qint32>(image.height())
+           << static_cast<qint32>(image.format())
+           << static_cast<qint32>(image.bytesPerLine());
+    stream.writeRawData(reinterpret_cast<const char*>(image.constBits()),
+            image.bytesPerLine() * image.height());
+    if (stream.status() != QDataStream::Ok || !file.commit()) {
+        qWarning() << "SkinImageCache: Failed to write" << file.fileName();
+    }
+}
+
+// static
+void SkinImageCache::prune(int maxAgeDays) {
+    if (!isEnabled()) {
+        return;
+    }
+    const QDateTime oldest = QDateTime::currentDateTime().addDays(-maxAgeDays);
+    const QFileInfoList files = QDir(s_directory).entryInfoList(
+            QStringList{QLatin1Char('*') + kFileSuffix}, QDir::Files);
+    for (const QFileInfo& fileInfo : files) {
+        // Loaded and stored files have been touched, see load()
+        if (fileInfo.lastModified() < oldest) {
+            QFile::remove(fileInfo.absoluteFilePath());
+        }
+    }
+}
+
+// static
+void SkinImageCache::takeStats(int* pHits, int* pMisses) {
+    *pHits = s_hits;
+    *pMisses = s_misses;
+    s_hits = 0;
+    s_misses = 0;
+}
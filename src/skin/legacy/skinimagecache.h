@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QString>
+
+/// A persistent cache for the pixmaps that are rasterized from the SVG
+/// graphics of a skin.
+///
+/// Rendering the SVGs with QSvgRenderer dominates the time it takes to load
+/// a skin. The rasterized images are stored in an uncompressed binary format
+/// in the settings directory, keyed by a hash of the SVG data, the scale
+/// factor and the color scheme, so any change of a skin file, the scaling or
+/// the selected color scheme results in a different key. The key also
+/// includes the version of the renderer and of Qt. The modification time of
+/// a file is updated when it is loaded, and entries that have not been used
+/// for a while are removed by prune().
+class SkinImageCache {
+  public:
+    /// Enables the cache in the given directory. The cache is disabled
+    /// as long as no directory has been set and by an empty path.
+    static void setDirectory(const QString& path);
+    static bool isEnabled();
+
+    static QByteArray key(const QByteArray& svgData,
+            double scaleFactor,
+            const QString& colorSchemeId);
+
+    /// Returns a null image if the key is not cached.
+    static QImage load(const QByteArray& key);
+    static void store(const QByteArray& key, const QImage& image);
+
+    /// Removes the entries that have not been used for the given number of
+    /// days.
+    static void prune(int maxAgeDays);
+
+    /// The lookups since the last call, for reporting the load time.
+    static void takeStats(int* pHits, int* pMisses);
+};
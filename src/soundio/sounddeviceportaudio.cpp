@@ -880,48 +880,10 @@ int SoundDevicePortAudio::callbackProcessClkRef(
         m_bSetThreadPriority = true;
 
 
-#ifdef __SSE__
         // This disables the denormals calculations, to avoid a
         // performance penalty of ~20
         // https://bugs.launchpad.net/mixxx/+bug/1404401
-        if (!_MM_GET_DENORMALS_ZERO_MODE()) {
-            qDebug() << "SSE: Enabling denormals to zero mode";
-            _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
-        } else {
-             qDebug() << "SSE: Denormals to zero mode already enabled";
-        }
-
-        if (!_MM_GET_FLUSH_ZERO_MODE()) {
-            qDebug() << "SSE: Enabling flush to zero mode";
-            _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
-        } else {
-             qDebug() << "SSE: Flush to zero mode already enabled";
-        }
-#else
-#if defined( __i386__ ) || defined( __i486__ ) || defined( __i586__ ) || \
-         defined( __i686__ ) || defined( __x86_64__ ) || defined (_M_I86)
-        qWarning() << "No SSE: No denormals to zero mode available. EQs and effects may suffer high CPU load";
-#endif
-#endif
-
-#if defined(__aarch64__)
-        // Flush-to-zero on aarch64 is controlled by the Floating-point Control Register
-        // Load the register into our variable.
-        int savedFPCR;
-        asm volatile("mrs %[savedFPCR], FPCR"
-                     : [ savedFPCR ] "=r"(savedFPCR));
-
-        qDebug() << "aarch64 FPCR: setting bit 24 to 1 to enable Flush-to-zero";
-        // Bit 24 is the flush-to-zero mode control bit. Setting it to 1 flushes denormals to 0.
-        asm volatile("msr FPCR, %[src]"
-                     :
-                     : [ src ] "r"(savedFPCR | (1 << 24)));
-#endif
-
-        // verify if flush to zero or denormals to zero works
-        // test passes if one of the two flag is set.
-        volatile double doubleMin = DBL_MIN; // the smallest normalized double
-        VERIFY_OR_DEBUG_ASSERT(doubleMin / 2 == 0.0) {
+        VERIFY_OR_DEBUG_ASSERT(mixxx::enableDenormalsAreZero()) {
             qWarning() << "Denormals to zero mode is not working. EQs and effects may suffer high CPU load";
         } else {
             qDebug() << "Denormals to zero mode is working";
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <QByteArray>
+
+#include "library/dao/analysisdataformat.h"
+
+namespace {
+
+class AnalysisDataFormatTest : public testing::Test {
+  protected:
+    // A slowly changing signal that spans several blocks and does not end at
+    // a block boundary.
+    static QByteArray makeData(int size) {
+        QByteArray data(size, '\0');
+        for (int i = 0; i < size; ++i) {
+            data[i] = static_cast<char>((i / 7 + (i % 2) * 31) & 0xFF);
+        }
+        return data;
+    }
+};
+
+TEST_F(AnalysisDataFormatTest, roundTrip) {
+    const QByteArray data = makeData(300 * 1000);
+    for (const auto codec : {AnalysisDataFormat::Codec::None,
+                 AnalysisDataFormat::Codec::Zlib,
+                 AnalysisDataFormat::defaultCodec()}) {
+        for (const int deltaStride : {0, 1, 2}) {
+            const QByteArray encoded = AnalysisDataFormat::encode(data, deltaStride, codec);
+            EXPECT_TRUE(AnalysisDataFormat::hasBlockedLayout(
+                    encoded.constData(), encoded.size()));
+            EXPECT_EQ(data, AnalysisDataFormat::decode(encoded));
+        }
+    }
+}
+
+TEST_F(AnalysisDataFormatTest, compresses) {
+    const QByteArray data = makeData(300 * 1000);
+    const QByteArray encoded = AnalysisDataFormat::encode(data, 2);
+    EXPECT_LT(encoded.size(), data.size() / 2);
+}
+
+TEST_F(AnalysisDataFormatTest, emptyData) {
+    const QByteArray encoded = AnalysisDataFormat::encode(QByteArray(), 2);
+    const QByteArray decoded = AnalysisDataFormat::decode(encoded);
+    EXPECT_FALSE(decoded.isNull());
+    EXPECT_TRUE(decoded.isEmpty());
+}
+
+TEST_F(AnalysisDataFormatTest, blockBoundaries) {
+    for (const int size : {1, 65535, 65536, 65537, 2 * 65536}) {
+        const QByteArray data = makeData(size);
+        EXPECT_EQ(data, AnalysisDataFormat::decode(AnalysisDataFormat::encode(data, 2)));
+    }
+}
+
+TEST_F(AnalysisDataFormatTest, decodeLegacy) {
+    const QByteArray data = makeData(100 * 1000);
+    const QByteArray legacy = qCompress(data);
+    EXPECT_FALSE(AnalysisDataFormat::hasBlockedLayout(legacy.constData(), legacy.size()));
+    EXPECT_EQ(data, AnalysisDataFormat::decode(legacy));
+}
+
+TEST_F(AnalysisDataFormatTest, rejectCorruptData) {
+    const QByteArray data = makeData(100 * 1000);
+    QByteArray encoded = AnalysisDataFormat::encode(data, 2);
+    encoded.truncate(encoded.size() / 2);
+    EXPECT_TRUE(AnalysisDataFormat::decode(encoded).isNull());
+}
+
+} // namespace
@@ -0,0 +1,256 @@
+#include <benchmark/benchmark.h>
+
+#include <QSqlDatabase>
+#include <cmath>
+#include <vector>
+
+#include "analyzer/analyzerebur128.h"
+#include "analyzer/analyzergain.h"
+#include "analyzer/analyzersilence.h"
+#include "analyzer/analyzerwaveform.h"
+#include "analyzer/constants.h"
+#if defined __KEYFINDER__
+#include "analyzer/plugins/analyzerkeyfinder.h"
+#endif
+#include "analyzer/plugins/analyzerqueenmarybeats.h"
+#include "analyzer/plugins/analyzerqueenmarykey.h"
+#include "analyzer/plugins/analyzersoundtouchbeats.h"
+#include "preferences/replaygainsettings.h"
+#include "track/beatutils.h"
+#include "track/keyutils.h"
+#include "track/track.h"
+#include "util/math.h"
+
+// Throughput and accuracy benchmarks for the analyzers. All analyzers
+// process the same deterministic test signal:
+//  - kSilenceSeconds of silence at the start and the end
+//  - noise bursts at kTestBpm in between (keyless, for beat detection)
+//  - sustained chords of an A minor cadence (Am - Dm - E) for key detection
+//
+// Besides the processing time each benchmark reports "audio_s" (seconds
+// of audio analyzed per second) and the deviation from the known
+// properties of the signal, so regressions in speed or precision
+// are both visible.
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr double kTestBpm = 124.0;
+constexpr double kSilenceSeconds = 2.0;
+constexpr double kSoundSeconds = 60.0;
+constexpr double kTotalSeconds = kSoundSeconds + 2 * kSilenceSeconds;
+constexpr double kChordSeconds = 2.0;
+constexpr mixxx::track::io::key::ChromaticKey kTestKey =
+        mixxx::track::io::key::A_MINOR;
+
+SINT secondsToFrames(double seconds) {
+    return static_cast<SINT>(seconds * kSampleRate.value());
+}
+
+double midiNoteToFrequency(int note) {
+    return 440.0 * std::pow(2.0, (note - 69) / 12.0);
+}
+
+// The interleaved stereo test signal, generated only once
+const std::vector<CSAMPLE>& testSignal() {
+    static const std::vector<CSAMPLE> s_samples = [] {
+        const SINT totalFrames = secondsToFrames(kTotalSeconds);
+        const SINT soundStart = secondsToFrames(kSilenceSeconds);
+        const SINT soundEnd = totalFrames - soundStart;
+        std::vector<CSAMPLE> samples(totalFrames * mixxx::kAnalysisChannels, 0);
+
+        // Am, Dm and E chords as MIDI notes. The G# of the E major
+        // chord distinguishes A minor from its relative C major.
+        const int chords[][3] = {{57, 60, 64}, {62, 65, 69}, {64, 68, 71}};
+        const SINT beatFrames = static_cast<SINT>(60.0 * kSampleRate.value() / kTestBpm);
+        const SINT burstFrames = secondsToFrames(0.03);
+        // Deterministic white noise from a linear congruential generator
+        quint32 noiseState = 12345;
+
+        for (SINT frame = soundStart; frame < soundEnd; ++frame) {
+            const double time = static_cast<double>(frame - soundStart) / kSampleRate.value();
+            const auto& chord = chords[static_cast<int>(time / kChordSeconds) % 3];
+            double value = 0;
+            for (const int note : chord) {
+                value += 0.1 * std::sin(2 * M_PI * midiNoteToFrequency(note) * time);
+            }
+            const SINT beatOffset = (frame - soundStart) % beatFrames;
+            if (beatOffset < burstFrames) {
+                noiseState = noiseState * 1664525u + 1013904223u;
+                const double noise = static_cast<double>(noiseState) / 4294967295.0 * 2 - 1;
+                value += 0.6 * noise *
+                        std::exp(-5.0 * beatOffset / static_cast<double>(burstFrames));
+            }
+            samples[frame * 2] = static_cast<CSAMPLE>(value);
+            samples[frame * 2 + 1] = static_cast<CSAMPLE>(value);
+        }
+        return samples;
+    }();
+    return s_samples;
+}
+
+TrackPointer newTestTrack() {
+    auto pTrack = Track::newTemporary();
+    pTrack->setAudioProperties(
+            mixxx::audio::ChannelCount(mixxx::kAnalysisChannels),
+            kSampleRate,
+            mixxx::audio::Bitrate(),
+            mixxx::Duration::fromSeconds(kTotalSeconds));
+    return pTrack;
+}
+
+UserSettingsPointer newTestConfig() {
+    auto pConfig = UserSettingsPointer(new UserSettings(QString()));
+    ReplayGainSettings replayGainSettings(pConfig);
+    replayGainSettings.setReplayGainAnalyzerEnabled(true);
+    replayGainSettings.setReplayGainReanalyze(true);
+    return pConfig;
+}
+
+template<typename Processor>
+void processInChunks(const std::vector<CSAMPLE>& samples, Processor process) {
+    for (std::size_t offset = 0; offset < samples.size();
+            offset += mixxx::kAnalysisSamplesPerChunk) {
+        const int length = static_cast<int>(math_min<std::size_t>(
+                mixxx::kAnalysisSamplesPerChunk, samples.size() - offset));
+        process(samples.data() + offset, length);
+    }
+}
+
+void setAudioRateCounter(benchmark::State& state) {
+    state.counters["audio_s"] = benchmark::Counter(
+            kTotalSeconds, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template<typename Plugin>
+void BM_AnalyzerBeatsPlugin(benchmark::State& state) {
+    const auto& samples = testSignal();
+    mixxx::Bpm bpm;
+    for (auto _ : state) {
+        Plugin plugin;
+        plugin.initialize(kSampleRate);
+        processInChunks(samples, [&plugin](const CSAMPLE* pIn, int length) {
+            plugin.processSamples(pIn, length);
+        });
+        plugin.finalize();
+        if (plugin.supportsBeatTracking()) {
+            bpm = BeatUtils::calculateBpm(plugin.getBeats(), kSampleRate);
+        } else {
+            bpm = plugin.getBpm();
+        }
+    }
+    setAudioRateCounter(state);
+    state.counters["bpm_error"] = bpm.isValid() ? std::abs(bpm.value() - kTestBpm) : kTestBpm;
+}
+BENCHMARK_TEMPLATE(BM_AnalyzerBeatsPlugin, mixxx::AnalyzerQueenMaryBeats)
+        ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AnalyzerBeatsPlugin, mixxx::AnalyzerSoundTouchBeats)
+        ->Unit(benchmark::kMillisecond);
+
+template<typename Plugin>
+void BM_AnalyzerKeyPlugin(benchmark::State& state) {
+    const auto& samples = testSignal();
+    mixxx::track::io::key::ChromaticKey key = mixxx::track::io::key::INVALID;
+    for (auto _ : state) {
+        Plugin plugin;
+        plugin.initialize(kSampleRate);
+        processInChunks(samples, [&plugin](const CSAMPLE* pIn, int length) {
+            plugin.processSamples(pIn, length);
+        });
+        plugin.finalize();
+        key = KeyUtils::calculateGlobalKey(plugin.getKeyChanges(),
+                static_cast<int>(samples.size()),
+                kSampleRate.value());
+    }
+    setAudioRateCounter(state);
+    state.counters["key_correct"] = key == kTestKey ? 1 : 0;
+}
+BENCHMARK_TEMPLATE(BM_AnalyzerKeyPlugin, mixxx::AnalyzerQueenMaryKey)
+        ->Unit(benchmark::kMillisecond);
+#if defined __KEYFINDER__
+BENCHMARK_TEMPLATE(BM_AnalyzerKeyPlugin, mixxx::AnalyzerKeyFinder)
+        ->Unit(benchmark::kMillisecond);
+#endif
+
+// Runs a complete analysis and returns the analyzed track
+template<typename AnalyzerType, typename... Args>
+TrackPointer analyzeTestSignal(Args&&... args) {
+    const auto& samples = testSignal();
+    auto pTrack = newTestTrack();
+    AnalyzerType analyzer(std::forward<Args>(args)...);
+    if (!analyzer.initialize(pTrack, kSampleRate, static_cast<int>(samples.size()))) {
+        return nullptr;
+    }
+    processInChunks(samples, [&analyzer](const CSAMPLE* pIn, int length) {
+        analyzer.processSamples(pIn, length);
+    });
+    analyzer.storeResults(pTrack);
+    analyzer.cleanup();
+    return pTrack;
+}
+
+void BM_AnalyzerEbur128(benchmark::State& state) {
+    const auto pConfig = newTestConfig();
+    ReplayGainSettings(pConfig).setReplayGainAnalyzerVersion(2);
+    TrackPointer pTrack;
+    for (auto _ : state) {
+        pTrack = analyzeTestSignal<AnalyzerEbur128>(pConfig);
+    }
+    setAudioRateCounter(state);
+    state.counters["replaygain_ratio"] = pTrack ? pTrack->getReplayGain().getRatio() : 0;
+}
+BENCHMARK(BM_AnalyzerEbur128)->Unit(benchmark::kMillisecond);
+
+void BM_AnalyzerGain(benchmark::State& state) {
+    const auto pConfig = newTestConfig();
+    ReplayGainSettings(pConfig).setReplayGainAnalyzerVersion(1);
+    TrackPointer pTrack;
+    for (auto _ : state) {
+        pTrack = analyzeTestSignal<AnalyzerGain>(pConfig);
+    }
+    setAudioRateCounter(state);
+    state.counters["replaygain_ratio"] = pTrack ? pTrack->getReplayGain().getRatio() : 0;
+}
+BENCHMARK(BM_AnalyzerGain)->Unit(benchmark::kMillisecond);
+
+void BM_AnalyzerSilence(benchmark::State& state) {
+    const auto pConfig = newTestConfig();
+    TrackPointer pTrack;
+    for (auto _ : state) {
+        pTrack = analyzeTestSignal<AnalyzerSilence>(pConfig);
+    }
+    setAudioRateCounter(state);
+    // The deviation of the detected sound boundaries in milliseconds
+    const CuePointer pAudibleSound = pTrack
+            ? pTrack->findCueByType(mixxx::CueType::AudibleSound)
+            : CuePointer();
+    if (pAudibleSound) {
+        const double framesPerMillisecond = kSampleRate.value() / 1000.0;
+        state.counters["start_error_ms"] = std::abs(
+                pAudibleSound->getPosition().value() -
+                secondsToFrames(kSilenceSeconds)) /
+                framesPerMillisecond;
+        state.counters["end_error_ms"] = std::abs(
+                pAudibleSound->getEndPosition().value() -
+                secondsToFrames(kSilenceSeconds + kSoundSeconds)) /
+                framesPerMillisecond;
+    }
+}
+BENCHMARK(BM_AnalyzerSilence)->Unit(benchmark::kMillisecond);
+
+void BM_AnalyzerWaveform(benchmark::State& state) {
+    const auto pConfig = newTestConfig();
+    // Temporary tracks have no id, so the database is never accessed
+    const QSqlDatabase dbConnection;
+    TrackPointer pTrack;
+    for (auto _ : state) {
+        pTrack = analyzeTestSignal<AnalyzerWaveform>(pConfig, dbConnection);
+    }
+    setAudioRateCounter(state);
+    state.counters["visual_frames"] = pTrack && pTrack->getWaveform()
+            ? pTrack->getWaveform()->getDataSize() / 2
+            : 0;
+}
+BENCHMARK(BM_AnalyzerWaveform)->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,96 @@
+#include "engine/cachingreader/cachingreadertap.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr SINT kChannels = 2;
+
+std::vector<CSAMPLE> samplesForRange(mixxx::IndexRange frameIndexRange) {
+    std::vector<CSAMPLE> samples;
+    for (SINT frameIndex = frameIndexRange.start();
+            frameIndex < frameIndexRange.end();
+            ++frameIndex) {
+        samples.push_back(static_cast<CSAMPLE>(frameIndex));
+        samples.push_back(-static_cast<CSAMPLE>(frameIndex));
+    }
+    return samples;
+}
+
+class CachingReaderTapTest : public testing::Test {
+  protected:
+    void publish(mixxx::IndexRange frameIndexRange) {
+        const auto samples = samplesForRange(frameIndexRange);
+        m_tap.publish(frameIndexRange, samples.data());
+    }
+
+    const TrackId m_trackId = TrackId(4711);
+    CachingReaderTap m_tap{m_trackId};
+};
+
+TEST_F(CachingReaderTapTest, ConsumePublishedRange) {
+    publish(mixxx::IndexRange::forward(0, 100));
+    publish(mixxx::IndexRange::forward(100, 100));
+
+    const auto range = mixxx::IndexRange::forward(50, 100);
+    std::vector<CSAMPLE> dest(range.length() * kChannels);
+    EXPECT_EQ(range, m_tap.consume(range, dest.data()));
+    EXPECT_EQ(samplesForRange(range), dest);
+}
+
+TEST_F(CachingReaderTapTest, StopAtGap) {
+    publish(mixxx::IndexRange::forward(0, 100));
+    publish(mixxx::IndexRange::forward(200, 100));
+
+    const auto range = mixxx::IndexRange::forward(50, 200);
+    std::vector<CSAMPLE> dest(range.length() * kChannels);
+    EXPECT_EQ(mixxx::IndexRange::forward(50, 50), m_tap.consume(range, dest.data()));
+}
+
+TEST_F(CachingReaderTapTest, DiscardConsumedChunks) {
+    publish(mixxx::IndexRange::forward(0, 100));
+
+    std::vector<CSAMPLE> dest(100 * kChannels);
+    m_tap.consume(mixxx::IndexRange::forward(100, 100), dest.data());
+    // The chunk before the requested range has been dropped
+    EXPECT_TRUE(m_tap.consume(mixxx::IndexRange::forward(0, 100), dest.data())
+                        .empty());
+}
+
+TEST_F(CachingReaderTapTest, ClaimAttachedTap) {
+    const auto pTap = std::make_shared<CachingReaderTap>(m_trackId);
+    ASSERT_TRUE(CachingReaderTap::attach(pTap));
+    // Only a single analysis job may attach a tap per track
+    EXPECT_FALSE(CachingReaderTap::attach(
+            std::make_shared<CachingReaderTap>(m_trackId)));
+
+    // Only a single worker may claim the tap
+    std::shared_ptr<CachingReaderTap> pWorkerTap;
+    int workerGeneration = -1;
+    CachingReaderTap::update(m_trackId, &pWorkerTap, &workerGeneration);
+    EXPECT_EQ(pTap, pWorkerTap);
+    EXPECT_EQ(CachingReaderTap::generation(), workerGeneration);
+
+    std::shared_ptr<CachingReaderTap> pOtherWorkerTap;
+    int otherWorkerGeneration = -1;
+    CachingReaderTap::update(m_trackId, &pOtherWorkerTap, &otherWorkerGeneration);
+    EXPECT_FALSE(pOtherWorkerTap);
+
+    // The other worker may claim it after it has been released
+    CachingReaderTap::release(&pWorkerTap);
+    EXPECT_FALSE(pWorkerTap);
+    EXPECT_NE(CachingReaderTap::generation(), otherWorkerGeneration);
+    CachingReaderTap::update(m_trackId, &pOtherWorkerTap, &otherWorkerGeneration);
+    EXPECT_EQ(pTap, pOtherWorkerTap);
+
+    // Workers drop the tap after it has been detached
+    CachingReaderTap::detach(pTap);
+    EXPECT_NE(CachingReaderTap::generation(), otherWorkerGeneration);
+    CachingReaderTap::update(m_trackId, &pOtherWorkerTap, &otherWorkerGeneration);
+    EXPECT_FALSE(pOtherWorkerTap);
+}
+
+} // namespace
@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "control/controlobject.h"
+#include "control/controlproxy.h"
+
+// Contention benchmarks for the control registry. Every thread resolves
+// keys like controller scripts and skins do when creating ControlProxys.
+// The "lookups" counter reports the resolved keys per second and thread.
+
+namespace {
+
+constexpr int kGroupCount = 8;
+constexpr int kItemCount = 128;
+constexpr int kKeyCount = kGroupCount * kItemCount;
+
+const std::vector<ConfigKey>& testKeys() {
+    static const std::vector<ConfigKey> s_keys = [] {
+        std::vector<ConfigKey> keys;
+        keys.reserve(kKeyCount);
+        for (int group = 0; group < kGroupCount; ++group) {
+            for (int item = 0; item < kItemCount; ++item) {
+                keys.emplace_back(QStringLiteral("[Channel%1]").arg(group + 1),
+                        QStringLiteral("benchmark_control%1").arg(item));
+            }
+        }
+        return keys;
+    }();
+    return s_keys;
+}
+
+// The controls of the test keys, created only once and never destroyed
+void createTestControls() {
+    static const bool s_created = [] {
+        for (const auto& key : testKeys()) {
+            new ControlObject(key);
+        }
+        return true;
+    }();
+    Q_UNUSED(s_created);
+}
+
+void BM_ControlProxyCreation(benchmark::State& state) {
+    createTestControls();
+    const auto& keys = testKeys();
+    // Every thread starts at a different key
+    std::size_t index = state.thread_index * 97;
+    for (auto _ : state) {
+        ControlProxy proxy(keys[index % keys.size()]);
+        benchmark::DoNotOptimize(proxy.get());
+        ++index;
+    }
+    state.counters["lookups"] = benchmark::Counter(1, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_ControlProxyCreation)->ThreadRange(1, 16)->UseRealTime();
+
+// Lookups while another thread keeps creating and destroying controls
+void BM_ControlLookupWithConcurrentCreation(benchmark::State& state) {
+    createTestControls();
+    const auto& keys = testKeys();
+    if (state.thread_index == 0) {
+        int created = 0;
+        for (auto _ : state) {
+            ControlObject control(ConfigKey(QStringLiteral("[Benchmark]"),
+                    QStringLiteral("created%1").arg(created++ % kItemCount)));
+        }
+        return;
+    }
+    std::size_t index = state.thread_index * 97;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ControlObject::getControl(keys[index % keys.size()]));
+        ++index;
+    }
+    state.counters["lookups"] = benchmark::Counter(1, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_ControlLookupWithConcurrentCreation)->ThreadRange(2, 16)->UseRealTime();
+
+// Creates as many distinct controls as Mixxx does at startup with a few decks,
+// samplers and effect units. Every control is a new key in the registry.
+void BM_StartupControlCreation(benchmark::State& state) {
+    const int controlCount = static_cast<int>(state.range(0));
+    std::vector<ConfigKey> keys;
+    keys.reserve(controlCount);
+    for (int i = 0; i < controlCount; ++i) {
+        keys.emplace_back(QStringLiteral("[Startup%1]").arg(i / kItemCount),
+                QStringLiteral("control%1").arg(i % kItemCount));
+    }
+    std::vector<std::unique_ptr<ControlObject>> controls;
+    controls.reserve(controlCount);
+    for (auto _ : state) {
+        for (const auto& key : keys) {
+            controls.push_back(std::make_unique<ControlObject>(key));
+        }
+        state.PauseTiming();
+        controls.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * controlCount);
+}
+BENCHMARK(BM_StartupControlCreation)->Range(1 << 10, 1 << 15);
+
+} // namespace
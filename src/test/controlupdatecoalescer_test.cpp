@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <QObject>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "control/controlobject.h"
+#include "control/controlproxy.h"
+#include "control/controlupdatecoalescer.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+class ControlUpdateCoalescerTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        m_pControl = std::make_unique<ControlObject>(ConfigKey("[Test]", "coalesced"));
+        m_pProxy = std::make_unique<ControlProxy>(m_pControl->getKey());
+        ASSERT_TRUE(m_pProxy->connectValueChangedCoalesced(
+                &m_receiver, [this](double value) {
+                    m_received.push_back(value);
+                }));
+        ControlUpdateCoalescer::process();
+        ControlUpdateCoalescer::takeCounters();
+    }
+
+    void setFromOtherThread(const std::vector<double>& values) {
+        std::thread thread([this, &values] {
+            for (const double value : values) {
+                m_pControl->set(value);
+            }
+        });
+        thread.join();
+    }
+
+    std::unique_ptr<ControlObject> m_pControl;
+    std::unique_ptr<ControlProxy> m_pProxy;
+    QObject m_receiver;
+    std::vector<double> m_received;
+};
+
+TEST_F(ControlUpdateCoalescerTest, DeliversLatestValueOncePerTick) {
+    setFromOtherThread({1.0, 2.0, 3.0});
+    EXPECT_TRUE(m_received.empty());
+
+    ControlUpdateCoalescer::process();
+    ASSERT_EQ(1u, m_received.size());
+    EXPECT_DOUBLE_EQ(3.0, m_received.front());
+
+    const auto counters = ControlUpdateCoalescer::takeCounters();
+    EXPECT_EQ(1u, counters.dispatched);
+    EXPECT_EQ(2u, counters.coalesced);
+
+    // Nothing changed since the last tick
+    ControlUpdateCoalescer::process();
+    EXPECT_EQ(1u, m_received.size());
+}
+
+TEST_F(ControlUpdateCoalescerTest, DeliversChangesOfGuiThreadImmediately) {
+    m_pControl->set(1.0);
+    m_pControl->set(2.0);
+    EXPECT_EQ(std::vector<double>({1.0, 2.0}), m_received);
+
+    ControlUpdateCoalescer::process();
+    EXPECT_EQ(2u, m_received.size());
+}
+
+TEST_F(ControlUpdateCoalescerTest, SharesSlotBetweenProxies) {
+    std::vector<double> received;
+    auto pProxy = std::make_unique<ControlProxy>(m_pControl->getKey());
+    ASSERT_TRUE(pProxy->connectValueChangedCoalesced(
+            &m_receiver, [&received](double value) {
+                received.push_back(value);
+            }));
+
+    setFromOtherThread({1.0, 2.0});
+    ControlUpdateCoalescer::process();
+    EXPECT_EQ(std::vector<double>({2.0}), m_received);
+    EXPECT_EQ(std::vector<double>({2.0}), received);
+
+    // The remaining proxy keeps receiving updates
+    pProxy.reset();
+    setFromOtherThread({4.0});
+    ControlUpdateCoalescer::process();
+    EXPECT_EQ(std::vector<double>({2.0, 4.0}), m_received);
+}
+
+TEST_F(ControlUpdateCoalescerTest, IgnoresChangesOfUnsubscribedControls) {
+    setFromOtherThread({1.0});
+    m_pProxy.reset();
+    ControlUpdateCoalescer::process();
+    EXPECT_TRUE(m_received.empty());
+}
+
+} // namespace
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include <QSignalSpy>
+#include <memory>
+
+#include "effects/backends/builtin/echoeffect.h"
+#include "effects/backends/builtin/flangereffect.h"
+#include "effects/effectchain.h"
+#include "effects/effectslot.h"
+#include "effects/effectsmanager.h"
+#include "effects/presets/effectchainpreset.h"
+#include "engine/effects/engineeffect.h"
+#include "engine/effects/engineeffectchain.h"
+#include "engine/effects/engineeffectsmanager.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+constexpr int kPresetLoadTimeoutMillis = 5000;
+
+class EffectChainTest : public MixxxTest {
+  protected:
+    EffectChainTest()
+            : m_pChannelHandleFactory(std::make_shared<ChannelHandleFactory>()),
+              m_channel1(m_pChannelHandleFactory->getOrCreateHandle("[Channel1]"),
+                      "[Channel1]"),
+              m_master(m_pChannelHandleFactory->getOrCreateHandle("[Master]"),
+                      "[Master]") {
+        m_pEffectsManager = std::make_unique<EffectsManager>(
+                config(), m_pChannelHandleFactory);
+        m_pEffectsManager->registerInputChannel(m_channel1);
+        m_pEffectsManager->registerOutputChannel(m_master);
+        m_pEffectsManager->setup();
+        // Routes [Channel1] to the chain
+        m_pChain = m_pEffectsManager->getStandardEffectChain(0);
+        processEngineRequests();
+    }
+
+    void processEngineRequests() {
+        m_pEffectsManager->getEngineEffectsManager()->onCallbackStart();
+    }
+
+    EffectChainPresetPointer makeChainPreset(const QString& effectId) {
+        EffectManifestPointer pManifest = m_pEffectsManager->getBackendManager()
+                                                  ->getManifest(effectId, EffectBackendType::BuiltIn);
+        return EffectChainPresetPointer(new EffectChainPreset(pManifest));
+    }
+
+    std::shared_ptr<ChannelHandleFactory> m_pChannelHandleFactory;
+    ChannelHandleAndGroup m_channel1;
+    ChannelHandleAndGroup m_master;
+    std::unique_ptr<EffectsManager> m_pEffectsManager;
+    EffectChainPointer m_pChain;
+};
+
+TEST_F(EffectChainTest, PresetIsLoadedAfterPreparation) {
+    QSignalSpy presetChanged(m_pChain.data(), &EffectChain::chainPresetChanged);
+    const EffectChainPresetPointer pPreset = makeChainPreset(EchoEffect::getId());
+
+    m_pChain->loadChainPreset(pPreset);
+    // The effects are loaded in the main thread after they have been prepared
+    EXPECT_FALSE(m_pChain->getEffectSlot(0)->isLoaded());
+
+    ASSERT_TRUE(presetChanged.wait(kPresetLoadTimeoutMillis));
+    EXPECT_EQ(1, presetChanged.count());
+    EXPECT_EQ(pPreset->name(), m_pChain->presetName());
+    EXPECT_EQ(EchoEffect::getId(), m_pChain->getEffectSlot(0)->id());
+    EXPECT_FALSE(m_pChain->getEffectSlot(1)->isLoaded());
+    processEngineRequests();
+}
+
+TEST_F(EffectChainTest, PendingPresetIsDiscarded) {
+    QSignalSpy presetChanged(m_pChain.data(), &EffectChain::chainPresetChanged);
+    const EffectChainPresetPointer pDiscardedPreset = makeChainPreset(EchoEffect::getId());
+    const EffectChainPresetPointer pPreset = makeChainPreset(FlangerEffect::getId());
+
+    m_pChain->loadChainPreset(pDiscardedPreset);
+    m_pChain->loadChainPreset(pPreset);
+
+    ASSERT_TRUE(presetChanged.wait(kPresetLoadTimeoutMillis));
+    // Give the discarded preset a chance to be loaded by mistake
+    EXPECT_FALSE(presetChanged.wait(100));
+    EXPECT_EQ(1, presetChanged.count());
+    EXPECT_EQ(pPreset->name(), m_pChain->presetName());
+    EXPECT_EQ(FlangerEffect::getId(), m_pChain->getEffectSlot(0)->id());
+    processEngineRequests();
+}
+
+TEST_F(EffectChainTest, LoadedPresetIsReplaced) {
+    QSignalSpy presetChanged(m_pChain.data(), &EffectChain::chainPresetChanged);
+
+    m_pChain->loadChainPreset(makeChainPreset(EchoEffect::getId()));
+    ASSERT_TRUE(presetChanged.wait(kPresetLoadTimeoutMillis));
+    processEngineRequests();
+
+    // The EngineEffect of the echo has been handed over to the engine, which
+    // hands it back to the main thread when it is replaced.
+    m_pChain->loadChainPreset(makeChainPreset(FlangerEffect::getId()));
+    ASSERT_TRUE(presetChanged.wait(kPresetLoadTimeoutMillis));
+    processEngineRequests();
+
+    EXPECT_EQ(2, presetChanged.count());
+    EXPECT_EQ(FlangerEffect::getId(), m_pChain->getEffectSlot(0)->id());
+}
+
+TEST_F(EffectChainTest, ReplaceEffectsInChainSwapsTheEffects) {
+    const EffectsBackendManagerPointer pBackendManager =
+            m_pEffectsManager->getBackendManager();
+    const QSet<ChannelHandleAndGroup>& inputChannels =
+            m_pEffectsManager->registeredInputChannels();
+    const QSet<ChannelHandleAndGroup>& outputChannels =
+            m_pEffectsManager->registeredOutputChannels();
+    EngineEffectChain chain("[TestChain]", inputChannels, outputChannels);
+    auto* pEcho = new EngineEffect(
+            pBackendManager->getManifest(EchoEffect::getId(), EffectBackendType::BuiltIn),
+            pBackendManager,
+            inputChannels,
+            outputChannels);
+    auto* pFlanger = new EngineEffect(
+            pBackendManager->getManifest(FlangerEffect::getId(), EffectBackendType::BuiltIn),
+            pBackendManager,
+            inputChannels,
+            outputChannels);
+
+    QPair<EffectsRequestPipe*, EffectsResponsePipe*> pipes =
+            TwoWayMessagePipe<EffectsRequest*, EffectsResponse>::makeTwoWayMessagePipe(
+                    4, 4);
+    auto replaceEffects = [&chain, &pipes](EngineEffect* pEffect1, EngineEffect* pEffect2) {
+        EffectsRequest request;
+        request.type = EffectsRequest::REPLACE_EFFECTS_IN_CHAIN;
+        request.pTargetChain = &chain;
+        request.ReplaceEffectsInChain.pEffects = new EngineEffect*[2]{pEffect1, pEffect2};
+        request.ReplaceEffectsInChain.iNumEffects = 2;
+        EXPECT_TRUE(chain.processEffectsRequest(request, pipes.second));
+        EffectsResponse response;
+        EXPECT_TRUE(pipes.first->readMessage(&response));
+        EXPECT_TRUE(response.success);
+        // The replaced effects are handed back with the request
+        std::vector<EngineEffect*> replaced(request.ReplaceEffectsInChain.pEffects,
+                request.ReplaceEffectsInChain.pEffects + 2);
+        delete[] request.ReplaceEffectsInChain.pEffects;
+        return replaced;
+    };
+
+    EXPECT_EQ(std::vector<EngineEffect*>({nullptr, nullptr}),
+            replaceEffects(pEcho, nullptr));
+    EXPECT_EQ(std::vector<EngineEffect*>({pEcho, nullptr}),
+            replaceEffects(nullptr, pFlanger));
+    EXPECT_EQ(std::vector<EngineEffect*>({nullptr, pFlanger}),
+            replaceEffects(nullptr, nullptr));
+
+    delete pEcho;
+    delete pFlanger;
+    delete pipes.first;
+    delete pipes.second;
+}
+
+} // namespace
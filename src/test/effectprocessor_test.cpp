@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "effects/backends/effectprocessor.h"
+#include "engine/channelhandle.h"
+#include "engine/effects/groupfeaturestate.h"
+#include "util/sample.h"
+
+namespace {
+
+constexpr CSAMPLE kGain = 0.5f;
+
+class CountedEffectState : public EffectState {
+  public:
+    CountedEffectState(const mixxx::EngineParameters& engineParameters)
+            : EffectState(engineParameters) {
+        ++s_instanceCount;
+    }
+    ~CountedEffectState() override {
+        --s_instanceCount;
+    }
+
+    static int s_instanceCount;
+};
+
+int CountedEffectState::s_instanceCount = 0;
+
+class GainEffect : public EffectProcessorImpl<CountedEffectState> {
+  public:
+    void loadEngineEffectParameters(
+            const QMap<QString, EngineEffectParameterPointer>& parameters) override {
+        Q_UNUSED(parameters);
+    }
+
+    void processChannel(CountedEffectState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            const mixxx::EngineParameters& engineParameters,
+            const EffectEnableState enableState,
+            const GroupFeatureState& groupFeatures) override {
+        Q_UNUSED(pState);
+        Q_UNUSED(enableState);
+        Q_UNUSED(groupFeatures);
+        SampleUtil::copyWithGain(pOutput, pInput, kGain, engineParameters.samplesPerBuffer());
+    }
+};
+
+class EffectProcessorTest : public testing::Test {
+  protected:
+    EffectProcessorTest()
+            : m_engineParameters(mixxx::audio::SampleRate(44100), 64),
+              m_master(m_factory.getOrCreateHandle("[Master]")),
+              m_headphone(m_factory.getOrCreateHandle("[Headphone]")),
+              m_channel1(m_factory.getOrCreateHandle("[Channel1]")),
+              m_channel2(m_factory.getOrCreateHandle("[Channel2]")),
+              m_input(m_engineParameters.samplesPerBuffer(), 1.0f),
+              m_output(m_engineParameters.samplesPerBuffer()) {
+        m_inputChannels.insert(ChannelHandleAndGroup(m_channel1, "[Channel1]"));
+        m_inputChannels.insert(ChannelHandleAndGroup(m_channel2, "[Channel2]"));
+        m_outputChannels.insert(ChannelHandleAndGroup(m_master, "[Master]"));
+        m_outputChannels.insert(ChannelHandleAndGroup(m_headphone, "[Headphone]"));
+    }
+
+    void SetUp() override {
+        CountedEffectState::s_instanceCount = 0;
+    }
+
+    void TearDown() override {
+        EXPECT_EQ(0, CountedEffectState::s_instanceCount);
+    }
+
+    // Returns the first sample of the processed buffer
+    CSAMPLE process(GainEffect* pEffect,
+            const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle) {
+        SampleUtil::clear(m_output.data(), m_engineParameters.samplesPerBuffer());
+        pEffect->process(inputHandle,
+                outputHandle,
+                m_input.data(),
+                m_output.data(),
+                m_engineParameters,
+                EffectEnableState::Enabled,
+                GroupFeatureState());
+        return m_output[0];
+    }
+
+    const mixxx::EngineParameters m_engineParameters;
+    ChannelHandleFactory m_factory;
+    const ChannelHandle m_master;
+    const ChannelHandle m_headphone;
+    const ChannelHandle m_channel1;
+    const ChannelHandle m_channel2;
+    QSet<ChannelHandleAndGroup> m_inputChannels;
+    QSet<ChannelHandleAndGroup> m_outputChannels;
+    std::vector<CSAMPLE> m_input;
+    std::vector<CSAMPLE> m_output;
+};
+
+TEST_F(EffectProcessorTest, StatesAreTakenFromThePoolWhenProcessing) {
+    GainEffect effect;
+    effect.initialize(m_inputChannels, m_outputChannels, m_engineParameters);
+    EXPECT_EQ(0, CountedEffectState::s_instanceCount);
+
+    // One state for every output
+    effect.prepareStatesForInputChannel(&m_channel1);
+    EXPECT_EQ(2, CountedEffectState::s_instanceCount);
+
+    EXPECT_EQ(kGain, process(&effect, m_channel1, m_master));
+    EXPECT_EQ(kGain, process(&effect, m_channel1, m_master));
+    EXPECT_EQ(2, CountedEffectState::s_instanceCount);
+
+    // The state in use counts for the channel
+    effect.prepareStatesForInputChannel(&m_channel1);
+    EXPECT_EQ(2, CountedEffectState::s_instanceCount);
+}
+
+TEST_F(EffectProcessorTest, EveryOutputOfEveryPreparedChannelIsProcessed) {
+    GainEffect effect;
+    effect.initialize(m_inputChannels, m_outputChannels, m_engineParameters);
+    effect.prepareStatesForInputChannel(&m_channel1);
+
+    // A second channel routed to the effect after the first one uses all of
+    // its states must not play dry.
+    EXPECT_EQ(kGain, process(&effect, m_channel1, m_master));
+    EXPECT_EQ(kGain, process(&effect, m_channel1, m_headphone));
+    effect.prepareStatesForInputChannel(&m_channel2);
+    EXPECT_EQ(kGain, process(&effect, m_channel2, m_master));
+    EXPECT_EQ(kGain, process(&effect, m_channel2, m_headphone));
+    EXPECT_EQ(4, CountedEffectState::s_instanceCount);
+}
+
+TEST_F(EffectProcessorTest, UnpreparedChannelPassesThroughDry) {
+    GainEffect effect;
+    effect.initialize(m_inputChannels, m_outputChannels, m_engineParameters);
+    effect.prepareStatesForInputChannel(&m_channel1);
+
+    EXPECT_EQ(1.0f, process(&effect, m_channel2, m_master));
+    EXPECT_EQ(2, CountedEffectState::s_instanceCount);
+}
+
+TEST_F(EffectProcessorTest, DeleteStatesForInputChannel) {
+    GainEffect effect;
+    effect.initialize(m_inputChannels, m_outputChannels, m_engineParameters);
+    effect.prepareStatesForInputChannel(&m_channel1);
+    effect.prepareStatesForInputChannel(&m_channel2);
+
+    process(&effect, m_channel1, m_master);
+    process(&effect, m_channel1, m_headphone);
+    process(&effect, m_channel2, m_master);
+    // 3 states in use and 1 in the pool
+    EXPECT_EQ(4, CountedEffectState::s_instanceCount);
+
+    effect.releaseStatesForInputChannel(&m_channel1);
+    effect.deleteStatesForInputChannel(&m_channel1);
+    EXPECT_EQ(2, CountedEffectState::s_instanceCount);
+
+    effect.prepareStatesForInputChannel(&m_channel1);
+    EXPECT_EQ(4, CountedEffectState::s_instanceCount);
+    EXPECT_EQ(kGain, process(&effect, m_channel1, m_master));
+}
+
+TEST_F(EffectProcessorTest, ChannelRoutedAgainBeforeDeletion) {
+    GainEffect effect;
+    effect.initialize(m_inputChannels, m_outputChannels, m_engineParameters);
+    effect.prepareStatesForInputChannel(&m_channel1);
+    process(&effect, m_channel1, m_master);
+    process(&effect, m_channel1, m_headphone);
+
+    // The channel is routed to the chain again before the engine has
+    // released its old states, so they still count as in use.
+    effect.releaseStatesForInputChannel(&m_channel1);
+    effect.prepareStatesForInputChannel(&m_channel1);
+    EXPECT_EQ(2, CountedEffectState::s_instanceCount);
+
+    effect.deleteStatesForInputChannel(&m_channel1);
+    EXPECT_EQ(2, CountedEffectState::s_instanceCount);
+    EXPECT_EQ(kGain, process(&effect, m_channel1, m_master));
+    EXPECT_EQ(kGain, process(&effect, m_channel1, m_headphone));
+}
+
+} // anonymous namespace
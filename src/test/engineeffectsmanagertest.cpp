@@ -0,0 +1,295 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "effects/backends/effectmanifest.h"
+#include "effects/backends/effectprocessor.h"
+#include "engine/channelhandle.h"
+#include "engine/effects/engineeffect.h"
+#include "engine/effects/engineeffectchain.h"
+#include "engine/effects/engineeffectsmanager.h"
+#include "engine/effects/groupfeaturestate.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+constexpr SINT kFramesPerBuffer = 256;
+constexpr SINT kSamplesPerBuffer = kFramesPerBuffer * mixxx::kEngineChannelCount;
+// Longer than half of a buffer, so the dry delay can not be filled within
+// the first buffer
+constexpr SINT kLatencyFrames = 300;
+constexpr int kMessagePipeFifoSize = 16;
+
+class LatentEffectState : public EffectState {
+  public:
+    LatentEffectState(const mixxx::EngineParameters& engineParameters)
+            : EffectState(engineParameters),
+              delayLine(kLatencyFrames * mixxx::kEngineChannelCount),
+              position(0) {
+    }
+
+    std::vector<CSAMPLE> delayLine;
+    std::size_t position;
+};
+
+/// Delays the input by kLatencyFrames, like a plugin that processes blocks
+class LatentEffect : public EffectProcessorImpl<LatentEffectState> {
+  public:
+    void loadEngineEffectParameters(
+            const QMap<QString, EngineEffectParameterPointer>& parameters) override {
+        Q_UNUSED(parameters);
+    }
+
+    void processChannel(LatentEffectState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            const mixxx::EngineParameters& engineParameters,
+            const EffectEnableState enableState,
+            const GroupFeatureState& groupFeatures) override {
+        Q_UNUSED(enableState);
+        Q_UNUSED(groupFeatures);
+        for (SINT i = 0; i < engineParameters.samplesPerBuffer(); ++i) {
+            pOutput[i] = pState->delayLine[pState->position];
+            pState->delayLine[pState->position] = pInput[i];
+            pState->position = (pState->position + 1) % pState->delayLine.size();
+        }
+    }
+
+    SINT latencyFrames() const override {
+        return kLatencyFrames;
+    }
+};
+
+/// An EngineEffectsManager with a chain of a LatentEffect for two decks
+class LatentEffectChain {
+  public:
+    LatentEffectChain(const QSet<ChannelHandleAndGroup>& inputChannels,
+            const QSet<ChannelHandleAndGroup>& outputChannels,
+            CSAMPLE mix)
+            : m_chain("[TestChain]", inputChannels, outputChannels) {
+        EffectManifestPointer pManifest(new EffectManifest());
+        pManifest->setId("org.mixxx.test.latent");
+        pManifest->setName("Latent");
+        m_pEffect = std::make_unique<EngineEffect>(pManifest,
+                std::make_unique<LatentEffect>(),
+                inputChannels,
+                outputChannels);
+        for (const ChannelHandleAndGroup& inputChannel : inputChannels) {
+            m_pEffect->prepareStatesForInputChannel(&inputChannel.handle());
+        }
+
+        const auto pipes =
+                TwoWayMessagePipe<EffectsRequest*, EffectsResponse>::makeTwoWayMessagePipe(
+                        kMessagePipeFifoSize, kMessagePipeFifoSize);
+        m_pRequestPipe.reset(pipes.first);
+        m_pResponsePipe = pipes.second;
+        m_pManager = std::make_unique<EngineEffectsManager>(m_pResponsePipe);
+
+        EffectsRequest addChain;
+        addChain.type = EffectsRequest::ADD_EFFECT_CHAIN;
+        addChain.AddEffectChain.pChain = &m_chain;
+        addChain.AddEffectChain.signalProcessingStage = SignalProcessingStage::Postfader;
+        sendRequest(m_pManager.get(), &addChain);
+
+        EffectsRequest addEffect;
+        addEffect.type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
+        addEffect.AddEffectToChain.pEffect = m_pEffect.get();
+        addEffect.AddEffectToChain.iIndex = 0;
+        sendRequest(&m_chain, &addEffect);
+
+        EffectsRequest setChainParameters;
+        setChainParameters.type = EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS;
+        setChainParameters.SetEffectChainParameters.enabled = true;
+        setChainParameters.SetEffectChainParameters.mix_mode =
+                EffectChainMixMode::DrySlashWet;
+        setChainParameters.SetEffectChainParameters.mix = mix;
+        sendRequest(&m_chain, &setChainParameters);
+
+        EffectsRequest enableEffect;
+        enableEffect.type = EffectsRequest::SET_EFFECT_PARAMETERS;
+        enableEffect.SetEffectParameters.enabled = true;
+        sendRequest(m_pEffect.get(), &enableEffect);
+    }
+
+    void setEnabledForInputChannel(const ChannelHandle& inputChannel, bool enabled) {
+        EffectsRequest request;
+        if (enabled) {
+            request.type = EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
+            request.EnableInputChannelForChain.pChannelHandle = &inputChannel;
+        } else {
+            request.type = EffectsRequest::DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
+            request.DisableInputChannelForChain.pChannelHandle = &inputChannel;
+        }
+        sendRequest(&m_chain, &request);
+    }
+
+    EngineEffectsManager* manager() const {
+        return m_pManager.get();
+    }
+
+  private:
+    void sendRequest(EffectsRequestHandler* pHandler, EffectsRequest* pRequest) {
+        pHandler->processEffectsRequest(*pRequest, m_pResponsePipe);
+        // Discard the response
+        EffectsResponse response;
+        while (m_pRequestPipe->readMessage(&response)) {
+        }
+    }
+
+    EngineEffectChain m_chain;
+    std::unique_ptr<EngineEffect> m_pEffect;
+    std::unique_ptr<EffectsRequestPipe> m_pRequestPipe;
+    // Owned by m_pManager
+    EffectsResponsePipe* m_pResponsePipe;
+    std::unique_ptr<EngineEffectsManager> m_pManager;
+};
+
+class EngineEffectsManagerTest : public testing::Test {
+  protected:
+    EngineEffectsManagerTest()
+            : m_channel1(m_factory.getOrCreateHandle("[Channel1]"), "[Channel1]"),
+              m_channel2(m_factory.getOrCreateHandle("[Channel2]"), "[Channel2]"),
+              m_master(m_factory.getOrCreateHandle("[Master]"), "[Master]"),
+              m_inputChannels{m_channel1, m_channel2},
+              m_outputChannels{m_master} {
+    }
+
+    // A slowly rising signal, so a jump of the dry signal by the latency is
+    // larger than the steps of a crossfade.
+    static CSAMPLE rampSample(SINT frame) {
+        return static_cast<CSAMPLE>(frame) * 1e-4f;
+    }
+
+    static void fillRamp(CSAMPLE* pBuffer, SINT firstFrame, CSAMPLE offset) {
+        for (SINT frame = 0; frame < kFramesPerBuffer; ++frame) {
+            for (int channel = 0; channel < mixxx::kEngineChannelCount; ++channel) {
+                pBuffer[frame * mixxx::kEngineChannelCount + channel] =
+                        rampSample(firstFrame + frame) + offset;
+            }
+        }
+    }
+
+    ChannelHandleFactory m_factory;
+    const ChannelHandleAndGroup m_channel1;
+    const ChannelHandleAndGroup m_channel2;
+    const ChannelHandleAndGroup m_master;
+    const QSet<ChannelHandleAndGroup> m_inputChannels;
+    const QSet<ChannelHandleAndGroup> m_outputChannels;
+    const GroupFeatureState m_groupFeatures;
+};
+
+TEST_F(EngineEffectsManagerTest, ParallelChannelsMatchSerialProcessing) {
+    // Both decks share the chain. [Channel2] is disabled while [Channel1]
+    // keeps the effect, so [Channel2] returns its dry delay to the chain
+    // while [Channel1] is processed.
+    LatentEffectChain parallel(m_inputChannels, m_outputChannels, 0.5f);
+    LatentEffectChain serial(m_inputChannels, m_outputChannels, 0.5f);
+    for (auto* pChain : {&parallel, &serial}) {
+        pChain->setEnabledForInputChannel(m_channel1.handle(), true);
+        pChain->setEnabledForInputChannel(m_channel2.handle(), true);
+    }
+
+    mixxx::SampleBuffer parallel1(kSamplesPerBuffer);
+    mixxx::SampleBuffer parallel2(kSamplesPerBuffer);
+    mixxx::SampleBuffer serial1(kSamplesPerBuffer);
+    mixxx::SampleBuffer serial2(kSamplesPerBuffer);
+    const EngineEffectsManager::InPlaceChannel channels[] = {
+            {&m_channel1.handle(), parallel1.data(), &m_groupFeatures, 1.0f, 1.0f},
+            {&m_channel2.handle(), parallel2.data(), &m_groupFeatures, 1.0f, 1.0f},
+    };
+
+    for (int buffer = 0; buffer < 16; ++buffer) {
+        if (buffer == 8) {
+            for (auto* pChain : {&parallel, &serial}) {
+                pChain->setEnabledForInputChannel(m_channel2.handle(), false);
+            }
+        }
+        const SINT firstFrame = buffer * kFramesPerBuffer;
+        fillRamp(parallel1.data(), firstFrame, 0.0f);
+        fillRamp(parallel2.data(), firstFrame, 0.25f);
+        fillRamp(serial1.data(), firstFrame, 0.0f);
+        fillRamp(serial2.data(), firstFrame, 0.25f);
+
+        parallel.manager()->processPostFaderInPlace(
+                m_master.handle(), channels, 2, kSamplesPerBuffer, kSampleRate);
+        serial.manager()->processPostFaderInPlace(m_channel1.handle(),
+                m_master.handle(),
+                serial1.data(),
+                kSamplesPerBuffer,
+                kSampleRate,
+                m_groupFeatures);
+        serial.manager()->processPostFaderInPlace(m_channel2.handle(),
+                m_master.handle(),
+                serial2.data(),
+                kSamplesPerBuffer,
+                kSampleRate,
+                m_groupFeatures);
+
+        for (SINT i = 0; i < kSamplesPerBuffer; ++i) {
+            ASSERT_EQ(serial1[i], parallel1[i]) << "buffer " << buffer << " sample " << i;
+            ASSERT_EQ(serial2[i], parallel2[i]) << "buffer " << buffer << " sample " << i;
+        }
+    }
+
+    // The dry delay of [Channel2] has faded out and [Channel2] passes through
+    // undelayed.
+    fillRamp(serial2.data(), 16 * kFramesPerBuffer, 0.25f);
+    mixxx::SampleBuffer expected(kSamplesPerBuffer);
+    fillRamp(expected.data(), 16 * kFramesPerBuffer, 0.25f);
+    serial.manager()->processPostFaderInPlace(m_channel2.handle(),
+            m_master.handle(),
+            serial2.data(),
+            kSamplesPerBuffer,
+            kSampleRate,
+            m_groupFeatures);
+    for (SINT i = 0; i < kSamplesPerBuffer; ++i) {
+        ASSERT_EQ(expected[i], serial2[i]);
+    }
+}
+
+TEST_F(EngineEffectsManagerTest, DrySignalFadesWhenCompensationStartsAndStops) {
+    // Only the dry signal is audible
+    LatentEffectChain chain(m_inputChannels, m_outputChannels, 0.0f);
+
+    mixxx::SampleBuffer buffer(kSamplesPerBuffer);
+    CSAMPLE previousSample = rampSample(-1);
+    for (int bufferIndex = 0; bufferIndex < 24; ++bufferIndex) {
+        if (bufferIndex == 4) {
+            chain.setEnabledForInputChannel(m_channel1.handle(), true);
+        } else if (bufferIndex == 16) {
+            chain.setEnabledForInputChannel(m_channel1.handle(), false);
+        }
+        const SINT firstFrame = bufferIndex * kFramesPerBuffer;
+        fillRamp(buffer.data(), firstFrame, 0.0f);
+        chain.manager()->processPostFaderInPlace(m_channel1.handle(),
+                m_master.handle(),
+                buffer.data(),
+                kSamplesPerBuffer,
+                kSampleRate,
+                m_groupFeatures);
+
+        for (SINT frame = 0; frame < kFramesPerBuffer; ++frame) {
+            const SINT inputFrame = firstFrame + frame;
+            const CSAMPLE sample = buffer[frame * mixxx::kEngineChannelCount];
+            // The dry signal is the input, the input delayed by the latency
+            // or a crossfade of both. It never fades through the silence of
+            // an empty delay line.
+            EXPECT_LE(rampSample(inputFrame - kLatencyFrames) - 1e-5f, sample)
+                    << "frame " << inputFrame;
+            EXPECT_GE(rampSample(inputFrame) + 1e-5f, sample)
+                    << "frame " << inputFrame;
+            // No jump by the latency
+            EXPECT_LT(std::abs(sample - previousSample),
+                    rampSample(kLatencyFrames) / 2)
+                    << "frame " << inputFrame;
+            previousSample = sample;
+        }
+    }
+    // The last buffers pass through undelayed
+    EXPECT_EQ(rampSample(24 * kFramesPerBuffer - 1), previousSample);
+}
+
+} // namespace
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cfloat>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "engine/effects/engineeffectsworkerpool.h"
+#include "util/denormalsarezero.h"
+
+namespace {
+
+TEST(EngineEffectsWorkerPoolTest, RunsEveryTaskOnce) {
+    EngineEffectsWorkerPool pool(3);
+    EXPECT_EQ(3, pool.workerCount());
+
+    for (int taskCount = 1; taskCount <= 8; ++taskCount) {
+        for (int i = 0; i < 100; ++i) {
+            std::vector<std::atomic<int>> calls(taskCount);
+            pool.run(taskCount, [&calls](int index) {
+                calls[index].fetch_add(1);
+            });
+            for (const auto& count : calls) {
+                ASSERT_EQ(1, count.load());
+            }
+        }
+    }
+}
+
+TEST(EngineEffectsWorkerPoolTest, ResultsAreVisibleAfterRun) {
+    EngineEffectsWorkerPool pool(2);
+    std::vector<int> results(4);
+    for (int i = 0; i < 1000; ++i) {
+        pool.run(4, [&results, i](int index) {
+            results[index] = i + index;
+        });
+        for (int index = 0; index < 4; ++index) {
+            ASSERT_EQ(i + index, results[index]);
+        }
+    }
+}
+
+TEST(EngineEffectsWorkerPoolTest, DenormalsAreFlushedLikeInTheEngineThread) {
+    constexpr int kTaskCount = 8;
+    constexpr int kSamples = 64;
+    std::vector<float> input(kTaskCount * kSamples);
+    for (std::size_t i = 0; i < input.size(); ++i) {
+        input[i] = FLT_MIN / static_cast<float>(2 + i % 16);
+    }
+    auto process = [&input](std::vector<float>* pOutput, int index) {
+        for (int i = index * kSamples; i < (index + 1) * kSamples; ++i) {
+            (*pOutput)[i] = input[i] * 0.5f + input[i] * 0.25f;
+        }
+    };
+
+    std::vector<float> serial(input.size());
+    std::vector<float> parallel(input.size());
+    bool denormalsAreZero = false;
+    bool processedByWorker = false;
+    // Created outside of the engine thread like in Mixxx, where the workers do
+    // not inherit the floating point mode of the engine thread
+    EngineEffectsWorkerPool pool(3);
+    // Like the engine thread, without changing the floating point mode of
+    // the thread that runs the other tests
+    std::thread engineThread([&] {
+        denormalsAreZero = mixxx::enableDenormalsAreZero();
+        for (int index = 0; index < kTaskCount; ++index) {
+            process(&serial, index);
+        }
+        const auto engineThreadId = std::this_thread::get_id();
+        for (int i = 0; i < 100 && !processedByWorker; ++i) {
+            std::atomic<bool> workerStarted(false);
+            pool.run(kTaskCount, [&](int index) {
+                if (std::this_thread::get_id() != engineThreadId) {
+                    workerStarted.store(true);
+                }
+                // Give the workers a chance to take tasks
+                for (int spin = 0; spin < 100000 && !workerStarted.load(); ++spin) {
+                    std::this_thread::yield();
+                }
+                process(&parallel, index);
+            });
+            processedByWorker = workerStarted.load();
+        }
+    });
+    engineThread.join();
+
+    if (!denormalsAreZero) {
+        GTEST_SKIP() << "Denormals can not be flushed to zero on this platform";
+    }
+    ASSERT_TRUE(processedByWorker);
+    EXPECT_EQ(0, std::memcmp(serial.data(), parallel.data(), serial.size() * sizeof(float)));
+    for (float sample : parallel) {
+        ASSERT_EQ(0.0f, sample);
+    }
+}
+
+} // namespace
@@ -0,0 +1,161 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "engine/filters/enginefilterbessel4.h"
+#include "engine/filters/enginefilterbessel8.h"
+#include "engine/filters/enginefilteriirbatch.h"
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+constexpr double kLowFreq = 246;
+constexpr double kHighFreq = 2484;
+constexpr int kBufferSize = 1024;
+
+std::vector<CSAMPLE> sineBuffer(int size, double frequency, int offset) {
+    std::vector<CSAMPLE> buffer(size);
+    for (int i = 0; i < size; ++i) {
+        buffer[i] = static_cast<CSAMPLE>(
+                std::sin(2 * M_PI * frequency * (offset + i / 2) / kSampleRate));
+    }
+    return buffer;
+}
+
+class EngineFilterIIRBatchTest : public testing::Test {
+  protected:
+    // Processes some buffers with a pair of filters and with a batch and
+    // compares the results
+    template<class LPF>
+    void expectSameAsSingleFilters() {
+        LPF low1(kSampleRate, kLowFreq);
+        LPF low2(kSampleRate, kHighFreq);
+        EngineFilterIIRBatch<LPF::kSize, LPF::kPass, 2> batch;
+        batch.setCoefs(0, low1);
+        batch.setCoefs(1, low2);
+
+        std::vector<CSAMPLE> out1(kBufferSize);
+        std::vector<CSAMPLE> out2(kBufferSize);
+        std::vector<CSAMPLE> batchOut1(kBufferSize);
+        std::vector<CSAMPLE> batchOut2(kBufferSize);
+        for (int i = 0; i < 8; ++i) {
+            if (i == 4) {
+                // Cross fade to new coefficients in one of the filters
+                low1.setFrequencyCorners(kSampleRate, kLowFreq * 2);
+                batch.setCoefs(0, low1);
+            }
+            const auto in1 = sineBuffer(kBufferSize, 100, i * kBufferSize / 2);
+            auto in2 = sineBuffer(kBufferSize, 1000, i * kBufferSize / 2);
+            low1.process(in1.data(), out1.data(), kBufferSize);
+            low2.process(in2.data(), out2.data(), kBufferSize);
+            // The second filter is processed in place
+            batch.process({in1.data(), in2.data()},
+                    {batchOut1.data(), in2.data()},
+                    kBufferSize);
+            for (int j = 0; j < kBufferSize; ++j) {
+                EXPECT_NEAR(out1[j], batchOut1[j], 1e-6) << "buffer " << i << " sample " << j;
+                EXPECT_NEAR(out2[j], in2[j], 1e-6) << "buffer " << i << " sample " << j;
+            }
+        }
+    }
+};
+
+TEST_F(EngineFilterIIRBatchTest, Bessel4LowSameAsSingleFilters) {
+    expectSameAsSingleFilters<EngineFilterBessel4Low>();
+}
+
+TEST_F(EngineFilterIIRBatchTest, Bessel8LowSameAsSingleFilters) {
+    expectSameAsSingleFilters<EngineFilterBessel8Low>();
+}
+
+TEST_F(EngineFilterIIRBatchTest, ProcessAndPauseFadesOut) {
+    EngineFilterBessel4Low low1(kSampleRate, kLowFreq);
+    EngineFilterBessel4Low low2(kSampleRate, kHighFreq);
+    EngineFilterIIRBatch<4, IIR_LP, 2> batch;
+    batch.setCoefs(0, low1);
+    batch.setCoefs(1, low2);
+
+    const std::vector<CSAMPLE> in(kBufferSize, 0.5f);
+    std::vector<CSAMPLE> out1(kBufferSize);
+    std::vector<CSAMPLE> out2(kBufferSize);
+    batch.process({in.data(), in.data()}, {out1.data(), out2.data()}, kBufferSize);
+    batch.process({in.data(), in.data()}, {out1.data(), out2.data()}, kBufferSize);
+    EXPECT_NEAR(0.5f, out1[kBufferSize - 1], 0.01f);
+
+    batch.processAndPauseFilter({in.data(), in.data()},
+            {out1.data(), out2.data()},
+            kBufferSize);
+    EXPECT_EQ(0.0f, out1[kBufferSize - 1]);
+    EXPECT_EQ(0.0f, out2[kBufferSize - 1]);
+
+    // The paused filters start from silence
+    batch.process({in.data(), in.data()}, {out1.data(), out2.data()}, kBufferSize);
+    EXPECT_EQ(0.0f, out1[0]);
+    EXPECT_EQ(0.0f, out2[0]);
+}
+
+// The low passes of the Bessel4 LV-Mix EQ, processed one after the other
+static void BM_Bessel4LowSingleFilters(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    EngineFilterBessel4Low low1(kSampleRate, kLowFreq);
+    EngineFilterBessel4Low low2(kSampleRate, kHighFreq);
+    const auto in = sineBuffer(size, 440, 0);
+    std::vector<CSAMPLE> out1(size);
+    std::vector<CSAMPLE> out2(size);
+    for (auto _ : state) {
+        low1.process(in.data(), out1.data(), size);
+        low2.process(in.data(), out2.data(), size);
+    }
+}
+BENCHMARK(BM_Bessel4LowSingleFilters)->Range(64, 4096);
+
+// The low passes of the Bessel4 LV-Mix EQ, processed in one batch
+static void BM_Bessel4LowBatch(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    EngineFilterBessel4Low low1(kSampleRate, kLowFreq);
+    EngineFilterBessel4Low low2(kSampleRate, kHighFreq);
+    EngineFilterIIRBatch<4, IIR_LP, 2> batch;
+    batch.setCoefs(0, low1);
+    batch.setCoefs(1, low2);
+    const auto in = sineBuffer(size, 440, 0);
+    std::vector<CSAMPLE> out1(size);
+    std::vector<CSAMPLE> out2(size);
+    for (auto _ : state) {
+        batch.process({in.data(), in.data()}, {out1.data(), out2.data()}, size);
+    }
+}
+BENCHMARK(BM_Bessel4LowBatch)->Range(64, 4096);
+
+static void BM_Bessel8LowSingleFilters(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    EngineFilterBessel8Low low1(kSampleRate, kLowFreq);
+    EngineFilterBessel8Low low2(kSampleRate, kHighFreq);
+    const auto in = sineBuffer(size, 440, 0);
+    std::vector<CSAMPLE> out1(size);
+    std::vector<CSAMPLE> out2(size);
+    for (auto _ : state) {
+        low1.process(in.data(), out1.data(), size);
+        low2.process(in.data(), out2.data(), size);
+    }
+}
+BENCHMARK(BM_Bessel8LowSingleFilters)->Range(64, 4096);
+
+static void BM_Bessel8LowBatch(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    EngineFilterBessel8Low low1(kSampleRate, kLowFreq);
+    EngineFilterBessel8Low low2(kSampleRate, kHighFreq);
+    EngineFilterIIRBatch<8, IIR_LP, 2> batch;
+    batch.setCoefs(0, low1);
+    batch.setCoefs(1, low2);
+    const auto in = sineBuffer(size, 440, 0);
+    std::vector<CSAMPLE> out1(size);
+    std::vector<CSAMPLE> out2(size);
+    for (auto _ : state) {
+        batch.process({in.data(), in.data()}, {out1.data(), out2.data()}, size);
+    }
+}
+BENCHMARK(BM_Bessel8LowBatch)->Range(64, 4096);
+
+} // namespace
@@ -0,0 +1,66 @@
+#include "analyzer/fastanalysis.h"
+
+#include <gtest/gtest.h>
+
+#include "analyzer/constants.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+
+class FastAnalysisTest : public testing::Test {
+};
+
+TEST_F(FastAnalysisTest, ShortTrackIsProcessedCompletely) {
+    const SINT totalFrames = 30 * kSampleRate.value();
+    const auto frameRanges = mixxx::fastAnalysisFrameRanges(totalFrames, kSampleRate);
+    ASSERT_EQ(1, frameRanges.size());
+    EXPECT_EQ(mixxx::IndexRange::forward(0, totalFrames), frameRanges.first());
+}
+
+TEST_F(FastAnalysisTest, SegmentsAreEvenlySpaced) {
+    const SINT totalFrames = 300 * kSampleRate.value();
+    const auto frameRanges = mixxx::fastAnalysisFrameRanges(totalFrames, kSampleRate);
+    ASSERT_EQ(mixxx::kFastAnalysisSegmentCount, frameRanges.size());
+
+    SINT analyzedFrames = 0;
+    const SINT gapFrames = frameRanges.first().start();
+    // The intro is skipped
+    EXPECT_LT(0, gapFrames);
+    for (int i = 0; i < frameRanges.size(); ++i) {
+        analyzedFrames += frameRanges.at(i).length();
+        if (i > 0) {
+            EXPECT_EQ(gapFrames, frameRanges.at(i).start() - frameRanges.at(i - 1).end());
+        }
+    }
+    EXPECT_GE(totalFrames - gapFrames, frameRanges.last().end());
+    EXPECT_EQ(mixxx::kFastAnalysisSecondsToAnalyze * kSampleRate.value(), analyzedFrames);
+}
+
+TEST_F(FastAnalysisTest, MergeKeyChanges) {
+    using namespace mixxx::track::io::key;
+    const QList<mixxx::IndexRange> frameRanges = {
+            mixxx::IndexRange::forward(100, 100),
+            mixxx::IndexRange::forward(300, 100),
+            mixxx::IndexRange::forward(500, 100),
+            mixxx::IndexRange::forward(700, 100)};
+    // Positions are relative to the concatenated ranges. The second range
+    // has no clear key, the third and fourth agree on a new key.
+    const KeyChangeList concatenatedKeyChanges = {
+            qMakePair(C_MAJOR, 0.0),
+            qMakePair(D_MINOR, 100.0),
+            qMakePair(E_MINOR, 140.0),
+            qMakePair(F_MAJOR, 170.0),
+            qMakePair(G_MAJOR, 200.0),
+            qMakePair(A_MINOR, 290.0),
+            qMakePair(G_MAJOR, 310.0)};
+    const KeyChangeList keyChanges = mixxx::fastAnalysisMergeKeyChanges(
+            frameRanges, concatenatedKeyChanges);
+    ASSERT_EQ(2, keyChanges.size());
+    EXPECT_EQ(C_MAJOR, keyChanges.at(0).first);
+    EXPECT_EQ(0.0, keyChanges.at(0).second);
+    EXPECT_EQ(G_MAJOR, keyChanges.at(1).first);
+    EXPECT_EQ(500.0, keyChanges.at(1).second);
+}
+
+} // namespace
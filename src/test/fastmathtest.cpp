@@ -0,0 +1,241 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "effects/backends/builtin/flangereffect.h"
+#include "effects/backends/builtin/phasereffect.h"
+#include "engine/filters/enginefiltermoogladder4.h"
+#include "util/fastmath.h"
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+constexpr SINT kFramesPerBuffer = 1024;
+
+std::vector<CSAMPLE> testSignal(SINT frames, int offsetFrames) {
+    std::vector<CSAMPLE> buffer(frames * 2);
+    for (SINT i = 0; i < frames; ++i) {
+        const double t = static_cast<double>(offsetFrames + i) / kSampleRate;
+        buffer[i * 2] = static_cast<CSAMPLE>(
+                0.5 * std::sin(2 * M_PI * 220 * t) + 0.3 * std::sin(2 * M_PI * 3100 * t));
+        buffer[i * 2 + 1] = static_cast<CSAMPLE>(0.7 * std::sin(2 * M_PI * 440 * t));
+    }
+    return buffer;
+}
+
+FlangerParameters flangerParameters(int buffer) {
+    FlangerParameters parameters;
+    parameters.sampleRate = kSampleRate;
+    parameters.lfoPeriodFrames = kSampleRate * 1.3;
+    // Change the parameters with every buffer to test the ramps
+    parameters.previousMix = 0.5f + 0.1f * (buffer % 4);
+    parameters.mix = 0.5f + 0.1f * ((buffer + 1) % 4);
+    parameters.previousRegen = 0.25f * (buffer % 4);
+    parameters.regen = 0.25f * ((buffer + 1) % 4);
+    parameters.previousWidth = 4.0 + (buffer % 3);
+    parameters.width = 4.0 + ((buffer + 1) % 3);
+    parameters.previousManual = 6.0;
+    parameters.manual = 6.0;
+    return parameters;
+}
+
+PhaserParameters phaserParameters(int buffer) {
+    PhaserParameters parameters;
+    parameters.freqSkip = static_cast<CSAMPLE>(2 * M_PI / (kSampleRate * 0.5));
+    // Change the parameters with every buffer to test the ramps and the
+    // changes of the stages
+    parameters.feedback = buffer % 2 == 0 ? 0.9f : -0.6f;
+    parameters.range = 0.5f + 0.1f * (buffer % 5);
+    parameters.stages = 2 * (1 + buffer % 6);
+    parameters.stereo = (buffer / 7) % 2 != 0;
+    parameters.previousDepth = 0.5f + 0.1f * (buffer % 4);
+    parameters.depth = 0.5f + 0.1f * ((buffer + 1) % 4);
+    return parameters;
+}
+
+TEST(FastMathTest, Tanh) {
+    for (float x = -8.0f; x <= 8.0f; x += 0.001f) {
+        ASSERT_NEAR(std::tanh(x), fastTanh(x), 1e-4) << "x = " << x;
+    }
+}
+
+TEST(FastMathTest, SinCycles) {
+    for (float cycles = 0.0f; cycles < 1.0f; cycles += 0.0001f) {
+        ASSERT_NEAR(std::sin(2 * M_PI * cycles), fastSinCycles(cycles), 4e-6)
+                << "cycles = " << cycles;
+    }
+}
+
+template<typename Filter>
+void expectMoogKernelsMatch(double resonance) {
+    Filter reference(kSampleRate, 500, resonance);
+    reference.setKernel(DspKernel::Reference);
+    Filter vectorized(kSampleRate, 500, resonance);
+    std::vector<CSAMPLE> referenceOut(kFramesPerBuffer * 2);
+    std::vector<CSAMPLE> vectorizedOut(kFramesPerBuffer * 2);
+    for (int buffer = 0; buffer < 32; ++buffer) {
+        if (buffer % 8 == 4) {
+            // Sweep the corner, which smoothes the parameters
+            const double corner = 500 + 250 * buffer;
+            reference.setParameter(kSampleRate, static_cast<float>(corner), resonance);
+            vectorized.setParameter(kSampleRate, static_cast<float>(corner), resonance);
+        }
+        const auto in = testSignal(kFramesPerBuffer, buffer * kFramesPerBuffer);
+        reference.process(in.data(), referenceOut.data(), kFramesPerBuffer * 2);
+        vectorized.process(in.data(), vectorizedOut.data(), kFramesPerBuffer * 2);
+        for (SINT i = 0; i < kFramesPerBuffer * 2; ++i) {
+            ASSERT_NEAR(referenceOut[i], vectorizedOut[i], 1e-5)
+                    << "buffer " << buffer << " sample " << i;
+        }
+    }
+}
+
+TEST(FastMathTest, MoogLadder4LowKernelsMatch) {
+    expectMoogKernelsMatch<EngineFilterMoogLadder4Low>(1);
+    expectMoogKernelsMatch<EngineFilterMoogLadder4Low>(3.5);
+}
+
+TEST(FastMathTest, MoogLadder4HighKernelsMatch) {
+    expectMoogKernelsMatch<EngineFilterMoogLadder4High>(1);
+    expectMoogKernelsMatch<EngineFilterMoogLadder4High>(3.5);
+}
+
+TEST(FastMathTest, FlangerKernelsMatch) {
+    const mixxx::EngineParameters engineParameters(
+            mixxx::audio::SampleRate(kSampleRate), kFramesPerBuffer);
+    // The states are too large for the stack
+    auto pReferenceState = std::make_unique<FlangerGroupState>(engineParameters);
+    auto pVectorizedState = std::make_unique<FlangerGroupState>(engineParameters);
+    std::vector<CSAMPLE> referenceOut(kFramesPerBuffer * 2);
+    std::vector<CSAMPLE> vectorizedOut(kFramesPerBuffer * 2);
+    // Run through more than one period of the LFO
+    for (int buffer = 0; buffer < 128; ++buffer) {
+        const auto in = testSignal(kFramesPerBuffer, buffer * kFramesPerBuffer);
+        const FlangerParameters parameters = flangerParameters(buffer);
+        FlangerEffect::processReference(pReferenceState.get(),
+                in.data(),
+                referenceOut.data(),
+                kFramesPerBuffer,
+                parameters);
+        FlangerEffect::processVectorized(pVectorizedState.get(),
+                in.data(),
+                vectorizedOut.data(),
+                kFramesPerBuffer,
+                parameters);
+        ASSERT_EQ(pReferenceState->lfoFrames, pVectorizedState->lfoFrames);
+        ASSERT_EQ(pReferenceState->delayPos, pVectorizedState->delayPos);
+        for (SINT i = 0; i < kFramesPerBuffer * 2; ++i) {
+            // The delay is interpolated in float precision
+            ASSERT_NEAR(referenceOut[i], vectorizedOut[i], 1e-3)
+                    << "buffer " << buffer << " sample " << i;
+        }
+    }
+}
+
+TEST(FastMathTest, PhaserKernelsMatch) {
+    const mixxx::EngineParameters engineParameters(
+            mixxx::audio::SampleRate(kSampleRate), kFramesPerBuffer);
+    PhaserGroupState referenceState(engineParameters);
+    PhaserGroupState vectorizedState(engineParameters);
+    std::vector<CSAMPLE> referenceOut(kFramesPerBuffer * 2);
+    std::vector<CSAMPLE> vectorizedOut(kFramesPerBuffer * 2);
+    // Run through more than one period of the LFO
+    for (int buffer = 0; buffer < 128; ++buffer) {
+        const auto in = testSignal(kFramesPerBuffer, buffer * kFramesPerBuffer);
+        const PhaserParameters parameters = phaserParameters(buffer);
+        PhaserEffect::processReference(&referenceState,
+                in.data(),
+                referenceOut.data(),
+                kFramesPerBuffer,
+                parameters);
+        PhaserEffect::processVectorized(&vectorizedState,
+                in.data(),
+                vectorizedOut.data(),
+                kFramesPerBuffer,
+                parameters);
+        // The LFO is not approximated
+        ASSERT_EQ(referenceState.leftPhase, vectorizedState.leftPhase);
+        ASSERT_EQ(referenceState.rightPhase, vectorizedState.rightPhase);
+        for (SINT i = 0; i < kFramesPerBuffer * 2; ++i) {
+            ASSERT_NEAR(referenceOut[i], vectorizedOut[i], 1e-4)
+                    << "buffer " << buffer << " sample " << i;
+        }
+    }
+}
+
+void kernelArguments(benchmark::internal::Benchmark* pBenchmark) {
+    for (int kernel = 0; kernel <= 1; ++kernel) {
+        for (int framesPerBuffer = 64; framesPerBuffer <= 4096; framesPerBuffer *= 8) {
+            pBenchmark->Args({framesPerBuffer, kernel});
+        }
+    }
+}
+
+DspKernel kernelArgument(const benchmark::State& state) {
+    return state.range(1) != 0 ? DspKernel::Vectorized : DspKernel::Reference;
+}
+
+static void BM_MoogLadder4LowKernel(benchmark::State& state) {
+    const SINT frames = state.range(0);
+    EngineFilterMoogLadder4Low filter(kSampleRate, 1000, 1);
+    filter.setKernel(kernelArgument(state));
+    const auto in = testSignal(frames, 0);
+    std::vector<CSAMPLE> out(frames * 2);
+    for (auto _ : state) {
+        filter.process(in.data(), out.data(), static_cast<int>(frames * 2));
+    }
+}
+BENCHMARK(BM_MoogLadder4LowKernel)->Apply(kernelArguments);
+
+static void BM_FlangerKernel(benchmark::State& state) {
+    const SINT frames = state.range(0);
+    const mixxx::EngineParameters engineParameters(
+            mixxx::audio::SampleRate(kSampleRate), frames);
+    auto pState = std::make_unique<FlangerGroupState>(engineParameters);
+    const auto in = testSignal(frames, 0);
+    std::vector<CSAMPLE> out(frames * 2);
+    const FlangerParameters parameters = flangerParameters(0);
+    const bool vectorized = kernelArgument(state) == DspKernel::Vectorized;
+    for (auto _ : state) {
+        if (vectorized) {
+            FlangerEffect::processVectorized(
+                    pState.get(), in.data(), out.data(), frames, parameters);
+        } else {
+            FlangerEffect::processReference(
+                    pState.get(), in.data(), out.data(), frames, parameters);
+        }
+    }
+}
+BENCHMARK(BM_FlangerKernel)->Apply(kernelArguments);
+
+static void BM_PhaserKernel(benchmark::State& state) {
+    const SINT frames = state.range(0);
+    const mixxx::EngineParameters engineParameters(
+            mixxx::audio::SampleRate(kSampleRate), frames);
+    PhaserGroupState phaserState(engineParameters);
+    const auto in = testSignal(frames, 0);
+    std::vector<CSAMPLE> out(frames * 2);
+    // The default parameters of the effect
+    PhaserParameters parameters = phaserParameters(0);
+    parameters.feedback = 0.0f;
+    parameters.range = 1.0f;
+    parameters.stages = 7;
+    parameters.previousDepth = 0.5f;
+    parameters.depth = 0.5f;
+    const bool vectorized = kernelArgument(state) == DspKernel::Vectorized;
+    for (auto _ : state) {
+        if (vectorized) {
+            PhaserEffect::processVectorized(
+                    &phaserState, in.data(), out.data(), frames, parameters);
+        } else {
+            PhaserEffect::processReference(
+                    &phaserState, in.data(), out.data(), frames, parameters);
+        }
+    }
+}
+BENCHMARK(BM_PhaserKernel)->Apply(kernelArguments);
+
+} // namespace
@@ -0,0 +1,172 @@
+#include "waveform/frametimerecorder.h"
+
+#include <gtest/gtest.h>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "test/mixxxtest.h"
+#include "util/time.h"
+
+namespace {
+
+class FrameTimeRecorderTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        mixxx::Time::setTestMode(true);
+        setTimeMillis(1000);
+    }
+
+    void TearDown() override {
+        mixxx::Time::setTestMode(false);
+    }
+
+    void setTimeMillis(qint64 millis) {
+        mixxx::Time::setTestElapsedTime(mixxx::Duration::fromMillis(millis));
+    }
+
+    // Records a frame that starts at startMillis, renders two widgets for
+    // 2 and renderMillis ms and swaps 4 ms after the end of rendering
+    void recordFrame(qint64 startMillis, qint64 renderMillis, int droppedFramesTotal) {
+        setTimeMillis(startMillis);
+        m_recorder.beginRender();
+        setTimeMillis(startMillis + 2);
+        m_recorder.widgetRendered(0, mixxx::Duration::fromMillis(startMillis));
+        setTimeMillis(startMillis + 2 + renderMillis);
+        m_recorder.widgetRendered(1, mixxx::Duration::fromMillis(startMillis + 2));
+        m_recorder.endRender(droppedFramesTotal);
+        setTimeMillis(startMillis + 6 + renderMillis);
+        m_recorder.beginSwap();
+        setTimeMillis(startMillis + 7 + renderMillis);
+        m_recorder.endSwap();
+    }
+
+    FrameTimeRecorder m_recorder;
+};
+
+TEST_F(FrameTimeRecorderTest, Percentiles) {
+    for (int i = 0; i < 100; ++i) {
+        recordFrame(1000 + i * 20, i + 1, 0);
+    }
+    EXPECT_EQ(100, m_recorder.frameCount());
+
+    const auto widget0 = m_recorder.widgetRenderPercentiles(0);
+    EXPECT_EQ(mixxx::Duration::fromMillis(2), widget0.p50);
+    EXPECT_EQ(mixxx::Duration::fromMillis(2), widget0.max);
+
+    const auto widget1 = m_recorder.widgetRenderPercentiles(1);
+    EXPECT_EQ(mixxx::Duration::fromMillis(50), widget1.p50);
+    EXPECT_EQ(mixxx::Duration::fromMillis(95), widget1.p95);
+    EXPECT_EQ(mixxx::Duration::fromMillis(99), widget1.p99);
+    EXPECT_EQ(mixxx::Duration::fromMillis(100), widget1.max);
+
+    const auto render = m_recorder.renderPercentiles();
+    EXPECT_EQ(mixxx::Duration::fromMillis(52), render.p50);
+
+    const auto renderToSwap = m_recorder.renderToSwapPercentiles();
+    EXPECT_EQ(mixxx::Duration::fromMillis(4), renderToSwap.p50);
+    EXPECT_EQ(mixxx::Duration::fromMillis(4), renderToSwap.max);
+}
+
+TEST_F(FrameTimeRecorderTest, RingKeepsNewestFrames) {
+    for (int i = 0; i < FrameTimeRecorder::kFrameCount + 10; ++i) {
+        recordFrame(1000 + i * 20, 1, 0);
+    }
+    EXPECT_EQ(FrameTimeRecorder::kFrameCount, m_recorder.frameCount());
+    EXPECT_EQ(mixxx::Duration::fromMillis(1000 + 10 * 20),
+            m_recorder.frame(0).renderStart);
+    EXPECT_EQ(mixxx::Duration::fromMillis(
+                      1000 + (FrameTimeRecorder::kFrameCount + 9) * 20),
+            m_recorder.frame(FrameTimeRecorder::kFrameCount - 1).renderStart);
+
+    m_recorder.clear();
+    EXPECT_EQ(0, m_recorder.frameCount());
+}
+
+TEST_F(FrameTimeRecorderTest, DroppedFramesAndBusyRatio) {
+    recordFrame(1000, 2, 0);
+    recordFrame(1020, 2, 3);
+    recordFrame(1040, 2, 3);
+    // The VSyncThread has been reset
+    recordFrame(1060, 2, 1);
+    EXPECT_EQ(4, m_recorder.droppedFrames());
+    EXPECT_EQ(3, m_recorder.frame(1).droppedFrames);
+    EXPECT_EQ(0, m_recorder.frame(2).droppedFrames);
+
+    // 4 ms render and 1 ms swap of every 20 ms
+    EXPECT_DOUBLE_EQ(0.25, m_recorder.guiThreadBusyRatio());
+}
+
+TEST_F(FrameTimeRecorderTest, ChromeTrace) {
+    recordFrame(1000, 2, 0);
+    recordFrame(1020, 2, 1);
+
+    const QJsonDocument trace = QJsonDocument::fromJson(
+            m_recorder.toChromeTrace(QStringList{"[Channel1]"}));
+    ASSERT_TRUE(trace.isObject());
+    const QJsonArray events = trace.object().value("traceEvents").toArray();
+    // Thread name and per frame render, two widgets, swap,
+    // plus the dropped frame of the second frame
+    ASSERT_EQ(1 + 2 * 4 + 1, events.size());
+
+    const QJsonObject render = events[1].toObject();
+    EXPECT_EQ("render", render.value("name").toString());
+    EXPECT_EQ("X", render.value("ph").toString());
+    EXPECT_DOUBLE_EQ(1000000.0, render.value("ts").toDouble());
+    EXPECT_DOUBLE_EQ(4000.0, render.value("dur").toDouble());
+    EXPECT_EQ("[Channel1]", events[2].toObject().value("name").toString());
+    EXPECT_EQ("waveform 1", events[3].toObject().value("name").toString());
+    EXPECT_EQ("swap", events[4].toObject().value("name").toString());
+    EXPECT_EQ("dropped frames", events.last().toObject().value("name").toString());
+}
+
+TEST_F(FrameTimeRecorderTest, OffscreenFrames) {
+    recordFrame(1000, 2, 0);
+    // Both widgets are rendered in parallel by the render thread
+    m_recorder.offscreenWidgetRendered(0,
+            mixxx::Duration::fromMillis(1001),
+            mixxx::Duration::fromMillis(5));
+    m_recorder.offscreenWidgetRendered(1,
+            mixxx::Duration::fromMillis(1001),
+            mixxx::Duration::fromMillis(7));
+    m_recorder.offscreenWidgetRendered(0,
+            mixxx::Duration::fromMillis(1021),
+            mixxx::Duration::fromMillis(3));
+    // Out of range
+    m_recorder.offscreenWidgetRendered(FrameTimeRecorder::kMaxWidgets,
+            mixxx::Duration::fromMillis(1021),
+            mixxx::Duration::fromMillis(3));
+    ASSERT_EQ(3, m_recorder.offscreenFrameCount());
+    EXPECT_EQ(1, m_recorder.offscreenFrame(1).widgetIndex);
+
+    const auto widget0 = m_recorder.offscreenRenderPercentiles(0);
+    EXPECT_EQ(mixxx::Duration::fromMillis(3), widget0.p50);
+    EXPECT_EQ(mixxx::Duration::fromMillis(5), widget0.max);
+    // The time of the GUI thread is recorded separately
+    EXPECT_EQ(mixxx::Duration::fromMillis(2),
+            m_recorder.widgetRenderPercentiles(0).max);
+
+    const QJsonDocument trace = QJsonDocument::fromJson(
+            m_recorder.toChromeTrace(QStringList{"[Channel1]", "[Channel2]"}));
+    const QJsonArray events = trace.object().value("traceEvents").toArray();
+    // The GUI thread name and frame, then a thread name per widget and
+    // the offscreen frames
+    ASSERT_EQ(1 + 4 + 2 + 3, events.size());
+    const QJsonObject threadName = events[5].toObject();
+    EXPECT_EQ("M", threadName.value("ph").toString());
+    EXPECT_EQ("WaveformRender [Channel1]",
+            threadName.value("args").toObject().value("name").toString());
+    const QJsonObject offscreen = events[6].toObject();
+    EXPECT_EQ("[Channel1]", offscreen.value("name").toString());
+    EXPECT_EQ(threadName.value("tid").toInt(), offscreen.value("tid").toInt());
+    EXPECT_NE(events[1].toObject().value("tid").toInt(),
+            offscreen.value("tid").toInt());
+    EXPECT_DOUBLE_EQ(5000.0, offscreen.value("dur").toDouble());
+    EXPECT_EQ("[Channel2]", events[8].toObject().value("name").toString());
+
+    m_recorder.clear();
+    EXPECT_EQ(0, m_recorder.offscreenFrameCount());
+}
+
+} // namespace
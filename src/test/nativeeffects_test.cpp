@@ -1,96 +1,300 @@
-#if 0
-// TODO: make this work again
 #include <benchmark/benchmark.h>
-#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
 
 #include "control/controlpotmeter.h"
-#include "effects/builtin/autopaneffect.h"
-#include "effects/builtin/bessel4lvmixeqeffect.h"
-#include "effects/builtin/bessel8lvmixeqeffect.h"
-#include "effects/builtin/bitcrushereffect.h"
-#include "effects/builtin/echoeffect.h"
-#include "effects/builtin/filtereffect.h"
-#include "effects/builtin/flangereffect.h"
-#include "effects/builtin/graphiceqeffect.h"
-#include "effects/builtin/linkwitzriley8eqeffect.h"
-#include "effects/builtin/moogladder4filtereffect.h"
-#include "effects/builtin/phasereffect.h"
-#include "effects/builtin/reverbeffect.h"
+#include "effects/backends/builtin/bessel4lvmixeqeffect.h"
+#include "effects/backends/builtin/bessel8lvmixeqeffect.h"
+#include "effects/backends/builtin/bitcrushereffect.h"
+#include "effects/backends/builtin/convolutionreverbeffect.h"
+#include "effects/backends/builtin/echoeffect.h"
+#include "effects/backends/builtin/filtereffect.h"
+#include "effects/backends/builtin/flangereffect.h"
+#include "effects/backends/builtin/graphiceqeffect.h"
+#include "effects/backends/builtin/linkwitzriley8eqeffect.h"
+#include "effects/backends/builtin/moogladder4filtereffect.h"
+#include "effects/backends/builtin/phasereffect.h"
+#include "effects/backends/builtin/reverbeffect.h"
+#include "effects/backends/effectsbackendmanager.h"
+#include "effects/effectsmessenger.h"
 #include "engine/channelhandle.h"
+#include "engine/effects/engineeffect.h"
+#include "engine/effects/engineeffectchain.h"
+#include "engine/effects/engineeffectsmanager.h"
 #include "engine/effects/groupfeaturestate.h"
-#include "test/baseeffecttest.h"
 #include "util/samplebuffer.h"
 
+// Benchmarks of the built-in effects with their default parameters, processed
+// by an EngineEffectChain like in the engine. The second argument selects a
+// silent input, which is processed until the tail of the effect has decayed
+// before the measurement starts.
+//
+// The parameter transport benchmarks measure the cost of changing parameters
+// between two callbacks of the EngineEffectsManager, once with an
+// EffectsRequest per change and once with the parameter table of the
+// EngineEffect.
+
 namespace {
 
-class EffectsBenchmarkTest : public BaseEffectTest {
-  protected:
-    void SetUp() override {
-        registerTestBackend();
+constexpr int kEffectsMessagePipeFifoSize = 16;
+// Like EffectsManager, large enough for all changes of a callback
+constexpr int kTransportMessagePipeFifoSize = 2048;
+// The longest silence to wait for the tail of an effect to decay
+constexpr int kMaxTailSeconds = 300;
+
+// The EffectsBackendManager and the EQ frequency controls, created only once
+// and never destroyed
+EffectsBackendManagerPointer backendManager() {
+    static const EffectsBackendManagerPointer s_pBackendManager = [] {
+        auto* pLoEqFrequency = new ControlPotmeter(
+                ConfigKey("[Mixer Profile]", "LoEQFrequency"), 0., 22040);
+        pLoEqFrequency->setDefaultValue(250.0);
+        auto* pHiEqFrequency = new ControlPotmeter(
+                ConfigKey("[Mixer Profile]", "HiEQFrequency"), 0., 22040);
+        pHiEqFrequency->setDefaultValue(2500.0);
+        return EffectsBackendManagerPointer(new EffectsBackendManager());
+    }();
+    return s_pBackendManager;
+}
+
+void sendRequest(EffectsRequestHandler* pHandler,
+        EffectsRequest* pRequest,
+        EffectsRequestPipe* pRequestPipe,
+        EffectsResponsePipe* pResponsePipe) {
+    pHandler->processEffectsRequest(*pRequest, pResponsePipe);
+    // Discard the response
+    EffectsResponse response;
+    while (pRequestPipe->readMessage(&response)) {
     }
-};
+}
 
-template <class EffectType>
-void benchmarkBuiltInEffectDefaultParameters(const mixxx::EngineParameters& engineParameters,
-                                            benchmark::State* pState, EffectsManager* pEffectsManager) {
-    EffectManifestPointer pManifest = EffectType::getManifest();
+template<class EffectType>
+void BM_BuiltInEffectDefaultParameters(benchmark::State& state) {
+    const mixxx::EngineParameters engineParameters(
+            mixxx::audio::SampleRate(44100),
+            static_cast<SINT>(state.range(0)));
+    const bool silentInput = state.range(1) != 0;
 
     ChannelHandleFactory factory;
-    QSet<ChannelHandleAndGroup> activeInputChannels;
+    const ChannelHandleAndGroup channel1(
+            factory.getOrCreateHandle("[Channel1]"), "[Channel1]");
+    const ChannelHandleAndGroup master(
+            factory.getOrCreateHandle("[Master]"), "[Master]");
+    const QSet<ChannelHandleAndGroup> inputChannels{channel1};
+    const QSet<ChannelHandleAndGroup> outputChannels{master};
+
+    const auto pBackendManager = backendManager();
+    EngineEffect effect(
+            pBackendManager->getManifest(EffectType::getId(), EffectBackendType::BuiltIn),
+            pBackendManager,
+            inputChannels,
+            outputChannels);
+    EngineEffectChain chain("[BenchmarkChain]", inputChannels, outputChannels);
+
+    const auto pipes =
+            TwoWayMessagePipe<EffectsRequest*, EffectsResponse>::makeTwoWayMessagePipe(
+                    kEffectsMessagePipeFifoSize, kEffectsMessagePipeFifoSize);
+    const std::unique_ptr<EffectsRequestPipe> pRequestPipe(pipes.first);
+    const std::unique_ptr<EffectsResponsePipe> pResponsePipe(pipes.second);
+
+    EffectsRequest addEffect;
+    addEffect.type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
+    addEffect.AddEffectToChain.pEffect = &effect;
+    addEffect.AddEffectToChain.iIndex = 0;
+    sendRequest(&chain, &addEffect, pRequestPipe.get(), pResponsePipe.get());
+
+    EffectsRequest setChainParameters;
+    setChainParameters.type = EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS;
+    setChainParameters.SetEffectChainParameters.enabled = true;
+    setChainParameters.SetEffectChainParameters.mix_mode = EffectChainMixMode::DrySlashWet;
+    setChainParameters.SetEffectChainParameters.mix = 1.0;
+    sendRequest(&chain, &setChainParameters, pRequestPipe.get(), pResponsePipe.get());
 
-    QString channel1_group = QString("[Channel1]");
-    ChannelHandle channel1 = factory.getOrCreateHandle(channel1_group);
-    ChannelHandleAndGroup handle_and_group(channel1, channel1_group);
-    pEffectsManager->registerInputChannel(handle_and_group);
-    pEffectsManager->registerOutputChannel(handle_and_group);
-    activeInputChannels.insert(handle_and_group);
-    EffectInstantiatorPointer pInstantiator = EffectInstantiatorPointer(
-        new EffectProcessorInstantiator<EffectType>());
-    EngineEffect effect(pManifest, activeInputChannels, pEffectsManager, pInstantiator);
+    // Like EffectChain::enableForInputChannel(), otherwise the effect has no
+    // state for the channel and passes the input through
+    effect.prepareStatesForInputChannel(&channel1.handle());
+    EffectsRequest enableForChannel;
+    enableForChannel.type = EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
+    enableForChannel.EnableInputChannelForChain.pChannelHandle = &channel1.handle();
+    sendRequest(&chain, &enableForChannel, pRequestPipe.get(), pResponsePipe.get());
 
-    GroupFeatureState featureState;
-    EffectEnableState enableState = EffectEnableState::Enabled;
+    EffectsRequest enableEffect;
+    enableEffect.type = EffectsRequest::SET_EFFECT_PARAMETERS;
+    enableEffect.SetEffectParameters.enabled = true;
+    sendRequest(&effect, &enableEffect, pRequestPipe.get(), pResponsePipe.get());
 
     mixxx::SampleBuffer input(engineParameters.samplesPerBuffer());
     mixxx::SampleBuffer output(engineParameters.samplesPerBuffer());
+    if (!silentInput) {
+        input.fill(0.5f);
+    }
+    const GroupFeatureState featureState;
+
+    // Finish the intermediate enabling states, and with silent input wait
+    // until the chain bypasses the effect.
+    const SINT maxSetupBuffers = 1 +
+            kMaxTailSeconds * engineParameters.sampleRate() /
+                    engineParameters.framesPerBuffer();
+    for (SINT i = 0; i < maxSetupBuffers; ++i) {
+        const bool processed = chain.process(channel1.handle(),
+                master.handle(),
+                input.data(),
+                output.data(),
+                engineParameters.samplesPerBuffer(),
+                engineParameters.sampleRate().value(),
+                featureState);
+        if (i > 0 && (!silentInput || !processed)) {
+            break;
+        }
+    }
+
+    for (auto _ : state) {
+        chain.process(channel1.handle(),
+                master.handle(),
+                input.data(),
+                output.data(),
+                engineParameters.samplesPerBuffer(),
+                engineParameters.sampleRate().value(),
+                featureState);
+    }
+}
 
-    while (pState->KeepRunning()) {
-        effect.process(channel1, channel1, input.data(), output.data(),
-                       engineParameters.samplesPerBuffer(),
-                       engineParameters.sampleRate(),
-                       enableState, featureState);
+void commonArguments(benchmark::internal::Benchmark* pBenchmark) {
+    for (int silentInput = 0; silentInput <= 1; ++silentInput) {
+        for (int framesPerBuffer = 32; framesPerBuffer <= 4096; framesPerBuffer *= 2) {
+            pBenchmark->Args({framesPerBuffer, silentInput});
+        }
     }
 }
 
-#define FOR_COMMON_BUFFER_SIZES(bm) bm->Arg(32)->Arg(64)->Arg(128)->Arg(256)->Arg(512)->Arg(1024)->Arg(2048)->Arg(4096);
-
-#define DECLARE_EFFECT_BENCHMARK(EffectName)                                         \
-    TEST_F(EffectsBenchmarkTest, BM_BuiltInEffects_DefaultParameters_##EffectName) { \
-        ControlPotmeter loEqFrequency(                                               \
-                ConfigKey("[Mixer Profile]", "LoEQFrequency"), 0., 22040);           \
-        loEqFrequency.setDefaultValue(250.0);                                        \
-        ControlPotmeter hiEqFrequency(                                               \
-                ConfigKey("[Mixer Profile]", "HiEQFrequency"), 0., 22040);           \
-        hiEqFrequency.setDefaultValue(2500.0);                                       \
-        mixxx::EngineParameters engineParameters(                                    \
-                mixxx::audio::SampleRate(44100),                                     \
-                state.range_x());                                                    \
-        benchmarkBuiltInEffectDefaultParameters<EffectName>(                         \
-                engineParameters, &state, m_pEffectsManager);                        \
-    }                                                                                \
-    FOR_COMMON_BUFFER_SIZES(BENCHMARK(BM_BuiltInEffects_DefaultParameters_##EffectName));
-
-DECLARE_EFFECT_BENCHMARK(Bessel4LVMixEQEffect)
-DECLARE_EFFECT_BENCHMARK(Bessel8LVMixEQEffect)
-DECLARE_EFFECT_BENCHMARK(BitCrusherEffect)
-DECLARE_EFFECT_BENCHMARK(EchoEffect)
-DECLARE_EFFECT_BENCHMARK(FilterEffect)
-DECLARE_EFFECT_BENCHMARK(FlangerEffect)
-DECLARE_EFFECT_BENCHMARK(GraphicEQEffect)
-DECLARE_EFFECT_BENCHMARK(LinkwitzRiley8EQEffect)
-DECLARE_EFFECT_BENCHMARK(MoogLadder4FilterEffect)
-DECLARE_EFFECT_BENCHMARK(PhaserEffect)
-DECLARE_EFFECT_BENCHMARK(ReverbEffect)
-
-}  // namespace
-#endif
+BENCHMARK_TEMPLATE(BM_BuiltInEffectDefaultParameters, Bessel4LVMixEQEffect)->Apply(commonArguments);
+BENCHMARK_TEMPLATE(BM_BuiltInEffectDefaultParameters, Bessel8LVMixEQEffect)->Apply(commonArguments);
+BENCHMARK_TEMPLATE(BM_BuiltInEffectDefaultParameters, BitCrusherEffect)->Apply(commonArguments);
+BENCHMARK_TEMPLATE(BM_BuiltInEffectDefaultParameters, ConvolutionReverbEffect)->Apply(commonArguments);
+BENCHMARK_TEMPLATE(BM_BuiltInEffectDefaultParameters, EchoEffect)->Apply(commonArguments);
+BENCHMARK_TEMPLATE(BM_BuiltInEffectDefaultParameters, FilterEffect)->Apply(commonArguments);
+BENCHMARK_TEMPLATE(BM_BuiltInEffectDefaultParameters, FlangerEffect)->Apply(commonArguments);
+BENCHMARK_TEMPLATE(BM_BuiltInEffectDefaultParameters, GraphicEQEffect)->Apply(commonArguments);
+BENCHMARK_TEMPLATE(BM_BuiltInEffectDefaultParameters, LinkwitzRiley8EQEffect)->Apply(commonArguments);
+BENCHMARK_TEMPLATE(BM_BuiltInEffectDefaultParameters, MoogLadder4FilterEffect)->Apply(commonArguments);
+BENCHMARK_TEMPLATE(BM_BuiltInEffectDefaultParameters, PhaserEffect)->Apply(commonArguments);
+BENCHMARK_TEMPLATE(BM_BuiltInEffectDefaultParameters, ReverbEffect)->Apply(commonArguments);
+
+// An EngineEffectsManager with a GraphicEQEffect in a chain, fed by an
+// EffectsMessenger like in Mixxx
+class ParameterTransport {
+  public:
+    ParameterTransport()
+            : m_channel(m_factory.getOrCreateHandle("[Channel1]"), "[Channel1]"),
+              m_master(m_factory.getOrCreateHandle("[Master]"), "[Master]"),
+              m_effect(backendManager()->getManifest(
+                               GraphicEQEffect::getId(), EffectBackendType::BuiltIn),
+                      backendManager(),
+                      {m_channel},
+                      {m_master}),
+              m_chain("[BenchmarkChain]", {m_channel}, {m_master}) {
+        const auto pipes =
+                TwoWayMessagePipe<EffectsRequest*, EffectsResponse>::makeTwoWayMessagePipe(
+                        kTransportMessagePipeFifoSize, kTransportMessagePipeFifoSize);
+        m_pMessenger = std::make_unique<EffectsMessenger>(pipes.first, nullptr);
+        m_pEngineEffectsManager = std::make_unique<EngineEffectsManager>(pipes.second);
+
+        auto* pAddChain = new EffectsRequest();
+        pAddChain->type = EffectsRequest::ADD_EFFECT_CHAIN;
+        pAddChain->AddEffectChain.pChain = &m_chain;
+        pAddChain->AddEffectChain.signalProcessingStage = SignalProcessingStage::Postfader;
+        m_pMessenger->writeRequest(pAddChain);
+
+        auto* pAddEffect = new EffectsRequest();
+        pAddEffect->type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
+        pAddEffect->pTargetChain = &m_chain;
+        pAddEffect->AddEffectToChain.pEffect = &m_effect;
+        pAddEffect->AddEffectToChain.iIndex = 0;
+        m_pMessenger->writeRequest(pAddEffect);
+
+        m_pEngineEffectsManager->onCallbackStart();
+        m_pMessenger->processEffectsResponses();
+
+        for (const auto& pParameter : m_effect.getManifest()->parameters()) {
+            m_defaultValues.push_back(pParameter->getDefault());
+        }
+    }
+
+    EngineEffect* effect() {
+        return &m_effect;
+    }
+    EffectsMessenger* messenger() {
+        return m_pMessenger.get();
+    }
+    EngineEffectsManager* engineEffectsManager() {
+        return m_pEngineEffectsManager.get();
+    }
+    const std::vector<double>& defaultValues() const {
+        return m_defaultValues;
+    }
+
+  private:
+    ChannelHandleFactory m_factory;
+    const ChannelHandleAndGroup m_channel;
+    const ChannelHandleAndGroup m_master;
+    EngineEffect m_effect;
+    EngineEffectChain m_chain;
+    // Destroyed before the chain and the effect
+    std::unique_ptr<EffectsMessenger> m_pMessenger;
+    std::unique_ptr<EngineEffectsManager> m_pEngineEffectsManager;
+    std::vector<double> m_defaultValues;
+};
+
+// The transport before the parameter table: every change is an EffectsRequest
+// that is allocated, sent through the pipe, answered by the engine and
+// deleted by the messenger. SET_EFFECT_PARAMETERS takes the path of the
+// removed SET_PARAMETER_PARAMETERS request.
+void BM_EffectParameterRequests(benchmark::State& state) {
+    const auto changesPerCallback = static_cast<int>(state.range(0));
+    ParameterTransport transport;
+
+    for (auto _ : state) {
+        for (int i = 0; i < changesPerCallback; ++i) {
+            auto* pRequest = new EffectsRequest();
+            pRequest->type = EffectsRequest::SET_EFFECT_PARAMETERS;
+            pRequest->pTargetEffect = transport.effect();
+            pRequest->SetEffectParameters.enabled = true;
+            transport.messenger()->writeRequest(pRequest);
+        }
+        transport.engineEffectsManager()->onCallbackStart();
+    }
+    transport.messenger()->processEffectsResponses();
+    state.SetItemsProcessed(state.iterations() * changesPerCallback);
+}
+
+// The changes are stored in the parameter table and the engine copies the
+// table once per callback.
+void BM_EffectParameterTable(benchmark::State& state) {
+    const auto changesPerCallback = static_cast<int>(state.range(0));
+    ParameterTransport transport;
+    const std::vector<double>& values = transport.defaultValues();
+    const auto parameterCount = static_cast<int>(values.size());
+
+    for (auto _ : state) {
+        for (int i = 0; i < changesPerCallback; ++i) {
+            const int index = i % parameterCount;
+            transport.effect()->setParameter(index, values[index]);
+        }
+        transport.engineEffectsManager()->onCallbackStart();
+    }
+    state.SetItemsProcessed(state.iterations() * changesPerCallback);
+}
+
+void transportArguments(benchmark::internal::Benchmark* pBenchmark) {
+    // A single knob, a controller sweeping a few knobs, and a burst of
+    // changes from a preset or a fast MIDI controller
+    for (int changesPerCallback : {1, 12, 96}) {
+        pBenchmark->Args({changesPerCallback});
+    }
+}
+
+BENCHMARK(BM_EffectParameterRequests)->Apply(transportArguments);
+BENCHMARK(BM_EffectParameterTable)->Apply(transportArguments);
+
+} // namespace
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <QImage>
+#include <QPainter>
+
+#include "test/mixxxtest.h"
+#include "widget/wpixmapstore.h"
+
+namespace {
+
+const QByteArray kSvg = QByteArrayLiteral(
+        "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"10\" height=\"6\">"
+        "<rect width=\"10\" height=\"6\" fill=\"#ff0000\"/></svg>");
+
+PixmapSource svgSource() {
+    PixmapSource source;
+    source.setSVG(kSvg);
+    return source;
+}
+
+class PaintableTest : public MixxxTest {
+  protected:
+    void TearDown() override {
+        WPixmapStore::finishDeferredRasterization();
+    }
+};
+
+TEST_F(PaintableTest, RasterizesImmediatelyByDefault) {
+    Paintable paintable(svgSource(), Paintable::TILE, 2.0);
+    EXPECT_FALSE(paintable.isRasterizing());
+    EXPECT_EQ(QSize(20, 12), paintable.size());
+}
+
+TEST_F(PaintableTest, DeferredRasterization) {
+    WPixmapStore::beginDeferredRasterization();
+    Paintable paintable(svgSource(), Paintable::TILE, 2.0);
+    EXPECT_TRUE(paintable.isRasterizing());
+    // The size is known before the image is ready
+    EXPECT_EQ(QSize(20, 12), paintable.size());
+
+    EXPECT_EQ(1, WPixmapStore::finishDeferredRasterization());
+    EXPECT_FALSE(paintable.isRasterizing());
+    EXPECT_EQ(QSize(20, 12), paintable.size());
+
+    QImage target(20, 12, QImage::Format_ARGB32);
+    target.fill(Qt::transparent);
+    QPainter painter(&target);
+    paintable.draw(0, 0, &painter);
+    painter.end();
+    EXPECT_EQ(qRgb(255, 0, 0), target.pixel(19, 11));
+}
+
+TEST_F(PaintableTest, DrawingFinishesDeferredRasterization) {
+    WPixmapStore::beginDeferredRasterization();
+    Paintable paintable(svgSource(), Paintable::TILE, 1.0);
+
+    QImage target(10, 6, QImage::Format_ARGB32);
+    target.fill(Qt::transparent);
+    QPainter painter(&target);
+    paintable.draw(0, 0, &painter);
+    painter.end();
+    EXPECT_FALSE(paintable.isRasterizing());
+    EXPECT_EQ(qRgb(255, 0, 0), target.pixel(0, 0));
+    EXPECT_EQ(0, WPixmapStore::finishDeferredRasterization());
+}
+
+TEST_F(PaintableTest, DestroyWhileRasterizing) {
+    WPixmapStore::beginDeferredRasterization();
+    {
+        Paintable paintable(svgSource(), Paintable::TILE, 4.0);
+        EXPECT_TRUE(paintable.isRasterizing());
+    }
+    EXPECT_EQ(0, WPixmapStore::finishDeferredRasterization());
+}
+
+} // namespace
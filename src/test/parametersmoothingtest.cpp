@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "engine/filters/enginefilterbiquad1.h"
+#include "engine/filters/enginefiltermoogladder4.h"
+#include "util/parametersmoothing.h"
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+constexpr double kQ = 0.707106781;
+constexpr int kBufferSize = 1024;
+
+std::vector<CSAMPLE> sineBuffer(int size, double frequency, int offset) {
+    std::vector<CSAMPLE> buffer(size);
+    for (int i = 0; i < size; ++i) {
+        buffer[i] = static_cast<CSAMPLE>(
+                std::sin(2 * M_PI * frequency * (offset + i / 2) / kSampleRate));
+    }
+    return buffer;
+}
+
+TEST(ParameterSmoothingTest, ForEachBlockCoversBuffer) {
+    std::vector<float> factors;
+    SINT nextFrame = 0;
+    ParameterSmoothing::forEachBlock<float>(100,
+            [&](float t, SINT offsetFrames, SINT blockFrames) {
+                EXPECT_EQ(nextFrame, offsetFrames);
+                EXPECT_LE(blockFrames, ParameterSmoothing::kControlFrames);
+                nextFrame = offsetFrames + blockFrames;
+                factors.push_back(t);
+            });
+    EXPECT_EQ(100, nextFrame);
+    ASSERT_EQ(4u, factors.size());
+    EXPECT_FLOAT_EQ(0.25f, factors[0]);
+    EXPECT_FLOAT_EQ(0.5f, factors[1]);
+    EXPECT_FLOAT_EQ(0.75f, factors[2]);
+    EXPECT_FLOAT_EQ(1.0f, factors[3]);
+}
+
+TEST(ParameterSmoothingTest, Interpolate) {
+    const double from[] = {0, 1, -2};
+    const double to[] = {1, 1, 2};
+    double values[3];
+    ParameterSmoothing::interpolate(values, from, to, 3, 0.25);
+    EXPECT_DOUBLE_EQ(0.25, values[0]);
+    EXPECT_DOUBLE_EQ(1, values[1]);
+    EXPECT_DOUBLE_EQ(-1, values[2]);
+}
+
+TEST(ParameterSmoothingTest, InterpolatedBiquadReachesNewCorner) {
+    EngineFilterBiquad1Low sweptFilter(kSampleRate, 500, kQ, true);
+    EngineFilterBiquad1Low filter(kSampleRate, 2000, kQ, true);
+    std::vector<CSAMPLE> sweptOut(kBufferSize);
+    std::vector<CSAMPLE> out(kBufferSize);
+    for (int i = 0; i < 16; ++i) {
+        if (i < 8) {
+            // Sweep the corner up while processing
+            sweptFilter.setFrequencyCorners(kSampleRate, 500 + 1500 * (i + 1) / 8.0, kQ);
+        }
+        const auto in = sineBuffer(kBufferSize, 1000, i * kBufferSize / 2);
+        sweptFilter.process(in.data(), sweptOut.data(), kBufferSize);
+        filter.process(in.data(), out.data(), kBufferSize);
+    }
+    for (int j = 0; j < kBufferSize; ++j) {
+        EXPECT_NEAR(out[j], sweptOut[j], 1e-5) << "sample " << j;
+    }
+}
+
+// Sweeps the corner of a biquad low pass with every buffer, either by
+// interpolating the coefficients or by crossfading to a restarted filter
+static void BM_Biquad1LowSweep(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    EngineFilterBiquad1Low filter(kSampleRate, 500, kQ, true);
+    filter.setCoefInterpolation(state.range(1) != 0);
+    const auto in = sineBuffer(size, 440, 0);
+    std::vector<CSAMPLE> out(size);
+    int step = 0;
+    for (auto _ : state) {
+        filter.setFrequencyCorners(kSampleRate, 500 + 10 * (step++ % 100), kQ);
+        filter.process(in.data(), out.data(), size);
+    }
+}
+
+void sweepArguments(benchmark::internal::Benchmark* pBenchmark) {
+    for (int interpolate = 0; interpolate <= 1; ++interpolate) {
+        for (int framesPerBuffer = 64; framesPerBuffer <= 4096; framesPerBuffer *= 8) {
+            pBenchmark->Args({framesPerBuffer * 2, interpolate});
+        }
+    }
+}
+
+BENCHMARK(BM_Biquad1LowSweep)->Apply(sweepArguments);
+
+static void BM_MoogLadder4LowSweep(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    EngineFilterMoogLadder4Low filter(kSampleRate, 500, 1);
+    const auto in = sineBuffer(size, 440, 0);
+    std::vector<CSAMPLE> out(size);
+    int step = 0;
+    for (auto _ : state) {
+        filter.setParameter(kSampleRate, 500.0f + 10 * (step++ % 100), 1);
+        filter.process(in.data(), out.data(), size);
+    }
+}
+BENCHMARK(BM_MoogLadder4LowSweep)->Range(64, 4096);
+
+} // namespace
@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "engine/filters/partitionedconvolver.h"
+#include "util/math.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr int kChannelCount = ConvolutionFilter::kChannelCount;
+
+// Deterministic noise in [-1, 1)
+std::vector<CSAMPLE> noise(SINT frames, unsigned int seed) {
+    std::vector<CSAMPLE> buffer(frames * kChannelCount);
+    unsigned int state = seed;
+    for (CSAMPLE& sample : buffer) {
+        state = state * 1664525u + 1013904223u;
+        sample = static_cast<CSAMPLE>(state >> 8) / static_cast<CSAMPLE>(1 << 23) - 1.0f;
+    }
+    return buffer;
+}
+
+// A decaying impulse response, an input and their direct convolution
+struct Signals {
+    Signals(SINT impulseFrames, SINT inputFrames)
+            : impulseFrames(impulseFrames),
+              inputFrames(inputFrames),
+              impulse(noise(impulseFrames, 1)),
+              input(noise(inputFrames, 2)),
+              convolved(inputFrames * kChannelCount) {
+        for (SINT frame = 0; frame < impulseFrames; ++frame) {
+            const auto gain = static_cast<CSAMPLE>(std::exp(-5.0 * frame / impulseFrames));
+            impulse[frame * kChannelCount] *= gain;
+            impulse[frame * kChannelCount + 1] *= gain;
+        }
+        for (SINT frame = 0; frame < inputFrames; ++frame) {
+            for (int channel = 0; channel < kChannelCount; ++channel) {
+                double sum = 0;
+                for (SINT i = math_max<SINT>(0, frame - impulseFrames + 1); i <= frame; ++i) {
+                    sum += input[i * kChannelCount + channel] *
+                            impulse[(frame - i) * kChannelCount + channel];
+                }
+                convolved[frame * kChannelCount + channel] = sum;
+            }
+        }
+    }
+
+    const SINT impulseFrames;
+    const SINT inputFrames;
+    std::vector<CSAMPLE> impulse;
+    const std::vector<CSAMPLE> input;
+    std::vector<double> convolved;
+};
+
+class PartitionedConvolverTest : public testing::Test {
+  protected:
+    // Processes the input in buffers of framesPerBuffer and compares the
+    // output to the direct convolution, delayed by one head block
+    void expectConvolution(const Signals& signals, SINT framesPerBuffer) {
+        const mixxx::EngineParameters engineParameters(kSampleRate, framesPerBuffer);
+        const ConvolutionPartitioning partitioning =
+                ConvolutionPartitioning::forFramesPerBuffer(framesPerBuffer);
+        const auto pFilter = std::make_shared<const ConvolutionFilter>(
+                signals.impulse.data(), signals.impulseFrames, partitioning);
+        PartitionedConvolver convolver(
+                [pFilter](mixxx::audio::SampleRate, ConvolutionPartitioning) {
+                    return pFilter;
+                },
+                engineParameters);
+
+        std::vector<CSAMPLE> output(signals.inputFrames * kChannelCount);
+        for (SINT frame = 0; frame + framesPerBuffer <= signals.inputFrames;
+                frame += framesPerBuffer) {
+            convolver.process(&signals.input[frame * kChannelCount],
+                    &output[frame * kChannelCount],
+                    engineParameters,
+                    1.0f,
+                    1.0f);
+            // The engine thread never waits, but the test must not depend on
+            // the speed of the background thread.
+            convolver.waitForBackgroundThread();
+        }
+
+        for (SINT frame = 0; frame < signals.inputFrames; ++frame) {
+            for (int channel = 0; channel < kChannelCount; ++channel) {
+                const SINT convolvedFrame = frame - partitioning.headBlockFrames;
+                const double expected = convolvedFrame < 0
+                        ? 0.0
+                        : signals.convolved[convolvedFrame * kChannelCount + channel];
+                ASSERT_NEAR(expected, output[frame * kChannelCount + channel], 1e-3)
+                        << "frames per buffer " << framesPerBuffer
+                        << " frame " << frame << " channel " << channel;
+            }
+        }
+    }
+};
+
+TEST_F(PartitionedConvolverTest, Partitioning) {
+    const ConvolutionPartitioning smallBuffers =
+            ConvolutionPartitioning::forFramesPerBuffer(64);
+    EXPECT_EQ(128, smallBuffers.headBlockFrames);
+    EXPECT_EQ(1024, smallBuffers.tailBlockFrames);
+    EXPECT_EQ(1920, smallBuffers.headFrames());
+
+    // The tail block is never shorter than an engine buffer
+    const ConvolutionPartitioning largeBuffers =
+            ConvolutionPartitioning::forFramesPerBuffer(3000);
+    EXPECT_EQ(4096, largeBuffers.tailBlockFrames);
+    EXPECT_EQ(512, largeBuffers.headBlockFrames);
+}
+
+TEST_F(PartitionedConvolverTest, HeadOnly) {
+    expectConvolution(Signals(1000, 8192), 256);
+}
+
+TEST_F(PartitionedConvolverTest, CommonBufferSizes) {
+    // The buffer sizes of commonArguments() in nativeeffects_test.cpp. They
+    // are shorter and longer than the head block, and the tail is convolved
+    // at all of them.
+    const Signals signals(20000, 32768);
+    for (SINT framesPerBuffer = 32; framesPerBuffer <= 4096; framesPerBuffer *= 2) {
+        expectConvolution(signals, framesPerBuffer);
+    }
+}
+
+TEST_F(PartitionedConvolverTest, ResetDiscardsSignal) {
+    const SINT framesPerBuffer = 512;
+    const mixxx::EngineParameters engineParameters(kSampleRate, framesPerBuffer);
+    const SINT impulseFrames = 6000;
+    const std::vector<CSAMPLE> impulse = noise(impulseFrames, 3);
+    const auto pFilter = std::make_shared<const ConvolutionFilter>(impulse.data(),
+            impulseFrames,
+            ConvolutionPartitioning::forFramesPerBuffer(framesPerBuffer));
+    PartitionedConvolver convolver(
+            [pFilter](mixxx::audio::SampleRate, ConvolutionPartitioning) {
+                return pFilter;
+            },
+            engineParameters);
+
+    const std::vector<CSAMPLE> input = noise(framesPerBuffer, 4);
+    std::vector<CSAMPLE> output(framesPerBuffer * kChannelCount);
+    for (int i = 0; i < 8; ++i) {
+        convolver.process(input.data(), output.data(), engineParameters, 1.0f, 1.0f);
+        convolver.waitForBackgroundThread();
+    }
+    convolver.reset();
+
+    const std::vector<CSAMPLE> silence(framesPerBuffer * kChannelCount);
+    for (int i = 0; i < 16; ++i) {
+        convolver.process(silence.data(), output.data(), engineParameters, 1.0f, 1.0f);
+        convolver.waitForBackgroundThread();
+        for (CSAMPLE sample : output) {
+            ASSERT_EQ(0.0f, sample) << "buffer " << i;
+        }
+    }
+}
+
+TEST_F(PartitionedConvolverTest, SampleRateChangeRebuildsFilter) {
+    const SINT framesPerBuffer = 256;
+    const SINT impulseFrames = 3000;
+    std::vector<mixxx::audio::SampleRate> requestedSampleRates;
+    PartitionedConvolver convolver(
+            [&](mixxx::audio::SampleRate sampleRate,
+                    ConvolutionPartitioning partitioning) {
+                requestedSampleRates.push_back(sampleRate);
+                const std::vector<CSAMPLE> impulse = noise(impulseFrames, 5);
+                return std::make_shared<const ConvolutionFilter>(
+                        impulse.data(), impulseFrames, partitioning);
+            },
+            mixxx::EngineParameters(kSampleRate, framesPerBuffer));
+
+    const mixxx::EngineParameters engineParameters(
+            mixxx::audio::SampleRate(48000), framesPerBuffer);
+    const std::vector<CSAMPLE> input = noise(framesPerBuffer, 6);
+    std::vector<CSAMPLE> output(framesPerBuffer * kChannelCount);
+    // The output is silent while the buffers are reallocated
+    convolver.process(input.data(), output.data(), engineParameters, 1.0f, 1.0f);
+    for (CSAMPLE sample : output) {
+        ASSERT_EQ(0.0f, sample);
+    }
+    convolver.waitForBackgroundThread();
+    ASSERT_EQ(2u, requestedSampleRates.size());
+    EXPECT_EQ(mixxx::audio::SampleRate(48000), requestedSampleRates[1]);
+
+    bool convolved = false;
+    for (int i = 0; i < 4; ++i) {
+        convolver.process(input.data(), output.data(), engineParameters, 1.0f, 1.0f);
+        convolver.waitForBackgroundThread();
+        for (CSAMPLE sample : output) {
+            convolved = convolved || sample != 0.0f;
+        }
+    }
+    EXPECT_TRUE(convolved);
+}
+
+} // namespace
@@ -303,6 +303,18 @@ TEST_F(SampleUtilTest, sumAbsPerChannel) {
     }
 }
 
+TEST_F(SampleUtilTest, isSilent) {
+    for (int i = 0; i < buffers.size(); ++i) {
+        CSAMPLE* buffer = buffers[i];
+        int size = sizes[i];
+        FillBuffer(buffer, 0.00001f, size);
+        EXPECT_TRUE(SampleUtil::isSilent(buffer, size, 0.0001f));
+        buffer[size - 1] = -0.0001f;
+        EXPECT_FALSE(SampleUtil::isSilent(buffer, size, 0.0001f));
+        EXPECT_TRUE(SampleUtil::isSilent(buffer, size - 1, 0.0001f));
+    }
+}
+
 TEST_F(SampleUtilTest, interleaveBuffer) {
     for (int i = 0; i < buffers.size(); ++i) {
         CSAMPLE* buffer = buffers[i];
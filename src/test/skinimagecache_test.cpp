@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QFile>
+#include <QImage>
+#include <QTemporaryDir>
+
+#include "skin/legacy/skinimagecache.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+class SkinImageCacheTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        SkinImageCache::setDirectory(m_tempDir.path());
+        int hits;
+        int misses;
+        SkinImageCache::takeStats(&hits, &misses);
+    }
+
+    void TearDown() override {
+        SkinImageCache::setDirectory(QString());
+    }
+
+    static QImage testImage() {
+        QImage image(7, 5, QImage::Format_ARGB32_Premultiplied);
+        for (int y = 0; y < image.height(); ++y) {
+            for (int x = 0; x < image.width(); ++x) {
+                image.setPixel(x, y, qRgba(x * 30, y * 40, 200, 255));
+            }
+        }
+        return image;
+    }
+
+    QString cacheFilePath(const QByteArray& key) const {
+        return m_tempDir.filePath(QString::fromLatin1(key) + QStringLiteral(".img"));
+    }
+
+    void setDaysSinceLastUse(const QByteArray& key, int days) {
+        QFile file(cacheFilePath(key));
+        ASSERT_TRUE(file.open(QIODevice::Append));
+        ASSERT_TRUE(file.setFileTime(QDateTime::currentDateTime().addDays(-days),
+                QFileDevice::FileModificationTime));
+    }
+
+    QTemporaryDir m_tempDir;
+};
+
+TEST_F(SkinImageCacheTest, StoreAndLoad) {
+    const QByteArray key = SkinImageCache::key("<svg/>", 1.0, QString());
+    EXPECT_TRUE(SkinImageCache::load(key).isNull());
+
+    const QImage image = testImage();
+    SkinImageCache::store(key, image);
+    EXPECT_EQ(image, SkinImageCache::load(key));
+
+    int hits;
+    int misses;
+    SkinImageCache::takeStats(&hits, &misses);
+    EXPECT_EQ(1, hits);
+    EXPECT_EQ(1, misses);
+}
+
+TEST_F(SkinImageCacheTest, KeyDependsOnScaleAndColorScheme) {
+    const QByteArray key = SkinImageCache::key("<svg/>", 1.0, QString());
+    EXPECT_EQ(key, SkinImageCache::key("<svg/>", 1.0, QString()));
+    EXPECT_NE(key, SkinImageCache::key("<svg />", 1.0, QString()));
+    EXPECT_NE(key, SkinImageCache::key("<svg/>", 2.0, QString()));
+    EXPECT_NE(key, SkinImageCache::key("<svg/>", 1.0, QStringLiteral("Dark")));
+}
+
+TEST_F(SkinImageCacheTest, PruneRemovesUnusedEntries) {
+    const QByteArray usedKey = SkinImageCache::key("<svg/>", 1.0, QString());
+    const QByteArray unusedKey = SkinImageCache::key("<svg/>", 2.0, QString());
+    SkinImageCache::store(usedKey, testImage());
+    SkinImageCache::store(unusedKey, testImage());
+    setDaysSinceLastUse(usedKey, 60);
+    setDaysSinceLastUse(unusedKey, 60);
+
+    // Loading marks the entry as used
+    EXPECT_FALSE(SkinImageCache::load(usedKey).isNull());
+    SkinImageCache::prune(30);
+
+    EXPECT_TRUE(QFile::exists(cacheFilePath(usedKey)));
+    EXPECT_FALSE(QFile::exists(cacheFilePath(unusedKey)));
+}
+
+TEST_F(SkinImageCacheTest, IgnoresCorruptFile) {
+    const QByteArray key = SkinImageCache::key("<svg/>", 1.0, QString());
+    SkinImageCache::store(key, testImage());
+
+    QFile file(cacheFilePath(key));
+    ASSERT_TRUE(file.resize(file.size() - 1));
+    EXPECT_TRUE(SkinImageCache::load(key).isNull());
+}
+
+TEST_F(SkinImageCacheTest, DisabledWithoutDirectory) {
+    SkinImageCache::setDirectory(QString());
+    EXPECT_FALSE(SkinImageCache::isEnabled());
+
+    const QByteArray key = SkinImageCache::key("<svg/>", 1.0, QString());
+    SkinImageCache::store(key, testImage());
+    EXPECT_TRUE(SkinImageCache::load(key).isNull());
+}
+
+} // namespace
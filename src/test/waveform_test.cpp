@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "util/math.h"
+#include "waveform/waveform.h"
+
+namespace {
+
+class WaveformTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        // 10 seconds of audio at 441 visual samples per second
+        m_pWaveform = std::make_unique<Waveform>(44100, 2 * 441000, 441, -1);
+        WaveformData* data = m_pWaveform->data();
+        for (int i = 0; i < m_pWaveform->getDataSize(); ++i) {
+            data[i].filtered.low = static_cast<unsigned char>(i % 251);
+            data[i].filtered.mid = static_cast<unsigned char>((i * 7) % 253);
+            data[i].filtered.high = static_cast<unsigned char>((i * 13) % 255);
+            data[i].filtered.all = static_cast<unsigned char>((i * 3) % 256);
+        }
+    }
+
+    void expectLevelIsMaximumOfBase(const Waveform& waveform, int level) {
+        const int factor = 1 << level;
+        const int baseFrames = waveform.getDataSize() / 2;
+        const WaveformData* base = waveform.data();
+        const WaveformData* reduced = waveform.mipmapData(level);
+        const int reducedFrames = waveform.getMipmapDataSize(level) / 2;
+        for (int frame = 0; frame < reducedFrames; ++frame) {
+            for (int channel = 0; channel < 2; ++channel) {
+                unsigned char low = 0;
+                unsigned char all = 0;
+                for (int i = frame * factor;
+                        i < math_min((frame + 1) * factor, baseFrames);
+                        ++i) {
+                    low = math_max(low, base[i * 2 + channel].filtered.low);
+                    all = math_max(all, base[i * 2 + channel].filtered.all);
+                }
+                ASSERT_EQ(low, reduced[frame * 2 + channel].filtered.low);
+                ASSERT_EQ(all, reduced[frame * 2 + channel].filtered.all);
+            }
+        }
+    }
+
+    std::unique_ptr<Waveform> m_pWaveform;
+};
+
+TEST_F(WaveformTest, mipmapLevelsHalveTheData) {
+    ASSERT_GT(m_pWaveform->getMipmapLevelCount(), 1);
+    for (int level = 1; level < m_pWaveform->getMipmapLevelCount(); ++level) {
+        const int frames = m_pWaveform->getMipmapDataSize(level - 1) / 2;
+        EXPECT_EQ((frames + 1) / 2 * 2, m_pWaveform->getMipmapDataSize(level));
+    }
+}
+
+TEST_F(WaveformTest, mipmapsKeepPerBandMaximum) {
+    m_pWaveform->setCompletion(m_pWaveform->getDataSize());
+    m_pWaveform->updateMipmaps();
+    for (int level = 1; level < m_pWaveform->getMipmapLevelCount(); ++level) {
+        expectLevelIsMaximumOfBase(*m_pWaveform, level);
+    }
+}
+
+TEST_F(WaveformTest, mipmapsUpdateIncrementally) {
+    const int dataSize = m_pWaveform->getDataSize();
+    for (int completion = 0; completion < dataSize; completion += 1234) {
+        m_pWaveform->setCompletion(completion);
+        m_pWaveform->updateMipmaps();
+    }
+    m_pWaveform->setCompletion(dataSize);
+    m_pWaveform->updateMipmaps();
+    for (int level = 1; level < m_pWaveform->getMipmapLevelCount(); ++level) {
+        expectLevelIsMaximumOfBase(*m_pWaveform, level);
+    }
+}
+
+TEST_F(WaveformTest, mipmapLevelForZoom) {
+    EXPECT_EQ(0, m_pWaveform->getMipmapLevelForVisualFramesPerPixel(0.5));
+    EXPECT_EQ(0, m_pWaveform->getMipmapLevelForVisualFramesPerPixel(1.9));
+    EXPECT_EQ(1, m_pWaveform->getMipmapLevelForVisualFramesPerPixel(2.0));
+    EXPECT_EQ(2, m_pWaveform->getMipmapLevelForVisualFramesPerPixel(5.0));
+    EXPECT_EQ(m_pWaveform->getMipmapLevelCount() - 1,
+            m_pWaveform->getMipmapLevelForVisualFramesPerPixel(1e9));
+}
+
+TEST_F(WaveformTest, mipmapsAreSerialized) {
+    m_pWaveform->setCompletion(m_pWaveform->getDataSize());
+    m_pWaveform->updateMipmaps();
+    const Waveform restored(m_pWaveform->toByteArray());
+    ASSERT_EQ(m_pWaveform->getMipmapLevelCount(), restored.getMipmapLevelCount());
+    for (int level = 1; level < restored.getMipmapLevelCount(); ++level) {
+        ASSERT_EQ(m_pWaveform->getMipmapDataSize(level), restored.getMipmapDataSize(level));
+        expectLevelIsMaximumOfBase(restored, level);
+    }
+}
+
+} // namespace
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <QImage>
+
+#include "waveform/renderers/waveformcolumnrasterizer.h"
+
+namespace {
+
+constexpr QRgb kRed = qRgb(255, 0, 0);
+constexpr QRgb kAxis = qRgb(128, 128, 128);
+
+class WaveformColumnRasterizerTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        WaveformColumnRasterizer::resizeImage(&m_image, 8, 10, 1.0);
+    }
+
+    QImage m_image;
+    WaveformColumnRasterizer m_rasterizer;
+};
+
+TEST_F(WaveformColumnRasterizerTest, WritesSpansAndAxis) {
+    m_rasterizer.begin(2, 3, 1.0);
+    m_rasterizer.setColumn(0, 2, 6, kRed);
+    // Reversed spans are accepted
+    m_rasterizer.setColumn(2, 8, 4, kRed);
+    m_rasterizer.rasterize(&m_image, 5, kAxis);
+
+    for (int y = 0; y < 10; ++y) {
+        // Columns outside of the batch are untouched
+        EXPECT_EQ(0u, m_image.pixel(0, y));
+        EXPECT_EQ(0u, m_image.pixel(5, y));
+        EXPECT_EQ(y >= 2 && y < 6 ? kRed : (y == 5 ? kAxis : 0u), m_image.pixel(2, y));
+        // An empty column only shows the axis
+        EXPECT_EQ(y == 5 ? kAxis : 0u, m_image.pixel(3, y));
+        EXPECT_EQ(y >= 4 && y < 8 ? kRed : (y == 5 ? kAxis : 0u), m_image.pixel(4, y));
+    }
+}
+
+TEST_F(WaveformColumnRasterizerTest, OverwritesPreviousContent) {
+    m_image.fill(kRed);
+    m_rasterizer.begin(0, 8, 1.0);
+    m_rasterizer.rasterize(&m_image, -1, kAxis);
+    for (int y = 0; y < 10; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            EXPECT_EQ(0u, m_image.pixel(x, y));
+        }
+    }
+}
+
+TEST_F(WaveformColumnRasterizerTest, ScalesWithDevicePixelRatio) {
+    WaveformColumnRasterizer::resizeImage(&m_image, 4, 5, 2.0);
+    ASSERT_EQ(8, m_image.width());
+    ASSERT_EQ(10, m_image.height());
+    m_rasterizer.begin(1, 1, 2.0);
+    m_rasterizer.setColumn(0, 1, 3, kRed);
+    m_rasterizer.rasterize(&m_image, -1, kAxis);
+    for (int y = 0; y < 10; ++y) {
+        const QRgb expected = y >= 2 && y < 6 ? kRed : 0u;
+        EXPECT_EQ(0u, m_image.pixel(1, y));
+        EXPECT_EQ(expected, m_image.pixel(2, y));
+        EXPECT_EQ(expected, m_image.pixel(3, y));
+        EXPECT_EQ(0u, m_image.pixel(4, y));
+    }
+}
+
+} // namespace
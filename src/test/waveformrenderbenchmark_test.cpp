@@ -0,0 +1,194 @@
+#include <benchmark/benchmark.h>
+
+#include <QDomDocument>
+#include <QImage>
+#include <QPainter>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "control/controlobject.h"
+#include "skin/legacy/skincontext.h"
+#include "track/track.h"
+#include "util/math.h"
+#include "waveform/renderers/qtwaveformrendererfilteredsignal.h"
+#include "waveform/renderers/waveformrendererfilteredsignal.h"
+#include "waveform/renderers/waveformrendererhsv.h"
+#include "waveform/renderers/waveformrendererrgb.h"
+#include "waveform/renderers/waveformwidgetrenderer.h"
+#include "waveform/waveform.h"
+#include "waveform/waveformwidgetfactory.h"
+
+// Offscreen render benchmarks for the QPainter based waveform types. Each
+// benchmark draws the signal of a fixed waveform into a 1920 px wide image,
+// advancing the play position by one 60 Hz frame per iteration like on a
+// playing deck. The "fps" counter reports the frames drawn per second.
+//
+// The argument is the zoom factor, i.e. the visual samples per pixel.
+
+namespace {
+
+constexpr int kWidth = 1920;
+constexpr int kHeight = 160;
+constexpr int kSampleRate = 44100;
+constexpr int kTrackSeconds = 180;
+constexpr int kTrackSamples = 2 * kSampleRate * kTrackSeconds;
+constexpr int kVisualSampleRate = 441;
+constexpr double kFrameSeconds = 1.0 / 60.0;
+
+const char* const kGroup = "[Channel1]";
+
+// The waveform of a track with a beat on every 500 ms and slowly changing
+// band levels, generated only once
+ConstWaveformPointer testWaveform() {
+    static const ConstWaveformPointer s_pWaveform = [] {
+        auto pWaveform = QSharedPointer<Waveform>::create(
+                kSampleRate, kTrackSamples, kVisualSampleRate, -1);
+        WaveformData* data = pWaveform->data();
+        const int dataSize = pWaveform->getDataSize();
+        for (int i = 0; i < dataSize; ++i) {
+            const double time = static_cast<double>(i / 2) / kVisualSampleRate;
+            const double beat = std::exp(-8.0 * std::fmod(time, 0.5));
+            const double phrase = 0.5 + 0.5 * std::sin(2 * M_PI * time / 16.0);
+            data[i].filtered.low = static_cast<unsigned char>(255 * beat);
+            data[i].filtered.mid = static_cast<unsigned char>(160 * phrase);
+            data[i].filtered.high = static_cast<unsigned char>(
+                    80 + 60 * std::sin(2 * M_PI * time * 7.0));
+            data[i].filtered.all = math_max3(data[i].filtered.low,
+                    data[i].filtered.mid,
+                    data[i].filtered.high);
+        }
+        pWaveform->setCompletion(dataSize);
+        pWaveform->updateMipmaps();
+        return ConstWaveformPointer(pWaveform);
+    }();
+    return s_pWaveform;
+}
+
+// The controls of a deck that the renderers read
+class DeckControls {
+  public:
+    DeckControls() {
+        const char* const keys[] = {"rate_ratio",
+                "total_gain",
+                "track_samples",
+                "filterWaveformEnable",
+                "filterLow",
+                "filterMid",
+                "filterHigh",
+                "filterLowKill",
+                "filterMidKill",
+                "filterHighKill"};
+        for (const char* key : keys) {
+            m_controls.push_back(std::make_unique<ControlObject>(ConfigKey(kGroup, key)));
+        }
+    }
+
+  private:
+    std::vector<std::unique_ptr<ControlObject>> m_controls;
+};
+
+// Provides the state that is otherwise calculated from the engine in
+// onPreRender()
+class BenchmarkWaveformRenderer : public WaveformWidgetRenderer {
+  public:
+    BenchmarkWaveformRenderer()
+            : WaveformWidgetRenderer(kGroup) {
+    }
+
+    void prepare(const TrackPointer& pTrack, double zoom) {
+        setTrack(pTrack);
+        m_trackSamples = kTrackSamples;
+        m_gain = 1.0;
+        m_rateRatio = 1.0;
+        m_zoomFactor = zoom;
+        m_visualSamplePerPixel = zoom;
+        m_audioVisualRatio = pTrack->getWaveform()->getAudioVisualRatio();
+        m_audioSamplePerPixel = m_visualSamplePerPixel * m_audioVisualRatio;
+        m_trackPixelCount = m_trackSamples / 2.0 / m_audioSamplePerPixel;
+    }
+
+    void setPlayPosition(double playPos) {
+        m_playPos = playPos;
+        const double displayedLength = getLength() / m_trackPixelCount;
+        m_firstDisplayedPosition = playPos - displayedLength * m_playMarkerPosition;
+        m_lastDisplayedPosition = playPos + displayedLength * (1.0 - m_playMarkerPosition);
+    }
+};
+
+QDomElement skinNode(QDomDocument* pDoc) {
+    QDomElement node = pDoc->createElement("Visual");
+    const char* const colors[][2] = {{"SignalColor", "#00a0ff"},
+            {"SignalLowColor", "#ff3300"},
+            {"SignalMidColor", "#ffaa00"},
+            {"SignalHighColor", "#ffffff"},
+            {"AxesColor", "#808080"}};
+    for (const auto& color : colors) {
+        QDomElement element = pDoc->createElement(color[0]);
+        element.appendChild(pDoc->createTextNode(color[1]));
+        node.appendChild(element);
+    }
+    return node;
+}
+
+WaveformWidgetFactory* waveformWidgetFactory() {
+    // Provides the visual gains and settings, never destroyed
+    static WaveformWidgetFactory* s_pFactory = WaveformWidgetFactory::createInstance();
+    return s_pFactory;
+}
+
+template<typename Renderer>
+void BM_WaveformRender(benchmark::State& state) {
+    waveformWidgetFactory();
+    const DeckControls controls;
+    const auto pConfig = UserSettingsPointer(new UserSettings(QString()));
+    const SkinContext context(pConfig, QString());
+    QDomDocument doc;
+
+    BenchmarkWaveformRenderer waveformRenderer;
+    Renderer* pRenderer = waveformRenderer.addRenderer<Renderer>();
+    if (!waveformRenderer.init()) {
+        state.SkipWithError("Failed to initialize the renderer");
+        return;
+    }
+    waveformRenderer.setup(skinNode(&doc), context);
+    waveformRenderer.resize(kWidth, kHeight, 1.0f);
+
+    auto pTrack = Track::newTemporary();
+    pTrack->setWaveform(testWaveform());
+    waveformRenderer.prepare(pTrack, static_cast<double>(state.range(0)));
+
+    QImage image(kWidth, kHeight, QImage::Format_ARGB32_Premultiplied);
+    const double frameAdvance = kFrameSeconds / kTrackSeconds;
+    double playPos = 0.1;
+    for (auto _ : state) {
+        waveformRenderer.setPlayPosition(playPos);
+        image.fill(Qt::black);
+        QPainter painter(&image);
+        pRenderer->draw(&painter, nullptr);
+        painter.end();
+        playPos += frameAdvance;
+        if (playPos > 0.9) {
+            playPos = 0.1;
+        }
+    }
+    state.counters["fps"] = benchmark::Counter(1, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK_TEMPLATE(BM_WaveformRender, WaveformRendererRGB)->Arg(1)->Arg(3)->Arg(10);
+BENCHMARK_TEMPLATE(BM_WaveformRender, WaveformRendererHSV)->Arg(1)->Arg(3)->Arg(10);
+BENCHMARK_TEMPLATE(BM_WaveformRender, WaveformRendererFilteredSignal)->Arg(1)->Arg(3)->Arg(10);
+BENCHMARK_TEMPLATE(BM_WaveformRender, QtWaveformRendererFilteredSignal)
+        ->Arg(1)
+        ->Arg(3)
+        ->Arg(10);
+
+// The RGB waveform redrawing all columns on every frame
+void BM_WaveformRenderRGBWithoutScrollingCache(benchmark::State& state) {
+    waveformWidgetFactory()->setScrollingCacheEnabled(false);
+    BM_WaveformRender<WaveformRendererRGB>(state);
+    waveformWidgetFactory()->setScrollingCacheEnabled(true);
+}
+BENCHMARK(BM_WaveformRenderRGBWithoutScrollingCache)->Arg(1)->Arg(3)->Arg(10);
+
+} // namespace
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <QHash>
+
+#include "test/mixxxtest.h"
+#include "waveform/renderers/waveformrendererabstract.h"
+#include "waveform/renderers/waveformwidgetrenderer.h"
+
+namespace {
+
+class TestRenderer : public WaveformRendererAbstract {
+  public:
+    explicit TestRenderer(WaveformWidgetRenderer* pWaveformWidgetRenderer)
+            : WaveformRendererAbstract(pWaveformWidgetRenderer),
+              m_value(0) {
+    }
+
+    void setup(const QDomNode&, const SkinContext&) override {
+    }
+    void draw(QPainter*, QPaintEvent*) override {
+    }
+    uint renderStateHash(uint seed) const override {
+        return qHash(m_value, seed);
+    }
+
+    int m_value;
+};
+
+class TestWaveformWidgetRenderer : public WaveformWidgetRenderer {
+  public:
+    TestWaveformWidgetRenderer()
+            : WaveformWidgetRenderer(QStringLiteral("[Channel1]")) {
+    }
+
+    bool nextFrame() {
+        updateRenderState();
+        return needsRender();
+    }
+};
+
+class WaveformRenderStateTest : public MixxxTest {
+  protected:
+    WaveformRenderStateTest()
+            : m_pRenderer(m_widgetRenderer.addRenderer<TestRenderer>()) {
+        // The first frame is always drawn
+        EXPECT_TRUE(m_widgetRenderer.nextFrame());
+    }
+
+    TestWaveformWidgetRenderer m_widgetRenderer;
+    TestRenderer* m_pRenderer;
+};
+
+TEST_F(WaveformRenderStateTest, SkipsUnchangedFrames) {
+    EXPECT_FALSE(m_widgetRenderer.nextFrame());
+    EXPECT_FALSE(m_widgetRenderer.nextFrame());
+
+    m_widgetRenderer.setPlayMarkerPosition(0.25);
+    EXPECT_TRUE(m_widgetRenderer.nextFrame());
+    EXPECT_FALSE(m_widgetRenderer.nextFrame());
+}
+
+TEST_F(WaveformRenderStateTest, RendererState) {
+    m_pRenderer->m_value = 1;
+    EXPECT_TRUE(m_widgetRenderer.nextFrame());
+    EXPECT_FALSE(m_widgetRenderer.nextFrame());
+}
+
+TEST_F(WaveformRenderStateTest, InvalidateFrame) {
+    m_widgetRenderer.invalidateFrame();
+    EXPECT_TRUE(m_widgetRenderer.nextFrame());
+    EXPECT_FALSE(m_widgetRenderer.nextFrame());
+
+    m_widgetRenderer.resize(100, 50, 1.0f);
+    EXPECT_TRUE(m_widgetRenderer.nextFrame());
+    EXPECT_FALSE(m_widgetRenderer.nextFrame());
+}
+
+TEST_F(WaveformRenderStateTest, RendersIdleFramesPeriodically) {
+    int renderedFrames = 0;
+    for (int i = 0; i < 600; ++i) {
+        if (m_widgetRenderer.nextFrame()) {
+            ++renderedFrames;
+        }
+    }
+    // About once per second at 60 FPS
+    EXPECT_GE(renderedFrames, 9);
+    EXPECT_LE(renderedFrames, 10);
+}
+
+} // namespace
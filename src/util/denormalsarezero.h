@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cfloat>
+
 // This was copied from the gcc header pmmintrin.h which requires SSE3
 // According to https://gcc.gnu.org/bugzilla/show_bug.cgi?id=21408
 // the DAZ bit is also available on SSE2
@@ -44,3 +46,34 @@
 #define _MM_GET_DENORMALS_ZERO_MODE()
 
 #endif
+
+namespace mixxx {
+
+/// Flushes denormals to zero in the calling thread. This avoids a performance
+/// penalty of ~20 in EQs and effects, see
+/// https://bugs.launchpad.net/mixxx/+bug/1404401
+/// Every thread that processes audio must call this once. Returns false if
+/// denormals are still computed.
+inline bool enableDenormalsAreZero() {
+#ifdef __SSE__
+    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+    _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+#endif
+
+#if defined(__aarch64__)
+    // Flush-to-zero on aarch64 is controlled by bit 24 of the Floating-point
+    // Control Register
+    unsigned long savedFPCR;
+    asm volatile("mrs %[savedFPCR], FPCR"
+                 : [ savedFPCR ] "=r"(savedFPCR));
+    asm volatile("msr FPCR, %[src]"
+                 :
+                 : [ src ] "r"(savedFPCR | (1UL << 24)));
+#endif
+
+    // Flush to zero or denormals to zero works if one of the two flags is set
+    volatile double doubleMin = DBL_MIN; // the smallest normalized double
+    return doubleMin / 2 == 0.0;
+}
+
+} // namespace mixxx
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "util/math.h"
+
+/// Approximations of math functions for the inner loops of DSP kernels.
+/// They are free of branches and library calls, so loops that call them
+/// are vectorized by the compiler.
+
+/// Selects the implementation of an effect or filter that has a vectorized
+/// kernel. The reference kernel is the original scalar implementation and
+/// is kept to verify the vectorized one. The effects use the reference
+/// kernels while the [Master],dsp_kernel control is set.
+enum class DspKernel {
+    Vectorized = 0,
+    Reference = 1,
+};
+
+/// tanh(x) with an absolute error below 1e-4, based on the continued
+/// fraction of Lambert that is exact enough up to |x| = 5 where it is clamped
+inline float fastTanh(float x) {
+    const float x2 = x * x;
+    const float y = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2))) /
+            (135135.0f + x2 * (62370.0f + x2 * (3150.0f + x2 * 28.0f)));
+    return math_min(math_max(y, -1.0f), 1.0f);
+}
+
+/// sin(2 * pi * cycles) for cycles in [0, 1) with an absolute error below
+/// 4e-6. This replaces the sine tables of LFOs without their memory lookups.
+inline float fastSinCycles(float cycles) {
+    // sin(2 * pi * cycles) = -sin(pi * t) with t in [-1, 1), folded to
+    // [-0.5, 0.5] where the Taylor series converges quickly
+    float t = 2.0f * cycles - 1.0f;
+    t = t > 0.5f ? 1.0f - t : t;
+    t = t < -0.5f ? -1.0f - t : t;
+    const float t2 = t * t;
+    return -t *
+            (3.14159265f +
+                    t2 * (-5.16771278f +
+                                 t2 * (2.55016404f +
+                                              t2 * (-0.59926453f +
+                                                           t2 * 0.08214589f))));
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "util/math.h"
+#include "util/platform.h"
+#include "util/types.h"
+
+/// Smoothing of effect and filter parameters at control rate.
+///
+/// When a parameter changes between two engine buffers, the buffer is
+/// processed in sub-blocks of kControlFrames frames and the parameter is
+/// interpolated linearly once per sub-block. Filters interpolate their
+/// coefficients this way instead of crossfading the outputs of an old and a
+/// new filter or recalculating the coefficients for every sample. The samples
+/// of a sub-block are processed with constant parameters in loops without
+/// branches.
+class ParameterSmoothing {
+  public:
+    /// 0.7 ms at 44.1 kHz, the steps are too short to be audible
+    static constexpr SINT kControlFrames = 32;
+
+    /// Calls processBlock(t, offsetFrames, blockFrames) for the consecutive
+    /// sub-blocks of a buffer with the given number of frames. The
+    /// interpolation factor t increases by the same step for every sub-block
+    /// and is 1 for the last one.
+    template<typename T, typename ProcessBlock>
+    static void forEachBlock(SINT frames, ProcessBlock&& processBlock) {
+        const SINT blocks = math_max<SINT>(
+                (frames + kControlFrames - 1) / kControlFrames, 1);
+        SINT offsetFrames = 0;
+        for (SINT block = 1; block <= blocks; ++block) {
+            const SINT blockFrames = math_min(kControlFrames, frames - offsetFrames);
+            processBlock(static_cast<T>(block) / static_cast<T>(blocks),
+                    offsetFrames,
+                    blockFrames);
+            offsetFrames += blockFrames;
+        }
+    }
+
+    /// pValues = pFrom + (pTo - pFrom) * t
+    template<typename T>
+    static void interpolate(T* M_RESTRICT pValues,
+            const T* M_RESTRICT pFrom,
+            const T* M_RESTRICT pTo,
+            int count,
+            T t) {
+        // note: LOOP VECTORIZED.
+        for (int i = 0; i < count; ++i) {
+            pValues[i] = pFrom[i] + (pTo[i] - pFrom[i]) * t;
+        }
+    }
+};
@@ -425,6 +425,16 @@ SampleUtil::CLIP_STATUS SampleUtil::sumAbsPerChannel(CSAMPLE* pfAbsL,
     return clipping;
 }
 
+// static
+bool SampleUtil::isSilent(const CSAMPLE* pBuffer, SINT numSamples, CSAMPLE threshold) {
+    // Counting instead of returning early keeps the loop vectorizable
+    CSAMPLE loud = 0;
+    for (SINT i = 0; i < numSamples; ++i) {
+        loud += fabs(pBuffer[i]) >= threshold ? 1 : 0;
+    }
+    return loud == 0;
+}
+
 // static
 void SampleUtil::copyClampBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc, SINT iNumSamples) {
@@ -0,0 +1,82 @@
+#include "util/wakesemaphore.h"
+
+#if defined(__LINUX__)
+#include <cerrno>
+#elif defined(__WINDOWS__)
+#include <windows.h>
+
+#include <climits>
+#endif
+
+#if defined(__LINUX__)
+
+WakeSemaphore::WakeSemaphore() {
+    sem_init(&m_semaphore, 0, 0);
+}
+
+WakeSemaphore::~WakeSemaphore() {
+    sem_destroy(&m_semaphore);
+}
+
+void WakeSemaphore::release() {
+    sem_post(&m_semaphore);
+}
+
+void WakeSemaphore::acquire() {
+    while (sem_wait(&m_semaphore) != 0 && errno == EINTR) {
+    }
+}
+
+#elif defined(__APPLE__)
+
+WakeSemaphore::WakeSemaphore()
+        : m_semaphore(dispatch_semaphore_create(0)) {
+}
+
+WakeSemaphore::~WakeSemaphore() {
+    dispatch_release(m_semaphore);
+}
+
+void WakeSemaphore::release() {
+    dispatch_semaphore_signal(m_semaphore);
+}
+
+void WakeSemaphore::acquire() {
+    dispatch_semaphore_wait(m_semaphore, DISPATCH_TIME_FOREVER);
+}
+
+#elif defined(__WINDOWS__)
+
+WakeSemaphore::WakeSemaphore()
+        : m_semaphore(CreateSemaphore(nullptr, 0, LONG_MAX, nullptr)) {
+}
+
+WakeSemaphore::~WakeSemaphore() {
+    CloseHandle(m_semaphore);
+}
+
+void WakeSemaphore::release() {
+    ReleaseSemaphore(m_semaphore, 1, nullptr);
+}
+
+void WakeSemaphore::acquire() {
+    WaitForSingleObject(m_semaphore, INFINITE);
+}
+
+#else
+
+WakeSemaphore::WakeSemaphore() {
+}
+
+WakeSemaphore::~WakeSemaphore() {
+}
+
+void WakeSemaphore::release() {
+    m_semaphore.release();
+}
+
+void WakeSemaphore::acquire() {
+    m_semaphore.acquire();
+}
+
+#endif
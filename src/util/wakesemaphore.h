@@ -0,0 +1,39 @@
+#pragma once
+
+#if defined(__LINUX__)
+#include <semaphore.h>
+#elif defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#elif !defined(__WINDOWS__)
+#include <QSemaphore>
+#endif
+
+#include "util/class.h"
+
+/// A counting semaphore that wakes a sleeping thread without taking a lock in
+/// the waking thread. QSemaphore::release() locks a mutex that may be held by
+/// the woken thread, which would block the engine thread. The threads that
+/// help the engine thread are woken with this.
+class WakeSemaphore {
+  public:
+    WakeSemaphore();
+    ~WakeSemaphore();
+
+    /// Never blocks
+    void release();
+    void acquire();
+
+  private:
+#if defined(__LINUX__)
+    sem_t m_semaphore;
+#elif defined(__APPLE__)
+    dispatch_semaphore_t m_semaphore;
+#elif defined(__WINDOWS__)
+    // A HANDLE, without including windows.h here
+    void* m_semaphore;
+#else
+    QSemaphore m_semaphore;
+#endif
+
+    DISALLOW_COPY_AND_ASSIGN(WakeSemaphore);
+};
@@ -0,0 +1,300 @@
+#include "waveform/frametimerecorder.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "util/assert.h"
+#include "util/time.h"
+
+namespace {
+
+constexpr int kTracePid = 1;
+constexpr int kTraceTid = 1;
+// Followed by one thread for every widget
+constexpr int kOffscreenTraceTid = 2;
+
+FrameTimeRecorder::Percentiles percentiles(std::vector<mixxx::Duration>* pDurations) {
+    FrameTimeRecorder::Percentiles result;
+    if (pDurations->empty()) {
+        return result;
+    }
+    std::sort(pDurations->begin(), pDurations->end());
+    const auto nearestRank = [pDurations](double percentile) {
+        const auto rank = static_cast<std::size_t>(
+                std::ceil(percentile * pDurations->size()));
+        return (*pDurations)[std::max<std::size_t>(rank, 1) - 1];
+    };
+    result.p50 = nearestRank(0.5);
+    result.p95 = nearestRank(0.95);
+    result.p99 = nearestRank(0.99);
+    result.max = pDurations->back();
+    return result;
+}
+
+QJsonObject completeEvent(const QString& name,
+        mixxx::Duration start,
+        mixxx::Duration duration,
+        int tid = kTraceTid) {
+    return QJsonObject{
+            {QStringLiteral("name"), name},
+            {QStringLiteral("ph"), QStringLiteral("X")},
+            {QStringLiteral("ts"), start.toDoubleMicros()},
+            {QStringLiteral("dur"), duration.toDoubleMicros()},
+            {QStringLiteral("pid"), kTracePid},
+            {QStringLiteral("tid"), tid},
+    };
+}
+
+QJsonObject threadNameEvent(const QString& name, int tid) {
+    return QJsonObject{
+            {QStringLiteral("name"), QStringLiteral("thread_name")},
+            {QStringLiteral("ph"), QStringLiteral("M")},
+            {QStringLiteral("pid"), kTracePid},
+            {QStringLiteral("tid"), tid},
+            {QStringLiteral("args"),
+                    QJsonObject{{QStringLiteral("name"), name}}},
+    };
+}
+
+} // anonymous namespace
+
+FrameTimeRecorder::FrameTimeRecorder()
+        : m_currentIndex(kFrameCount - 1),
+          m_frameCount(0),
+          m_lastDroppedFramesTotal(0),
+          m_offscreenCurrentIndex(kOffscreenFrameCount - 1),
+          m_offscreenFrameCount(0) {
+}
+
+void FrameTimeRecorder::beginRender() {
+    m_currentIndex = (m_currentIndex + 1) % kFrameCount;
+    m_frameCount = std::min(m_frameCount + 1, kFrameCount);
+    // Reset in place, the widget arrays are only valid up to widgetCount
+    Frame& frame = currentFrame();
+    frame.renderStart = mixxx::Time::elapsed();
+    frame.renderDuration = mixxx::Duration();
+    frame.swapStart = mixxx::Duration();
+    frame.swapDuration = mixxx::Duration();
+    frame.widgetCount = 0;
+    frame.droppedFrames = 0;
+}
+
+void FrameTimeRecorder::widgetRendered(int index, mixxx::Duration start) {
+    if (m_frameCount == 0 || index < 0 || index >= kMaxWidgets) {
+        return;
+    }
+    Frame& frame = currentFrame();
+    // Skipped widgets are recorded with a zero duration
+    for (int i = frame.widgetCount; i < index; ++i) {
+        frame.widgetRenderStart[i] = start;
+        frame.widgetRenderDuration[i] = mixxx::Duration();
+    }
+    frame.widgetRenderStart[index] = start;
+    frame.widgetRenderDuration[index] = mixxx::Time::elapsed() - start;
+    frame.widgetCount = std::max(frame.widgetCount, index + 1);
+}
+
+void FrameTimeRecorder::endRender(int droppedFramesTotal) {
+    if (m_frameCount == 0) {
+        return;
+    }
+    Frame& frame = currentFrame();
+    frame.renderDuration = mixxx::Time::elapsed() - frame.renderStart;
+    // The VSyncThread resets its counter when the sync mode changes
+    frame.droppedFrames = droppedFramesTotal >= m_lastDroppedFramesTotal
+            ? droppedFramesTotal - m_lastDroppedFramesTotal
+            : droppedFramesTotal;
+    m_lastDroppedFramesTotal = droppedFramesTotal;
+}
+
+void FrameTimeRecorder::beginSwap() {
+    if (m_frameCount == 0) {
+        return;
+    }
+    currentFrame().swapStart = mixxx::Time::elapsed();
+}
+
+void FrameTimeRecorder::endSwap() {
+    if (m_frameCount == 0) {
+        return;
+    }
+    Frame& frame = currentFrame();
+    frame.swapDuration = mixxx::Time::elapsed() - frame.swapStart;
+}
+
+void FrameTimeRecorder::offscreenWidgetRendered(int index,
+        mixxx::Duration start,
+        mixxx::Duration duration) {
+    if (index < 0 || index >= kMaxWidgets) {
+        return;
+    }
+    m_offscreenCurrentIndex = (m_offscreenCurrentIndex + 1) % kOffscreenFrameCount;
+    m_offscreenFrameCount = std::min(m_offscreenFrameCount + 1, kOffscreenFrameCount);
+    OffscreenFrame& frame = m_offscreenFrames[m_offscreenCurrentIndex];
+    frame.widgetIndex = index;
+    frame.start = start;
+    frame.duration = duration;
+}
+
+const FrameTimeRecorder::Frame& FrameTimeRecorder::frame(int index) const {
+    DEBUG_ASSERT(index >= 0 && index < m_frameCount);
+    const int oldestIndex = (m_currentIndex - m_frameCount + 1 + kFrameCount) % kFrameCount;
+    return m_frames[(oldestIndex + index) % kFrameCount];
+}
+
+const FrameTimeRecorder::OffscreenFrame& FrameTimeRecorder::offscreenFrame(
+        int index) const {
+    DEBUG_ASSERT(index >= 0 && index < m_offscreenFrameCount);
+    const int oldestIndex = (m_offscreenCurrentIndex - m_offscreenFrameCount + 1 +
+                                    kOffscreenFrameCount) %
+            kOffscreenFrameCount;
+    return m_offscreenFrames[(oldestIndex + index) % kOffscreenFrameCount];
+}
+
+void FrameTimeRecorder::clear() {
+    m_frameCount = 0;
+    m_offscreenFrameCount = 0;
+}
+
+FrameTimeRecorder::Percentiles FrameTimeRecorder::renderPercentiles() const {
+    std::vector<mixxx::Duration> durations;
+    durations.reserve(m_frameCount);
+    for (int i = 0; i < m_frameCount; ++i) {
+        durations.push_back(frame(i).renderDuration);
+    }
+    return percentiles(&durations);
+}
+
+FrameTimeRecorder::Percentiles FrameTimeRecorder::widgetRenderPercentiles(
+        int widgetIndex) const {
+    std::vector<mixxx::Duration> durations;
+    durations.reserve(m_frameCount);
+    for (int i = 0; i < m_frameCount; ++i) {
+        const Frame& recordedFrame = frame(i);
+        // Frames that skipped the widget are recorded with a zero duration
+        if (widgetIndex < recordedFrame.widgetCount &&
+                recordedFrame.widgetRenderDuration[widgetIndex] != mixxx::Duration()) {
+            durations.push_back(recordedFrame.widgetRenderDuration[widgetIndex]);
+        }
+    }
+    return percentiles(&durations);
+}
+
+FrameTimeRecorder::Percentiles FrameTimeRecorder::offscreenRenderPercentiles(
+        int widgetIndex) const {
+    std::vector<mixxx::Duration> durations;
+    durations.reserve(m_offscreenFrameCount);
+    for (int i = 0; i < m_offscreenFrameCount; ++i) {
+        const OffscreenFrame& recordedFrame = offscreenFrame(i);
+        if (recordedFrame.widgetIndex == widgetIndex) {
+            durations.push_back(recordedFrame.duration);
+        }
+    }
+    return percentiles(&durations);
+}
+
+FrameTimeRecorder::Percentiles FrameTimeRecorder::renderToSwapPercentiles() const {
+    std::vector<mixxx::Duration> durations;
+    durations.reserve(m_frameCount);
+    for (int i = 0; i < m_frameCount; ++i) {
+        const Frame& recordedFrame = frame(i);
+        if (recordedFrame.isSwapped()) {
+            durations.push_back(recordedFrame.swapStart -
+                    recordedFrame.renderStart - recordedFrame.renderDuration);
+        }
+    }
+    return percentiles(&durations);
+}
+
+int FrameTimeRecorder::droppedFrames() const {
+    int droppedFrames = 0;
+    for (int i = 0; i < m_frameCount; ++i) {
+        droppedFrames += frame(i).droppedFrames;
+    }
+    return droppedFrames;
+}
+
+double FrameTimeRecorder::guiThreadBusyRatio() const {
+    if (m_frameCount < 2) {
+        return 0.0;
+    }
+    // The time of the last frame is not known, it is excluded
+    mixxx::Duration busy;
+    for (int i = 0; i < m_frameCount - 1; ++i) {
+        const Frame& recordedFrame = frame(i);
+        busy += recordedFrame.renderDuration + recordedFrame.swapDuration;
+    }
+    const mixxx::Duration total =
+            frame(m_frameCount - 1).renderStart - frame(0).renderStart;
+    if (total <= mixxx::Duration()) {
+        return 0.0;
+    }
+    return busy.toDoubleNanos() / total.toDoubleNanos();
+}
+
+QByteArray FrameTimeRecorder::toChromeTrace(const QStringList& widgetNames) const {
+    const auto widgetName = [&widgetNames](int widget) {
+        return widget < widgetNames.size()
+                ? widgetNames[widget]
+                : QStringLiteral("waveform %1").arg(widget);
+    };
+    QJsonArray events;
+    events.append(threadNameEvent(QStringLiteral("GUI"), kTraceTid));
+    for (int i = 0; i < m_frameCount; ++i) {
+        const Frame& recordedFrame = frame(i);
+        events.append(completeEvent(QStringLiteral("render"),
+                recordedFrame.renderStart,
+                recordedFrame.renderDuration));
+        for (int widget = 0; widget < recordedFrame.widgetCount; ++widget) {
+            if (recordedFrame.widgetRenderDuration[widget] == mixxx::Duration()) {
+                continue;
+            }
+            events.append(completeEvent(widgetName(widget),
+                    recordedFrame.widgetRenderStart[widget],
+                    recordedFrame.widgetRenderDuration[widget]));
+        }
+        if (recordedFrame.isSwapped()) {
+            events.append(completeEvent(QStringLiteral("swap"),
+                    recordedFrame.swapStart,
+                    recordedFrame.swapDuration));
+        }
+        if (recordedFrame.droppedFrames > 0) {
+            events.append(QJsonObject{
+                    {QStringLiteral("name"), QStringLiteral("dropped frames")},
+                    {QStringLiteral("ph"), QStringLiteral("i")},
+                    {QStringLiteral("s"), QStringLiteral("t")},
+                    {QStringLiteral("ts"), recordedFrame.renderStart.toDoubleMicros()},
+                    {QStringLiteral("pid"), kTracePid},
+                    {QStringLiteral("tid"), kTraceTid},
+                    {QStringLiteral("args"),
+                            QJsonObject{{QStringLiteral("count"),
+                                    recordedFrame.droppedFrames}}},
+            });
+        }
+    }
+    std::array<bool, kMaxWidgets> hasOffscreenThread{};
+    for (int i = 0; i < m_offscreenFrameCount; ++i) {
+        const OffscreenFrame& recordedFrame = offscreenFrame(i);
+        const int tid = kOffscreenTraceTid + recordedFrame.widgetIndex;
+        if (!hasOffscreenThread[recordedFrame.widgetIndex]) {
+            hasOffscreenThread[recordedFrame.widgetIndex] = true;
+            events.append(threadNameEvent(
+                    QStringLiteral("WaveformRender %1")
+                            .arg(widgetName(recordedFrame.widgetIndex)),
+                    tid));
+        }
+        events.append(completeEvent(widgetName(recordedFrame.widgetIndex),
+                recordedFrame.start,
+                recordedFrame.duration,
+                tid));
+    }
+    return QJsonDocument(QJsonObject{
+                                 {QStringLiteral("traceEvents"), events},
+                                 {QStringLiteral("displayTimeUnit"), QStringLiteral("ms")},
+                         })
+            .toJson(QJsonDocument::Compact);
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <QByteArray>
+#include <QStringList>
+#include <array>
+
+#include "util/duration.h"
+
+/// Records the timing of the frames rendered by WaveformWidgetFactory for
+/// the developer tools.
+///
+/// The records are kept in a ring of fixed size that is allocated once, so
+/// recording does not allocate and can stay enabled during a live
+/// performance. Widgets that are rendered offscreen by the
+/// WaveformRenderThread are recorded in a second ring, because their frames
+/// are not aligned with the frames of the GUI thread. All functions must be
+/// called from the GUI thread.
+class FrameTimeRecorder {
+  public:
+    static constexpr int kMaxWidgets = 8;
+    static constexpr int kFrameCount = 1024;
+    static constexpr int kOffscreenFrameCount = kFrameCount * kMaxWidgets;
+
+    /// All times are relative to the start of Mixxx, see mixxx::Time.
+    struct Frame {
+        mixxx::Duration renderStart;
+        mixxx::Duration renderDuration;
+        mixxx::Duration swapStart;
+        mixxx::Duration swapDuration;
+        std::array<mixxx::Duration, kMaxWidgets> widgetRenderStart;
+        std::array<mixxx::Duration, kMaxWidgets> widgetRenderDuration;
+        int widgetCount = 0;
+        /// The VSyncThread frames that were missed since the previous frame
+        int droppedFrames = 0;
+
+        bool isSwapped() const {
+            return swapStart > renderStart;
+        }
+    };
+
+    /// A frame of a single widget rendered by the WaveformRenderThread
+    struct OffscreenFrame {
+        int widgetIndex = 0;
+        mixxx::Duration start;
+        mixxx::Duration duration;
+    };
+
+    struct Percentiles {
+        mixxx::Duration p50;
+        mixxx::Duration p95;
+        mixxx::Duration p99;
+        mixxx::Duration max;
+    };
+
+    FrameTimeRecorder();
+
+    void beginRender();
+    /// The widget with the index has been rendered starting at the given time.
+    void widgetRendered(int index, mixxx::Duration start);
+    /// The total count of dropped frames is reported by the VSyncThread.
+    void endRender(int droppedFramesTotal);
+    void beginSwap();
+    void endSwap();
+    /// The widget with the index has been rendered by the WaveformRenderThread.
+    void offscreenWidgetRendered(int index,
+            mixxx::Duration start,
+            mixxx::Duration duration);
+
+    /// The number of recorded frames, at most kFrameCount
+    int frameCount() const {
+        return m_frameCount;
+    }
+    /// The frame with index 0 is the oldest recorded frame.
+    const Frame& frame(int index) const;
+    /// The number of recorded offscreen frames, at most kOffscreenFrameCount
+    int offscreenFrameCount() const {
+        return m_offscreenFrameCount;
+    }
+    /// The offscreen frame with index 0 is the oldest recorded one.
+    const OffscreenFrame& offscreenFrame(int index) const;
+    void clear();
+
+    Percentiles renderPercentiles() const;
+    /// The time the GUI thread spent rendering the widget. For widgets that
+    /// are rendered offscreen this is the time to draw the finished image.
+    Percentiles widgetRenderPercentiles(int widgetIndex) const;
+    Percentiles offscreenRenderPercentiles(int widgetIndex) const;
+    /// The time from the end of rendering until the swap starts
+    Percentiles renderToSwapPercentiles() const;
+    int droppedFrames() const;
+    /// The fraction of the recorded time the GUI thread spent in the render
+    /// and swap slots.
+    double guiThreadBusyRatio() const;
+
+    /// Returns the recorded frames in the Chrome trace event format, which
+    /// can be loaded into chrome://tracing or Perfetto. The offscreen frames
+    /// of every widget are shown as a separate thread, because the widgets
+    /// are rendered in parallel.
+    QByteArray toChromeTrace(const QStringList& widgetNames) const;
+
+  private:
+    Frame& currentFrame() {
+        return m_frames[m_currentIndex];
+    }
+
+    std::array<Frame, kFrameCount> m_frames;
+    int m_currentIndex;
+    int m_frameCount;
+    int m_lastDroppedFramesTotal;
+
+    std::array<OffscreenFrame, kOffscreenFrameCount> m_offscreenFrames;
+    int m_offscreenCurrentIndex;
+    int m_offscreenFrameCount;
+};
@@ -2,6 +2,7 @@
 
 #include "waveform/guitick.h"
 #include "control/controlobject.h"
+#include "control/controlupdatecoalescer.h"
 
 GuiTick::GuiTick() {
     m_pCOGuiTickTime = std::make_unique<ControlObject>(ConfigKey("[Master]", "guiTickTime"));
@@ -20,4 +21,7 @@ void GuiTick::process() {
         m_lastUpdateTime = m_cpuTimeLastTick;
         m_pCOGuiTick50ms->set(cpuTimeLastTickSeconds);
     }
+
+    // Deliver the control changes of the engine to the widgets once per frame
+    ControlUpdateCoalescer::process();
 }
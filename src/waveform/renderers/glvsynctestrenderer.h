@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QHash>
+
 #include "waveform/renderers/glwaveformrenderer.h"
 #if !defined(QT_NO_OPENGL) && !defined(QT_OPENGL_ES_2)
 
@@ -16,6 +18,10 @@ class GLVSyncTestRenderer : public WaveformRendererSignalBase,
 
     virtual void onSetup(const QDomNode &node);
     virtual void draw(QPainter* painter, QPaintEvent* event);
+    uint renderStateHash(uint seed) const override {
+        // Changes with every frame, the test pattern is drawn continuously
+        return qHash(m_drawcount, seed);
+    }
 private:
     int m_drawcount;
 };
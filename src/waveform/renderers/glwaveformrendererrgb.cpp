@@ -37,12 +37,12 @@ void GLWaveformRendererRGB::draw(QPainter* painter, QPaintEvent* /*event*/) {
         return;
     }
 
-    const int dataSize = waveform->getDataSize();
+    int dataSize = 0;
+    const WaveformData* data = getWaveformDataForZoom(*waveform, &dataSize);
     if (dataSize <= 1) {
         return;
     }
 
-    const WaveformData* data = waveform->data();
     if (data == nullptr) {
         return;
     }
@@ -52,7 +52,7 @@ void GLWaveformRendererRGB::draw(QPainter* painter, QPaintEvent* /*event*/) {
     auto lastVisualIndex = static_cast<GLfloat>(
             m_waveformRenderer->getLastDisplayedPosition() * dataSize);
     const auto lineWidth = static_cast<GLfloat>(
-            (1.0 / m_waveformRenderer->getVisualSamplePerPixel()) + 1.5);
+            (1.0 / getVisualSamplePerPixelForZoom(*waveform, dataSize)) + 1.5);
 
     const auto firstIndex = static_cast<int>(firstVisualIndex + 0.5);
     firstVisualIndex = firstIndex - firstIndex % 2;
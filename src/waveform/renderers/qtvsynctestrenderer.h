@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QHash>
+
 #include "waveformrenderersignalbase.h"
 
 class ControlObject;
@@ -11,6 +13,10 @@ class QtVSyncTestRenderer : public WaveformRendererSignalBase {
 
     virtual void onSetup(const QDomNode &node);
     virtual void draw(QPainter* painter, QPaintEvent* event);
+    uint renderStateHash(uint seed) const override {
+        // Changes with every frame, the test pattern is drawn continuously
+        return qHash(m_drawcount, seed);
+    }
   private:
     int m_drawcount;
 };
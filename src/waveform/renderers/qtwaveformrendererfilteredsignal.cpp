@@ -107,12 +107,12 @@ int QtWaveformRendererFilteredSignal::buildPolygon() {
         return 0;
     }
 
-    const int dataSize = waveform->getDataSize();
+    int dataSize = 0;
+    const WaveformData* data = getWaveformDataForZoom(*waveform, &dataSize);
     if (dataSize <= 1) {
         return 0;
     }
 
-    const WaveformData* data = waveform->data();
     if (data == nullptr) {
         return 0;
     }
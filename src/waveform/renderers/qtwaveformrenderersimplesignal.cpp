@@ -49,12 +49,12 @@ void QtWaveformRendererSimpleSignal::draw(QPainter* painter, QPaintEvent* /*even
         return;
     }
 
-    const int dataSize = waveform->getDataSize();
+    int dataSize = 0;
+    const WaveformData* data = getWaveformDataForZoom(*waveform, &dataSize);
     if (dataSize <= 1) {
         return;
     }
 
-    const WaveformData* data = waveform->data();
     if (data == nullptr) {
         return;
     }
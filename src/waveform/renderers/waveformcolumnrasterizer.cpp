@@ -0,0 +1,92 @@
+#include "waveform/renderers/waveformcolumnrasterizer.h"
+
+#include <QImage>
+#include <algorithm>
+#include <cmath>
+
+#include "util/assert.h"
+#include "util/math.h"
+
+WaveformColumnRasterizer::WaveformColumnRasterizer()
+        : m_devicePixelRatio(1.0),
+          m_x(0),
+          m_firstDeviceColumn(0) {
+}
+
+// static
+bool WaveformColumnRasterizer::resizeImage(
+        QImage* pImage, int length, int breadth, qreal devicePixelRatio) {
+    const int width = static_cast<int>(length * devicePixelRatio);
+    const int height = static_cast<int>(breadth * devicePixelRatio);
+    if (!pImage->isNull() &&
+            pImage->devicePixelRatio() == devicePixelRatio &&
+            pImage->width() == width &&
+            pImage->height() == height) {
+        return false;
+    }
+    *pImage = QImage(width, height, QImage::Format_ARGB32_Premultiplied);
+    pImage->setDevicePixelRatio(devicePixelRatio);
+    pImage->fill(Qt::transparent);
+    return true;
+}
+
+int WaveformColumnRasterizer::deviceColumn(int logicalColumn) const {
+    return static_cast<int>(std::floor(logicalColumn * m_devicePixelRatio));
+}
+
+void WaveformColumnRasterizer::begin(int x, int columnCount, qreal devicePixelRatio) {
+    m_devicePixelRatio = devicePixelRatio;
+    m_x = x;
+    m_firstDeviceColumn = deviceColumn(x);
+    const int deviceColumnCount = deviceColumn(x + columnCount) - m_firstDeviceColumn;
+    // Empty spans
+    m_top.assign(deviceColumnCount, 0);
+    m_bottom.assign(deviceColumnCount, 0);
+    m_color.assign(deviceColumnCount, 0);
+}
+
+void WaveformColumnRasterizer::setColumn(int column, float top, float bottom, QRgb color) {
+    const int first = deviceColumn(m_x + column) - m_firstDeviceColumn;
+    const int last = math_min(deviceColumn(m_x + column + 1) - m_firstDeviceColumn,
+            static_cast<int>(m_top.size()));
+    if (first < 0 || first >= last) {
+        return;
+    }
+    if (top > bottom) {
+        std::swap(top, bottom);
+    }
+    const auto deviceTop = static_cast<qint32>(std::lround(top * m_devicePixelRatio));
+    const auto deviceBottom = static_cast<qint32>(std::lround(bottom * m_devicePixelRatio));
+    std::fill(m_top.begin() + first, m_top.begin() + last, deviceTop);
+    std::fill(m_bottom.begin() + first, m_bottom.begin() + last, deviceBottom);
+    std::fill(m_color.begin() + first, m_color.begin() + last, qPremultiply(color));
+}
+
+void WaveformColumnRasterizer::rasterize(QImage* pImage, float axis, QRgb axisColor) const {
+    VERIFY_OR_DEBUG_ASSERT(pImage->format() == QImage::Format_ARGB32_Premultiplied) {
+        return;
+    }
+    const int count = math_min(static_cast<int>(m_top.size()),
+            pImage->width() - m_firstDeviceColumn);
+    if (count <= 0 || m_firstDeviceColumn < 0) {
+        return;
+    }
+    const qint32* pTop = m_top.data();
+    const qint32* pBottom = m_bottom.data();
+    const quint32* pColor = m_color.data();
+    const int axisRow = static_cast<int>(axis * m_devicePixelRatio);
+    const quint32 premultipliedAxisColor = qPremultiply(axisColor);
+
+    for (qint32 row = 0; row < pImage->height(); ++row) {
+        quint32* pLine = reinterpret_cast<quint32*>(pImage->scanLine(row)) +
+                m_firstDeviceColumn;
+        const quint32 background = row == axisRow ? premultipliedAxisColor : 0;
+        // LOOP VECTORIZED: The select is done with a bit mask, a conditional
+        // expression would prevent the vectorization.
+        for (int i = 0; i < count; ++i) {
+            const quint32 mask = 0u -
+                    static_cast<quint32>((row >= pTop[i]) & (row < pBottom[i]));
+            pLine[i] = (pColor[i] & mask) | (background & ~mask);
+        }
+    }
+}
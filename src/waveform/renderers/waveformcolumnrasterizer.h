@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QRgb>
+#include <QtGlobal>
+#include <vector>
+
+QT_FORWARD_DECLARE_CLASS(QImage)
+
+/// Writes the one pixel wide columns of a waveform directly into the
+/// scanlines of a QImage instead of drawing a QPainter line per column.
+///
+/// The columns are collected first, then each scanline of the target is
+/// written in a single branch-free pass over all columns, which the compiler
+/// vectorizes. The target must be a horizontal (length x breadth) image in
+/// QImage::Format_ARGB32_Premultiplied, vertical waveforms are drawn by
+/// rotating it when compositing.
+class WaveformColumnRasterizer {
+  public:
+    WaveformColumnRasterizer();
+
+    /// (Re)creates a transparent target image for length x breadth logical
+    /// pixels if it does not match. Returns true if it was (re)created.
+    static bool resizeImage(QImage* pImage, int length, int breadth, qreal devicePixelRatio);
+
+    /// Starts a new batch of columnCount logical columns, beginning at the
+    /// logical column x of the target image.
+    void begin(int x, int columnCount, qreal devicePixelRatio);
+
+    /// Sets the span [top, bottom) in logical pixels across the breadth
+    /// and the color of a column of the current batch. Columns that are not
+    /// set stay empty.
+    void setColumn(int column, float top, float bottom, QRgb color);
+
+    /// Writes the current batch into the image. All pixels of the covered
+    /// columns are overwritten: with the column color inside of the spans,
+    /// with axisColor on the axis row and transparent elsewhere.
+    void rasterize(QImage* pImage, float axis, QRgb axisColor) const;
+
+  private:
+    int deviceColumn(int logicalColumn) const;
+
+    qreal m_devicePixelRatio;
+    int m_x;
+    int m_firstDeviceColumn;
+    // Structure of arrays with one entry per device column
+    std::vector<qint32> m_top;
+    std::vector<qint32> m_bottom;
+    std::vector<quint32> m_color;
+};
@@ -4,6 +4,7 @@
 #include "widget/wskincolor.h"
 #include "widget/wwidget.h"
 #include "widget/wimagestore.h"
+#include "util/assert.h"
 
 WaveformRenderBackground::WaveformRenderBackground(
     WaveformWidgetRenderer* waveformWidgetRenderer)
@@ -22,17 +23,28 @@ void WaveformRenderBackground::setup(const QDomNode& node,
         m_backgroundPixmapPath = context.makeSkinPath(backgroundPixmapPath);
     }
     setDirty(true);
+    if (m_waveformRenderer->getWidth() > 0 && m_waveformRenderer->getHeight() > 0) {
+        generateImage();
+    }
+}
+
+void WaveformRenderBackground::onResize() {
+    // The image is generated here on the GUI thread rather than on next
+    // paint, because the waveform may be drawn on the WaveformRenderThread
+    // and WImageStore is not thread-safe.
+    generateImage();
 }
 
 void WaveformRenderBackground::draw(QPainter* painter,
                                     QPaintEvent* /*event*/) {
-    if (isDirty()) {
-        generateImage();
-    }
+    // Only before the first resize
+    DEBUG_ASSERT(!isDirty() ||
+            m_waveformRenderer->getWidth() <= 0 ||
+            m_waveformRenderer->getHeight() <= 0);
 
     // If there is no background image, just fill the painter with the
     // background color.
-    if (m_backgroundImage.isNull()) {
+    if (isDirty() || m_backgroundImage.isNull()) {
         painter->fillRect(0, 0, m_waveformRenderer->getWidth(),
                           m_waveformRenderer->getHeight(), m_backgroundColor);
         return;
@@ -18,6 +18,7 @@ class WaveformRenderBackground : public WaveformRendererAbstract {
 
     virtual void setup(const QDomNode& node, const SkinContext& context);
     virtual void draw(QPainter* painter, QPaintEvent* event);
+    void onResize() override;
 
   private:
     void generateImage();
@@ -1,4 +1,5 @@
 #include <QDomNode>
+#include <QHash>
 #include <QPaintEvent>
 #include <QPainter>
 
@@ -24,6 +25,15 @@ void WaveformRenderBeat::setup(const QDomNode& node, const SkinContext& context)
     m_beatColor = WSkinColor::getCorrectColor(m_beatColor).toRgb();
 }
 
+uint WaveformRenderBeat::renderStateHash(uint seed) const {
+    TrackPointer trackInfo = m_waveformRenderer->getTrackInfo();
+    if (!trackInfo) {
+        return seed;
+    }
+    // Beats are immutable, every change creates a new object
+    return qHash(trackInfo->getBeats().get(), seed);
+}
+
 void WaveformRenderBeat::draw(QPainter* painter, QPaintEvent* /*event*/) {
     TrackPointer trackInfo = m_waveformRenderer->getTrackInfo();
 
@@ -13,6 +13,7 @@ class WaveformRenderBeat : public WaveformRendererAbstract {
 
     virtual void setup(const QDomNode& node, const SkinContext& context);
     virtual void draw(QPainter* painter, QPaintEvent* event);
+    uint renderStateHash(uint seed) const override;
 
   private:
     QColor m_beatColor;
@@ -21,6 +21,16 @@ class WaveformRendererAbstract {
 
     virtual void onResize() {}
     virtual void onSetTrack() {}
+    /// Called from the GUI thread after the color of a mark has changed
+    virtual void onMarksChanged() {}
+
+    /// Mixes the state this renderer draws into the seed, unless it is
+    /// already covered by the play position and zoom of the
+    /// WaveformWidgetRenderer. Frames are skipped while the hash of all
+    /// renderers does not change.
+    virtual uint renderStateHash(uint seed) const {
+        return seed;
+    }
 
   protected:
     bool isDirty() const {
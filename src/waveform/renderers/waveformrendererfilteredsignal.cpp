@@ -40,12 +40,12 @@ void WaveformRendererFilteredSignal::draw(QPainter* painter,
         return;
     }
 
-    const int dataSize = waveform->getDataSize();
+    int dataSize = 0;
+    const WaveformData* data = getWaveformDataForZoom(*waveform, &dataSize);
     if (dataSize <= 1) {
         return;
     }
 
-    const WaveformData* data = waveform->data();
     if (data == nullptr) {
         return;
     }
@@ -222,7 +222,8 @@ void WaveformRendererFilteredSignal::draw(QPainter* painter,
         }
     }
 
-    double lineThickness = math_max(1.0, 1.0 / m_waveformRenderer->getVisualSamplePerPixel());
+    double lineThickness = math_max(1.0,
+            1.0 / getVisualSamplePerPixelForZoom(*waveform, dataSize));
 
     painter->setPen(QPen(QBrush(m_pColors->getLowColor()), lineThickness, Qt::SolidLine, Qt::FlatCap));
     if (m_pLowKillControlObject && m_pLowKillControlObject->get() == 0.0) {
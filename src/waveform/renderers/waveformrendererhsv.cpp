@@ -1,5 +1,7 @@
 #include "waveformrendererhsv.h"
 
+#include <QPainter>
+
 #include "waveformwidgetrenderer.h"
 #include "waveform/waveform.h"
 #include "waveform/waveformwidgetfactory.h"
@@ -21,6 +23,10 @@ void WaveformRendererHSV::onSetup(const QDomNode& node) {
     Q_UNUSED(node);
 }
 
+void WaveformRendererHSV::onResize() {
+    m_frameImage = QImage();
+}
+
 void WaveformRendererHSV::draw(QPainter* painter,
                                           QPaintEvent* /*event*/) {
     const TrackPointer trackInfo = m_waveformRenderer->getTrackInfo();
@@ -33,12 +39,12 @@ void WaveformRendererHSV::draw(QPainter* painter,
         return;
     }
 
-    const int dataSize = waveform->getDataSize();
+    int dataSize = 0;
+    const WaveformData* data = getWaveformDataForZoom(*waveform, &dataSize);
     if (dataSize <= 1) {
         return;
     }
 
-    const WaveformData* data = waveform->data();
     if (data == nullptr) {
         return;
     }
@@ -78,20 +84,22 @@ void WaveformRendererHSV::draw(QPainter* painter,
     QColor color;
     float lo, hi, total;
 
-    QPen pen;
-    pen.setCapStyle(Qt::FlatCap);
-    pen.setWidthF(math_max(1.0, 1.0 / m_waveformRenderer->getVisualSamplePerPixel()));
-
+    const int length = m_waveformRenderer->getLength();
     const int breadth = m_waveformRenderer->getBreadth();
     const float halfBreadth = static_cast<float>(breadth) / 2.0f;
 
     const float heightFactor = allGain * halfBreadth / 255.0f;
 
-    //draw reference line
-    painter->setPen(m_pColors->getAxesColor());
-    painter->drawLine(QLineF(0, halfBreadth, m_waveformRenderer->getLength(), halfBreadth));
+    // The columns are written into the scanlines of an image that is
+    // composited in one go. All columns are rewritten, so a reused image
+    // needs no clearing.
+    WaveformColumnRasterizer::resizeImage(&m_frameImage,
+            length,
+            breadth,
+            painter->device()->devicePixelRatioF());
+    m_rasterizer.begin(0, length, m_frameImage.devicePixelRatio());
 
-    for (int x = 0; x < m_waveformRenderer->getLength(); ++x) {
+    for (int x = 0; x < length; ++x) {
         // Width of the x position in visual indices.
         const double xSampleWidth = gain * x;
 
@@ -161,27 +169,31 @@ void WaveformRendererHSV::draw(QPainter* painter,
             // Set color
             color.setHsvF(h, 1.0-hi, 1.0-lo);
 
-            pen.setColor(color);
-
-            painter->setPen(pen);
             switch (m_alignment) {
                 case Qt::AlignBottom :
                 case Qt::AlignRight :
-                    painter->drawLine(
-                        x, breadth,
-                        x, breadth - (int)(heightFactor * (float)math_max(maxAll[0],maxAll[1])));
+                    m_rasterizer.setColumn(x,
+                            breadth - (int)(heightFactor * (float)math_max(maxAll[0], maxAll[1])),
+                            breadth,
+                            color.rgb());
                     break;
                 case Qt::AlignTop :
                 case Qt::AlignLeft :
-                    painter->drawLine(
-                        x, 0,
-                        x, (int)(heightFactor * (float)math_max(maxAll[0],maxAll[1])));
+                    m_rasterizer.setColumn(x,
+                            0,
+                            (int)(heightFactor * (float)math_max(maxAll[0], maxAll[1])),
+                            color.rgb());
                     break;
                 default :
-                    painter->drawLine(
-                        x, (int)(halfBreadth - heightFactor * (float)maxAll[0]),
-                        x, (int)(halfBreadth + heightFactor * (float)maxAll[1]));
+                    m_rasterizer.setColumn(x,
+                            (int)(halfBreadth - heightFactor * (float)maxAll[0]),
+                            (int)(halfBreadth + heightFactor * (float)maxAll[1]),
+                            color.rgb());
             }
         }
     }
+
+    // Also draws the reference line below the columns
+    m_rasterizer.rasterize(&m_frameImage, halfBreadth, m_pColors->getAxesColor().rgba());
+    painter->drawImage(QRectF(0, 0, length, breadth), m_frameImage);
 }
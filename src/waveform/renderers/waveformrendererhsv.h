@@ -1,18 +1,26 @@
 #pragma once
 
+#include <QImage>
+
 #include "util/class.h"
+#include "waveform/renderers/waveformcolumnrasterizer.h"
 #include "waveformrenderersignalbase.h"
 
 class WaveformRendererHSV : public WaveformRendererSignalBase {
   public:
     explicit WaveformRendererHSV(
         WaveformWidgetRenderer* waveformWidget);
-    virtual ~WaveformRendererHSV();
+    ~WaveformRendererHSV() override;
+
+    void onSetup(const QDomNode& node) override;
 
-    virtual void onSetup(const QDomNode& node);
+    void draw(QPainter* painter, QPaintEvent* event) override;
 
-    virtual void draw(QPainter* painter, QPaintEvent* event);
+    void onResize() override;
 
   private:
+    WaveformColumnRasterizer m_rasterizer;
+    QImage m_frameImage;
+
     DISALLOW_COPY_AND_ASSIGN(WaveformRendererHSV);
 };
@@ -1,5 +1,8 @@
 #include "waveformrendererrgb.h"
 
+#include <QPainter>
+#include <iterator>
+
 #include "waveformwidgetrenderer.h"
 #include "waveform/waveform.h"
 #include "waveform/waveformwidgetfactory.h"
@@ -9,9 +12,29 @@
 #include "util/math.h"
 #include "util/painterscope.h"
 
+namespace {
+
+// Gains that differ by less than this are considered equal. The zoom is
+// recomputed from the displayed positions on every frame and jitters in
+// the last digits.
+constexpr double kRingGainTolerance = 1e-9;
+
+inline int ringIndex(qint64 column, int length) {
+    const int index = static_cast<int>(column % length);
+    return index < 0 ? index + length : index;
+}
+
+} // anonymous namespace
+
 WaveformRendererRGB::WaveformRendererRGB(
         WaveformWidgetRenderer* waveformWidgetRenderer)
-        : WaveformRendererSignalBase(waveformWidgetRenderer) {
+        : WaveformRendererSignalBase(waveformWidgetRenderer),
+          m_ringFirstColumn(0),
+          m_ringGain(0.0),
+          m_ringData(nullptr),
+          m_ringDataSize(0),
+          m_ringCompletion(0),
+          m_ringGains{} {
 }
 
 WaveformRendererRGB::~WaveformRendererRGB() {
@@ -20,6 +43,15 @@ WaveformRendererRGB::~WaveformRendererRGB() {
 void WaveformRendererRGB::onSetup(const QDomNode& /* node */) {
 }
 
+void WaveformRendererRGB::onResize() {
+    m_frameImage = QImage();
+    m_ringImage = QImage();
+}
+
+void WaveformRendererRGB::onSetTrack() {
+    m_ringImage = QImage();
+}
+
 void WaveformRendererRGB::draw(QPainter* painter,
                                           QPaintEvent* /*event*/) {
     const TrackPointer trackInfo = m_waveformRenderer->getTrackInfo();
@@ -32,12 +64,12 @@ void WaveformRendererRGB::draw(QPainter* painter,
         return;
     }
 
-    const int dataSize = waveform->getDataSize();
+    int dataSize = 0;
+    const WaveformData* data = getWaveformDataForZoom(*waveform, &dataSize);
     if (dataSize <= 1) {
         return;
     }
 
-    const WaveformData* data = waveform->data();
     if (data == nullptr) {
         return;
     }
@@ -57,37 +89,129 @@ void WaveformRendererRGB::draw(QPainter* painter,
     const double firstVisualIndex = m_waveformRenderer->getFirstDisplayedPosition() * dataSize;
     const double lastVisualIndex = m_waveformRenderer->getLastDisplayedPosition() * dataSize;
 
-    const double offset = firstVisualIndex;
-
     // Represents the # of waveform data points per horizontal pixel.
     const double gain = (lastVisualIndex - firstVisualIndex) /
             (double)m_waveformRenderer->getLength();
 
+    if (WaveformWidgetFactory::instance()->isScrollingCacheEnabled() && gain > 0.0) {
+        drawScrollingCache(painter, *waveform, data, dataSize, firstVisualIndex, gain);
+        return;
+    }
+
+    const int length = m_waveformRenderer->getLength();
+    const int breadth = m_waveformRenderer->getBreadth();
+    const qreal devicePixelRatio = painter->device()->devicePixelRatioF();
+    // All columns are rewritten, so a reused image needs no clearing
+    WaveformColumnRasterizer::resizeImage(&m_frameImage, length, breadth, devicePixelRatio);
+    rasterizeColumns(&m_frameImage, data, dataSize, 0, length, firstVisualIndex, gain);
+    painter->drawImage(QRectF(0, 0, length, breadth), m_frameImage);
+}
+
+void WaveformRendererRGB::drawScrollingCache(QPainter* painter,
+        const Waveform& waveform,
+        const WaveformData* data,
+        int dataSize,
+        double firstVisualIndex,
+        double gain) {
+    const int length = m_waveformRenderer->getLength();
+    const int breadth = m_waveformRenderer->getBreadth();
+    if (length <= 0 || breadth <= 0) {
+        return;
+    }
+    const qreal devicePixelRatio = painter->device()->devicePixelRatioF();
+
+    float gains[4];
+    getGains(&gains[0], &gains[1], &gains[2], &gains[3]);
+
+    // Everything needs to be redrawn if the mapping from columns to
+    // waveform data or the appearance of the columns has changed.
+    const bool resized = WaveformColumnRasterizer::resizeImage(
+            &m_ringImage, length, breadth, devicePixelRatio);
+    const bool invalidate = resized ||
+            std::abs(gain - m_ringGain) > kRingGainTolerance * gain ||
+            data != m_ringData ||
+            dataSize != m_ringDataSize ||
+            waveform.getCompletion() != m_ringCompletion ||
+            !std::equal(std::begin(gains), std::end(gains), std::begin(m_ringGains));
+    if (invalidate) {
+        m_ringGain = gain;
+        m_ringData = data;
+        m_ringDataSize = dataSize;
+        m_ringCompletion = waveform.getCompletion();
+        std::copy(std::begin(gains), std::end(gains), std::begin(m_ringGains));
+    }
+
+    // Scrolling is quantized to whole columns
+    const qint64 firstColumn = static_cast<qint64>(std::floor(firstVisualIndex / m_ringGain));
+    const qint64 scrolledColumns = firstColumn - m_ringFirstColumn;
+    if (invalidate || std::abs(scrolledColumns) >= length) {
+        drawRingColumns(data, dataSize, firstColumn, length);
+    } else if (scrolledColumns > 0) {
+        drawRingColumns(data, dataSize, m_ringFirstColumn + length,
+                static_cast<int>(scrolledColumns));
+    } else if (scrolledColumns < 0) {
+        drawRingColumns(data, dataSize, firstColumn,
+                static_cast<int>(-scrolledColumns));
+    }
+    m_ringFirstColumn = firstColumn;
+
+    // Composite the ring buffer starting at the first visible column
+    const int wrap = ringIndex(firstColumn, length);
+    painter->drawImage(QRectF(0, 0, length - wrap, breadth),
+            m_ringImage,
+            QRectF(wrap * devicePixelRatio,
+                    0,
+                    (length - wrap) * devicePixelRatio,
+                    breadth * devicePixelRatio));
+    if (wrap > 0) {
+        painter->drawImage(QRectF(length - wrap, 0, wrap, breadth),
+                m_ringImage,
+                QRectF(0, 0, wrap * devicePixelRatio, breadth * devicePixelRatio));
+    }
+}
+
+void WaveformRendererRGB::drawRingColumns(const WaveformData* data,
+        int dataSize,
+        qint64 firstColumn,
+        int columnCount) {
+    const int length = m_waveformRenderer->getLength();
+    // The columns might wrap around the end of the ring buffer
+    while (columnCount > 0) {
+        const int x = ringIndex(firstColumn, length);
+        const int count = math_min(columnCount, length - x);
+        rasterizeColumns(&m_ringImage,
+                data,
+                dataSize,
+                x,
+                count,
+                firstColumn * m_ringGain,
+                m_ringGain);
+        firstColumn += count;
+        columnCount -= count;
+    }
+}
+
+void WaveformRendererRGB::rasterizeColumns(QImage* pImage,
+        const WaveformData* data,
+        int dataSize,
+        int x,
+        int columnCount,
+        double firstVisualIndex,
+        double gain) {
     // Per-band gain from the EQ knobs.
     float allGain(1.0), lowGain(1.0), midGain(1.0), highGain(1.0);
     getGains(&allGain, &lowGain, &midGain, &highGain);
 
-    QColor color;
-
-    QPen pen;
-    pen.setCapStyle(Qt::FlatCap);
-    pen.setWidthF(math_max(1.0, 1.0 / m_waveformRenderer->getVisualSamplePerPixel()));
-
     const int breadth = m_waveformRenderer->getBreadth();
     const float halfBreadth = static_cast<float>(breadth) / 2.0f;
 
     const float heightFactor = allGain * halfBreadth / sqrtf(255 * 255 * 3);
 
-    // Draw reference line
-    painter->setPen(m_pColors->getAxesColor());
-    painter->drawLine(QLineF(0, halfBreadth, m_waveformRenderer->getLength(), halfBreadth));
-
-    for (int x = 0; x < m_waveformRenderer->getLength(); ++x) {
-        // Width of the x position in visual indices.
-        const double xSampleWidth = gain * x;
+    m_rasterizer.begin(x, columnCount, pImage->devicePixelRatio());
 
+    for (int column = 0; column < columnCount; ++column) {
         // Effective visual index of x
-        const double xVisualSampleIndex = xSampleWidth + offset;
+        const double xVisualSampleIndex = gain * column + firstVisualIndex;
 
         // Our current pixel (x) corresponds to a number of visual samples
         // (visualSamplerPerPixel) in our waveform object. We take the max of
@@ -150,30 +274,34 @@ void WaveformRendererRGB::draw(QPainter* painter,
 
         // Prevent division by zero
         if (max > 0.0f) {
-            // Set color
-            color.setRgbF(red / max, green / max, blue / max);
-
-            pen.setColor(color);
-
-            painter->setPen(pen);
+            // Normalized color
+            const QRgb color = qRgb(static_cast<int>(255 * red / max + 0.5),
+                    static_cast<int>(255 * green / max + 0.5),
+                    static_cast<int>(255 * blue / max + 0.5));
             switch (m_alignment) {
                 case Qt::AlignBottom:
                 case Qt::AlignRight:
-                    painter->drawLine(
-                        x, breadth,
-                        x, breadth - (int)(heightFactor * sqrtf(math_max(maxAll, maxAllNext))));
+                    m_rasterizer.setColumn(column,
+                            breadth - (int)(heightFactor * sqrtf(math_max(maxAll, maxAllNext))),
+                            breadth,
+                            color);
                     break;
                 case Qt::AlignTop:
                 case Qt::AlignLeft:
-                    painter->drawLine(
-                        x, 0,
-                        x, (int)(heightFactor * sqrtf(math_max(maxAll, maxAllNext))));
+                    m_rasterizer.setColumn(column,
+                            0,
+                            (int)(heightFactor * sqrtf(math_max(maxAll, maxAllNext))),
+                            color);
                     break;
                 default:
-                    painter->drawLine(
-                        x, (int)(halfBreadth - heightFactor * sqrtf(maxAll)),
-                        x, (int)(halfBreadth + heightFactor * sqrtf(maxAllNext)));
+                    m_rasterizer.setColumn(column,
+                            (int)(halfBreadth - heightFactor * sqrtf(maxAll)),
+                            (int)(halfBreadth + heightFactor * sqrtf(maxAllNext)),
+                            color);
             }
         }
     }
+
+    // Also draws the reference line below the columns
+    m_rasterizer.rasterize(pImage, halfBreadth, m_pColors->getAxesColor().rgba());
 }
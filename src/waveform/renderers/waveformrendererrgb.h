@@ -1,17 +1,59 @@
 #pragma once
 
+#include <QImage>
+
 #include "util/class.h"
+#include "waveform/renderers/waveformcolumnrasterizer.h"
 #include "waveformrenderersignalbase.h"
 
 class WaveformRendererRGB : public WaveformRendererSignalBase {
   public:
     explicit WaveformRendererRGB(
         WaveformWidgetRenderer* waveformWidget);
-    virtual ~WaveformRendererRGB();
+    ~WaveformRendererRGB() override;
+
+    void onSetup(const QDomNode& node) override;
+    void draw(QPainter* painter, QPaintEvent* event) override;
 
-    virtual void onSetup(const QDomNode& node);
-    virtual void draw(QPainter* painter, QPaintEvent* event);
+    void onResize() override;
+    void onSetTrack() override;
 
   private:
+    // Writes columnCount columns starting at x into the image, replacing
+    // its previous content. The column at x shows the data around
+    // firstVisualIndex and each following column advances by gain visual
+    // indices.
+    void rasterizeColumns(QImage* pImage,
+            const WaveformData* data,
+            int dataSize,
+            int x,
+            int columnCount,
+            double firstVisualIndex,
+            double gain);
+
+    // Scrolling cache: The columns are drawn into a ring buffer that is
+    // indexed by the absolute column number modulo its length. While
+    // scrolling only the newly exposed columns need to be drawn.
+    void drawScrollingCache(QPainter* painter,
+            const Waveform& waveform,
+            const WaveformData* data,
+            int dataSize,
+            double firstVisualIndex,
+            double gain);
+    void drawRingColumns(const WaveformData* data,
+            int dataSize,
+            qint64 firstColumn,
+            int columnCount);
+
+    WaveformColumnRasterizer m_rasterizer;
+    QImage m_frameImage;
+    QImage m_ringImage;
+    qint64 m_ringFirstColumn;
+    double m_ringGain;
+    const WaveformData* m_ringData;
+    int m_ringDataSize;
+    int m_ringCompletion;
+    float m_ringGains[4];
+
     DISALLOW_COPY_AND_ASSIGN(WaveformRendererRGB);
 };
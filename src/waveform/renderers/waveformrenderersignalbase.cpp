@@ -226,3 +226,25 @@ void WaveformRendererSignalBase::getGains(float* pAllGain, float* pLowGain,
         }
     }
 }
+
+const WaveformData* WaveformRendererSignalBase::getWaveformDataForZoom(
+        const Waveform& waveform, int* pDataSize) const {
+    const int length = m_waveformRenderer->getLength();
+    int level = 0;
+    if (length > 0) {
+        const double visualFramesPerPixel =
+                (m_waveformRenderer->getLastDisplayedPosition() -
+                        m_waveformRenderer->getFirstDisplayedPosition()) *
+                waveform.getDataSize() / 2.0 / length;
+        level = waveform.getMipmapLevelForVisualFramesPerPixel(visualFramesPerPixel);
+    }
+    *pDataSize = waveform.getMipmapDataSize(level);
+    return waveform.mipmapData(level);
+}
+
+double WaveformRendererSignalBase::getVisualSamplePerPixelForZoom(
+        const Waveform& waveform, int dataSize) const {
+    // Each level covers the whole track with fewer visual samples
+    return m_waveformRenderer->getVisualSamplePerPixel() * dataSize /
+            waveform.getDataSize();
+}
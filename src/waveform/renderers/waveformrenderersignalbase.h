@@ -3,6 +3,7 @@
 #include "waveformrendererabstract.h"
 #include "waveformsignalcolors.h"
 #include "skin/legacy/skincontext.h"
+#include "waveform/waveform.h"
 
 class ControlObject;
 class ControlProxy;
@@ -24,6 +25,17 @@ public:
     void getGains(float* pAllGain, float* pLowGain, float* pMidGain,
                   float* highGain);
 
+    // Returns the data of the coarsest level of the waveform pyramid that still
+    // has at least one visual frame per pixel at the current zoom and stores
+    // its size in pDataSize. Positions relative to the track map onto the
+    // returned data the same way as onto the full resolution data.
+    const WaveformData* getWaveformDataForZoom(
+            const Waveform& waveform, int* pDataSize) const;
+    // Returns the visual samples per pixel of the data of dataSize that has
+    // been returned by getWaveformDataForZoom(), instead of those of the full
+    // resolution data.
+    double getVisualSamplePerPixelForZoom(const Waveform& waveform, int dataSize) const;
+
   protected:
     ControlProxy* m_pEQEnabled;
     ControlProxy* m_pLowFilterControlObject;
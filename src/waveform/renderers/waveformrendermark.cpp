@@ -1,6 +1,7 @@
 #include "waveform/renderers/waveformrendermark.h"
 
 #include <QDomNode>
+#include <QHash>
 #include <QPainter>
 #include <QPainterPath>
 
@@ -28,6 +29,9 @@ WaveformRenderMark::WaveformRenderMark(
 void WaveformRenderMark::setup(const QDomNode& node, const SkinContext& context) {
     WaveformSignalColors signalColors = *m_waveformRenderer->getWaveformSignalColors();
     m_marks.setup(m_waveformRenderer->getGroup(), node, context, signalColors);
+    if (m_waveformRenderer->getWidth() > 0 && m_waveformRenderer->getHeight() > 0) {
+        onResize();
+    }
 }
 
 void WaveformRenderMark::draw(QPainter* painter, QPaintEvent* /*event*/) {
@@ -53,10 +57,13 @@ void WaveformRenderMark::draw(QPainter* painter, QPaintEvent* /*event*/) {
             continue;
         }
 
-        // Generate image on first paint can't be done in setup since we need to
-        // wait for the render widget to be resized yet.
+        // The images are generated on the GUI thread on resize, because the
+        // waveform may be drawn on the WaveformRenderThread.
         if (pMark->m_image.isNull()) {
-            generateMarkImage(pMark);
+            // Only before the first resize
+            DEBUG_ASSERT(m_waveformRenderer->getWidth() <= 0 ||
+                    m_waveformRenderer->getHeight() <= 0);
+            continue;
         }
 
         const double samplePosition = pMark->getSamplePosition();
@@ -157,10 +164,32 @@ void WaveformRenderMark::draw(QPainter* painter, QPaintEvent* /*event*/) {
     m_waveformRenderer->setMarkPositions(marksOnScreen);
 }
 
+uint WaveformRenderMark::renderStateHash(uint seed) const {
+    for (const auto& pMark : m_marks) {
+        seed = qHash(pMark->getSamplePosition(), seed);
+        seed = qHash(pMark->getSampleEndPosition(), seed);
+        seed = qHash(static_cast<int>(pMark->isVisible()), seed);
+    }
+    return seed;
+}
+
 void WaveformRenderMark::onResize() {
-    // Delete all marks' images. New images will be created on next paint.
+    // Regenerate all marks' images for the new size. This is done here
+    // on the GUI thread rather than on next paint, because the waveform
+    // may be drawn on the WaveformRenderThread and WImageStore is not
+    // thread-safe. Marks that are not valid yet may become valid without
+    // a resize, so they get an image too.
     for (const auto& pMark : m_marks) {
-        pMark->m_image = QImage();
+        generateMarkImage(pMark);
+    }
+}
+
+void WaveformRenderMark::onMarksChanged() {
+    // WaveformMark::setBaseColor() has reset the image
+    for (const auto& pMark : m_marks) {
+        if (pMark->m_image.isNull()) {
+            generateMarkImage(pMark);
+        }
     }
 }
 
@@ -178,6 +207,7 @@ void WaveformRenderMark::onSetTrack() {
 }
 
 void WaveformRenderMark::slotCuesUpdated() {
+    const auto locker = lockMutex(m_waveformRenderer->renderStateMutex());
     TrackPointer trackInfo = m_waveformRenderer->getTrackInfo();
     if (!trackInfo) {
         return;
@@ -206,6 +236,7 @@ void WaveformRenderMark::slotCuesUpdated() {
             int dimBrightThreshold = m_waveformRenderer->getDimBrightThreshold();
             pMark->setBaseColor(newColor, dimBrightThreshold);
             generateMarkImage(pMark);
+            m_waveformRenderer->invalidateFrame();
         }
     }
 }
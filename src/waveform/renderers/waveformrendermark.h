@@ -20,9 +20,11 @@ class WaveformRenderMark : public QObject, public WaveformRendererAbstract {
     void draw(QPainter* painter, QPaintEvent* event) override;
 
     void onResize() override;
+    uint renderStateHash(uint seed) const override;
 
     // Called when a new track is loaded.
     void onSetTrack() override;
+    void onMarksChanged() override;
 
   public slots:
     // Called when the loaded track's cues are added, deleted or modified and
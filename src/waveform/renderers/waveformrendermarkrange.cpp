@@ -1,6 +1,7 @@
 #include <QtDebug>
 #include <QColor>
 #include <QDomNode>
+#include <QHash>
 #include <QPaintEvent>
 #include <QPainter>
 #include <QObject>
@@ -37,6 +38,16 @@ void WaveformRenderMarkRange::setup(const QDomNode& node, const SkinContext& con
     }
 }
 
+uint WaveformRenderMarkRange::renderStateHash(uint seed) const {
+    for (const auto& markRange : m_markRanges) {
+        seed = qHash(markRange.start(), seed);
+        seed = qHash(markRange.end(), seed);
+        seed = qHash(static_cast<int>(markRange.enabled()), seed);
+        seed = qHash(static_cast<int>(markRange.visible()), seed);
+    }
+    return seed;
+}
+
 void WaveformRenderMarkRange::draw(QPainter *painter, QPaintEvent * /*event*/) {
     PainterScope PainterScope(painter);
 
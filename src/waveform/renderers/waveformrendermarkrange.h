@@ -23,6 +23,7 @@ class WaveformRenderMarkRange : public WaveformRendererAbstract {
 
     void setup(const QDomNode& node, const SkinContext& context) override;
     void draw(QPainter* painter, QPaintEvent* event) override;
+    uint renderStateHash(uint seed) const override;
 
   private:
     void generateImages();
@@ -1,5 +1,6 @@
 #include "waveform/renderers/waveformwidgetrenderer.h"
 
+#include <QHash>
 #include <QPainter>
 #include <QPainterPath>
 
@@ -19,10 +20,14 @@ const double WaveformWidgetRenderer::s_defaultPlayMarkerPosition = 0.5;
 
 namespace {
 constexpr int kDefaultDimBrightThreshold = 127;
+// Unchanged frames are still drawn about once per second, in case a
+// change of the render state is not tracked.
+constexpr int kMaxSkippedFrames = 60;
 } // namespace
 
 WaveformWidgetRenderer::WaveformWidgetRenderer(const QString& group)
         : m_group(group),
+          m_renderStateMutex(QT_RECURSIVE_MUTEX_INIT),
           m_orientation(Qt::Horizontal),
           m_dimBrightThreshold(kDefaultDimBrightThreshold),
           m_height(-1),
@@ -50,7 +55,11 @@ WaveformWidgetRenderer::WaveformWidgetRenderer(const QString& group)
           m_pTrackSamplesControlObject(nullptr),
           m_trackSamples(0.0),
           m_scaleFactor(1.0),
-          m_playMarkerPosition(s_defaultPlayMarkerPosition) {
+          m_playMarkerPosition(s_defaultPlayMarkerPosition),
+          m_frameInvalidated(true),
+          m_needsRender(true),
+          m_lastRenderStateHash(0),
+          m_skippedFrames(0) {
     //qDebug() << "WaveformWidgetRenderer";
 
 #ifdef WAVEFORMWIDGETRENDERER_DEBUG
@@ -104,6 +113,15 @@ bool WaveformWidgetRenderer::init() {
 }
 
 void WaveformWidgetRenderer::onPreRender(VSyncThread* vsyncThread) {
+    prepareFrame(m_visualPlayPosition->getAtNextVSync(vsyncThread));
+}
+
+void WaveformWidgetRenderer::onPreRender(
+        const PerformanceTimer& frameTimer, int displayMicros) {
+    prepareFrame(m_visualPlayPosition->getAtFrame(frameTimer, displayMicros));
+}
+
+void WaveformWidgetRenderer::prepareFrame(double truePlayPos) {
     // For a valid track to render we need
     m_trackSamples = static_cast<int>(m_pTrackSamplesControlObject->get());
     if (m_trackSamples <= 0) {
@@ -134,7 +152,6 @@ void WaveformWidgetRenderer::onPreRender(VSyncThread* vsyncThread) {
 
     m_audioSamplePerPixel = m_visualSamplePerPixel * m_audioVisualRatio;
 
-    double truePlayPos = m_visualPlayPosition->getAtNextVSync(vsyncThread);
     // truePlayPos = -1 happens, when a new track is in buffer but m_visualPlayPosition was not updated
 
     if (m_audioSamplePerPixel > 0 && truePlayPos != -1) {
@@ -174,6 +191,42 @@ void WaveformWidgetRenderer::onPreRender(VSyncThread* vsyncThread) {
     //        "m_gain" << m_gain;
 }
 
+void WaveformWidgetRenderer::updateRenderState() {
+    const uint hash = renderStateHash();
+    const bool frameInvalidated = m_frameInvalidated.exchange(false);
+    m_needsRender = frameInvalidated ||
+            hash != m_lastRenderStateHash ||
+            m_skippedFrames >= kMaxSkippedFrames;
+    m_lastRenderStateHash = hash;
+    m_skippedFrames = m_needsRender ? 0 : m_skippedFrames + 1;
+}
+
+uint WaveformWidgetRenderer::renderStateHash() const {
+    uint hash = qHash(m_trackSamples);
+    hash = qHash(m_playPos, hash);
+    hash = qHash(m_firstDisplayedPosition, hash);
+    hash = qHash(m_visualSamplePerPixel, hash);
+    hash = qHash(m_gain, hash);
+    hash = qHash(m_playMarkerPosition, hash);
+    hash = qHash(m_alphaBeatGrid, hash);
+    hash = qHash(m_width, hash);
+    hash = qHash(m_height, hash);
+    hash = qHash(m_devicePixelRatio, hash);
+    hash = qHash(m_pTrack.get(), hash);
+    if (m_pTrack) {
+        // The waveform grows while the track is analyzed
+        ConstWaveformPointer pWaveform = m_pTrack->getWaveform();
+        hash = qHash(pWaveform.get(), hash);
+        if (pWaveform) {
+            hash = qHash(pWaveform->getCompletion(), hash);
+        }
+    }
+    for (const auto* pRenderer : m_rendererStack) {
+        hash = pRenderer->renderStateHash(hash);
+    }
+    return hash;
+}
+
 void WaveformWidgetRenderer::draw(QPainter* painter, QPaintEvent* event) {
 #ifdef WAVEFORMWIDGETRENDERER_DEBUG
     m_lastSystemFrameTime = m_timer->restart().toIntegerNanos();
@@ -308,9 +361,11 @@ void WaveformWidgetRenderer::drawTriangle(QPainter* painter,
 }
 
 void WaveformWidgetRenderer::resize(int width, int height, float devicePixelRatio) {
+    const auto locker = lockMutex(&m_renderStateMutex);
     m_width = width;
     m_height = height;
     m_devicePixelRatio = devicePixelRatio;
+    m_frameInvalidated = true;
     for (int i = 0; i < m_rendererStack.size(); ++i) {
         m_rendererStack[i]->setDirty(true);
         m_rendererStack[i]->onResize();
@@ -319,6 +374,7 @@ void WaveformWidgetRenderer::resize(int width, int height, float devicePixelRati
 
 void WaveformWidgetRenderer::setup(
         const QDomNode& node, const SkinContext& context) {
+    const auto locker = lockMutex(&m_renderStateMutex);
     m_scaleFactor = context.getScaleFactor();
     QString orientationString = context.selectString(node, "Orientation").toLower();
     if (orientationString == "vertical") {
@@ -338,29 +394,50 @@ void WaveformWidgetRenderer::setup(
         m_rendererStack[i]->setScaleFactor(m_scaleFactor);
         m_rendererStack[i]->setup(node, context);
     }
+    m_frameInvalidated = true;
 }
 
 void WaveformWidgetRenderer::setZoom(double zoom) {
     //qDebug() << "WaveformWidgetRenderer::setZoom" << zoom;
+    const auto locker = lockMutex(&m_renderStateMutex);
     m_zoomFactor = math_clamp<double>(zoom, s_waveformMinZoom, s_waveformMaxZoom);
 }
 
 void WaveformWidgetRenderer::setDisplayBeatGridAlpha(int alpha) {
+    const auto locker = lockMutex(&m_renderStateMutex);
     m_alphaBeatGrid = alpha;
 }
 
 void WaveformWidgetRenderer::setTrack(TrackPointer track) {
+    const auto locker = lockMutex(&m_renderStateMutex);
     m_pTrack = track;
     //used to postpone first display until track sample is actually available
     m_trackSamples = -1.0;
+    m_frameInvalidated = true;
 
     for (int i = 0; i < m_rendererStack.size(); ++i) {
         m_rendererStack[i]->onSetTrack();
     }
 }
 
+void WaveformWidgetRenderer::setMarkBaseColor(
+        WaveformMarkPointer pMark, QColor baseColor, int dimBrightThreshold) {
+    const auto locker = lockMutex(&m_renderStateMutex);
+    pMark->setBaseColor(baseColor, dimBrightThreshold);
+    for (int i = 0; i < m_rendererStack.size(); ++i) {
+        m_rendererStack[i]->onMarksChanged();
+    }
+    m_frameInvalidated = true;
+}
+
 WaveformMarkPointer WaveformWidgetRenderer::getCueMarkAtPoint(QPoint point) const {
-    for (auto it = m_markPositions.constBegin(); it != m_markPositions.constEnd(); ++it) {
+    // The mark images and the orientation are only changed by the GUI thread
+    const auto pMarkPositions = m_markPositions.getValue();
+    if (!pMarkPositions) {
+        // Nothing has been drawn yet
+        return nullptr;
+    }
+    for (auto it = pMarkPositions->constBegin(); it != pMarkPositions->constEnd(); ++it) {
         WaveformMarkPointer pMark = it.key();
         VERIFY_OR_DEBUG_ASSERT(pMark) {
             continue;
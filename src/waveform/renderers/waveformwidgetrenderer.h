@@ -4,9 +4,12 @@
 #include <QTime>
 #include <QVector>
 #include <QtDebug>
+#include <atomic>
 
+#include "control/controlvalue.h"
 #include "track/track_decl.h"
 #include "util/class.h"
+#include "util/compatibility/qmutex.h"
 #include "util/performancetimer.h"
 #include "waveform/renderers/waveformmark.h"
 #include "waveform/renderers/waveformrendererabstract.h"
@@ -34,6 +37,10 @@ class WaveformWidgetRenderer {
 
     void setup(const QDomNode& node, const SkinContext& context);
     void onPreRender(VSyncThread* vsyncThread);
+    /// Like onPreRender(VSyncThread*), for a frame that is displayed
+    /// displayMicros after frameTimer has been started. Called by the
+    /// WaveformRenderThread, which does not depend on the VSyncThread.
+    void onPreRender(const PerformanceTimer& frameTimer, int displayMicros);
     void draw(QPainter* painter, QPaintEvent* event);
 
     const QString& getGroup() const {
@@ -42,8 +49,13 @@ class WaveformWidgetRenderer {
     const TrackPointer getTrackInfo() const {
         return m_pTrack;
     }
-    /// Get cue mark at a point on the waveform widget.
+    /// Get cue mark at a point on the waveform widget. Reads the marks of the
+    /// last drawn frame without blocking the thread that draws the next one.
     WaveformMarkPointer getCueMarkAtPoint(QPoint point) const;
+    /// Changes the color of a mark, e.g. to highlight it. Must be called from
+    /// the GUI thread, because the mark images are not generated while a
+    /// frame is drawn.
+    void setMarkBaseColor(WaveformMarkPointer pMark, QColor baseColor, int dimBrightThreshold);
 
     double getFirstDisplayedPosition() const {
         return m_firstDisplayedPosition;
@@ -61,7 +73,7 @@ class WaveformWidgetRenderer {
         return m_visualSamplePerPixel;
     }
     double getAudioSamplePerPixel() const {
-        return m_audioSamplePerPixel;
+        return m_audioSamplePerPixel.load(std::memory_order_relaxed);
     }
 
     // those function replace at its best sample position to an admissible
@@ -139,7 +151,9 @@ class WaveformWidgetRenderer {
 
     void setTrack(TrackPointer track);
     void setMarkPositions(const QMap<WaveformMarkPointer, int>& markPositions) {
-        m_markPositions = markPositions;
+        m_markPositions.setValue(
+                QSharedPointer<const QMap<WaveformMarkPointer, int>>::create(
+                        markPositions));
     }
 
     double getPlayMarkerPosition() {
@@ -150,11 +164,39 @@ class WaveformWidgetRenderer {
         VERIFY_OR_DEBUG_ASSERT(newPos >= 0.0 && newPos <= 1.0) {
             newPos = math_clamp(newPos, 0.0, 1.0);
         }
+        const auto locker = lockMutex(&m_renderStateMutex);
         m_playMarkerPosition = newPos;
     }
 
+    /// Forces the next frame to be drawn, for changes that are not part of
+    /// the render state, e.g. when the window of a widget that renders with
+    /// OpenGL has been exposed again. Must be called from the GUI thread.
+    void invalidateFrame() {
+        m_frameInvalidated = true;
+    }
+    /// Whether the last updateRenderState() found a change that needs the
+    /// widget to be drawn again. Unchanged frames are skipped, so idle
+    /// decks cost almost no rendering time.
+    bool needsRender() const {
+        return m_needsRender;
+    }
+
+    /// Guards the configuration of the renderer stack, e.g. size, track, zoom
+    /// and mark images, while the WaveformRenderThread prepares and draws a
+    /// frame. Must be held by the GUI thread when modifying it, e.g. from
+    /// slots. The state that changes with every frame is not guarded: the
+    /// play position is read from VisualPlayPosition and the controls, and
+    /// the mark positions are published by setMarkPositions().
+    QT_RECURSIVE_MUTEX* renderStateMutex() const {
+        return &m_renderStateMutex;
+    }
+
   protected:
+    /// Compares the state after onPreRender() with the last drawn frame
+    void updateRenderState();
+
     const QString m_group;
+    mutable QT_RECURSIVE_MUTEX m_renderStateMutex;
     TrackPointer m_pTrack;
     QList<WaveformRendererAbstract*> m_rendererStack;
     Qt::Orientation m_orientation;
@@ -170,7 +212,8 @@ class WaveformWidgetRenderer {
 
     double m_zoomFactor;
     double m_visualSamplePerPixel;
-    double m_audioSamplePerPixel;
+    // Also read by the GUI thread while the waveform is dragged
+    std::atomic<double> m_audioSamplePerPixel;
     double m_audioVisualRatio;
 
     int m_alphaBeatGrid;
@@ -202,7 +245,17 @@ class WaveformWidgetRenderer {
 private:
     DISALLOW_COPY_AND_ASSIGN(WaveformWidgetRenderer);
     friend class WaveformWidgetFactory;
-    QMap<WaveformMarkPointer, int> m_markPositions;
+    // Written by the thread that draws, read by the GUI thread
+    ControlValueAtomic<QSharedPointer<const QMap<WaveformMarkPointer, int>>> m_markPositions;
+    void prepareFrame(double truePlayPos);
+    uint renderStateHash() const;
+
+    // Set by the GUI thread
+    std::atomic<bool> m_frameInvalidated;
+    bool m_needsRender;
+    uint m_lastRenderStateHash;
+    int m_skippedFrames;
+
     // draw play position indicator triangles
     void drawPlayPosmarker(QPainter* painter);
     void drawTriangle(QPainter* painter,
@@ -59,18 +59,36 @@ double VisualPlayPosition::getAtNextVSync(VSyncThread* vSyncThread) {
     if (m_valid) {
         VisualPlayPositionData data = m_data.getValue();
         int refToVSync = vSyncThread->fromTimerToNextSyncMicros(data.m_referenceTime);
-        int offset = refToVSync - data.m_callbackEntrytoDac;
-        offset = math_min(offset, m_audioBufferMicros * kMaxOffsetBufferCnt);
-        double playPos = data.m_enginePlayPos;  // load playPos for the first sample in Buffer
-        // add the offset for the position of the sample that will be transferred to the DAC
-        // When the next display frame is displayed
-        playPos += data.m_positionStep * offset * data.m_rate / m_audioBufferMicros;
-        //qDebug() << "playPos" << playPos << offset;
-        return playPos;
+        return playPosAt(data, refToVSync);
+    }
+    return -1;
+}
+
+double VisualPlayPosition::getAtFrame(const PerformanceTimer& frameTimer, int displayMicros) {
+    if (m_valid) {
+        VisualPlayPositionData data = m_data.getValue();
+        // int math is fine here, because we do not expect times > 4.2 s
+        int refToDisplay = static_cast<int>(
+                                   frameTimer.difference(data.m_referenceTime)
+                                           .toIntegerMicros()) +
+                displayMicros;
+        return playPosAt(data, refToDisplay);
     }
     return -1;
 }
 
+double VisualPlayPosition::playPosAt(
+        const VisualPlayPositionData& data, int refToDisplayMicros) const {
+    int offset = refToDisplayMicros - data.m_callbackEntrytoDac;
+    offset = math_min(offset, m_audioBufferMicros * kMaxOffsetBufferCnt);
+    double playPos = data.m_enginePlayPos;  // load playPos for the first sample in Buffer
+    // add the offset for the position of the sample that will be transferred to the DAC
+    // When the next display frame is displayed
+    playPos += data.m_positionStep * offset * data.m_rate / m_audioBufferMicros;
+    //qDebug() << "playPos" << playPos << offset;
+    return playPos;
+}
+
 void VisualPlayPosition::getPlaySlipAtNextVSync(VSyncThread* vSyncThread, double* pPlayPosition, double* pSlipPosition) {
     //static double testPos = 0;
     //testPos += 0.000017759; //0.000016608; //  1.46257e-05;
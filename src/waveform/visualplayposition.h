@@ -47,6 +47,10 @@ class VisualPlayPosition : public QObject {
     void set(double playPos, double rate, double positionStep,
             double slipPosition, double tempoTrackSeconds);
     double getAtNextVSync(VSyncThread* vsyncThread);
+    // Like getAtNextVSync(), for a frame that is displayed displayMicros
+    // after frameTimer has been started. Used by the WaveformRenderThread,
+    // which has its own frame timer.
+    double getAtFrame(const PerformanceTimer& frameTimer, int displayMicros);
     void getPlaySlipAtNextVSync(VSyncThread* vSyncThread, double* playPosition, double* slipPosition);
     double getEnginePlayPos();
     void getTrackTime(double* pPlayPosition, double* pTempoTrackSeconds);
@@ -67,6 +71,8 @@ class VisualPlayPosition : public QObject {
     void slotAudioBufferSizeChanged(double sizeMs);
 
   private:
+    double playPosAt(const VisualPlayPositionData& data, int refToDisplayMicros) const;
+
     ControlValueAtomic<VisualPlayPositionData> m_data;
     ControlProxy* m_audioBufferSize;
     int m_audioBufferMicros; // Audio buffer size in µs
@@ -2,11 +2,52 @@
 
 #include "waveform/waveform.h"
 #include "proto/waveform.pb.h"
+#include "util/math.h"
 
 using namespace mixxx::track;
 
 constexpr int kNumChannels = 2;
 
+// Stop adding pyramid levels once a level would contain less than twice this
+// number of visual frames. Coarser levels would not save any work compared to
+// the setup cost of the renderers.
+constexpr int kMipmapMinimumFrames = 64;
+
+namespace {
+
+// The pyramid keeps the maximum of each band and no RMS level. The visual
+// samples are already peaks, see WaveformStride, and all signal renderers
+// reduce the visual samples of a pixel with their maximum too. So a level
+// renders like the full resolution data, except at the pixel borders, while
+// an RMS of peaks would not be the RMS of the signal and no renderer would
+// read it.
+inline WaveformData reduceWaveformData(
+        const WaveformData& first, const WaveformData& second) {
+    WaveformData result;
+    result.filtered.low = math_max(first.filtered.low, second.filtered.low);
+    result.filtered.mid = math_max(first.filtered.mid, second.filtered.mid);
+    result.filtered.high = math_max(first.filtered.high, second.filtered.high);
+    result.filtered.all = math_max(first.filtered.all, second.filtered.all);
+    return result;
+}
+
+// Waveforms stored by Mixxx 2.3 and older use the repeated value field.
+inline int signalSize(const io::Waveform::Signal& signal) {
+    if (signal.has_value_bytes()) {
+        return static_cast<int>(signal.value_bytes().size());
+    }
+    return signal.value_size();
+}
+
+inline unsigned char signalValue(const io::Waveform::Signal& signal, int i) {
+    if (signal.has_value_bytes()) {
+        return static_cast<unsigned char>(signal.value_bytes()[i]);
+    }
+    return static_cast<unsigned char>(signal.value(i));
+}
+
+} // anonymous namespace
+
 // Return the smallest power of 2 which is greater than the desired size when
 // squared.
 int computeTextureStride(int size) {
@@ -107,17 +148,58 @@ QByteArray Waveform::toByteArray() const {
     high->set_channels(numChannels);
 
     int dataSize = getDataSize();
+    std::string allBytes, lowBytes, midBytes, highBytes;
+    allBytes.reserve(dataSize);
+    lowBytes.reserve(dataSize);
+    midBytes.reserve(dataSize);
+    highBytes.reserve(dataSize);
     for (int i = 0; i < dataSize; ++i) {
         const WaveformData& datum = m_data.at(i);
-        all->add_value(datum.filtered.all);
-        low->add_value(datum.filtered.low);
-        mid->add_value(datum.filtered.mid);
-        high->add_value(datum.filtered.high);
+        allBytes.push_back(static_cast<char>(datum.filtered.all));
+        lowBytes.push_back(static_cast<char>(datum.filtered.low));
+        midBytes.push_back(static_cast<char>(datum.filtered.mid));
+        highBytes.push_back(static_cast<char>(datum.filtered.high));
+    }
+    all->set_value_bytes(allBytes);
+    low->set_value_bytes(lowBytes);
+    mid->set_value_bytes(midBytes);
+    high->set_value_bytes(highBytes);
+
+    // Only store the pyramid if it is complete, it is rebuilt otherwise.
+    bool mipmapsComplete = true;
+    for (std::size_t level = 0; level < m_mipmaps.size(); ++level) {
+        if (m_mipmapCompletion[level] * kNumChannels !=
+                static_cast<int>(m_mipmaps[level].size())) {
+            mipmapsComplete = false;
+            break;
+        }
+    }
+    if (mipmapsComplete) {
+        for (std::size_t level = 0; level < m_mipmaps.size(); ++level) {
+            const std::vector<WaveformData>& levelData = m_mipmaps[level];
+            std::string lowBytes, midBytes, highBytes, allBytes;
+            lowBytes.reserve(levelData.size());
+            midBytes.reserve(levelData.size());
+            highBytes.reserve(levelData.size());
+            allBytes.reserve(levelData.size());
+            for (const WaveformData& datum : levelData) {
+                lowBytes.push_back(static_cast<char>(datum.filtered.low));
+                midBytes.push_back(static_cast<char>(datum.filtered.mid));
+                highBytes.push_back(static_cast<char>(datum.filtered.high));
+                allBytes.push_back(static_cast<char>(datum.filtered.all));
+            }
+            io::Waveform::Mipmap* mipmap = waveform.add_mipmap();
+            mipmap->set_level(static_cast<int>(level) + 1);
+            mipmap->set_low(lowBytes);
+            mipmap->set_mid(midBytes);
+            mipmap->set_high(highBytes);
+            mipmap->set_all(allBytes);
+        }
     }
 
     qDebug() << "Writing waveform from byte array:"
              << "dataSize" << dataSize
-             << "allSignalSize" << all->value_size()
+             << "allSignalSize" << signalSize(*all)
              << "visualSampleRate" << waveform.visual_sample_rate()
              << "audioVisualRatio" << waveform.audio_visual_ratio();
 
@@ -156,15 +238,15 @@ void Waveform::readByteArray(const QByteArray& data) {
     const io::Waveform::Signal& high = waveform.signal_filtered().high();
 
     qDebug() << "Reading waveform from byte array:"
-             << "allSignalSize" << all.value_size()
+             << "allSignalSize" << signalSize(all)
              << "visualSampleRate" << waveform.visual_sample_rate()
              << "audioVisualRatio" << waveform.audio_visual_ratio();
 
-    resize(all.value_size());
+    resize(signalSize(all));
 
     int dataSize = getDataSize();
-    if (all.value_size() != dataSize) {
-        qDebug() << "ERROR: Couldn't resize Waveform to" << all.value_size()
+    if (signalSize(all) != dataSize) {
+        qDebug() << "ERROR: Couldn't resize Waveform to" << signalSize(all)
                  << "while reading.";
         resize(0);
         m_saveState = SaveState::NotSaved;
@@ -173,9 +255,12 @@ void Waveform::readByteArray(const QByteArray& data) {
 
     m_visualSampleRate = waveform.visual_sample_rate();
     m_audioVisualRatio = waveform.audio_visual_ratio();
-    if (low.value_size() != dataSize ||
-        mid.value_size() != dataSize ||
-        high.value_size() != dataSize) {
+    const int lowSize = signalSize(low);
+    const int midSize = signalSize(mid);
+    const int highSize = signalSize(high);
+    if (lowSize != dataSize ||
+        midSize != dataSize ||
+        highSize != dataSize) {
         qDebug() << "WARNING: Filtered data size does not match all-signal size.";
     }
 
@@ -185,15 +270,43 @@ void Waveform::readByteArray(const QByteArray& data) {
     bool mid_valid = mid.units() == io::Waveform::RMS;
     bool high_valid = high.units() == io::Waveform::RMS;
     for (int i = 0; i < dataSize; ++i) {
-        m_data[i].filtered.all = static_cast<unsigned char>(all.value(i));
-        bool use_low = low_valid && i < low.value_size();
-        bool use_mid = mid_valid && i < mid.value_size();
-        bool use_high = high_valid && i < high.value_size();
-        m_data[i].filtered.low = use_low ? static_cast<unsigned char>(low.value(i)) : 0;
-        m_data[i].filtered.mid = use_mid ? static_cast<unsigned char>(mid.value(i)) : 0;
-        m_data[i].filtered.high = use_high ? static_cast<unsigned char>(high.value(i)) : 0;
+        m_data[i].filtered.all = signalValue(all, i);
+        bool use_low = low_valid && i < lowSize;
+        bool use_mid = mid_valid && i < midSize;
+        bool use_high = high_valid && i < highSize;
+        m_data[i].filtered.low = use_low ? signalValue(low, i) : 0;
+        m_data[i].filtered.mid = use_mid ? signalValue(mid, i) : 0;
+        m_data[i].filtered.high = use_high ? signalValue(high, i) : 0;
     }
     m_completion = dataSize;
+
+    // Use the stored pyramid if it matches the layout we would compute,
+    // otherwise (e.g. for waveforms stored by older versions) rebuild it.
+    bool mipmapsValid = waveform.mipmap_size() == static_cast<int>(m_mipmaps.size());
+    for (int level = 0; mipmapsValid && level < waveform.mipmap_size(); ++level) {
+        const io::Waveform::Mipmap& mipmap = waveform.mipmap(level);
+        const std::size_t levelSize = m_mipmaps[level].size();
+        mipmapsValid = mipmap.level() == level + 1 &&
+                mipmap.low().size() == levelSize &&
+                mipmap.mid().size() == levelSize &&
+                mipmap.high().size() == levelSize &&
+                mipmap.all().size() == levelSize;
+    }
+    if (mipmapsValid) {
+        for (int level = 0; level < waveform.mipmap_size(); ++level) {
+            const io::Waveform::Mipmap& mipmap = waveform.mipmap(level);
+            std::vector<WaveformData>& levelData = m_mipmaps[level];
+            for (std::size_t i = 0; i < levelData.size(); ++i) {
+                levelData[i].filtered.low = static_cast<unsigned char>(mipmap.low()[i]);
+                levelData[i].filtered.mid = static_cast<unsigned char>(mipmap.mid()[i]);
+                levelData[i].filtered.high = static_cast<unsigned char>(mipmap.high()[i]);
+                levelData[i].filtered.all = static_cast<unsigned char>(mipmap.all()[i]);
+            }
+            m_mipmapCompletion[level] = static_cast<int>(levelData.size()) / kNumChannels;
+        }
+    } else {
+        updateMipmaps();
+    }
     m_saveState = SaveState::Saved;
 }
 
@@ -201,19 +314,89 @@ void Waveform::resize(int size) {
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.resize(m_textureStride * m_textureStride);
+    allocateMipmaps();
 }
 
 void Waveform::assign(int size, int value) {
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.assign(m_textureStride * m_textureStride, value);
+    allocateMipmaps();
     m_saveState = SaveState::SavePending;
 }
 
+void Waveform::allocateMipmaps() {
+    m_mipmaps.clear();
+    int frames = m_dataSize / kNumChannels;
+    while (frames >= 2 * kMipmapMinimumFrames) {
+        frames = (frames + 1) / 2;
+        m_mipmaps.emplace_back(frames * kNumChannels, WaveformData(0));
+    }
+    m_mipmapCompletion.assign(m_mipmaps.size(), 0);
+}
+
+int Waveform::getMipmapLevelForVisualFramesPerPixel(double visualFramesPerPixel) const {
+    int level = 0;
+    // Keep at least one visual frame per pixel, so that a pixel never spans
+    // less data than it would at full resolution.
+    while (level < static_cast<int>(m_mipmaps.size()) &&
+            visualFramesPerPixel >= 2.0) {
+        visualFramesPerPixel /= 2.0;
+        ++level;
+    }
+    return level;
+}
+
+int Waveform::getMipmapDataSize(int level) const {
+    if (level <= 0) {
+        return getDataSize();
+    }
+    DEBUG_ASSERT(level <= static_cast<int>(m_mipmaps.size()));
+    return static_cast<int>(m_mipmaps[level - 1].size());
+}
+
+const WaveformData* Waveform::mipmapData(int level) const {
+    if (level <= 0) {
+        return data();
+    }
+    DEBUG_ASSERT(level <= static_cast<int>(m_mipmaps.size()));
+    return m_mipmaps[level - 1].data();
+}
+
+void Waveform::updateMipmaps() {
+    const bool complete = getCompletion() >= m_dataSize;
+    const WaveformData* pSource = m_data.data();
+    int sourceFrames = m_dataSize / kNumChannels;
+    int sourceCompletedFrames = math_min(getCompletion(), m_dataSize) / kNumChannels;
+    for (std::size_t level = 0; level < m_mipmaps.size(); ++level) {
+        std::vector<WaveformData>& levelData = m_mipmaps[level];
+        const int levelFrames = static_cast<int>(levelData.size()) / kNumChannels;
+        // Only reduce complete pairs of source frames unless the source is
+        // complete, in which case a trailing odd frame is reduced on its own.
+        const int completedFrames = complete
+                ? levelFrames
+                : math_min(sourceCompletedFrames / 2, levelFrames);
+        for (int frame = m_mipmapCompletion[level]; frame < completedFrames; ++frame) {
+            const int first = 2 * frame;
+            const int second = math_min(first + 1, sourceFrames - 1);
+            for (int channel = 0; channel < kNumChannels; ++channel) {
+                levelData[frame * kNumChannels + channel] = reduceWaveformData(
+                        pSource[first * kNumChannels + channel],
+                        pSource[second * kNumChannels + channel]);
+            }
+        }
+        m_mipmapCompletion[level] = completedFrames;
+        pSource = levelData.data();
+        sourceFrames = levelFrames;
+        sourceCompletedFrames = completedFrames;
+    }
+}
+
 void Waveform::dump() const {
     qDebug() << "Waveform" << this
              << "size("+QString::number(getDataSize())+")"
              << "textureStride("+QString::number(m_textureStride)+")"
+             << "mipmapLevels("+QString::number(getMipmapLevelCount())+")"
              << "completion("+QString::number(getCompletion())+")"
              << "visualSampleRate("+QString::number(m_visualSampleRate)+")"
              << "audioVisualRatio("+QString::number(m_audioVisualRatio)+")";
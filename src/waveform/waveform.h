@@ -130,12 +130,30 @@ class Waveform {
     // constructor runs.
     const WaveformData* data() const { return &m_data[0];}
 
+    // The waveform keeps a pyramid of reduced copies of its data. Each level
+    // halves the number of visual frames of the level below by taking the
+    // per band maximum, level 0 being the full resolution data. Renderers that
+    // are zoomed far out pick the coarsest level that still provides one
+    // visual frame per pixel. The levels are allocated in the constructor and
+    // not resized afterwards, so we do not lock the mutex.
+    int getMipmapLevelCount() const {
+        return static_cast<int>(m_mipmaps.size()) + 1;
+    }
+    int getMipmapLevelForVisualFramesPerPixel(double visualFramesPerPixel) const;
+    int getMipmapDataSize(int level) const;
+    const WaveformData* mipmapData(int level) const;
+
+    // Reduces the data that has been completed since the last call into the
+    // pyramid levels. Must only be called by the thread that writes data().
+    void updateMipmaps();
+
     void dump() const;
 
   private:
     void readByteArray(const QByteArray& data);
     void resize(int size);
     void assign(int size, int value = 0);
+    void allocateMipmaps();
 
     inline WaveformData& at(int i) { return m_data[i];}
     inline unsigned char& low(int i) { return m_data[i].filtered.low;}
@@ -171,6 +189,13 @@ class Waveform {
     // stride is N. Not allowed to change after the constructor runs.
     int m_textureStride;
 
+    // The reduced levels 1..n of the pyramid, interleaved like m_data. Not
+    // allowed to be resized after the constructor runs.
+    std::vector<std::vector<WaveformData>> m_mipmaps;
+    // The number of visual frames of each level in m_mipmaps that have been
+    // reduced so far. Only accessed by the thread that writes the data.
+    std::vector<int> m_mipmapCompletion;
+
     // For performance, completion is shared as a QAtomicInt and does not lock
     // the mutex. The completion of the waveform calculation.
     QAtomicInt m_completion;
@@ -0,0 +1,127 @@
+#include "waveform/waveformrenderthread.h"
+
+#include <QFuture>
+#include <QVarLengthArray>
+#include <QtConcurrentRun>
+
+#include "moc_waveformrenderthread.cpp"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/timer.h"
+#include "waveform/widgets/waveformwidgetabstract.h"
+
+namespace {
+
+// A few frames of all decks at the highest frame rate
+constexpr int kRenderedFramesSize = 256;
+
+// 30 FPS, like the VSyncThread
+constexpr int kDefaultFrameIntervalMicros = 33333;
+
+// The render thread draws one widget itself
+constexpr int kMaxParallelWidgets = 3;
+
+} // anonymous namespace
+
+WaveformRenderThread::WaveformRenderThread(QObject* pParent)
+        : QThread(pParent),
+          m_frameIntervalMicros(kDefaultFrameIntervalMicros),
+          m_stop(0),
+          m_renderedFrames(kRenderedFramesSize) {
+    m_threadPool.setMaxThreadCount(kMaxParallelWidgets);
+}
+
+WaveformRenderThread::~WaveformRenderThread() {
+    stop();
+}
+
+void WaveformRenderThread::addWidget(WaveformWidgetAbstract* pWidget) {
+    VERIFY_OR_DEBUG_ASSERT(pWidget && !pWidget->m_pRenderThread) {
+        return;
+    }
+    const auto locker = lockMutex(&m_widgetsMutex);
+    m_widgets.append(pWidget);
+    pWidget->m_pRenderThread = this;
+}
+
+void WaveformRenderThread::removeWidget(WaveformWidgetAbstract* pWidget) {
+    // Blocks while a frame is rendered
+    const auto locker = lockMutex(&m_widgetsMutex);
+    m_widgets.removeAll(pWidget);
+    pWidget->m_pRenderThread = nullptr;
+}
+
+void WaveformRenderThread::setFrameIntervalMicros(int frameIntervalMicros) {
+    m_frameIntervalMicros.storeRelease(frameIntervalMicros);
+}
+
+int WaveformRenderThread::takeRenderedFrames(RenderedFrame* pFrames, int maxCount) {
+    return m_renderedFrames.read(pFrames, maxCount);
+}
+
+void WaveformRenderThread::stop() {
+    if (isRunning()) {
+        m_stop.storeRelease(1);
+        // Returns after the current frame interval
+        wait();
+    }
+    const auto locker = lockMutex(&m_widgetsMutex);
+    for (auto* pWidget : qAsConst(m_widgets)) {
+        pWidget->m_pRenderThread = nullptr;
+    }
+    m_widgets.clear();
+}
+
+void WaveformRenderThread::run() {
+    m_frameTimer.start();
+    while (!m_stop.loadAcquire()) {
+        const int frameIntervalMicros = m_frameIntervalMicros.loadAcquire();
+        renderFrame(frameIntervalMicros);
+
+        // waiting for interval by sleep
+        const int remainingMicros = frameIntervalMicros -
+                static_cast<int>(m_frameTimer.elapsed().toIntegerMicros());
+        if (remainingMicros > 100) {
+            usleep(remainingMicros);
+        }
+        m_frameTimer.restart();
+    }
+}
+
+void WaveformRenderThread::renderFrame(int frameIntervalMicros) {
+    const auto locker = lockMutex(&m_widgetsMutex);
+    ScopedTimer t("WaveformRenderThread::renderFrame() %1waveforms",
+            static_cast<int>(m_widgets.size()));
+    // The GUI thread blits the images as soon as they are finished, so they
+    // are displayed about when the next frame is due.
+    const int displayMicros = frameIntervalMicros;
+
+    // The widgets of the decks share no render state and are drawn in
+    // parallel.
+    QVarLengthArray<QFuture<bool>, kMaxParallelWidgets> futures;
+    for (int i = 1; i < m_widgets.size(); ++i) {
+        WaveformWidgetAbstract* pWidget = m_widgets[i];
+        futures.append(QtConcurrent::run(&m_threadPool, [this, pWidget, displayMicros] {
+            return pWidget->renderOffscreenFrame(m_frameTimer, displayMicros);
+        }));
+    }
+    if (!m_widgets.isEmpty()) {
+        m_widgets.first()->renderOffscreenFrame(m_frameTimer, displayMicros);
+    }
+    for (auto& future : futures) {
+        future.waitForFinished();
+    }
+
+    // The widgets may have been drawn in parallel, but only this thread
+    // writes into the FIFO.
+    for (const auto* pWidget : qAsConst(m_widgets)) {
+        if (pWidget->m_offscreenFrameDuration == mixxx::Duration()) {
+            continue;
+        }
+        const RenderedFrame frame{pWidget,
+                pWidget->m_offscreenFrameStart,
+                pWidget->m_offscreenFrameDuration};
+        // Dropped if the GUI thread does not keep up
+        m_renderedFrames.write(&frame, 1);
+    }
+}
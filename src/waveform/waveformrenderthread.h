@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QAtomicInt>
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QThreadPool>
+
+#include "util/duration.h"
+#include "util/fifo.h"
+#include "util/performancetimer.h"
+
+class WaveformWidgetAbstract;
+
+/// Renders the waveform widgets that paint with QPainter into offscreen
+/// images, so a busy GUI thread (e.g. library table repaints) does not stall
+/// waveform frames and vice versa. The thread is paced by its own frame
+/// timer and reads the play position from VisualPlayPosition for the time
+/// its frame is displayed. The GUI thread only blits the finished images.
+///
+/// OpenGL waveforms and spinnies keep rendering on the GUI thread, because
+/// their QGLWidget contexts are bound to it.
+class WaveformRenderThread : public QThread {
+    Q_OBJECT
+  public:
+    explicit WaveformRenderThread(QObject* pParent = nullptr);
+    ~WaveformRenderThread() override;
+
+    void addWidget(WaveformWidgetAbstract* pWidget);
+    /// Waits until a frame of the widget that is currently rendered is
+    /// finished. Must be called before the widget is destroyed.
+    void removeWidget(WaveformWidgetAbstract* pWidget);
+
+    /// Sets the interval of the frame timer, like
+    /// VSyncThread::setSyncIntervalTimeMicros()
+    void setFrameIntervalMicros(int frameIntervalMicros);
+
+    /// Stops the thread and lets all widgets draw on the GUI thread again.
+    void stop();
+
+    /// A frame that has been rendered offscreen, for the developer tools
+    struct RenderedFrame {
+        /// Only for identifying the widget, it may have been destroyed.
+        const WaveformWidgetAbstract* pWidget;
+        mixxx::Duration start;
+        mixxx::Duration duration;
+    };
+    /// Takes the frames rendered since the last call, at most maxCount.
+    /// Must only be called from the GUI thread. Frames that are not taken
+    /// in time are dropped by the render thread.
+    int takeRenderedFrames(RenderedFrame* pFrames, int maxCount);
+
+  protected:
+    void run() override;
+
+  private:
+    void renderFrame(int frameIntervalMicros);
+
+    QMutex m_widgetsMutex;
+    QList<WaveformWidgetAbstract*> m_widgets;
+    // Draws the widgets of the other decks in parallel. The global thread
+    // pool may be busy with analysis and cover art.
+    QThreadPool m_threadPool;
+    QAtomicInt m_frameIntervalMicros;
+    QAtomicInt m_stop;
+    // Started when a frame is rendered, only used by this thread
+    PerformanceTimer m_frameTimer;
+    // Written by the render thread and read by the GUI thread, lock-free
+    FIFO<RenderedFrame> m_renderedFrames;
+};
@@ -9,17 +9,20 @@
 #include <QWidget>
 #include <QWindow>
 #include <QtDebug>
+#include <array>
 
 #include "control/controlpotmeter.h"
 #include "moc_waveformwidgetfactory.cpp"
 #include "util/cmdlineargs.h"
 #include "util/math.h"
 #include "util/performancetimer.h"
+#include "util/time.h"
 #include "util/timer.h"
 #include "waveform/guitick.h"
 #include "waveform/sharedglcontext.h"
 #include "waveform/visualsmanager.h"
 #include "waveform/vsyncthread.h"
+#include "waveform/waveformrenderthread.h"
 #include "waveform/widgets/emptywaveformwidget.h"
 #include "waveform/widgets/glrgbwaveformwidget.h"
 #include "waveform/widgets/glsimplewaveformwidget.h"
@@ -108,11 +111,13 @@ WaveformWidgetFactory::WaveformWidgetFactory()
           m_defaultZoom(WaveformWidgetRenderer::s_waveformDefaultZoom),
           m_zoomSync(true),
           m_overviewNormalized(false),
+          m_scrollingCacheEnabled(true),
           m_openGlAvailable(false),
           m_openGlesAvailable(false),
           m_openGLShaderAvailable(false),
           m_beatGridAlpha(90),
           m_vsyncThread(nullptr),
+          m_pRenderThread(nullptr),
           m_pGuiTick(nullptr),
           m_pVisualsManager(nullptr),
           m_frameCnt(0),
@@ -270,6 +275,10 @@ WaveformWidgetFactory::WaveformWidgetFactory()
 }
 
 WaveformWidgetFactory::~WaveformWidgetFactory() {
+    if (m_pRenderThread) {
+        m_pRenderThread->stop();
+        delete m_pRenderThread;
+    }
     if (m_vsyncThread) {
         delete m_vsyncThread;
     }
@@ -337,6 +346,9 @@ bool WaveformWidgetFactory::setConfig(UserSettingsPointer config) {
         m_config->set(ConfigKey("[Waveform]","OverviewNormalized"), ConfigValue(m_overviewNormalized));
     }
 
+    m_scrollingCacheEnabled = m_config->getValue(
+            ConfigKey("[Waveform]", "ScrollingCache"), m_scrollingCacheEnabled);
+
     m_playMarkerPosition = m_config->getValue(ConfigKey("[Waveform]","PlayMarkerPosition"),
             WaveformWidgetRenderer::s_defaultPlayMarkerPosition);
     setPlayMarkerPosition(m_playMarkerPosition);
@@ -423,6 +435,9 @@ void WaveformWidgetFactory::setFrameRate(int frameRate) {
     if (m_vsyncThread) {
         m_vsyncThread->setSyncIntervalTimeMicros(static_cast<int>(1e6 / m_frameRate));
     }
+    if (m_pRenderThread) {
+        m_pRenderThread->setFrameIntervalMicros(static_cast<int>(1e6 / m_frameRate));
+    }
 }
 
 void WaveformWidgetFactory::setEndOfTrackWarningTime(int endTime) {
@@ -585,6 +600,9 @@ void WaveformWidgetFactory::setVisualGain(FilterIndex index, double gain) {
     if (m_config) {
         m_config->set(ConfigKey("[Waveform]","VisualGain_" + QString::number(index)), QString::number(m_visualGain[index]));
     }
+    for (const auto& holder : m_waveformWidgetHolders) {
+        holder.m_waveformWidget->invalidateFrame();
+    }
 }
 
 double WaveformWidgetFactory::getVisualGain(FilterIndex index) const {
@@ -598,6 +616,13 @@ void WaveformWidgetFactory::setOverviewNormalized(bool normalize) {
     }
 }
 
+void WaveformWidgetFactory::setScrollingCacheEnabled(bool enabled) {
+    m_scrollingCacheEnabled = enabled;
+    if (m_config) {
+        m_config->setValue(ConfigKey("[Waveform]", "ScrollingCache"), m_scrollingCacheEnabled);
+    }
+}
+
 void WaveformWidgetFactory::setPlayMarkerPosition(double position) {
     //qDebug() << "setPlayMarkerPosition, position=" << position;
     m_playMarkerPosition = position;
@@ -628,6 +653,8 @@ void WaveformWidgetFactory::notifyZoomChange(WWaveformViewer* viewer) {
 void WaveformWidgetFactory::render() {
     ScopedTimer t("WaveformWidgetFactory::render() %1waveforms",
             static_cast<int>(m_waveformWidgetHolders.size()));
+    m_frameTimeRecorder.beginRender();
+    recordOffscreenFrames();
 
     //int paintersSetupTime0 = 0;
     //int paintersSetupTime1 = 0;
@@ -647,11 +674,21 @@ void WaveformWidgetFactory::render() {
                 // render this widget.
                 bool shouldRender = shouldRenderWaveform(pWaveformWidget);
                 shouldRenderWaveforms[i] = shouldRender;
+                if (pWaveformWidget->isRenderedOffscreen()) {
+                    // The render thread prepares and draws the frames at
+                    // its own pace, independent of the load on the GUI
+                    // thread. It only needs to know which widgets are shown.
+                    pWaveformWidget->setShownOffscreen(shouldRender);
+                    shouldRenderWaveforms[i] = false;
+                    continue;
+                }
                 if (!shouldRender) {
                     continue;
                 }
                 // Calculate play position for the new Frame in following run
                 pWaveformWidget->preRender(m_vsyncThread);
+                // Skip the widget if nothing has changed since its last frame
+                shouldRenderWaveforms[i] = pWaveformWidget->needsRender();
             }
             //qDebug() << "prerender" << m_vsyncThread->elapsed();
 
@@ -665,7 +702,9 @@ void WaveformWidgetFactory::render() {
                 if (!shouldRenderWaveforms[i]) {
                     continue;
                 }
+                const mixxx::Duration widgetRenderStart = mixxx::Time::elapsed();
                 pWaveformWidget->render();
+                m_frameTimeRecorder.widgetRendered(static_cast<int>(i), widgetRenderStart);
                 //qDebug() << "render" << i << m_vsyncThread->elapsed();
             }
         }
@@ -693,6 +732,7 @@ void WaveformWidgetFactory::render() {
     m_pVisualsManager->process(m_endOfTrackWarningTime);
     m_pGuiTick->process();
 
+    m_frameTimeRecorder.endRender(m_vsyncThread->droppedFrames());
     //qDebug() << "refresh end" << m_vsyncThread->elapsed();
     m_vsyncThread->vsyncSlotFinished();
 }
@@ -700,6 +740,7 @@ void WaveformWidgetFactory::render() {
 void WaveformWidgetFactory::swap() {
     ScopedTimer t("WaveformWidgetFactory::swap() %1waveforms",
             static_cast<int>(m_waveformWidgetHolders.size()));
+    m_frameTimeRecorder.beginSwap();
 
     // Do this in an extra slot to be sure to hit the desired interval
     if (!m_skipRender) {
@@ -713,7 +754,9 @@ void WaveformWidgetFactory::swap() {
                 // unexposed window. Prevents continuous log spew of
                 // "QOpenGLContext::swapBuffers() called with non-exposed
                 // window, behavior is undefined" on Qt5. See Bug #1779487.
-                if (!shouldRenderWaveform(pWaveformWidget)) {
+                if (pWaveformWidget->isRenderedOffscreen() ||
+                        !shouldRenderWaveform(pWaveformWidget) ||
+                        !pWaveformWidget->needsRender()) {
                     continue;
                 }
                 QGLWidget* glw = qobject_cast<QGLWidget*>(pWaveformWidget->getWidget());
@@ -730,10 +773,43 @@ void WaveformWidgetFactory::swap() {
         // renderers. Swap all the WSpinny widgets now.
         emit swapSpinnies();
     }
+    m_frameTimeRecorder.endSwap();
     //qDebug() << "swap end" << m_vsyncThread->elapsed();
     m_vsyncThread->vsyncSlotFinished();
 }
 
+void WaveformWidgetFactory::recordOffscreenFrames() {
+    if (!m_pRenderThread) {
+        return;
+    }
+    std::array<WaveformRenderThread::RenderedFrame, 16> renderedFrames;
+    int count;
+    while ((count = m_pRenderThread->takeRenderedFrames(
+                    renderedFrames.data(), static_cast<int>(renderedFrames.size()))) > 0) {
+        for (int i = 0; i < count; ++i) {
+            const auto& renderedFrame = renderedFrames[i];
+            // The frames of widgets that have been replaced since are dropped
+            for (std::size_t index = 0; index < m_waveformWidgetHolders.size(); ++index) {
+                if (m_waveformWidgetHolders[index].m_waveformWidget ==
+                        renderedFrame.pWidget) {
+                    m_frameTimeRecorder.offscreenWidgetRendered(static_cast<int>(index),
+                            renderedFrame.start,
+                            renderedFrame.duration);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+QStringList WaveformWidgetFactory::frameTimeWidgetNames() const {
+    QStringList names;
+    for (const auto& holder : m_waveformWidgetHolders) {
+        names.append(holder.m_waveformViewer->getGroup());
+    }
+    return names;
+}
+
 WaveformWidgetType::Type WaveformWidgetFactory::autoChooseWidgetType() const {
     if (m_openGlAvailable) {
         if (m_openGLShaderAvailable) {
@@ -1009,6 +1085,9 @@ WaveformWidgetAbstract* WaveformWidgetFactory::createWaveformWidget(
                 widget = nullptr;
             }
         }
+        if (widget && widget->rendersOffscreen() && m_pRenderThread) {
+            m_pRenderThread->addWidget(widget);
+        }
     }
     return widget;
 }
@@ -1040,6 +1119,11 @@ void WaveformWidgetFactory::startVSync(GuiTick* pGuiTick, VisualsManager* pVisua
             &WaveformWidgetFactory::swap);
 
     m_vsyncThread->start(QThread::NormalPriority);
+
+    m_pRenderThread = new WaveformRenderThread(this);
+    m_pRenderThread->setObjectName(QStringLiteral("WaveformRender"));
+    m_pRenderThread->setFrameIntervalMicros(static_cast<int>(1e6 / m_frameRate));
+    m_pRenderThread->start(QThread::NormalPriority);
 }
 
 void WaveformWidgetFactory::getAvailableVSyncTypes(QList<QPair<int, QString > >* pList) {
@@ -8,6 +8,7 @@
 #include "skin/legacy/skincontext.h"
 #include "util/performancetimer.h"
 #include "util/singleton.h"
+#include "waveform/frametimerecorder.h"
 #include "waveform/waveform.h"
 #include "waveform/widgets/waveformwidgettype.h"
 
@@ -15,6 +16,7 @@ class WVuMeter;
 class WWaveformViewer;
 class WaveformWidgetAbstract;
 class VSyncThread;
+class WaveformRenderThread;
 class GuiTick;
 class VisualsManager;
 
@@ -118,6 +120,11 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
     void setOverviewNormalized(bool normalize);
     int isOverviewNormalized() const { return m_overviewNormalized;}
 
+    // If enabled, renderers that support it keep the scrolling waveform in
+    // an offscreen ring buffer and only draw the newly exposed columns.
+    void setScrollingCacheEnabled(bool enabled);
+    bool isScrollingCacheEnabled() const { return m_scrollingCacheEnabled; }
+
     const QVector<WaveformWidgetAbstractHandle> getAvailableTypes() const { return m_waveformWidgetHandles;}
     void getAvailableVSyncTypes(QList<QPair<int, QString > >* list);
     void destroyWidgets();
@@ -135,6 +142,15 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
 
     WaveformWidgetType::Type autoChooseWidgetType() const;
 
+    const FrameTimeRecorder& frameTimeRecorder() const {
+        return m_frameTimeRecorder;
+    }
+    void clearFrameTimes() {
+        m_frameTimeRecorder.clear();
+    }
+    /// The names of the widgets in the order of the recorded frame times
+    QStringList frameTimeWidgetNames() const;
+
   signals:
     void waveformUpdateTick();
     void waveformMeasured(float frameRate, int droppedFrames);
@@ -158,6 +174,8 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
     void evaluateWidgets();
     WaveformWidgetAbstract* createWaveformWidget(WaveformWidgetType::Type type, WWaveformViewer* viewer);
     int findIndexOf(WWaveformViewer* viewer) const;
+    /// Moves the frames of the WaveformRenderThread into the recorder
+    void recordOffscreenFrames();
 
     WaveformWidgetType::Type findTypeFromHandleIndex(int index);
 
@@ -180,6 +198,7 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
     bool m_zoomSync;
     double m_visualGain[FilterCount];
     bool m_overviewNormalized;
+    bool m_scrollingCacheEnabled;
 
     bool m_openGlAvailable;
     bool m_openGlesAvailable;
@@ -188,10 +207,12 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
     int m_beatGridAlpha;
 
     VSyncThread* m_vsyncThread;
+    WaveformRenderThread* m_pRenderThread;
     GuiTick* m_pGuiTick;  // not owned
     VisualsManager* m_pVisualsManager;  // not owned
 
     //Debug
+    FrameTimeRecorder m_frameTimeRecorder;
     PerformanceTimer m_time;
     float m_frameCnt;
     double m_actualFrameRate;
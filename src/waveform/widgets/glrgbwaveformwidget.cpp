@@ -46,6 +46,7 @@ void GLRGBWaveformWidget::castToQWidget() {
 
 void GLRGBWaveformWidget::paintEvent(QPaintEvent* event) {
     Q_UNUSED(event);
+    invalidateFrame();
 }
 
 mixxx::Duration GLRGBWaveformWidget::render() {
@@ -48,6 +48,7 @@ void GLSimpleWaveformWidget::castToQWidget() {
 
 void GLSimpleWaveformWidget::paintEvent(QPaintEvent* event) {
     Q_UNUSED(event);
+    invalidateFrame();
 }
 
 mixxx::Duration GLSimpleWaveformWidget::render() {
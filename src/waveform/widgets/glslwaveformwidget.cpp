@@ -77,6 +77,7 @@ void GLSLWaveformWidget::castToQWidget() {
 
 void GLSLWaveformWidget::paintEvent(QPaintEvent* event) {
     Q_UNUSED(event);
+    invalidateFrame();
 }
 
 mixxx::Duration GLSLWaveformWidget::render() {
@@ -51,6 +51,7 @@ void GLVSyncTestWidget::castToQWidget() {
 
 void GLVSyncTestWidget::paintEvent(QPaintEvent* event) {
     Q_UNUSED(event);
+    invalidateFrame();
 }
 
 mixxx::Duration GLVSyncTestWidget::render() {
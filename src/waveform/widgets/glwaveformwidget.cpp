@@ -50,6 +50,7 @@ void GLWaveformWidget::castToQWidget() {
 
 void GLWaveformWidget::paintEvent(QPaintEvent* event) {
     Q_UNUSED(event);
+    invalidateFrame();
 }
 
 mixxx::Duration GLWaveformWidget::render() {
@@ -38,5 +38,8 @@ void HSVWaveformWidget::castToQWidget() {
 
 void HSVWaveformWidget::paintEvent(QPaintEvent* event) {
     QPainter painter(this);
-    draw(&painter,event);
+    if (drawOffscreenFrame(&painter)) {
+        return;
+    }
+    draw(&painter, event);
 }
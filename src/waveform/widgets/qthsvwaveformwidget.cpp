@@ -43,6 +43,7 @@ void QtHSVWaveformWidget::castToQWidget() {
 
 void QtHSVWaveformWidget::paintEvent(QPaintEvent* event) {
     Q_UNUSED(event);
+    invalidateFrame();
 }
 
 mixxx::Duration QtHSVWaveformWidget::render() {
@@ -47,6 +47,7 @@ void QtRGBWaveformWidget::castToQWidget() {
 
 void QtRGBWaveformWidget::paintEvent(QPaintEvent* event) {
     Q_UNUSED(event);
+    invalidateFrame();
 }
 
 mixxx::Duration QtRGBWaveformWidget::render() {
@@ -50,6 +50,7 @@ void QtSimpleWaveformWidget::castToQWidget() {
 void QtSimpleWaveformWidget::paintEvent(QPaintEvent* event) {
     //qDebug() << "paintEvent()";
     Q_UNUSED(event);
+    invalidateFrame();
 }
 
 mixxx::Duration QtSimpleWaveformWidget::render() {
@@ -42,6 +42,7 @@ void QtVSyncTestWidget::castToQWidget() {
 
 void QtVSyncTestWidget::paintEvent(QPaintEvent* event) {
     Q_UNUSED(event);
+    invalidateFrame();
 }
 
 mixxx::Duration QtVSyncTestWidget::render() {
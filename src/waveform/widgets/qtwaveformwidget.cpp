@@ -48,6 +48,7 @@ void QtWaveformWidget::castToQWidget() {
 
 void QtWaveformWidget::paintEvent(QPaintEvent* event) {
     Q_UNUSED(event);
+    invalidateFrame();
 }
 
 mixxx::Duration QtWaveformWidget::render() {
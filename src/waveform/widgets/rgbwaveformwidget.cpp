@@ -38,5 +38,8 @@ void RGBWaveformWidget::castToQWidget() {
 
 void RGBWaveformWidget::paintEvent(QPaintEvent* event) {
     QPainter painter(this);
-    draw(&painter,event);
+    if (drawOffscreenFrame(&painter)) {
+        return;
+    }
+    draw(&painter, event);
 }
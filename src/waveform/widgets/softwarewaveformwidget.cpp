@@ -38,5 +38,8 @@ void SoftwareWaveformWidget::castToQWidget() {
 
 void SoftwareWaveformWidget::paintEvent(QPaintEvent* event) {
     QPainter painter(this);
+    if (drawOffscreenFrame(&painter)) {
+        return;
+    }
     draw(&painter, event);
 }
@@ -17,6 +17,8 @@ class SoftwareWaveformWidget : public QWidget, public WaveformWidgetAbstract {
     static inline bool useOpenGLShaders() { return false; }
     static inline bool developerOnly() { return false; }
 
+    virtual bool rendersOffscreen() const { return true; }
+
   protected:
     virtual void castToQWidget();
     virtual void paintEvent(QPaintEvent* event);
@@ -1,17 +1,27 @@
 #include "waveformwidgetabstract.h"
 
+#include <QPainter>
 #include <QWidget>
 #include <QtDebug>
 
+#include "util/compatibility/qmutex.h"
+#include "util/time.h"
 #include "waveform/renderers/waveformwidgetrenderer.h"
+#include "waveform/waveformrenderthread.h"
 
 WaveformWidgetAbstract::WaveformWidgetAbstract(const QString& group)
         : WaveformWidgetRenderer(group),
-          m_initSuccess(false) {
+          m_initSuccess(false),
+          m_pRenderThread(nullptr),
+          m_shownOffscreen(false) {
     m_widget = nullptr;
 }
 
 WaveformWidgetAbstract::~WaveformWidgetAbstract() {
+    if (m_pRenderThread) {
+        // Waits for a frame that is currently drawn
+        m_pRenderThread->removeWidget(this);
+    }
 }
 
 void WaveformWidgetAbstract::hold() {
@@ -27,10 +37,17 @@ void WaveformWidgetAbstract::release() {
 }
 
 void WaveformWidgetAbstract::preRender(VSyncThread* vsyncThread) {
+    // The WaveformRenderThread prepares its frames itself
+    DEBUG_ASSERT(!m_pRenderThread);
     WaveformWidgetRenderer::onPreRender(vsyncThread);
+    updateRenderState();
 }
 
 mixxx::Duration WaveformWidgetAbstract::render() {
+    if (m_pRenderThread) {
+        // The render thread schedules the repaint when the frame is finished
+        return mixxx::Duration();
+    }
     if (m_widget) {
         m_widget->repaint(); // Repaints the widget directly by calling paintEvent()
     }
@@ -46,3 +63,54 @@ void WaveformWidgetAbstract::resize(int width, int height) {
     }
     WaveformWidgetRenderer::resize(width, height, static_cast<float>(devicePixelRatio));
 }
+
+bool WaveformWidgetAbstract::renderOffscreenFrame(
+        const PerformanceTimer& frameTimer, int displayMicros) {
+    // Stays zero unless a frame is rendered
+    m_offscreenFrameDuration = mixxx::Duration();
+    if (!m_shownOffscreen.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    m_offscreenFrameStart = mixxx::Time::elapsed();
+    {
+        // Only blocks the GUI thread if it changes the configuration of the
+        // renderers, e.g. on resize or zoom, while the frame is drawn.
+        const auto locker = lockMutex(&m_renderStateMutex);
+        WaveformWidgetRenderer::onPreRender(frameTimer, displayMicros);
+        updateRenderState();
+        if (!needsRender() || m_width <= 0 || m_height <= 0) {
+            return false;
+        }
+        const QSize imageSize(
+                static_cast<int>(m_width * m_devicePixelRatio),
+                static_cast<int>(m_height * m_devicePixelRatio));
+        if (m_backImage.size() != imageSize) {
+            m_backImage = QImage(imageSize, QImage::Format_ARGB32_Premultiplied);
+        }
+        m_backImage.setDevicePixelRatio(m_devicePixelRatio);
+        QPainter painter(&m_backImage);
+        draw(&painter, nullptr);
+    }
+    {
+        const auto locker = lockMutex(&m_frontImageMutex);
+        m_frontImage.swap(m_backImage);
+    }
+    m_offscreenFrameDuration = mixxx::Time::elapsed() - m_offscreenFrameStart;
+    // QWidget::update() is a slot and is invoked on the GUI thread
+    QMetaObject::invokeMethod(m_widget, "update", Qt::QueuedConnection);
+    return true;
+}
+
+bool WaveformWidgetAbstract::drawOffscreenFrame(QPainter* painter) {
+    if (!m_pRenderThread) {
+        return false;
+    }
+    const auto locker = lockMutex(&m_frontImageMutex);
+    if (m_frontImage.isNull()) {
+        // No frame has been rendered yet
+        painter->fillRect(m_widget->rect(), m_colors.getBgColor());
+    } else {
+        painter->drawImage(QPoint(0, 0), m_frontImage);
+    }
+    return true;
+}
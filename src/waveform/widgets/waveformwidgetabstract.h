@@ -1,13 +1,17 @@
 #pragma once
 
+#include <QImage>
+#include <QMutex>
 #include <QString>
 #include <QWidget>
+#include <atomic>
 
 #include "util/duration.h"
 #include "waveform/renderers/waveformwidgetrenderer.h"
 #include "waveformwidgettype.h"
 
 class VSyncThread;
+class WaveformRenderThread;
 
 // NOTE(vRince) This class represent objects the waveformwidgetfactory can
 // holds, IMPORTANT all WaveformWidgetAbstract MUST inherist QWidget too !!  we
@@ -32,6 +36,20 @@ class WaveformWidgetAbstract : public WaveformWidgetRenderer {
     virtual mixxx::Duration render();
     virtual void resize(int width, int height);
 
+    /// True for widgets that paint with QPainter into a plain QWidget. Their
+    /// frames can be drawn into an offscreen image on the WaveformRenderThread.
+    virtual bool rendersOffscreen() const {
+        return false;
+    }
+    bool isRenderedOffscreen() const {
+        return m_pRenderThread != nullptr;
+    }
+    /// Called by the GUI thread on every tick for widgets that are rendered
+    /// offscreen. The WaveformRenderThread only draws the shown widgets.
+    void setShownOffscreen(bool shown) {
+        m_shownOffscreen.store(shown, std::memory_order_relaxed);
+    }
+
   protected:
     QWidget* m_widget;
     bool m_initSuccess;
@@ -39,5 +57,26 @@ class WaveformWidgetAbstract : public WaveformWidgetRenderer {
     //this is the factory resposability to trigger QWidget casting after constructor
     virtual void castToQWidget() = 0;
 
+    /// Blits the last frame from the WaveformRenderThread. Returns false if
+    /// the widget is not rendered offscreen and needs to draw itself.
+    bool drawOffscreenFrame(QPainter* painter);
+
+  private:
+    /// Called on the WaveformRenderThread for a frame that is displayed
+    /// displayMicros after frameTimer has been started. Returns false if the
+    /// widget is hidden or has not changed since the last frame.
+    bool renderOffscreenFrame(const PerformanceTimer& frameTimer, int displayMicros);
+
+    WaveformRenderThread* m_pRenderThread;
+    std::atomic<bool> m_shownOffscreen;
+    // Only touched by the WaveformRenderThread
+    QImage m_backImage;
+    mixxx::Duration m_offscreenFrameStart;
+    mixxx::Duration m_offscreenFrameDuration;
+    // Guards m_frontImage, which is painted by the GUI thread
+    QMutex m_frontImageMutex;
+    QImage m_frontImage;
+
     friend class WaveformWidgetFactory;
+    friend class WaveformRenderThread;
 };
@@ -2,14 +2,32 @@
 
 #include <QDir>
 #include <QString>
+#include <QtConcurrentRun>
 #include <QtDebug>
 
 #include "skin/legacy/imgloader.h"
+#include "skin/legacy/skinimagecache.h"
 
 #include "util/math.h"
 #include "util/memory.h"
 #include "util/painterscope.h"
 
+namespace {
+
+QImage rasterizeSvg(QSvgRenderer* pSvg,
+        double scaleFactor,
+        const ImgSource& loader) {
+    QImage image(pSvg->defaultSize() * scaleFactor, QImage::Format_ARGB32);
+    image.fill(0x00000000); // Transparent black.
+    QPainter painter(&image);
+    pSvg->render(&painter);
+    painter.end();
+    loader.correctImageColors(&image);
+    return image;
+}
+
+} // anonymous namespace
+
 // static
 Paintable::DrawMode Paintable::DrawModeFromString(const QString& str) {
     if (str.compare("FIXED", Qt::CaseInsensitive) == 0) {
@@ -48,10 +66,44 @@ QString Paintable::DrawModeToString(DrawMode mode) {
 
 Paintable::Paintable(const PixmapSource& source, DrawMode mode, double scaleFactor)
         : m_drawMode(mode),
-          m_source(source) {
+          m_source(source),
+          m_rasterizing(false) {
     if (!source.isSVG()) {
         m_pPixmap.reset(WPixmapStore::getPixmapNoCache(source.getPath(), scaleFactor));
     } else {
+#ifdef __APPLE__
+        // Apple does Retina scaling behind the scenes, so we also pass a
+        // Paintable::FIXED image. On the other targets, it is better to
+        // cache the pixmap. We do not do this for TILE and color schemas.
+        // which can result in a correct but possibly blurry picture at a
+        // Retina display. This can be fixed when switching to QT5
+        const bool rasterize = mode == TILE || WPixmapStore::willCorrectColors();
+#else
+        const bool rasterize = mode == TILE || mode == Paintable::FIXED ||
+                WPixmapStore::willCorrectColors();
+#endif
+        QByteArray cacheKey;
+        if (rasterize && SkinImageCache::isEnabled()) {
+            QByteArray svgData = source.getSvgSourceData();
+            if (svgData.isEmpty() && !source.getPath().isEmpty()) {
+                QFile svgFile(source.getPath());
+                if (svgFile.open(QIODevice::ReadOnly)) {
+                    svgData = svgFile.readAll();
+                }
+            }
+            if (!svgData.isEmpty()) {
+                cacheKey = SkinImageCache::key(svgData,
+                        scaleFactor,
+                        WPixmapStore::getColorSchemeId());
+                const QImage cachedImage = SkinImageCache::load(cacheKey);
+                if (!cachedImage.isNull()) {
+                    // The SVG itself is not needed for drawing the pixmap
+                    m_pPixmap.reset(new QPixmap(QPixmap::fromImage(cachedImage)));
+                    return;
+                }
+            }
+        }
+
         auto pSvg = std::make_unique<QSvgRenderer>();
         if (!source.getSvgSourceData().isEmpty()) {
             // Call here the different overload for svg content
@@ -68,36 +120,64 @@ Paintable::Paintable(const PixmapSource& source, DrawMode mode, double scaleFact
             return;
         }
         m_pSvg.reset(pSvg.release());
-#ifdef __APPLE__
-        // Apple does Retina scaling behind the scenes, so we also pass a
-        // Paintable::FIXED image. On the other targets, it is better to
-        // cache the pixmap. We do not do this for TILE and color schemas.
-        // which can result in a correct but possibly blurry picture at a
-        // Retina display. This can be fixed when switching to QT5
-        if (mode == TILE || WPixmapStore::willCorrectColors()) {
-#else
-        if (mode == TILE || mode == Paintable::FIXED || WPixmapStore::willCorrectColors()) {
-#endif
+        if (rasterize) {
             // The SVG renderer doesn't directly support tiling, so we render
             // it to a pixmap which will then get tiled.
-            QImage copy_buffer(m_pSvg->defaultSize() * scaleFactor, QImage::Format_ARGB32);
-            copy_buffer.fill(0x00000000);  // Transparent black.
-            QPainter painter(&copy_buffer);
-            m_pSvg->render(&painter);
-            WPixmapStore::correctImageColors(&copy_buffer);
-
-            m_pPixmap.reset(new QPixmap(copy_buffer.size()));
-            m_pPixmap->convertFromImage(copy_buffer);
+            // Keep the loader alive even if it is replaced while rendering.
+            const QSharedPointer<ImgSource> pLoader = WPixmapStore::getLoader();
+            if (WPixmapStore::isRasterizationDeferred()) {
+                m_rasterizing = true;
+                m_pendingSize = m_pSvg->defaultSize() * scaleFactor;
+                m_pendingCacheKey = cacheKey;
+                m_pendingImage = QtConcurrent::run(
+                        [pSvg = m_pSvg.data(), scaleFactor, pLoader] {
+                            return rasterizeSvg(pSvg, scaleFactor, *pLoader);
+                        });
+                WPixmapStore::addPendingRasterization(this);
+            } else {
+                setRasterizedImage(rasterizeSvg(m_pSvg.data(), scaleFactor, *pLoader),
+                        cacheKey);
+            }
         }
     }
 }
 
+Paintable::~Paintable() {
+    if (m_rasterizing) {
+        // The worker still renders m_pSvg
+        m_pendingImage.waitForFinished();
+        WPixmapStore::removePendingRasterization(this);
+    }
+}
+
+void Paintable::finishRasterization() {
+    if (!m_rasterizing) {
+        return;
+    }
+    const QImage image = m_pendingImage.result();
+    WPixmapStore::removePendingRasterization(this);
+    m_rasterizing = false;
+    m_pendingImage = QFuture<QImage>();
+    setRasterizedImage(image, m_pendingCacheKey);
+    m_pendingCacheKey.clear();
+}
+
+void Paintable::setRasterizedImage(const QImage& image, const QByteArray& cacheKey) {
+    if (!cacheKey.isEmpty()) {
+        SkinImageCache::store(cacheKey, image);
+    }
+    m_pPixmap.reset(new QPixmap(image.size()));
+    m_pPixmap->convertFromImage(image);
+}
+
 bool Paintable::isNull() const {
     return m_source.isEmpty();
 }
 
 QSize Paintable::size() const {
-    if (!m_pPixmap.isNull()) {
+    if (m_rasterizing) {
+        return m_pendingSize;
+    } else if (!m_pPixmap.isNull()) {
         return m_pPixmap->size();
     } else if (!m_pSvg.isNull()) {
         return m_pSvg->defaultSize();
@@ -106,7 +186,9 @@ QSize Paintable::size() const {
 }
 
 int Paintable::width() const {
-    if (!m_pPixmap.isNull()) {
+    if (m_rasterizing) {
+        return m_pendingSize.width();
+    } else if (!m_pPixmap.isNull()) {
         return m_pPixmap->width();
     } else if (!m_pSvg.isNull()) {
         QSize size = m_pSvg->defaultSize();
@@ -116,7 +198,9 @@ int Paintable::width() const {
 }
 
 int Paintable::height() const {
-    if (!m_pPixmap.isNull()) {
+    if (m_rasterizing) {
+        return m_pendingSize.height();
+    } else if (!m_pPixmap.isNull()) {
         return m_pPixmap->height();
     } else if (!m_pSvg.isNull()) {
         QSize size = m_pSvg->defaultSize();
@@ -126,7 +210,9 @@ int Paintable::height() const {
 }
 
 QRectF Paintable::rect() const {
-    if (!m_pPixmap.isNull()) {
+    if (m_rasterizing) {
+        return QRectF(QPointF(0, 0), m_pendingSize);
+    } else if (!m_pPixmap.isNull()) {
         return m_pPixmap->rect();
     } else if (!m_pSvg.isNull()) {
         return QRectF(QPointF(0, 0), m_pSvg->defaultSize());
@@ -236,6 +322,7 @@ void Paintable::drawInternal(const QRectF& targetRect, QPainter* pPainter,
                              const QRectF& sourceRect) {
     // qDebug() << "Paintable::drawInternal" << DrawModeToString(m_draw_mode)
     //          << targetRect << sourceRect;
+    finishRasterization();
     if (m_pPixmap) {
         if (m_drawMode == TILE) {
             // TODO(rryan): Using a source rectangle doesn't make much sense
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QFuture>
 #include <QPixmap>
 #include <QHash>
 #include <QSharedPointer>
@@ -29,6 +30,7 @@ class Paintable {
     };
 
     Paintable(const PixmapSource& source, DrawMode mode, double scaleFactor);
+    ~Paintable();
 
     QSize size() const;
     int width() const;
@@ -46,6 +48,15 @@ class Paintable {
                       const QRectF& sourceRect);
     bool isNull() const;
 
+    /// True while the SVG is rasterized on a worker thread, see
+    /// WPixmapStore::beginDeferredRasterization().
+    bool isRasterizing() const {
+        return m_rasterizing;
+    }
+    /// Waits for the rasterized image and converts it to the pixmap.
+    /// Drawing does this implicitly.
+    void finishRasterization();
+
     static DrawMode DrawModeFromString(const QString& str);
     static QString DrawModeToString(DrawMode mode);
     static QString getAltFileName(const QString& fileName);
@@ -53,9 +64,17 @@ class Paintable {
   private:
     void drawInternal(const QRectF& targetRect, QPainter* pPainter,
                       const QRectF& sourceRect);
+    void setRasterizedImage(const QImage& image, const QByteArray& cacheKey);
 
     QScopedPointer<QPixmap> m_pPixmap;
     QScopedPointer<QSvgRenderer> m_pSvg;
     DrawMode m_drawMode;
     PixmapSource m_source;
+
+    // While m_rasterizing is set, m_pSvg is rendered on a worker thread
+    // and must not be touched until m_pendingImage has finished.
+    bool m_rasterizing;
+    QSize m_pendingSize;
+    QByteArray m_pendingCacheKey;
+    QFuture<QImage> m_pendingImage;
 };
@@ -18,7 +18,10 @@
 #include <QPaintEvent>
 #include <QPainter>
 #include <QUrl>
+#include <QtConcurrentRun>
 #include <QtDebug>
+#include <algorithm>
+#include <cmath>
 
 #include "analyzer/analyzerprogress.h"
 #include "control/controlobject.h"
@@ -39,6 +42,37 @@
 #include "widget/controlwidgetconnection.h"
 #include "wskincolor.h"
 
+namespace {
+
+// The scaled images of the sizes that were used most recently are kept,
+// e.g. for skins that switch between a small and a big overview
+constexpr std::size_t kMaxScaledWaveformImages = 4;
+
+// Scales columnCount columns of the source image starting at firstColumn to
+// length x breadth device pixels. The source image is cropped by diffGain at
+// the top and the bottom, which zooms the waveform by the visual gain.
+QImage scaleWaveformColumns(const QImage& sourceImage,
+        int firstColumn,
+        int columnCount,
+        float diffGain,
+        int length,
+        int breadth,
+        Qt::Orientation orientation) {
+    const int crop = static_cast<int>(diffGain);
+    QImage image = sourceImage.copy(firstColumn,
+            crop,
+            columnCount,
+            sourceImage.height() - 2 * crop);
+    image = image.scaled(length, breadth, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    if (orientation == Qt::Vertical) {
+        // Rotating the scaled image is cheaper than rotating the source
+        image = image.transformed(QTransform(0, 1, 1, 0, 0, 0));
+    }
+    return image;
+}
+
+} // anonymous namespace
+
 WOverview::WOverview(
         const QString& group,
         PlayerManager* pPlayerManager,
@@ -48,7 +82,6 @@ WOverview::WOverview(
           m_actualCompletion(0),
           m_pixmapDone(false),
           m_waveformPeak(-1.0),
-          m_diffGain(0),
           m_devicePixelRatio(1.0),
           m_group(group),
           m_pConfig(pConfig),
@@ -68,7 +101,8 @@ WOverview::WOverview(
           m_b(0.0),
           m_analyzerProgress(kAnalyzerProgressUnknown),
           m_trackLoaded(false),
-          m_scaleFactor(1.0) {
+          m_scaleFactor(1.0),
+          m_scaledWaveformImagePending(false) {
     m_endOfTrackControl = new ControlProxy(
             m_group, "end_of_track", this, ControlFlag::NoAssertIfMissing);
     m_endOfTrackControl->connectValueChanged(this, &WOverview::onEndOfTrackChange);
@@ -96,6 +130,11 @@ WOverview::WOverview(
 
     connect(m_pCueMenuPopup.get(), &WCueMenuPopup::aboutToHide, this, &WOverview::slotCueMenuPopupAboutToHide);
 
+    connect(&m_scaledWaveformImageWatcher,
+            &QFutureWatcher<QImage>::finished,
+            this,
+            &WOverview::slotScaledWaveformImageReady);
+
     m_pPassthroughLabel = new QLabel(this);
     m_pPassthroughLabel->setObjectName("PassthroughLabel");
     m_pPassthroughLabel->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
@@ -273,13 +312,15 @@ void WOverview::slotWaveformSummaryUpdated() {
         // If the waveform is already complete, just draw it.
         if (m_pWaveform->getCompletion() == m_pWaveform->getDataSize()) {
             m_actualCompletion = 0;
-            if (drawNextPixmapPart()) {
+            invalidateScaledWaveformImages();
+            if (drawNextWaveformPart()) {
                 update();
             }
         }
     } else {
         // Null waveform pointer means waveform was cleared.
         m_waveformSourceImage = QImage();
+        clearScaledWaveformImages();
         m_analyzerProgress = kAnalyzerProgressUnknown;
         m_actualCompletion = 0;
         m_waveformPeak = -1.0;
@@ -294,7 +335,7 @@ void WOverview::onTrackAnalyzerProgress(TrackId trackId, AnalyzerProgress analyz
         return;
     }
 
-    bool updateNeeded = drawNextPixmapPart();
+    bool updateNeeded = drawNextWaveformPart();
     if (updateNeeded || (m_analyzerProgress != analyzerProgress)) {
         m_analyzerProgress = analyzerProgress;
         update();
@@ -324,6 +365,7 @@ void WOverview::slotLoadingTrack(TrackPointer pNewTrack, TrackPointer pOldTrack)
     }
 
     m_waveformSourceImage = QImage();
+    clearScaledWaveformImages();
     m_analyzerProgress = kAnalyzerProgressUnknown;
     m_actualCompletion = 0;
     m_waveformPeak = -1.0;
@@ -348,6 +390,131 @@ void WOverview::slotLoadingTrack(TrackPointer pNewTrack, TrackPointer pOldTrack)
     update();
 }
 
+bool WOverview::drawNextWaveformPart() {
+    const int previousCompletion = m_actualCompletion;
+    if (!drawNextPixmapPart()) {
+        return false;
+    }
+    for (auto& scaledImage : m_scaledWaveformImages) {
+        if (scaledImage.completion == previousCompletion) {
+            extendScaledWaveformImage(&scaledImage);
+        } else {
+            scaledImage.completion = -1;
+        }
+    }
+    // A pending image is extended when it is ready
+    return true;
+}
+
+void WOverview::extendScaledWaveformImage(ScaledWaveformImage* pScaledImage) const {
+    const int sourceLength = m_waveformSourceImage.width();
+    const int firstColumn = pScaledImage->completion / 2;
+    const int endColumn = m_actualCompletion / 2;
+    if (endColumn <= firstColumn || sourceLength == 0) {
+        pScaledImage->completion = m_actualCompletion;
+        return;
+    }
+    ScopedTimer t("WOverview::extendScaledWaveformImage");
+
+    const QSize size = pScaledImage->size;
+    const int length = m_orientation == Qt::Horizontal ? size.width() : size.height();
+    const int breadth = m_orientation == Qt::Horizontal ? size.height() : size.width();
+    const double scale = static_cast<double>(length) / sourceLength;
+    // The device pixels that are affected by the new columns and the source
+    // columns that cover them, so the seams blend like a complete rescale
+    const int firstPixel = static_cast<int>(std::floor(firstColumn * scale));
+    const int endPixel = math_min(length, static_cast<int>(std::ceil(endColumn * scale)));
+    if (endPixel > firstPixel) {
+        const int firstSourceColumn = static_cast<int>(std::floor(firstPixel / scale));
+        const int endSourceColumn = math_clamp(
+                static_cast<int>(std::ceil(endPixel / scale)),
+                firstSourceColumn + 1,
+                sourceLength);
+        const QImage part = scaleWaveformColumns(m_waveformSourceImage,
+                firstSourceColumn,
+                endSourceColumn - firstSourceColumn,
+                pScaledImage->diffGain,
+                endPixel - firstPixel,
+                breadth,
+                m_orientation);
+        QPainter painter(&pScaledImage->image);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        if (m_orientation == Qt::Horizontal) {
+            painter.drawImage(firstPixel, 0, part);
+        } else {
+            painter.drawImage(0, firstPixel, part);
+        }
+    }
+    pScaledImage->completion = m_actualCompletion;
+}
+
+const WOverview::ScaledWaveformImage* WOverview::scaledWaveformImage(
+        QSize size, float diffGain) {
+    const auto it = std::find_if(m_scaledWaveformImages.begin(),
+            m_scaledWaveformImages.end(),
+            [size, diffGain](const ScaledWaveformImage& scaledImage) {
+                return scaledImage.completion >= 0 &&
+                        scaledImage.size == size &&
+                        scaledImage.diffGain == diffGain;
+            });
+    if (it != m_scaledWaveformImages.end()) {
+        std::rotate(m_scaledWaveformImages.begin(), it, it + 1);
+        return &m_scaledWaveformImages.front();
+    }
+
+    // Only one image is scaled at a time, slotScaledWaveformImageReady()
+    // repaints and thereby requests the next one.
+    if (!m_scaledWaveformImagePending) {
+        m_scaledWaveformImagePending = true;
+        m_pendingScaledWaveformImage = ScaledWaveformImage{
+                size, diffGain, m_actualCompletion, QImage()};
+        // The worker scales a shallow copy, drawNextPixmapPart() detaches
+        // m_waveformSourceImage when painting into it in the meantime.
+        const QImage sourceImage = m_waveformSourceImage;
+        const Qt::Orientation orientation = m_orientation;
+        const int length = orientation == Qt::Horizontal ? size.width() : size.height();
+        const int breadth = orientation == Qt::Horizontal ? size.height() : size.width();
+        m_scaledWaveformImageWatcher.setFuture(QtConcurrent::run(
+                [sourceImage, diffGain, length, breadth, orientation] {
+                    return scaleWaveformColumns(sourceImage,
+                            0,
+                            sourceImage.width(),
+                            diffGain,
+                            length,
+                            breadth,
+                            orientation);
+                }));
+    }
+    return nullptr;
+}
+
+void WOverview::slotScaledWaveformImageReady() {
+    m_scaledWaveformImagePending = false;
+    ScaledWaveformImage scaledImage = std::move(m_pendingScaledWaveformImage);
+    if (scaledImage.completion >= 0) {
+        scaledImage.image = m_scaledWaveformImageWatcher.result();
+        // Add the columns that were analyzed while scaling
+        extendScaledWaveformImage(&scaledImage);
+        m_scaledWaveformImages.insert(m_scaledWaveformImages.begin(), std::move(scaledImage));
+        if (m_scaledWaveformImages.size() > kMaxScaledWaveformImages) {
+            m_scaledWaveformImages.pop_back();
+        }
+    }
+    update();
+}
+
+void WOverview::invalidateScaledWaveformImages() {
+    for (auto& scaledImage : m_scaledWaveformImages) {
+        scaledImage.completion = -1;
+    }
+    m_pendingScaledWaveformImage.completion = -1;
+}
+
+void WOverview::clearScaledWaveformImages() {
+    m_scaledWaveformImages.clear();
+    m_pendingScaledWaveformImage.completion = -1;
+}
+
 void WOverview::onEndOfTrackChange(double v) {
     //qDebug() << "WOverview::onEndOfTrackChange()" << v;
     m_endOfTrack = v > 0.0;
@@ -643,24 +810,16 @@ void WOverview::drawWaveformPixmap(QPainter* pPainter) {
             diffGain = 255.0f - (255.0f / visualGain);
         }
 
-        if (m_diffGain != diffGain || m_waveformImageScaled.isNull()) {
-            QRect sourceRect(0,
-                    static_cast<int>(diffGain),
-                    m_waveformSourceImage.width(),
-                    m_waveformSourceImage.height() -
-                            2 * static_cast<int>(diffGain));
-            QImage croppedImage = m_waveformSourceImage.copy(sourceRect);
-            if (m_orientation == Qt::Vertical) {
-                // Rotate pixmap
-                croppedImage = croppedImage.transformed(QTransform(0, 1, 1, 0, 0, 0));
+        const ScaledWaveformImage* pScaledImage =
+                scaledWaveformImage(size() * m_devicePixelRatio, diffGain);
+        if (!pScaledImage) {
+            // Stretch the most recent image until the new one is scaled
+            if (m_scaledWaveformImages.empty()) {
+                return;
             }
-            m_waveformImageScaled = croppedImage.scaled(size() * m_devicePixelRatio,
-                    Qt::IgnoreAspectRatio,
-                    Qt::SmoothTransformation);
-            m_diffGain = diffGain;
+            pScaledImage = &m_scaledWaveformImages.front();
         }
-
-        pPainter->drawImage(rect(), m_waveformImageScaled);
+        pPainter->drawImage(rect(), pScaledImage->image);
     }
 }
 
@@ -670,14 +829,14 @@ void WOverview::drawPlayedOverlay(QPainter* pPainter) {
         if (m_orientation == Qt::Vertical) {
             pPainter->fillRect(0,
                     0,
-                    m_waveformImageScaled.width(),
+                    width(),
                     m_iPlayPos,
                     m_playedOverlayColor);
         } else {
             pPainter->fillRect(0,
                     0,
                     m_iPlayPos,
-                    m_waveformImageScaled.height(),
+                    height(),
                     m_playedOverlayColor);
         }
     }
@@ -1246,10 +1405,8 @@ void WOverview::resizeEvent(QResizeEvent* pEvent) {
     m_a = (length() - 1) / (one - zero);
     m_b = zero * m_a;
 
+    // The scaled waveform image for the new size is requested when painting
     m_devicePixelRatio = devicePixelRatioF();
-
-    m_waveformImageScaled = QImage();
-    m_diffGain = 0;
     Init();
 }
 
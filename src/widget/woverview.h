@@ -12,10 +12,13 @@
 #pragma once
 
 #include <QColor>
+#include <QFutureWatcher>
+#include <QImage>
 #include <QList>
 #include <QMouseEvent>
 #include <QPaintEvent>
 #include <QPixmap>
+#include <vector>
 
 #include "analyzer/analyzerprogress.h"
 #include "skin/legacy/skincontext.h"
@@ -79,7 +82,6 @@ class WOverview : public WWidget, public TrackDropTarget {
     }
 
     QImage m_waveformSourceImage;
-    QImage m_waveformImageScaled;
 
     WaveformSignalColors m_signalColors;
 
@@ -89,7 +91,6 @@ class WOverview : public WWidget, public TrackDropTarget {
     bool m_pixmapDone;
     float m_waveformPeak;
 
-    float m_diffGain;
     qreal m_devicePixelRatio;
 
   private slots:
@@ -103,11 +104,34 @@ class WOverview : public WWidget, public TrackDropTarget {
 
     void slotWaveformSummaryUpdated();
     void slotCueMenuPopupAboutToHide();
+    void slotScaledWaveformImageReady();
 
   private:
+    // m_waveformSourceImage cropped by the gain and scaled to the size of
+    // the widget
+    struct ScaledWaveformImage {
+        // In device pixels
+        QSize size;
+        float diffGain = 0;
+        // m_actualCompletion when the image was scaled, -1 if the source
+        // image has been redrawn since
+        int completion = -1;
+        QImage image;
+    };
+
     // Append the waveform overview pixmap according to available data
     // in waveform
     virtual bool drawNextPixmapPart() = 0;
+    // Calls drawNextPixmapPart() and scales only the newly drawn part
+    // into the cached scaled images
+    bool drawNextWaveformPart();
+    void extendScaledWaveformImage(ScaledWaveformImage* pScaledImage) const;
+    // Returns the matching scaled image or nullptr after requesting it
+    // from a worker thread
+    const ScaledWaveformImage* scaledWaveformImage(QSize size, float diffGain);
+    // Keeps the images for drawing until their replacements are scaled
+    void invalidateScaledWaveformImages();
+    void clearScaledWaveformImages();
     void drawEndOfTrackBackground(QPainter* pPainter);
     void drawAxis(QPainter* pPainter);
     void drawWaveformPixmap(QPainter* pPainter);
@@ -196,4 +220,10 @@ class WOverview : public WWidget, public TrackDropTarget {
     AnalyzerProgress m_analyzerProgress;
     bool m_trackLoaded;
     double m_scaleFactor;
+
+    // The most recently used first, one per widget size and gain
+    std::vector<ScaledWaveformImage> m_scaledWaveformImages;
+    QFutureWatcher<QImage> m_scaledWaveformImageWatcher;
+    ScaledWaveformImage m_pendingScaledWaveformImage;
+    bool m_scaledWaveformImagePending;
 };
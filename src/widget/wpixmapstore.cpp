@@ -4,6 +4,7 @@
 #include <QString>
 #include <QtDebug>
 
+#include "util/assert.h"
 #include "util/math.h"
 #include "skin/legacy/imgloader.h"
 
@@ -11,6 +12,9 @@
 QHash<QString, WeakPaintablePointer> WPixmapStore::m_paintableCache;
 QSharedPointer<ImgSource> WPixmapStore::m_loader
         = QSharedPointer<ImgSource>(new ImgLoader());
+QString WPixmapStore::m_colorSchemeId;
+bool WPixmapStore::s_rasterizationDeferred = false;
+QSet<Paintable*> WPixmapStore::s_pendingRasterizations;
 
 // static
 PaintablePointer WPixmapStore::getPaintable(const PixmapSource& source,
@@ -56,8 +60,37 @@ bool WPixmapStore::willCorrectColors() {
     return m_loader->willCorrectColors();
 };
 
-void WPixmapStore::setLoader(QSharedPointer<ImgSource> ld) {
+// static
+void WPixmapStore::beginDeferredRasterization() {
+    DEBUG_ASSERT(s_pendingRasterizations.isEmpty());
+    s_rasterizationDeferred = true;
+}
+
+// static
+int WPixmapStore::finishDeferredRasterization() {
+    s_rasterizationDeferred = false;
+    // Finishing removes the Paintable from the set
+    const QSet<Paintable*> pending = s_pendingRasterizations;
+    for (Paintable* pPaintable : pending) {
+        pPaintable->finishRasterization();
+    }
+    DEBUG_ASSERT(s_pendingRasterizations.isEmpty());
+    return pending.size();
+}
+
+// static
+void WPixmapStore::addPendingRasterization(Paintable* pPaintable) {
+    s_pendingRasterizations.insert(pPaintable);
+}
+
+// static
+void WPixmapStore::removePendingRasterization(Paintable* pPaintable) {
+    s_pendingRasterizations.remove(pPaintable);
+}
+
+void WPixmapStore::setLoader(QSharedPointer<ImgSource> ld, const QString& colorSchemeId) {
     m_loader = ld;
+    m_colorSchemeId = colorSchemeId;
 
     // We shouldn't hand out pointers to existing pixmaps anymore since our
     // loader has changed. The pixmaps will get freed once all the widgets
@@ -2,6 +2,7 @@
 
 #include <QPixmap>
 #include <QHash>
+#include <QSet>
 #include <QSharedPointer>
 #include <QSvgRenderer>
 #include <QImage>
@@ -25,11 +26,37 @@ class WPixmapStore {
             Paintable::DrawMode mode,
             double scaleFactor);
     static QPixmap* getPixmapNoCache(const QString& fileName, double scaleFactor);
-    static void setLoader(QSharedPointer<ImgSource> ld);
+    /// The colorSchemeId identifies the filters of the loader for
+    /// caching the images on disk.
+    static void setLoader(QSharedPointer<ImgSource> ld,
+            const QString& colorSchemeId = QString());
+    static const QString& getColorSchemeId() {
+        return m_colorSchemeId;
+    }
+    static const QSharedPointer<ImgSource>& getLoader() {
+        return m_loader;
+    }
     static void correctImageColors(QImage* p);
     static bool willCorrectColors();
 
+    /// While deferred, the SVGs of new Paintables are rasterized in parallel
+    /// on the global thread pool. Their size is known immediately, the
+    /// pixmaps are created on the GUI thread by
+    /// finishDeferredRasterization(). Used while loading a skin.
+    static void beginDeferredRasterization();
+    static bool isRasterizationDeferred() {
+        return s_rasterizationDeferred;
+    }
+    /// Waits for all pending images and returns their count.
+    static int finishDeferredRasterization();
+
+    static void addPendingRasterization(Paintable* pPaintable);
+    static void removePendingRasterization(Paintable* pPaintable);
+
   private:
     static QHash<QString, WeakPaintablePointer> m_paintableCache;
     static QSharedPointer<ImgSource> m_loader;
+    static QString m_colorSchemeId;
+    static bool s_rasterizationDeferred;
+    static QSet<Paintable*> s_pendingRasterizations;
 };
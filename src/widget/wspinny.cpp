@@ -62,6 +62,8 @@ WSpinny::WSpinny(
           m_dRotationsPerSecond(MIXXX_VINYL_SPEED_33_NUM / 60),
           m_bClampFailedWarning(false),
           m_bGhostPlayback(false),
+          m_bFrameInvalidated(true),
+          m_bSwapPending(false),
           m_pPlayer(pPlayer),
           m_pDlgCoverArt(new DlgCoverArtFullSize(parent, pPlayer)),
           m_pCoverMenu(new WCoverArtMenu(this)) {
@@ -141,6 +143,7 @@ void WSpinny::onVinylSignalQualityUpdate(const VinylSignalQualityReport& report)
             line++;
         }
     }
+    m_bFrameInvalidated = true;
 #else
     Q_UNUSED(report);
 #endif
@@ -311,6 +314,8 @@ void WSpinny::slotReloadCoverArt() {
 
 void WSpinny::paintEvent(QPaintEvent *e) {
     Q_UNUSED(e);
+    // Drawn by render(), e.g. after update() or when the window is exposed
+    m_bFrameInvalidated = true;
 }
 
 void WSpinny::render(VSyncThread* vSyncThread) {
@@ -330,6 +335,15 @@ void WSpinny::render(VSyncThread* vSyncThread) {
                 &m_dGhostAngleCurrentPlaypos);
     }
 
+    // Skip the frame while the deck is stopped and nothing else changed
+    if (!m_bFrameInvalidated &&
+            m_dAngleCurrentPlaypos == m_dAngleLastPlaypos &&
+            m_dGhostAngleCurrentPlaypos == m_dGhostAngleLastPlaypos) {
+        return;
+    }
+    m_bFrameInvalidated = false;
+    m_bSwapPending = true;
+
     double scaleFactor = devicePixelRatioF();
 
     QPainter p(this);
@@ -401,7 +415,7 @@ void WSpinny::render(VSyncThread* vSyncThread) {
 }
 
 void WSpinny::swap() {
-    if (!isValid() || !isVisible()) {
+    if (!m_bSwapPending || !isValid() || !isVisible()) {
         return;
     }
     auto* window = windowHandle();
@@ -412,6 +426,7 @@ void WSpinny::swap() {
         makeCurrent();
     }
     swapBuffers();
+    m_bSwapPending = false;
 }
 
 
@@ -427,6 +442,7 @@ QPixmap WSpinny::scaledCoverArt(const QPixmap& normal) {
 }
 
 void WSpinny::resizeEvent(QResizeEvent* /*unused*/) {
+    m_bFrameInvalidated = true;
     m_loadedCoverScaled = scaledCoverArt(m_loadedCover);
     if (m_pFgImage && !m_pFgImage->isNull()) {
         m_fgImageScaled = m_pFgImage->scaled(
@@ -530,6 +546,9 @@ double WSpinny::calculatePositionFromAngle(double angle) {
 
 void WSpinny::updateVinylControlSpeed(double rpm) {
     m_dRotationsPerSecond = rpm/60.;
+    // The angle of the current position changes
+    m_dAngleLastPlaypos = -1;
+    m_dGhostAngleLastPlaypos = -1;
 }
 
 void WSpinny::updateVinylControlSignalEnabled(double enabled) {
@@ -546,6 +565,7 @@ void WSpinny::updateVinylControlSignalEnabled(double enabled) {
         // fill with transparent black
         m_qImage.fill(qRgba(0,0,0,0));
     }
+    m_bFrameInvalidated = true;
 #else
     Q_UNUSED(enabled);
 #endif
@@ -553,10 +573,12 @@ void WSpinny::updateVinylControlSignalEnabled(double enabled) {
 
 void WSpinny::updateVinylControlEnabled(double enabled) {
     m_bVinylActive = enabled != 0;
+    m_bFrameInvalidated = true;
 }
 
 void WSpinny::updateSlipEnabled(double enabled) {
     m_bGhostPlayback = static_cast<bool>(enabled);
+    m_bFrameInvalidated = true;
 }
 
 void WSpinny::mouseMoveEvent(QMouseEvent * e) {
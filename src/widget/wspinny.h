@@ -129,6 +129,9 @@ class WSpinny : public QGLWidget, public WBaseWidget, public VinylSignalQualityL
     double m_dRotationsPerSecond;
     bool m_bClampFailedWarning;
     bool m_bGhostPlayback;
+    // Unchanged frames are neither rendered nor swapped
+    bool m_bFrameInvalidated;
+    bool m_bSwapPending;
 
     BaseTrackPlayer* m_pPlayer;
     DlgCoverArtFullSize* m_pDlgCoverArt;
@@ -277,12 +277,12 @@ CuePointer WWaveformViewer::getCuePointerFromCueMark(WaveformMarkPointer pMark)
 void WWaveformViewer::highlightMark(WaveformMarkPointer pMark) {
     QColor highlightColor = Color::chooseContrastColor(pMark->fillColor(),
             m_dimBrightThreshold);
-    pMark->setBaseColor(highlightColor, m_dimBrightThreshold);
+    m_waveformWidget->setMarkBaseColor(pMark, highlightColor, m_dimBrightThreshold);
 }
 
 void WWaveformViewer::unhighlightMark(WaveformMarkPointer pMark) {
     QColor originalColor = mixxx::RgbColor::toQColor(getCuePointerFromCueMark(pMark)->getColor());
-    pMark->setBaseColor(originalColor, m_dimBrightThreshold);
+    m_waveformWidget->setMarkBaseColor(pMark, originalColor, m_dimBrightThreshold);
 }
 
 bool WWaveformViewer::isPlaying() const {
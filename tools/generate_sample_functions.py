@@ -204,8 +204,38 @@ def write_channelmixer_autogen(output, num_channels):
                     "processed signal into pOutput",
                     depth=2,
                 )
+            if inplace and i > 1:
+                # Channels without shared effect chains are processed in
+                # parallel
+                write(
+                    "const EngineEffectsManager::InPlaceChannel "
+                    "channels[%(i)d] = {" % {"i": i},
+                    depth=2,
+                )
+                for j in range(i):
+                    write(
+                        (
+                            "{&pChannel%(j)d->m_handle, pBuffer%(j)d, "
+                            "&pChannel%(j)d->m_features, oldGain[%(j)d], "
+                            "newGain[%(j)d]},"
+                        )
+                        % {"j": j},
+                        depth=4,
+                    )
+                write("};", depth=2)
+                write(
+                    (
+                        "pEngineEffectsManager->processPostFaderInPlace("
+                        "outputHandle, channels, %(i)d, iBufferSize, "
+                        "iSampleRate);"
+                    )
+                    % {"i": i},
+                    depth=2,
+                )
             for j in range(i):
                 if inplace:
+                    if i > 1:
+                        continue
                     write(
                         (
                             "pEngineEffectsManager->processPostFaderInPlace("